@@ -28,11 +28,14 @@
 
 #include "resource.h"
 #include "micmap/audio/audio_capture.hpp"
+#include "micmap/audio/analysis_worker.hpp"
+#include "micmap/audio/resampler.hpp"
 #include "micmap/detection/noise_detector.hpp"
 #include "micmap/steamvr/vr_input.hpp"
 #include "micmap/steamvr/dashboard_manager.hpp"
 #include "micmap/core/state_machine.hpp"
 #include "micmap/core/config_manager.hpp"
+#include "micmap/core/trigger_dispatcher.hpp"
 #include "micmap/common/logger.hpp"
 
 #include <memory>
@@ -62,7 +65,15 @@ struct MicMapApp {
     std::unique_ptr<steamvr::IDashboardManager> dashboardManager;
     std::unique_ptr<core::IStateMachine> stateMachine;
     std::unique_ptr<core::IConfigManager> configManager;
-    std::unique_ptr<steamvr::IDriverClient> driverClient;
+    std::shared_ptr<steamvr::IDriverClient> driverClient;
+    
+    // Delivers triggers on its own thread, so a stalled dashboard or driver
+    // request never holds up the audio path
+    std::unique_ptr<core::ITriggerDispatcher> triggerDispatcher;
+    
+    // Audio time: advanced by the capture callback, so durations and
+    // cooldowns are measured in samples rather than wall-clock reads
+    std::shared_ptr<common::SampleClock> audioClock;
     
     std::vector<audio::AudioDevice> devices;
     int selectedDeviceIndex = 0;
@@ -80,19 +91,34 @@ struct MicMapApp {
     std::atomic<bool> hasProfile{false};
     
     // Button fire tracking (matching mic_test)
-    std::chrono::steady_clock::time_point detectionStartTime;
+    common::Timestamp detectionStartTime;
     std::atomic<bool> detectionActive{false};
     std::atomic<bool> buttonWouldFire{false};
     std::atomic<int> detectionDurationMs{0};
     
     // Cooldown tracking to prevent repeated triggers
-    std::chrono::steady_clock::time_point lastTriggerTime;
+    common::Timestamp lastTriggerTime;
     std::atomic<bool> inCooldown{false};
     
-    std::chrono::steady_clock::time_point lastUpdate;
+    common::Timestamp lastUpdate;
     
     int detectionTimeMs = 300;
     
+    // Mic channels the current detector analyzes; above 1 detection runs
+    // from the multi-channel callback instead of the mono one. Set by
+    // createDetector() only while capture and analysis are stopped
+    size_t detectorChannels = 1;
+    size_t detectorHopSize = 512;
+    
+    // Results of one analyzeChannelsInto() call, sized for the largest
+    // packet so the newest frame is always among them
+    std::vector<detection::DetectionResult> channelResults;
+    
+    // With audio.analysisQueueMs set, the capture callbacks only queue audio
+    // and this worker runs training and detection on its own thread
+    std::unique_ptr<audio::AnalysisWorker> analysisWorker;
+    std::vector<float> workerMix;
+    
     HWND hwnd = nullptr;
     NOTIFYICONDATAW nid = {};
     bool minimizedToTray = false;
@@ -101,7 +127,15 @@ struct MicMapApp {
     bool initialize();
     void shutdown();
     void onTrigger();
+    std::vector<core::TriggerRoute> createTriggerRoutes();
+    void onDetectionResult(const detection::DetectionResult& result);
+    void processAudio(const float* samples, size_t count);
+    void processChannels(const float* const* planes, size_t frames);
+    void startAnalysis();
+    void stopAnalysis();
     void renderUI();
+    std::unique_ptr<detection::INoiseDetector> createDetector(uint32_t sampleRate);
+    void loadProfiles();
 };
 
 static MicMapApp g_app;
@@ -167,6 +201,78 @@ void SetupSystemTray(HWND hwnd) {
 
 void RemoveSystemTray() { Shell_NotifyIconW(NIM_DELETE, &g_app.nid); }
 
+std::unique_ptr<detection::INoiseDetector> MicMapApp::createDetector(uint32_t sampleRate) {
+    // Keep the audio timeline across re-created detectors unless the rate
+    // changes (capture is stopped whenever the device changes)
+    if (!audioClock || audioClock->getSampleRate() != sampleRate) {
+        audioClock = std::make_shared<common::SampleClock>(sampleRate);
+        detectionStartTime = common::Timestamp{};
+        lastTriggerTime = common::Timestamp{};
+        lastUpdate = common::Timestamp{};
+    }
+    
+    detection::NoiseDetectorConfig detectorConfig;
+    detectorConfig.sampleRate = sampleRate;
+    detectorConfig.clock = audioClock;
+    size_t channels = 1;
+    if (configManager) {
+        const auto& config = configManager->getConfig();
+        detectorConfig.fftSize = static_cast<size_t>(config.detection.fftSize);
+        detectorConfig.hopSize = static_cast<size_t>(config.detection.hopSize);
+        if (!detection::parseFFTBackendType(config.detection.fftBackend, detectorConfig.fftBackend)) {
+            MICMAP_LOG_WARNING("Unknown FFT backend '", config.detection.fftBackend, "', using auto");
+        }
+        if (config.detection.channels > 1) {
+            size_t deviceChannels = audioCapture ? audioCapture->getCurrentDevice().channels : 1;
+            size_t wanted = std::min(static_cast<size_t>(config.detection.channels),
+                                     detection::NoiseDetectorConfig::MAX_CHANNELS);
+            if (deviceChannels >= wanted) {
+                detectorConfig.channels = wanted;
+                channels = wanted;
+                if (config.detection.cascadeInterval > 0 || config.detection.monitorBins > 0) {
+                    MICMAP_LOG_INFO("Multi-channel detection analyzes every frame; cascade and monitor are off");
+                }
+            } else {
+                MICMAP_LOG_WARNING("Device has ", deviceChannels, " channels, detecting on the mono mix");
+            }
+        }
+        if (config.detection.cascadeInterval > 0 && channels == 1) {
+            detectorConfig.cascade.enabled = true;
+            detectorConfig.cascade.idleInterval = config.detection.cascadeInterval;
+        }
+        if (config.detection.monitorBins > 0 && channels == 1) {
+            detectorConfig.monitor.enabled = true;
+            detectorConfig.monitor.bins = static_cast<size_t>(config.detection.monitorBins);
+        }
+        if (config.detection.filterbank != "none") {
+            if (detection::parseFilterbankScale(config.detection.filterbank, detectorConfig.filterbank.scale)) {
+                detectorConfig.filterbank.enabled = true;
+                detectorConfig.filterbank.bands =
+                    static_cast<size_t>(std::max(1, config.detection.filterbankBands));
+                detectorConfig.filterbank.minFrequency = config.detection.filterbankMinHz;
+                detectorConfig.filterbank.maxFrequency = config.detection.filterbankMaxHz;
+            } else {
+                MICMAP_LOG_WARNING("Unknown filterbank '", config.detection.filterbank, "', matching FFT bins");
+            }
+        }
+    }
+    detectorChannels = channels;
+    detectorHopSize = detectorConfig.hopSize;
+    return detection::createFFTDetector(detectorConfig);
+}
+
+void MicMapApp::loadProfiles() {
+    if (!detector || !configManager) return;
+    if (!detector->loadTrainingData(configManager->getTrainingDataPath())) return;
+    
+    // Other users' or devices' profiles are matched alongside the trained one
+    for (const auto& file : configManager->getConfig().training.extraDataFiles) {
+        if (!detector->addTrainingData(configManager->getConfigDirectory() / file)) {
+            MICMAP_LOG_WARNING("Skipping profile ", file);
+        }
+    }
+}
+
 bool MicMapApp::initialize() {
     configManager = core::createConfigManager();
     configManager->loadDefault();
@@ -176,6 +282,13 @@ bool MicMapApp::initialize() {
     audioCapture = audio::createWASAPICapture();
     if (!audioCapture) return false;
     
+    // Detect at one rate whatever the device runs at, so profiles survive
+    // switching between 44.1, 48 and 96 kHz devices
+    if (config.audio.analysisRate > 0) {
+        audioCapture = audio::createResamplingCapture(std::move(audioCapture),
+                                                      static_cast<uint32_t>(config.audio.analysisRate));
+    }
+    
     devices = audioCapture->enumerateDevices();
     bool deviceSelected = false;
     
@@ -209,16 +322,21 @@ bool MicMapApp::initialize() {
     
     auto device = audioCapture->getCurrentDevice();
     if (device.sampleRate > 0) {
-        detector = detection::createFFTDetector(device.sampleRate, config.detection.fftSize);
+        detector = createDetector(device.sampleRate);
         detector->setMinDetectionDuration(config.detection.minDurationMs);
-        detector->loadTrainingData(configManager->getTrainingDataPath());
+        loadProfiles();
     }
     
     // Initialize driver client (non-blocking - will connect in background)
-    driverClient = steamvr::createDriverClient();
+    steamvr::DriverClientConfig driverConfig;
+    driverConfig.healthIntervalMs = config.steamvr.driverHealthIntervalMs;
+    driverConfig.useCommandChannel = config.steamvr.driverCommandChannel;
+    driverClient = steamvr::createDriverClient(driverConfig);
     
-    // Initialize VR input (don't initialize yet - will do async)
+    // Initialize VR input (don't initialize yet - will do async). Its
+    // dashboard clicks go through the same driver connection
     vrInput = steamvr::createOpenVRInput();
+    vrInput->setDriverClient(driverClient);
     vrInput->setEventCallback([this](const steamvr::VREvent& event) {
         if (event.type == steamvr::VREventType::Quit) {
             running = false;
@@ -240,95 +358,224 @@ bool MicMapApp::initialize() {
     stateMachine = core::createStateMachine(smConfig);
     stateMachine->setTriggerCallback([this]() { onTrigger(); });
     
+    // Both the duration check and the state machine can fire for one cover;
+    // the dispatcher merges triggers within the cooldown
+    core::TriggerDispatcherConfig dispatchConfig;
+    dispatchConfig.coalesceWindow = std::chrono::milliseconds(config.detection.cooldownMs);
+    dispatchConfig.deadline = std::chrono::milliseconds(config.steamvr.triggerDeadlineMs);
+    triggerDispatcher = core::createTriggerDispatcher(dispatchConfig);
+    triggerDispatcher->setRoutes(createTriggerRoutes());
+    triggerDispatcher->start();
+    
     // Check if we have a profile loaded
     hasProfile = detector && detector->hasTrainingData();
     
     if (audioCapture && detector) {
         audioCapture->setAudioCallback([this](const float* samples, size_t count) {
-            std::lock_guard<std::mutex> lock(audioMutex);
-            
-            // Calculate RMS level (matching mic_test)
-            float rms = 0.0f;
-            for (size_t i = 0; i < count; ++i) rms += samples[i] * samples[i];
-            rms = std::sqrt(rms / count);
-            
-            // Scale for display (0-1 range)
-            float scaledLevel = rms * 10.0f;
-            currentLevel = (scaledLevel > 1.0f) ? 1.0f : scaledLevel;
-            currentLevelDb = (rms <= 0.0f) ? -60.0f : std::max(-60.0f, 20.0f * std::log10(rms));
-            
-            // Training or detection (only detect if we have a profile) - matching mic_test
-            if (isTraining) {
-                detector->addTrainingSample(samples, count);
-                trainingSampleCount++;
-            } else if (detector->hasTrainingData()) {
-                // Only run detection if we have training data
-                auto result = detector->analyze(samples, count);
-                currentConfidence = result.confidence;
-                currentSpectralFlatness = result.spectralFlatness;
-                currentEnergy = result.energy;
-                currentEnergyDb = (result.energy <= 0.0f) ? -60.0f : std::max(-60.0f, 20.0f * std::log10(result.energy));
-                isDetected = result.isWhiteNoise;
-                
-                // Track detection duration for button fire (matching mic_test)
-                if (result.isWhiteNoise) {
-                    if (!detectionActive) {
-                        detectionStartTime = std::chrono::steady_clock::now();
-                        detectionActive = true;
-                    }
-                    
-                    auto now = std::chrono::steady_clock::now();
-                    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
-                        now - detectionStartTime).count();
-                    detectionDurationMs = static_cast<int>(duration);
-                    
-                    // Check cooldown
-                    auto cooldownElapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-                        now - lastTriggerTime).count();
-                    bool cooldownExpired = cooldownElapsed >= 300; // 300ms cooldown
-                    
-                    if (duration >= detectionTimeMs && !buttonWouldFire && cooldownExpired && !inCooldown) {
-                        buttonWouldFire = true;
-                        // Trigger the action!
-                        onTrigger();
-                        lastTriggerTime = now;
-                        inCooldown = true;
-                    }
-                } else {
-                    detectionActive = false;
-                    buttonWouldFire = false;
-                    detectionDurationMs = 0;
-                    inCooldown = false; // Reset cooldown when detection stops
-                }
-                
-                // Update state machine
-                auto now = std::chrono::steady_clock::now();
-                auto delta = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastUpdate);
-                lastUpdate = now;
-                if (stateMachine) stateMachine->update(result.confidence, delta);
-            } else {
-                // No profile - reset detection state
-                currentConfidence = 0.0f;
-                currentSpectralFlatness = 0.0f;
-                currentEnergy = 0.0f;
-                currentEnergyDb = -60.0f;
-                isDetected = false;
-                detectionActive = false;
-                buttonWouldFire = false;
-                detectionDurationMs = 0;
+            if (analysisWorker) {
+                if (detectorChannels == 1) analysisWorker->push(samples, count);
+                return;
             }
+            processAudio(samples, count);
+        });
+        
+        // Separate mic channels, delivered after the mono packet they were
+        // mixed into; the clock and level meter already advanced with it
+        audioCapture->setMultiChannelCallback([this](const float* samples, size_t frames, uint16_t channels) {
+            if (detectorChannels == 1 || channels < detectorChannels) return;
             
-            hasProfile = detector->hasTrainingData();
+            const float* planes[detection::NoiseDetectorConfig::MAX_CHANNELS];
+            for (size_t c = 0; c < detectorChannels; ++c) planes[c] = samples + c * frames;
+            if (analysisWorker) {
+                analysisWorker->push(planes, frames);
+                return;
+            }
+            processChannels(planes, frames);
         });
+        startAnalysis();
         audioCapture->startCapture();
     }
-    lastUpdate = std::chrono::steady_clock::now();
+    lastUpdate = audioClock ? audioClock->now() : common::Timestamp{};
     return true;
 }
 
+void MicMapApp::processAudio(const float* samples, size_t count) {
+    std::lock_guard<std::mutex> lock(audioMutex);
+    
+    audioClock->advance(count);
+    
+    // Calculate RMS level (matching mic_test)
+    float rms = 0.0f;
+    for (size_t i = 0; i < count; ++i) rms += samples[i] * samples[i];
+    rms = std::sqrt(rms / count);
+    
+    // Scale for display (0-1 range)
+    float scaledLevel = rms * 10.0f;
+    currentLevel = (scaledLevel > 1.0f) ? 1.0f : scaledLevel;
+    currentLevelDb = (rms <= 0.0f) ? -60.0f : std::max(-60.0f, 20.0f * std::log10(rms));
+    
+    // Training or detection (only detect if we have a profile) - matching mic_test
+    if (isTraining) {
+        if (detectorChannels == 1) {
+            detector->addTrainingSample(samples, count);
+        }
+        trainingSampleCount++;
+    } else if (detector->hasTrainingData()) {
+        // Only run detection if we have training data
+        if (detectorChannels == 1) {
+            onDetectionResult(detector->analyze(samples, count));
+        }
+    } else {
+        // No profile - reset detection state
+        currentConfidence = 0.0f;
+        currentSpectralFlatness = 0.0f;
+        currentEnergy = 0.0f;
+        currentEnergyDb = -60.0f;
+        isDetected = false;
+        detectionActive = false;
+        buttonWouldFire = false;
+        detectionDurationMs = 0;
+    }
+    
+    hasProfile = detector->hasTrainingData();
+}
+
+void MicMapApp::processChannels(const float* const* planes, size_t frames) {
+    std::lock_guard<std::mutex> lock(audioMutex);
+    
+    if (isTraining) {
+        detector->addTrainingChannels(planes, frames);
+    } else if (detector->hasTrainingData()) {
+        // Report the last frame, as analyze() does for the mono mix. The
+        // worker's batches fit the buffer sized in startAnalysis(); only
+        // an unusually large capture packet grows it here
+        size_t needed = detection::maxFramesPerCall(frames, detectorHopSize);
+        if (channelResults.size() < needed) channelResults.resize(needed);
+        size_t produced = detector->analyzeChannelsInto(planes, frames, channelResults.data(),
+                                                        channelResults.size());
+        if (produced > 0) onDetectionResult(channelResults[produced - 1]);
+    }
+}
+
+void MicMapApp::startAnalysis() {
+    analysisWorker.reset();
+    if (!configManager || !audioClock) return;
+    const auto& config = configManager->getConfig().audio;
+    if (config.analysisQueueMs <= 0) return;
+    
+    audio::AnalysisWorkerConfig workerConfig;
+    workerConfig.sampleRate = audioClock->getSampleRate();
+    workerConfig.streams = detectorChannels;
+    workerConfig.queueMs = config.analysisQueueMs;
+    workerConfig.maxBacklogMs = std::min(workerConfig.maxBacklogMs, config.analysisQueueMs);
+    workerConfig.blockMs = std::max(1, config.bufferSizeMs);
+    if (!audio::parseBackpressurePolicy(config.backpressure, workerConfig.policy)) {
+        MICMAP_LOG_WARNING("Unknown backpressure policy '", config.backpressure, "', using drop-oldest");
+    }
+    
+    analysisWorker = std::make_unique<audio::AnalysisWorker>(workerConfig,
+        [this](const float* const* streams, size_t frames) {
+            if (detectorChannels == 1) {
+                processAudio(streams[0], frames);
+                return;
+            }
+            // The capture's own mono mix is not queued; the clock and level
+            // meter follow the mix of the analyzed channels instead
+            float gain = 1.0f / static_cast<float>(detectorChannels);
+            for (size_t i = 0; i < frames; ++i) {
+                float sum = 0.0f;
+                for (size_t c = 0; c < detectorChannels; ++c) sum += streams[c][i];
+                workerMix[i] = sum * gain;
+            }
+            processAudio(workerMix.data(), frames);
+            processChannels(streams, frames);
+        });
+    workerMix.assign(detectorChannels > 1 ? analysisWorker->maxBatchFrames() : 0, 0.0f);
+    // A coalesced backlog reaches the detector in one call of up to the
+    // whole queue
+    {
+        std::lock_guard<std::mutex> lock(audioMutex);
+        channelResults.resize(std::max(channelResults.size(),
+            detection::maxFramesPerCall(analysisWorker->maxBatchFrames(), detectorHopSize)));
+    }
+    analysisWorker->start();
+    MICMAP_LOG_INFO("Analyzing on a worker thread (", config.analysisQueueMs, " ms queue, ",
+                    config.backpressure, ")");
+}
+
+void MicMapApp::stopAnalysis() {
+    if (!analysisWorker) return;
+    analysisWorker->stop();
+    auto stats = analysisWorker->getStats();
+    if (stats.droppedFrames > 0 || stats.lateFrames > 0) {
+        MICMAP_LOG_INFO("Analysis worker dropped ", stats.droppedFrames, " and was late for ",
+                        stats.lateFrames, " of ", stats.enqueuedFrames, " frames");
+    }
+    analysisWorker.reset();
+}
+
+void MicMapApp::onDetectionResult(const detection::DetectionResult& result) {
+    currentConfidence = result.confidence;
+    currentSpectralFlatness = result.spectralFlatness;
+    currentEnergy = result.energy;
+    currentEnergyDb = (result.energy <= 0.0f) ? -60.0f : std::max(-60.0f, 20.0f * std::log10(result.energy));
+    isDetected = result.isWhiteNoise;
+    
+    // Track detection duration for button fire (matching mic_test)
+    if (result.isWhiteNoise) {
+        auto now = audioClock->now();
+        if (!detectionActive) {
+            detectionStartTime = now;
+            detectionActive = true;
+        }
+        
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+            now - detectionStartTime).count();
+        detectionDurationMs = static_cast<int>(duration);
+        
+        // Check cooldown
+        auto cooldownElapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            now - lastTriggerTime).count();
+        bool cooldownExpired = cooldownElapsed >= 300; // 300ms cooldown
+        
+        if (duration >= detectionTimeMs && !buttonWouldFire && cooldownExpired && !inCooldown) {
+            buttonWouldFire = true;
+            // Trigger the action!
+            onTrigger();
+            lastTriggerTime = now;
+            inCooldown = true;
+        }
+    } else {
+        detectionActive = false;
+        buttonWouldFire = false;
+        detectionDurationMs = 0;
+        inCooldown = false; // Reset cooldown when detection stops
+    }
+    
+    // Update state machine
+    auto now = audioClock->now();
+    auto delta = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastUpdate);
+    lastUpdate = now;
+    if (stateMachine) stateMachine->update(result.confidence, delta);
+}
+
 void MicMapApp::shutdown() {
     running = false;
     if (audioCapture) audioCapture->stopCapture();
+    stopAnalysis();
+    if (triggerDispatcher) {
+        triggerDispatcher->stop();
+        auto stats = triggerDispatcher->getStats();
+        if (stats.delivered > 0) {
+            MICMAP_LOG_INFO("Triggers delivered: ", stats.delivered, ", mean latency ",
+                            stats.totalLatency.count() / static_cast<int64_t>(stats.delivered) / 1000,
+                            " ms, max ", stats.maxLatency.count() / 1000, " ms");
+        }
+        if (stats.failed > 0 || stats.expired > 0 || stats.unconfirmed > 0) {
+            MICMAP_LOG_INFO("Triggers failed: ", stats.failed, ", expired: ", stats.expired,
+                            ", unconfirmed: ", stats.unconfirmed);
+        }
+    }
     if (detector && detector->hasTrainingData() && configManager)
         detector->saveTrainingData(configManager->getTrainingDataPath());
     if (dashboardManager) dashboardManager->shutdown();
@@ -339,43 +586,67 @@ void MicMapApp::shutdown() {
 }
 
 void MicMapApp::onTrigger() {
+    // Called from the audio or analysis thread; delivery happens on the
+    // dispatcher thread
+    if (triggerDispatcher) triggerDispatcher->submit();
+}
+
+std::vector<core::TriggerRoute> MicMapApp::createTriggerRoutes() {
+    std::vector<core::TriggerRoute> routes;
+    auto sent = [](bool ok) {
+        return ok ? core::RouteOutcome::Delivered : core::RouteOutcome::NotAttempted;
+    };
+    // A driver click that went out without an acknowledgement may still be
+    // performed; the next route must not click again
+    auto clicked = [this](bool ok) {
+        if (!ok && driverClient && driverClient->lastCommandMayHaveRun()) {
+            return core::RouteOutcome::Unconfirmed;
+        }
+        return ok ? core::RouteOutcome::Delivered : core::RouteOutcome::NotAttempted;
+    };
+    
     // Use dashboardManager->performDashboardAction() like hmd_button_test's Auto button
     // This handles both opening dashboard (when closed) and sending click (when open)
-    
-    if (dashboardManager && dashboardManager->isConnected()) {
-        // Use the dashboard manager's performDashboardAction which handles both cases
-        dashboardManager->performDashboardAction();
-        return;
-    }
+    routes.push_back({"dashboard",
+        [this]() { return dashboardManager && dashboardManager->isConnected(); },
+        [this, sent, clicked]() {
+            // With the dashboard open this clicks through the shared driver client
+            bool open = dashboardManager->getDashboardState() == steamvr::DashboardState::Open;
+            bool ok = dashboardManager->performDashboardAction();
+            return open ? clicked(ok) : sent(ok);
+        }});
     
     // Fallback: try using driver client directly
-    if (driverClient && driverClient->isConnected()) {
-        auto state = steamvr::DashboardState::Unknown;
-        if (vrInput && vrInput->isInitialized()) {
-            state = vrInput->getDashboardState();
-        } else if (dashboardManager) {
-            state = dashboardManager->getDashboardState();
-        }
-        
-        if (state == steamvr::DashboardState::Closed || state == steamvr::DashboardState::Unknown) {
+    routes.push_back({"driver",
+        [this]() { return driverClient && driverClient->isConnected(); },
+        [this, clicked]() {
+            auto state = steamvr::DashboardState::Unknown;
+            if (vrInput && vrInput->isInitialized()) {
+                state = vrInput->getDashboardState();
+            } else if (dashboardManager) {
+                state = dashboardManager->getDashboardState();
+            }
+            
+            if (state == steamvr::DashboardState::Open) {
+                // Send click to select item under pointer
+                return clicked(driverClient->click("trigger", 100));
+            }
             // Open dashboard - send system button to toggle dashboard
-            driverClient->click("system", 100);
-        } else if (state == steamvr::DashboardState::Open) {
-            // Send click to select item under pointer
-            driverClient->click("trigger", 100);
-        }
-        return;
-    }
+            return clicked(driverClient->click("system", 100));
+        }});
     
     // Last resort: try VR input directly
-    if (vrInput && vrInput->isInitialized()) {
-        auto state = vrInput->getDashboardState();
-        if (state == steamvr::DashboardState::Closed || state == steamvr::DashboardState::Unknown) {
-            vrInput->sendHMDButtonEvent();
-        } else if (state == steamvr::DashboardState::Open) {
-            vrInput->sendDashboardSelect();
-        }
-    }
+    routes.push_back({"vrinput",
+        [this]() { return vrInput && vrInput->isInitialized(); },
+        [this, sent, clicked]() {
+            auto state = vrInput->getDashboardState();
+            if (state == steamvr::DashboardState::Open) {
+                return clicked(vrInput->sendDashboardSelect());
+            }
+            return sent(vrInput->sendHMDButtonEvent());
+        }});
+    
+    return routes;
 }
 
 void MicMapApp::renderUI() {
@@ -412,13 +683,15 @@ void MicMapApp::renderUI() {
         ImGui::SetNextItemWidth(-1);
         if (ImGui::Combo("##Dev", &selectedDeviceIndex, ptrs.data(), (int)ptrs.size()) && prev != selectedDeviceIndex && audioCapture) {
             audioCapture->stopCapture();
+            stopAnalysis();
             audioCapture->selectDeviceById(devices[selectedDeviceIndex].id);
             auto dev = audioCapture->getCurrentDevice();
             if (dev.sampleRate > 0) {
-                detector = detection::createFFTDetector(dev.sampleRate);
+                detector = createDetector(dev.sampleRate);
                 detector->setMinDetectionDuration(detectionTimeMs);
-                if (configManager) detector->loadTrainingData(configManager->getTrainingDataPath());
+                loadProfiles();
             }
+            startAnalysis();
             audioCapture->startCapture();
             if (configManager) configManager->getConfig().audio.deviceId = devices[selectedDeviceIndex].id;
         }
@@ -446,6 +719,7 @@ void MicMapApp::renderUI() {
             if (success) {
                 hasProfile = true;
                 if (configManager) detector->saveTrainingData(configManager->getTrainingDataPath());
+                loadProfiles();
             }
         }
     }
@@ -457,6 +731,7 @@ void MicMapApp::renderUI() {
                 if (success && configManager) {
                     detector->saveTrainingData(configManager->getTrainingDataPath());
                     hasProfile = true;
+                    loadProfiles();
                 }
             }
             isTraining = false;
@@ -470,11 +745,17 @@ void MicMapApp::renderUI() {
             trainingSampleCount = 0;
         }
         ImGui::SameLine();
-        if (ImGui::Button("Clear", ImVec2(60, 30)) && detector) {
+        if (ImGui::Button("Clear", ImVec2(60, 30)) && detector && audioCapture) {
+            // The worker and the capture callbacks use the detector and
+            // its channel count: replace it while both are stopped
             auto dev = audioCapture->getCurrentDevice();
             if (dev.sampleRate > 0) {
-                detector = detection::createFFTDetector(dev.sampleRate);
+                audioCapture->stopCapture();
+                stopAnalysis();
+                detector = createDetector(dev.sampleRate);
                 detector->setMinDetectionDuration(detectionTimeMs);
+                startAnalysis();
+                audioCapture->startCapture();
             }
             hasProfile = false;
             trainingSampleCount = 0;
@@ -609,6 +890,7 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE, LPSTR lpCmdLine, int nCmdShow
             // Initialize dashboard manager once VR is connected
             if (g_app.vrInput->isInitialized() && g_app.dashboardManager) {
                 auto sharedVR = std::shared_ptr<steamvr::IVRInput>(steamvr::createOpenVRInput().release());
+                sharedVR->setDriverClient(g_app.driverClient);
                 sharedVR->initialize();
                 steamvr::DashboardManagerConfig dashConfig;
                 dashConfig.autoReconnect = true;
@@ -640,8 +922,8 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE, LPSTR lpCmdLine, int nCmdShow
             g_app.dashboardManager->update();
         }
         
-        // Async reconnection attempts using futures to avoid blocking
-        static std::future<void> driverConnectFuture;
+        // Async reconnection attempts using futures to avoid blocking; the
+        // driver client reconnects on its own once connect() was called
         static std::future<void> vrInitFuture;
         static int reconnectCounter = 0;
         int reconnectInterval = g_app.minimizedToTray ? 100 : 40;
@@ -649,16 +931,6 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE, LPSTR lpCmdLine, int nCmdShow
         if (++reconnectCounter >= reconnectInterval) {
             reconnectCounter = 0;
             
-            // Check if driver needs reconnection (async)
-            if (g_app.driverClient && !g_app.driverClient->isConnected()) {
-                if (!driverConnectFuture.valid() ||
-                    driverConnectFuture.wait_for(std::chrono::milliseconds(0)) == std::future_status::ready) {
-                    driverConnectFuture = std::async(std::launch::async, []() {
-                        g_app.driverClient->connect();
-                    });
-                }
-            }
-            
             // Check if VR needs initialization (async)
             if (g_app.vrInput && !g_app.vrInput->isInitialized()) {
                 if (!vrInitFuture.valid() ||
@@ -668,6 +940,7 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE, LPSTR lpCmdLine, int nCmdShow
                         // Initialize dashboard manager once VR is connected
                         if (g_app.vrInput->isInitialized() && g_app.dashboardManager && !g_app.dashboardManager->isConnected()) {
                             auto sharedVR = std::shared_ptr<steamvr::IVRInput>(steamvr::createOpenVRInput().release());
+                            sharedVR->setDriverClient(g_app.driverClient);
                             sharedVR->initialize();
                             steamvr::DashboardManagerConfig dashConfig;
                             dashConfig.autoReconnect = true;
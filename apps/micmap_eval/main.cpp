@@ -0,0 +1,526 @@
+/**
+ * @file main.cpp
+ * @brief Offline detection evaluation over a labelled audio corpus
+ *
+ * Replays every WAV file below a directory through a trained detector and
+ * reports precision/recall, false triggers per hour and cover-to-trigger
+ * latency, per file and aggregated. Files are evaluated in parallel.
+ *
+ * Each recording "name.wav" may have an Audacity label file "name.txt" next
+ * to it (see loadLabelFile()). Segments labelled "covered..." are expected to
+ * trigger; recordings without labels (speech, game audio) should never
+ * trigger.
+ *
+ * Usage:
+ *   micmap_eval --profile <profile.mmap> [options] <corpus-dir>
+ *   micmap_eval --train <covered.wav> --profile <out.mmap> [options] <corpus-dir>
+ */
+
+#include "micmap/audio/resampler.hpp"
+#include "micmap/audio/wav_reader.hpp"
+#include "micmap/common/logger.hpp"
+#include "micmap/detection/evaluation.hpp"
+#include "micmap/detection/noise_detector.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+using namespace micmap;
+using namespace micmap::detection;
+
+namespace {
+
+// Frames read from a WAV file per call
+constexpr size_t READ_FRAMES = 65536;
+
+struct Options {
+    fs::path corpus;
+    fs::path profile;
+    std::vector<fs::path> extraProfiles;
+    fs::path trainFile;
+    unsigned jobs = 0;
+    uint32_t analysisRate = 0;      // 0 = each file's own rate
+    bool perFile = true;
+    NoiseDetectorConfig detector;
+    EvaluationConfig evaluation;
+};
+
+struct FileReport {
+    fs::path path;
+    std::string error;
+    EvaluationResult result;
+    CascadeStats cascade;
+};
+
+void printUsage() {
+    std::printf(
+        "Usage: micmap_eval --profile <profile.mmap> [options] <corpus-dir>\n"
+        "\n"
+        "Options:\n"
+        "  --profile <file>         Training profile to evaluate (written when --train is given)\n"
+        "  --train <wav>            Train the profile from this recording's covered segments\n"
+        "                           (the whole file if it has no labels)\n"
+        "  --add-profile <file>     Also match this profile (repeatable)\n"
+        "  --jobs <n>               Worker threads (default: all cores)\n"
+        "  --fft <n>                FFT size (default 2048)\n"
+        "  --hop <n>                Hop size (default 512)\n"
+        "  --rate <hz>              Resample recordings to this analysis rate (default: file rate)\n"
+        "  --channels <n>           Analyze n mic channels separately (default 1: mono mix)\n"
+        "  --min-duration-ms <ms>   Continuous detection needed to trigger (default 300)\n"
+        "  --tolerance-ms <ms>      Late triggers still credited to a segment (default 250)\n"
+        "  --high-confidence <c>    Confidence counted as a hit (default 0.60)\n"
+        "  --start-hits <n>         Hits in the hit window to start (default 4)\n"
+        "  --stop-hits <n>          Hits in the hit window to continue (default 2)\n"
+        "  --hit-window-ms <ms>     Frames the hits are counted over (default 128, 12 hops)\n"
+        "  --energy-window-ms <ms>  Hop energies the consistency is measured over (default 107)\n"
+        "  --spike-db <dB>          Hop energy that arms the spike gate (default -10)\n"
+        "  --spike-window-ms <ms>   How long a spike keeps the gate armed (default 500)\n"
+        "  --cascade <n>            Energy-gated cascade, one FFT per n idle frames (default off)\n"
+        "  --monitor <n>            Match idle frames on n sliding-DFT bins (default off)\n"
+        "  --match <m>              Profile match: auto, correlation or mahalanobis (default auto)\n"
+        "  --filterbank <s>         Match on mel or erb bands instead of FFT bins (default off)\n"
+        "  --bands <n>              Filterbank bands (default 32)\n"
+        "  --band-min-hz <hz>       Lower edge of the first band (default 50)\n"
+        "  --band-max-hz <hz>       Upper edge of the last band (default 16000)\n"
+        "  --summary                Only print the aggregate report\n");
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&](const char* name) -> const char* {
+            if (i + 1 >= argc) {
+                std::fprintf(stderr, "Missing value for %s\n", name);
+                return nullptr;
+            }
+            return argv[++i];
+        };
+
+        const char* v = nullptr;
+        if (arg == "--summary") {
+            options.perFile = false;
+            continue;
+        }
+        if (arg == "-h" || arg == "--help") {
+            return false;
+        }
+        if (arg.rfind("--", 0) != 0) {
+            options.corpus = arg;
+            continue;
+        }
+        if (!(v = value(arg.c_str()))) {
+            return false;
+        }
+
+        if (arg == "--profile") {
+            options.profile = v;
+        } else if (arg == "--add-profile") {
+            options.extraProfiles.push_back(v);
+        } else if (arg == "--train") {
+            options.trainFile = v;
+        } else if (arg == "--jobs") {
+            options.jobs = static_cast<unsigned>(std::strtoul(v, nullptr, 10));
+        } else if (arg == "--fft") {
+            options.detector.fftSize = std::strtoul(v, nullptr, 10);
+        } else if (arg == "--hop") {
+            options.detector.hopSize = std::strtoul(v, nullptr, 10);
+        } else if (arg == "--channels") {
+            options.detector.channels = std::strtoul(v, nullptr, 10);
+        } else if (arg == "--rate") {
+            options.analysisRate = static_cast<uint32_t>(std::strtoul(v, nullptr, 10));
+        } else if (arg == "--min-duration-ms") {
+            options.evaluation.minDurationMs = std::atoi(v);
+        } else if (arg == "--tolerance-ms") {
+            options.evaluation.triggerToleranceMs = std::atoi(v);
+        } else if (arg == "--high-confidence") {
+            options.detector.thresholds.highConfidence = std::strtof(v, nullptr);
+        } else if (arg == "--start-hits") {
+            options.detector.thresholds.startHits = std::atoi(v);
+        } else if (arg == "--stop-hits") {
+            options.detector.thresholds.stopHits = std::atoi(v);
+        } else if (arg == "--hit-window-ms") {
+            options.detector.thresholds.hitWindowMs = std::atoi(v);
+        } else if (arg == "--energy-window-ms") {
+            options.detector.thresholds.energyWindowMs = std::atoi(v);
+        } else if (arg == "--spike-db") {
+            options.detector.thresholds.spikeThresholdDb = std::strtof(v, nullptr);
+        } else if (arg == "--spike-window-ms") {
+            options.detector.thresholds.spikeWindowMs = std::atoi(v);
+        } else if (arg == "--cascade") {
+            options.detector.cascade.enabled = true;
+            options.detector.cascade.idleInterval = std::atoi(v);
+        } else if (arg == "--monitor") {
+            options.detector.monitor.enabled = true;
+            options.detector.monitor.bins = std::strtoul(v, nullptr, 10);
+        } else if (arg == "--match") {
+            std::string match = v;
+            if (match == "auto") {
+                options.detector.profileMatch = ProfileMatch::Auto;
+            } else if (match == "correlation") {
+                options.detector.profileMatch = ProfileMatch::Correlation;
+            } else if (match == "mahalanobis") {
+                options.detector.profileMatch = ProfileMatch::Mahalanobis;
+            } else {
+                std::fprintf(stderr, "Unknown profile match %s\n", v);
+                return false;
+            }
+        } else if (arg == "--filterbank") {
+            if (!parseFilterbankScale(v, options.detector.filterbank.scale)) {
+                std::fprintf(stderr, "Unknown filterbank %s\n", v);
+                return false;
+            }
+            options.detector.filterbank.enabled = true;
+        } else if (arg == "--bands") {
+            options.detector.filterbank.bands = std::strtoul(v, nullptr, 10);
+        } else if (arg == "--band-min-hz") {
+            options.detector.filterbank.minFrequency = std::strtof(v, nullptr);
+        } else if (arg == "--band-max-hz") {
+            options.detector.filterbank.maxFrequency = std::strtof(v, nullptr);
+        } else {
+            std::fprintf(stderr, "Unknown option %s\n", arg.c_str());
+            return false;
+        }
+    }
+    return !options.corpus.empty() && !options.profile.empty();
+}
+
+/**
+ * @brief Read a whole WAV file as mono float, resampled to analysisRate unless 0
+ *
+ * With channelCount above 1 the file must have that many channels, and
+ * channels also receives each of them separately, resampled alike.
+ */
+bool readRecording(const fs::path& path, uint32_t analysisRate, size_t channelCount,
+                   std::vector<float>& samples, std::vector<std::vector<float>>& channels,
+                   uint32_t& sampleRate, std::string& error) {
+    audio::WavReader reader;
+    if (!reader.open(path.string())) {
+        error = reader.getLastError();
+        return false;
+    }
+    sampleRate = reader.getInfo().sampleRate;
+    const size_t fileChannels = reader.getInfo().channels;
+    if (channelCount > 1 && fileChannels != channelCount) {
+        error = std::to_string(fileChannels) + " channels, expected " + std::to_string(channelCount);
+        return false;
+    }
+
+    const size_t total = static_cast<size_t>(reader.getInfo().totalFrames);
+    samples.resize(total);
+    channels.assign(channelCount > 1 ? channelCount : 0, std::vector<float>(total));
+    std::vector<float> planar(channels.empty() ? 0 : READ_FRAMES * fileChannels);
+    size_t read = 0;
+    while (read < total) {
+        size_t n = reader.readFrames(samples.data() + read,
+                                     planar.empty() ? nullptr : planar.data(),
+                                     std::min(total - read, READ_FRAMES));
+        if (n == 0) {
+            break;
+        }
+        for (size_t c = 0; c < channels.size(); ++c) {
+            std::copy_n(planar.data() + c * n, n, channels[c].data() + read);
+        }
+        read += n;
+    }
+    samples.resize(read);
+    for (auto& channel : channels) {
+        channel.resize(read);
+    }
+
+    if (analysisRate > 0 && analysisRate != sampleRate) {
+        try {
+            // One resampler per signal, so every channel sees the same filter state
+            auto resample = [&](std::vector<float>& signal) {
+                audio::Resampler resampler(sampleRate, analysisRate);
+                std::vector<float> resampled(resampler.maxOutput(signal.size()));
+                resampled.resize(resampler.process(signal.data(), signal.size(), resampled.data()));
+                signal.swap(resampled);
+            };
+            resample(samples);
+            for (auto& channel : channels) {
+                resample(channel);
+            }
+            sampleRate = analysisRate;
+        } catch (const std::invalid_argument& e) {
+            error = e.what();
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Pointers to the channels of a recording, offset by start samples
+ */
+std::vector<const float*> channelPointers(const std::vector<std::vector<float>>& channels, size_t start) {
+    std::vector<const float*> pointers;
+    for (const auto& channel : channels) {
+        pointers.push_back(channel.data() + start);
+    }
+    return pointers;
+}
+
+std::vector<LabelSegment> labelsFor(const fs::path& recording) {
+    std::vector<LabelSegment> labels;
+    fs::path labelPath = recording;
+    labelPath.replace_extension(".txt");
+    if (fs::exists(labelPath) && !loadLabelFile(labelPath, labels)) {
+        labels.clear();
+    }
+    return labels;
+}
+
+/**
+ * @brief Train a profile from the covered parts of one recording
+ */
+bool trainProfile(const Options& options, NoiseDetectorConfig config) {
+    std::vector<float> samples;
+    std::vector<std::vector<float>> channels;
+    std::string error;
+    if (!readRecording(options.trainFile, options.analysisRate, config.channels, samples, channels,
+                       config.sampleRate, error)) {
+        std::fprintf(stderr, "Cannot read %s: %s\n", options.trainFile.string().c_str(), error.c_str());
+        return false;
+    }
+
+    auto detector = createFFTDetector(config);
+    detector->startTraining();
+    auto addTraining = [&](size_t start, size_t count) {
+        if (channels.empty()) {
+            detector->addTrainingSample(samples.data() + start, count);
+        } else {
+            detector->addTrainingChannels(channelPointers(channels, start).data(), count);
+        }
+    };
+
+    auto labels = labelsFor(options.trainFile);
+    bool anyCovered = std::any_of(labels.begin(), labels.end(),
+                                  [](const LabelSegment& s) { return s.covered; });
+    if (anyCovered) {
+        for (const auto& segment : labels) {
+            if (!segment.covered) {
+                continue;
+            }
+            auto start = static_cast<size_t>(segment.startSec * config.sampleRate);
+            auto end = std::min(samples.size(), static_cast<size_t>(segment.endSec * config.sampleRate));
+            if (end > start) {
+                addTraining(start, end - start);
+            }
+        }
+    } else {
+        addTraining(0, samples.size());
+    }
+
+    if (!detector->finishTraining() || !detector->saveTrainingData(options.profile)) {
+        std::fprintf(stderr, "Training from %s failed\n", options.trainFile.string().c_str());
+        return false;
+    }
+    std::printf("Trained %s from %s\n\n", options.profile.string().c_str(),
+                options.trainFile.string().c_str());
+    return true;
+}
+
+FileReport evaluateFile(const fs::path& path, const Options& options, uint32_t profileRate) {
+    FileReport report;
+    report.path = path;
+
+    std::vector<float> samples;
+    std::vector<std::vector<float>> channels;
+    uint32_t sampleRate = 0;
+    if (!readRecording(path, options.analysisRate, options.detector.channels, samples, channels,
+                       sampleRate, report.error)) {
+        return report;
+    }
+    if (sampleRate != profileRate) {
+        report.error = "sample rate " + std::to_string(sampleRate) + " Hz does not match profile (" +
+                       std::to_string(profileRate) + " Hz)";
+        return report;
+    }
+
+    NoiseDetectorConfig config = options.detector;
+    config.sampleRate = sampleRate;
+    auto detector = createFFTDetector(config);
+    if (!detector->loadTrainingData(options.profile)) {
+        report.error = "cannot load profile";
+        return report;
+    }
+    for (const auto& extra : options.extraProfiles) {
+        if (!detector->addTrainingData(extra)) {
+            report.error = "cannot add profile " + extra.string();
+            return report;
+        }
+    }
+
+    if (channels.empty()) {
+        report.result = evaluateRecording(*detector, config.hopSize, samples.data(), samples.size(),
+                                          sampleRate, labelsFor(path), options.evaluation);
+    } else {
+        report.result = evaluateRecording(*detector, config.hopSize, channelPointers(channels, 0).data(),
+                                          channels.size(), samples.size(), sampleRate, labelsFor(path),
+                                          options.evaluation);
+    }
+    report.cascade = detector->getCascadeStats();
+    return report;
+}
+
+void printHeader() {
+    std::printf("%-32s %8s %7s %7s %7s %7s %9s %7s %8s %9s\n", "file", "dur(s)", "frameP",
+                "frameR", "eventP", "eventR", "hits", "false", "false/h", "p50(ms)");
+}
+
+void printRow(const std::string& name, const EvaluationResult& r) {
+    char hits[32];
+    std::snprintf(hits, sizeof(hits), "%zu/%zu", r.detectedSegments, r.coveredSegments);
+    std::printf("%-32s %8.1f %7.3f %7.3f %7.3f %7.3f %9s %7zu %8.2f %9.0f\n", name.c_str(),
+                r.durationSec, r.framePrecision(), r.frameRecall(), r.eventPrecision(),
+                r.eventRecall(), hits, r.falseTriggers, r.falseTriggersPerHour(),
+                percentileOf(r.latenciesMs, 50.0));
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+
+    common::Logger::getLogger()->setMinLevel(common::LogLevel::Warning);
+
+    if (!options.trainFile.empty() && !trainProfile(options, options.detector)) {
+        return 1;
+    }
+
+    // Probe the profile once for its sample rate and to fail early
+    uint32_t profileRate = 0;
+    try {
+        auto probe = createFFTDetector(options.detector);
+        if (!probe->loadTrainingData(options.profile)) {
+            std::fprintf(stderr, "Cannot load profile %s\n", options.profile.string().c_str());
+            return 1;
+        }
+        for (const auto& extra : options.extraProfiles) {
+            if (!probe->addTrainingData(extra)) {
+                std::fprintf(stderr, "Cannot add profile %s\n", extra.string().c_str());
+                return 1;
+            }
+        }
+        profileRate = probe->getTrainingData().sampleRate;
+        std::printf("Profile match: %s, %zu profile(s) of %zu %s\n",
+                    probe->getProfileMatch() == ProfileMatch::Mahalanobis ? "mahalanobis" : "correlation",
+                    probe->getProfileCount(), probe->getTrainingData().spectralProfile.size(),
+                    options.detector.filterbank.enabled ? "bands" : "bins");
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "Invalid detector settings: %s\n", e.what());
+        return 1;
+    }
+
+    std::vector<fs::path> files;
+    std::error_code ec;
+    for (fs::recursive_directory_iterator it(options.corpus, ec), end; !ec && it != end; it.increment(ec)) {
+        if (it->is_regular_file()) {
+            std::string ext = it->path().extension().string();
+            std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) {
+                return static_cast<char>(std::tolower(c));
+            });
+            if (ext == ".wav") {
+                files.push_back(it->path());
+            }
+        }
+    }
+    if (files.empty()) {
+        std::fprintf(stderr, "No WAV files found in %s\n", options.corpus.string().c_str());
+        return 1;
+    }
+    std::sort(files.begin(), files.end());
+
+    unsigned jobs = options.jobs ? options.jobs : std::max(1u, std::thread::hardware_concurrency());
+    jobs = std::min<unsigned>(jobs, static_cast<unsigned>(files.size()));
+
+    // Workers pull file indices from a shared counter; each file gets a
+    // fresh detector so no state leaks between recordings
+    std::vector<FileReport> reports(files.size());
+    std::atomic<size_t> next{0};
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for (unsigned j = 0; j < jobs; ++j) {
+        workers.emplace_back([&]() {
+            for (size_t i = next++; i < files.size(); i = next++) {
+                reports[i] = evaluateFile(files[i], options, profileRate);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    EvaluationResult total;
+    CascadeStats stages;
+    size_t failed = 0;
+    if (options.perFile) {
+        printHeader();
+    }
+    for (const auto& report : reports) {
+        std::string name = fs::relative(report.path, options.corpus, ec).string();
+        if (!report.error.empty()) {
+            std::fprintf(stderr, "%s: %s\n", name.c_str(), report.error.c_str());
+            ++failed;
+            continue;
+        }
+        if (options.perFile) {
+            printRow(name, report.result);
+        }
+        total.merge(report.result);
+        stages.frames += report.cascade.frames;
+        stages.energyOnly += report.cascade.energyOnly;
+        stages.reused += report.cascade.reused;
+        stages.monitored += report.cascade.monitored;
+        stages.analyzed += report.cascade.analyzed;
+    }
+
+    std::printf("\n");
+    printHeader();
+    printRow("TOTAL", total);
+
+    const auto& l = total.latenciesMs;
+    std::printf("\nCover-to-trigger latency over %zu triggers (ms):\n", l.size());
+    if (!l.empty()) {
+        double mean = 0.0;
+        for (double v : l) {
+            mean += v;
+        }
+        mean /= static_cast<double>(l.size());
+        std::printf("  min %.0f  p10 %.0f  p50 %.0f  p90 %.0f  p99 %.0f  max %.0f  mean %.0f\n",
+                    percentileOf(l, 0.0), percentileOf(l, 10.0), percentileOf(l, 50.0),
+                    percentileOf(l, 90.0), percentileOf(l, 99.0), percentileOf(l, 100.0), mean);
+    }
+
+    if ((options.detector.cascade.enabled || options.detector.monitor.enabled) && stages.frames > 0) {
+        auto share = [&stages](uint64_t n) {
+            return 100.0 * static_cast<double>(n) / static_cast<double>(stages.frames);
+        };
+        std::printf("\nCascade over %llu frames: energy only %.1f%%, reused %.1f%%, monitored %.1f%%, "
+                    "analysed %.1f%%\n",
+                    static_cast<unsigned long long>(stages.frames), share(stages.energyOnly),
+                    share(stages.reused), share(stages.monitored), share(stages.analyzed));
+    }
+
+    std::printf("\n%zu files (%zu failed), %.1f min of audio in %.2f s on %u threads (%.0fx real time)\n",
+                files.size(), failed, total.durationSec / 60.0, elapsed, jobs,
+                elapsed > 0.0 ? total.durationSec / elapsed : 0.0);
+    return failed == 0 ? 0 : 2;
+}
@@ -0,0 +1,106 @@
+/**
+ * @file bench_audio_buffer.cpp
+ * @brief Throughput benchmark for AudioBuffer concurrency modes
+ *
+ * Streams samples from a producer thread to a consumer thread in
+ * WASAPI-sized packets and reports throughput together with the worst-case
+ * time the producer spent inside write(), which is what the capture thread
+ * actually experiences.
+ */
+
+#include "micmap/audio/audio_buffer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using micmap::audio::AudioBuffer;
+using micmap::audio::AudioBufferMode;
+
+namespace {
+
+struct BenchResult {
+    double samplesPerSecond = 0.0;
+    double meanWriteNs = 0.0;
+    double maxWriteNs = 0.0;
+    uint64_t overflow = 0;
+};
+
+BenchResult run(AudioBufferMode mode, size_t packetSize, size_t totalSamples) {
+    using Clock = std::chrono::steady_clock;
+
+    AudioBuffer buffer(packetSize * 16, mode);
+    BenchResult result;
+
+    std::vector<float> packet(packetSize, 0.5f);
+    double totalWriteNs = 0.0;
+    size_t writeCalls = 0;
+
+    auto start = Clock::now();
+
+    std::thread consumer([&]() {
+        std::vector<float> out(packetSize);
+        size_t consumed = 0;
+        while (consumed < totalSamples) {
+            size_t count = buffer.read(out.data(), out.size());
+            if (count == 0) {
+                std::this_thread::yield();
+            }
+            consumed += count;
+        }
+    });
+
+    size_t produced = 0;
+    while (produced < totalSamples) {
+        size_t count = std::min(packetSize, totalSamples - produced);
+        auto before = Clock::now();
+        size_t written = buffer.write(packet.data(), count);
+        auto after = Clock::now();
+
+        double ns = static_cast<double>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(after - before).count());
+        totalWriteNs += ns;
+        result.maxWriteNs = std::max(result.maxWriteNs, ns);
+        ++writeCalls;
+
+        produced += written;
+        if (written < count) {
+            std::this_thread::yield();
+        }
+    }
+
+    consumer.join();
+    auto end = Clock::now();
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    result.samplesPerSecond = static_cast<double>(totalSamples) / seconds;
+    result.meanWriteNs = totalWriteNs / static_cast<double>(writeCalls);
+    result.overflow = buffer.overflowCount();
+    return result;
+}
+
+} // anonymous namespace
+
+int main() {
+    constexpr size_t TOTAL_SAMPLES = 50'000'000;
+    const size_t packetSizes[] = {64, 480, 4096};
+
+    std::printf("%-16s %8s %14s %14s %14s\n",
+                "mode", "packet", "Msamples/s", "mean write ns", "max write ns");
+
+    for (size_t packetSize : packetSizes) {
+        for (auto mode : {AudioBufferMode::Locked, AudioBufferMode::SingleProducer}) {
+            BenchResult r = run(mode, packetSize, TOTAL_SAMPLES);
+            std::printf("%-16s %8zu %14.1f %14.1f %14.0f\n",
+                        mode == AudioBufferMode::Locked ? "Locked" : "SingleProducer",
+                        packetSize,
+                        r.samplesPerSecond / 1e6,
+                        r.meanWriteNs,
+                        r.maxWriteNs);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,102 @@
+/**
+ * @file bench_fft_backends.cpp
+ * @brief Microbenchmark for the FFT backends
+ *
+ * Times one windowed forward transform for every backend and SIMD level
+ * across the FFT sizes the detector can be configured with.
+ */
+
+#include "micmap/detection/fft_backend.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+using micmap::common::SimdLevel;
+using micmap::detection::FFTBackendType;
+
+namespace {
+
+constexpr size_t SIZES[] = {256, 512, 1024, 2048, 4096, 8192};
+
+// Roughly constant total work per size
+constexpr size_t SAMPLES_PER_RUN = size_t{1} << 24;
+
+template <typename Fn>
+double nsPerCall(Fn&& fn, size_t iterations) {
+    using Clock = std::chrono::steady_clock;
+    fn();
+    auto start = Clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        fn();
+    }
+    auto end = Clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() /
+           static_cast<double>(iterations);
+}
+
+// Keeps results observable so the calls are not optimized away
+volatile float g_sink = 0.0f;
+
+} // anonymous namespace
+
+int main() {
+    struct Variant {
+        FFTBackendType type;
+        SimdLevel level;
+    };
+    const Variant variants[] = {
+        {FFTBackendType::KissFFT, SimdLevel::Scalar},
+        {FFTBackendType::Radix4, SimdLevel::Scalar},
+        {FFTBackendType::Radix4, SimdLevel::SSE2},
+        {FFTBackendType::Radix4, SimdLevel::AVX2},
+        {FFTBackendType::Radix4, SimdLevel::NEON},
+    };
+
+    std::printf("%-16s", "backend");
+    for (size_t size : SIZES) {
+        std::printf(" %9zu", size);
+    }
+    std::printf("\n");
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+
+    for (const Variant& variant : variants) {
+        if (variant.level != SimdLevel::Scalar &&
+            !micmap::common::isSimdLevelSupported(variant.level)) {
+            continue;
+        }
+
+        char label[32];
+        std::snprintf(label, sizeof(label), "%s/%s",
+                      micmap::detection::fftBackendTypeToString(variant.type),
+                      micmap::common::simdLevelToString(variant.level));
+        std::printf("%-16s", label);
+
+        for (size_t size : SIZES) {
+            auto fft = micmap::detection::createFFTBackend(variant.type, size, variant.level);
+            std::vector<float> input(size);
+            std::vector<float> window(size);
+            std::vector<float> output(2 * (size / 2 + 1));
+            for (size_t i = 0; i < size; ++i) {
+                input[i] = 0.3f * dist(rng);
+                window[i] = 0.5f * (1.0f - std::cos(6.2831853f * static_cast<float>(i) /
+                                                    static_cast<float>(size - 1)));
+            }
+
+            double ns = nsPerCall([&] {
+                fft->forward(input.data(), window.data(), output.data());
+                g_sink = output[2];
+            }, SAMPLES_PER_RUN / size);
+            std::printf(" %9.0f", ns);
+        }
+        std::printf("\n");
+    }
+
+    std::printf("(ns per windowed forward transform)\n");
+    return 0;
+}
@@ -0,0 +1,174 @@
+/**
+ * @file bench_audio.cpp
+ * @brief micmap_bench: AudioBuffer, analysis queue, capture conversion and resampling hot paths
+ */
+
+#include "micmap/audio/analysis_worker.hpp"
+#include "micmap/audio/audio_buffer.hpp"
+#include "micmap/audio/resampler.hpp"
+#include "micmap/audio/sample_convert.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using micmap::audio::AudioBuffer;
+using micmap::audio::AudioBufferMode;
+using micmap::audio::SampleFormat;
+using micmap::common::SimdLevel;
+
+namespace {
+
+// One WASAPI packet: 10 ms at 48 kHz
+constexpr size_t PACKET_FRAMES = 480;
+
+/**
+ * @brief Write one packet and read it back on the same thread
+ *
+ * Arg 0 selects the mode (0 = Locked, 1 = SingleProducer), arg 1 the packet size.
+ */
+void BM_AudioBufferWriteRead(benchmark::State& state) {
+    auto mode = state.range(0) == 0 ? AudioBufferMode::Locked : AudioBufferMode::SingleProducer;
+    size_t packet = static_cast<size_t>(state.range(1));
+
+    AudioBuffer buffer(packet * 16, mode);
+    std::vector<float> input(packet, 0.25f);
+    std::vector<float> output(packet);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(buffer.write(input.data(), packet));
+        benchmark::DoNotOptimize(buffer.read(output.data(), packet));
+        benchmark::ClobberMemory();
+    }
+
+    state.SetLabel(mode == AudioBufferMode::Locked ? "Locked" : "SingleProducer");
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(packet));
+}
+BENCHMARK(BM_AudioBufferWriteRead)
+    ->ArgNames({"mode", "packet"})
+    ->ArgsProduct({{0, 1}, {static_cast<int64_t>(PACKET_FRAMES), 4096}});
+
+/**
+ * @brief Queue one packet and wait until the analysis worker has it
+ *
+ * The hand-off from the capture thread to the worker in pipeline mode: the
+ * push itself plus the worker's wakeup. The handler does no work. Arg 0 is
+ * the number of streams.
+ */
+void BM_AnalysisWorkerHandoff(benchmark::State& state) {
+    size_t streams = static_cast<size_t>(state.range(0));
+
+    std::atomic<uint64_t> handled{0};
+    micmap::audio::AnalysisWorkerConfig config;
+    config.streams = streams;
+    micmap::audio::AnalysisWorker worker(config, [&](const float* const*, size_t frames) {
+        handled.fetch_add(frames, std::memory_order_release);
+    });
+    std::vector<float> input(PACKET_FRAMES * streams, 0.25f);
+    const float* planes[micmap::audio::AnalysisWorker::MAX_STREAMS];
+    for (size_t s = 0; s < streams; ++s) {
+        planes[s] = input.data() + s * PACKET_FRAMES;
+    }
+    worker.start();
+
+    uint64_t expected = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(worker.push(planes, PACKET_FRAMES));
+        expected += PACKET_FRAMES;
+        while (handled.load(std::memory_order_acquire) < expected) {
+        }
+    }
+
+    worker.stop();
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(PACKET_FRAMES));
+}
+BENCHMARK(BM_AnalysisWorkerHandoff)->ArgName("streams")->Arg(1)->Arg(2)->UseRealTime();
+
+/**
+ * @brief Convert one stereo packet to mono
+ *
+ * Arg 0 is the SampleFormat, arg 1 the requested SimdLevel.
+ */
+void BM_ConvertToMono(benchmark::State& state) {
+    auto format = static_cast<SampleFormat>(state.range(0));
+    auto level = static_cast<SimdLevel>(state.range(1));
+    if (level != SimdLevel::Scalar && !micmap::common::isSimdLevelSupported(level)) {
+        state.SkipWithError("SIMD level not supported on this CPU");
+        return;
+    }
+
+    constexpr uint16_t CHANNELS = 2;
+    std::vector<uint8_t> input(PACKET_FRAMES * CHANNELS * micmap::audio::bytesPerSample(format));
+    std::mt19937 rng(42);
+    for (uint8_t& byte : input) {
+        byte = static_cast<uint8_t>(rng());
+    }
+    if (format == SampleFormat::Float32) {
+        // Random bytes are not meaningful floats
+        auto* samples = reinterpret_cast<float*>(input.data());
+        std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+        for (size_t i = 0; i < PACKET_FRAMES * CHANNELS; ++i) {
+            samples[i] = dist(rng);
+        }
+    }
+    std::vector<float> output(PACKET_FRAMES);
+
+    for (auto _ : state) {
+        micmap::audio::convertToMono(format, input.data(), PACKET_FRAMES, CHANNELS,
+                                     output.data(), level);
+        benchmark::DoNotOptimize(output.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetLabel(micmap::common::simdLevelToString(level));
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(PACKET_FRAMES));
+}
+BENCHMARK(BM_ConvertToMono)
+    ->ArgNames({"format", "simd"})
+    ->ArgsProduct({
+        {static_cast<int64_t>(SampleFormat::Float32), static_cast<int64_t>(SampleFormat::Int16),
+         static_cast<int64_t>(SampleFormat::Int24), static_cast<int64_t>(SampleFormat::Int32)},
+        {static_cast<int64_t>(SimdLevel::Scalar), static_cast<int64_t>(SimdLevel::SSE2),
+         static_cast<int64_t>(SimdLevel::AVX2), static_cast<int64_t>(SimdLevel::NEON)}});
+
+/**
+ * @brief Resample one 10 ms device packet to 16 kHz
+ *
+ * Arg 0 is the device rate, arg 1 the requested SimdLevel.
+ */
+void BM_Resample(benchmark::State& state) {
+    auto inputRate = static_cast<uint32_t>(state.range(0));
+    auto level = static_cast<SimdLevel>(state.range(1));
+    if (level != SimdLevel::Scalar && !micmap::common::isSimdLevelSupported(level)) {
+        state.SkipWithError("SIMD level not supported on this CPU");
+        return;
+    }
+
+    micmap::audio::Resampler resampler(inputRate, 16000, level);
+    const size_t packet = inputRate / 100;
+    std::vector<float> input(packet);
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    for (float& s : input) {
+        s = dist(rng);
+    }
+    std::vector<float> output(resampler.maxOutput(packet));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(resampler.process(input.data(), packet, output.data()));
+        benchmark::ClobberMemory();
+    }
+
+    state.SetLabel(micmap::common::simdLevelToString(level));
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(packet));
+}
+BENCHMARK(BM_Resample)
+    ->ArgNames({"rate", "simd"})
+    ->ArgsProduct({{44100, 48000, 96000},
+                   {static_cast<int64_t>(SimdLevel::Scalar), static_cast<int64_t>(SimdLevel::SSE2),
+                    static_cast<int64_t>(SimdLevel::AVX2), static_cast<int64_t>(SimdLevel::NEON)}});
+
+} // anonymous namespace
@@ -0,0 +1,44 @@
+/**
+ * @file bench_core.cpp
+ * @brief micmap_bench: state machine update path
+ */
+
+#include "micmap/core/state_machine.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+
+using namespace micmap::core;
+
+namespace {
+
+/**
+ * @brief StateMachine::update at a 10 ms tick
+ *
+ * The confidence toggles every arg 0 ticks, so the machine cycles through
+ * Detecting, Triggered and Cooldown as in a real session. Arg 0 = 0 keeps
+ * it Idle.
+ */
+void BM_StateMachineUpdate(benchmark::State& state) {
+    int64_t period = state.range(0);
+
+    auto machine = createStateMachine();
+    int triggers = 0;
+    machine->setTriggerCallback([&triggers]() { ++triggers; });
+
+    constexpr std::chrono::milliseconds TICK{10};
+    int64_t tick = 0;
+
+    for (auto _ : state) {
+        bool active = period > 0 && (tick / period) % 2 == 0;
+        machine->update(active ? 0.9f : 0.1f, TICK);
+        ++tick;
+    }
+
+    benchmark::DoNotOptimize(triggers);
+    state.counters["triggers"] = static_cast<double>(triggers);
+}
+BENCHMARK(BM_StateMachineUpdate)->ArgName("period")->Arg(0)->Arg(100);
+
+} // anonymous namespace
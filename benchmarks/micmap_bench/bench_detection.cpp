@@ -0,0 +1,392 @@
+/**
+ * @file bench_detection.cpp
+ * @brief micmap_bench: spectral analysis, detection and training hot paths
+ */
+
+#include "micmap/detection/multichannel_analyzer.hpp"
+#include "micmap/detection/noise_detector.hpp"
+#include "micmap/detection/pattern_trainer.hpp"
+#include "micmap/detection/sliding_dft.hpp"
+#include "micmap/detection/spectral_analyzer.hpp"
+#include "micmap/detection/streaming_stft.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace micmap::detection;
+
+namespace {
+
+constexpr uint32_t SAMPLE_RATE = 48000;
+
+std::vector<float> whiteNoise(size_t count, float amplitude, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-amplitude, amplitude);
+    std::vector<float> samples(count);
+    for (float& s : samples) {
+        s = dist(rng);
+    }
+    return samples;
+}
+
+/**
+ * @brief One analyzer frame; arg 0 is the FFT size, arg 1 the FFTBackendType
+ */
+void BM_SpectralAnalyze(benchmark::State& state) {
+    size_t fftSize = static_cast<size_t>(state.range(0));
+    auto backend = static_cast<FFTBackendType>(state.range(1));
+
+    auto analyzer = createSpectralAnalyzer(SAMPLE_RATE, fftSize, backend);
+    auto samples = whiteNoise(fftSize, 0.3f, 1);
+
+    for (auto _ : state) {
+        SpectralResult result = analyzer->analyze(samples.data(), samples.size());
+        benchmark::DoNotOptimize(result.spectralFlatness);
+    }
+
+    state.SetLabel(fftBackendTypeToString(backend));
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(fftSize));
+}
+BENCHMARK(BM_SpectralAnalyze)
+    ->ArgNames({"fft", "backend"})
+    ->ArgsProduct({benchmark::CreateRange(256, 8192, 2),
+                   {static_cast<int64_t>(FFTBackendType::KissFFT),
+                    static_cast<int64_t>(FFTBackendType::Radix4)}});
+
+/**
+ * @brief Allocation-free analyzer frame at the default size
+ */
+void BM_SpectralAnalyzeInto(benchmark::State& state) {
+    constexpr size_t FFT_SIZE = 2048;
+    auto analyzer = createSpectralAnalyzer(SAMPLE_RATE, FFT_SIZE, FFTBackendType::Auto);
+    auto samples = whiteNoise(FFT_SIZE, 0.3f, 1);
+    std::vector<float> magnitudes(analyzer->getNumBins());
+
+    for (auto _ : state) {
+        SpectralFeatures features = analyzer->analyzeInto(samples.data(), samples.size(),
+                                                          magnitudes.data(), magnitudes.size());
+        benchmark::DoNotOptimize(features.spectralFlatness);
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(FFT_SIZE));
+}
+BENCHMARK(BM_SpectralAnalyzeInto);
+
+/**
+ * @brief Sliding DFT over arg 0 bins at the default frame and hop size
+ *
+ * Each frame transforms one new hop, so compare with BM_SpectralAnalyzeInto
+ * per frame rather than per sample.
+ */
+void BM_SlidingDFT(benchmark::State& state) {
+    constexpr size_t FFT_SIZE = 2048;
+    constexpr size_t HOP_SIZE = 512;
+    std::vector<size_t> bins;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        bins.push_back(static_cast<size_t>(10 + 30 * i));
+    }
+    SlidingDFTAnalyzer analyzer(SAMPLE_RATE, FFT_SIZE, HOP_SIZE, bins);
+    StreamingSTFT stft(FFT_SIZE, HOP_SIZE);
+    std::vector<float> magnitudes(bins.size());
+
+    constexpr size_t HOPS = 64;
+    auto input = whiteNoise(HOP_SIZE * HOPS, 0.3f, 1);
+    size_t hop = 0;
+
+    for (auto _ : state) {
+        stft.process(input.data() + hop * HOP_SIZE, HOP_SIZE, [&](const float* frame, const float*) {
+            SpectralFeatures features = analyzer.analyzeInto(frame, FFT_SIZE, nullptr, 0);
+            analyzer.getBinMagnitudes(magnitudes.data());
+            benchmark::DoNotOptimize(features.spectralFlatness);
+        });
+        hop = (hop + 1) % HOPS;
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(HOP_SIZE));
+}
+BENCHMARK(BM_SlidingDFT)->ArgName("bins")->Arg(8)->Arg(16)->Arg(32);
+
+/**
+ * @brief Trained detector fed one hop of samples per call; arg 0 is the FFT size
+ *
+ * Each call completes exactly one analysis frame (hop = fftSize / 4).
+ */
+void BM_NoiseDetectorAnalyze(benchmark::State& state) {
+    NoiseDetectorConfig config;
+    config.sampleRate = SAMPLE_RATE;
+    config.fftSize = static_cast<size_t>(state.range(0));
+    config.hopSize = config.fftSize / 4;
+
+    auto detector = createFFTDetector(config);
+    auto training = whiteNoise(SAMPLE_RATE * 2, 0.3f, 2);
+    detector->startTraining();
+    detector->addTrainingSample(training.data(), training.size());
+    if (!detector->finishTraining()) {
+        state.SkipWithError("Training failed");
+        return;
+    }
+
+    // Enough distinct hops that the input is not trivially cached
+    constexpr size_t HOPS = 64;
+    auto input = whiteNoise(config.hopSize * HOPS, 0.3f, 3);
+    size_t hop = 0;
+
+    for (auto _ : state) {
+        DetectionResult result = detector->analyze(input.data() + hop * config.hopSize,
+                                                   config.hopSize);
+        benchmark::DoNotOptimize(result.confidence);
+        hop = (hop + 1) % HOPS;
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(config.hopSize));
+}
+BENCHMARK(BM_NoiseDetectorAnalyze)->ArgName("fft")->RangeMultiplier(2)->Range(1024, 4096);
+
+/**
+ * @brief Trained detector with a hit and energy window of arg 0 milliseconds
+ *
+ * Both windows update in constant time, so longer windows cost the same
+ * per hop as the defaults.
+ */
+void BM_NoiseDetectorWindows(benchmark::State& state) {
+    NoiseDetectorConfig config;
+    config.sampleRate = SAMPLE_RATE;
+    config.thresholds.hitWindowMs = static_cast<int>(state.range(0));
+    config.thresholds.energyWindowMs = static_cast<int>(state.range(0));
+
+    auto detector = createFFTDetector(config);
+    auto training = whiteNoise(SAMPLE_RATE * 2, 0.3f, 2);
+    detector->startTraining();
+    detector->addTrainingSample(training.data(), training.size());
+    if (!detector->finishTraining()) {
+        state.SkipWithError("Training failed");
+        return;
+    }
+
+    constexpr size_t HOPS = 64;
+    auto input = whiteNoise(config.hopSize * HOPS, 0.3f, 3);
+    size_t hop = 0;
+
+    for (auto _ : state) {
+        DetectionResult result = detector->analyze(input.data() + hop * config.hopSize,
+                                                   config.hopSize);
+        benchmark::DoNotOptimize(result.confidence);
+        hop = (hop + 1) % HOPS;
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(config.hopSize));
+}
+BENCHMARK(BM_NoiseDetectorWindows)->ArgName("ms")->Arg(128)->Arg(680);
+
+/**
+ * @brief Trained detector on quiet ambient audio; arg 0 is the cascade idle
+ *        interval (0 disables the cascade), arg 1 the monitor bins (0 for none)
+ *
+ * Nothing can arm the spike gate, so with the cascade most hops stop at the
+ * energy gate and with the monitor the rest skip the FFT. The counters give
+ * the share of frames per cascade stage.
+ */
+void BM_NoiseDetectorCascade(benchmark::State& state) {
+    NoiseDetectorConfig config;
+    config.sampleRate = SAMPLE_RATE;
+    config.cascade.enabled = state.range(0) > 0;
+    config.cascade.idleInterval = std::max<int>(1, static_cast<int>(state.range(0)));
+    config.monitor.enabled = state.range(1) > 0;
+    config.monitor.bins = std::max<size_t>(1, static_cast<size_t>(state.range(1)));
+
+    auto detector = createFFTDetector(config);
+    auto training = whiteNoise(SAMPLE_RATE * 2, 0.3f, 2);
+    detector->startTraining();
+    detector->addTrainingSample(training.data(), training.size());
+    if (!detector->finishTraining()) {
+        state.SkipWithError("Training failed");
+        return;
+    }
+
+    constexpr size_t HOPS = 64;
+    auto input = whiteNoise(config.hopSize * HOPS, 0.01f, 3);
+    size_t hop = 0;
+
+    for (auto _ : state) {
+        DetectionResult result = detector->analyze(input.data() + hop * config.hopSize,
+                                                   config.hopSize);
+        benchmark::DoNotOptimize(result.confidence);
+        hop = (hop + 1) % HOPS;
+    }
+
+    CascadeStats stats = detector->getCascadeStats();
+    double frames = static_cast<double>(std::max<uint64_t>(stats.frames, 1));
+    state.counters["energyOnly"] = static_cast<double>(stats.energyOnly) / frames;
+    state.counters["monitored"] = static_cast<double>(stats.monitored) / frames;
+    state.counters["analyzed"] = static_cast<double>(stats.analyzed) / frames;
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(config.hopSize));
+}
+BENCHMARK(BM_NoiseDetectorCascade)
+    ->ArgNames({"interval", "monitor"})
+    ->ArgsProduct({{0, 4}, {0, 16}});
+
+/**
+ * @brief Trained detector matching every frame against arg 0 stored profiles
+ *
+ * Profiles beyond the first share the live log spectrum and cost a few dot
+ * products each, so the time per hop grows much slower than the count.
+ * Arg 1 is the number of mel bands profiles are matched on, 0 for FFT bins.
+ */
+void BM_NoiseDetectorProfiles(benchmark::State& state) {
+    NoiseDetectorConfig config;
+    config.sampleRate = SAMPLE_RATE;
+    config.filterbank.enabled = state.range(1) > 0;
+    config.filterbank.bands = static_cast<size_t>(std::max<int64_t>(state.range(1), 1));
+
+    auto detector = createFFTDetector(config);
+    auto profilePath = std::filesystem::temp_directory_path() / "micmap_bench_profile.mmap";
+    for (int64_t k = 0; k < state.range(0); ++k) {
+        auto trainer = createFFTDetector(config);
+        auto training = whiteNoise(SAMPLE_RATE, 0.3f, static_cast<uint32_t>(10 + k));
+        trainer->startTraining();
+        trainer->addTrainingSample(training.data(), training.size());
+        if (!trainer->finishTraining() || !trainer->saveTrainingData(profilePath) ||
+            !detector->addTrainingData(profilePath)) {
+            state.SkipWithError("Training failed");
+            return;
+        }
+    }
+    std::filesystem::remove(profilePath);
+
+    constexpr size_t HOPS = 64;
+    auto input = whiteNoise(config.hopSize * HOPS, 0.3f, 3);
+    size_t hop = 0;
+
+    for (auto _ : state) {
+        DetectionResult result = detector->analyze(input.data() + hop * config.hopSize,
+                                                   config.hopSize);
+        benchmark::DoNotOptimize(result.confidence);
+        hop = (hop + 1) % HOPS;
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(config.hopSize));
+}
+BENCHMARK(BM_NoiseDetectorProfiles)
+    ->ArgNames({"profiles", "bands"})
+    ->ArgsProduct({{1, 2, 4, 16}, {0, 32}});
+
+/**
+ * @brief Spectra and coherence of one frame of arg 0 channels
+ *
+ * Compare with arg 0 times BM_SpectralAnalyzeInto.
+ */
+void BM_MultiChannelAnalyzer(benchmark::State& state) {
+    constexpr size_t FFT_SIZE = 2048;
+    const size_t channels = static_cast<size_t>(state.range(0));
+    MultiChannelAnalyzer analyzer(SAMPLE_RATE, FFT_SIZE, channels);
+    std::vector<std::vector<float>> samples;
+    std::vector<const float*> frames;
+    for (size_t c = 0; c < channels; ++c) {
+        samples.push_back(whiteNoise(FFT_SIZE, 0.3f, static_cast<unsigned>(1 + c)));
+        frames.push_back(samples.back().data());
+    }
+    std::vector<float> magnitudes(channels * analyzer.getNumBins());
+    std::vector<SpectralFeatures> features(channels);
+
+    for (auto _ : state) {
+        float coherence = analyzer.analyzeInto(frames.data(), magnitudes.data(), features.data());
+        benchmark::DoNotOptimize(coherence);
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(FFT_SIZE * channels));
+}
+BENCHMARK(BM_MultiChannelAnalyzer)->ArgName("channels")->Arg(1)->Arg(2)->Arg(4);
+
+/**
+ * @brief Trained detector fed one hop of arg 0 channels per call
+ */
+void BM_NoiseDetectorChannels(benchmark::State& state) {
+    NoiseDetectorConfig config;
+    config.sampleRate = SAMPLE_RATE;
+    config.channels = static_cast<size_t>(state.range(0));
+
+    auto detector = createFFTDetector(config);
+    constexpr size_t HOPS = 64;
+    std::vector<std::vector<float>> training;
+    std::vector<std::vector<float>> input;
+    std::vector<const float*> pointers(config.channels);
+    for (size_t c = 0; c < config.channels; ++c) {
+        training.push_back(whiteNoise(SAMPLE_RATE * 2, 0.3f, static_cast<unsigned>(2 + c)));
+        input.push_back(whiteNoise(config.hopSize * HOPS, 0.3f, static_cast<unsigned>(20 + c)));
+        pointers[c] = training.back().data();
+    }
+    detector->startTraining();
+    detector->addTrainingChannels(pointers.data(), SAMPLE_RATE * 2);
+    if (!detector->finishTraining()) {
+        state.SkipWithError("Training failed");
+        return;
+    }
+
+    DetectionResult result;
+    size_t hop = 0;
+    for (auto _ : state) {
+        for (size_t c = 0; c < config.channels; ++c) {
+            pointers[c] = input[c].data() + hop * config.hopSize;
+        }
+        detector->analyzeChannelsInto(pointers.data(), config.hopSize, &result, 1);
+        benchmark::DoNotOptimize(result.confidence);
+        hop = (hop + 1) % HOPS;
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(config.hopSize));
+}
+BENCHMARK(BM_NoiseDetectorChannels)->ArgName("channels")->Arg(1)->Arg(2)->Arg(4);
+
+/**
+ * @brief PatternTrainer::addSample for one 2048-sample frame
+ */
+void BM_PatternTrainerAddSample(benchmark::State& state) {
+    constexpr size_t FFT_SIZE = 2048;
+    TrainingConfig config;
+    config.maxSamples = static_cast<size_t>(-1);
+    config.sampleInterval = std::chrono::milliseconds(0);
+
+    PatternTrainer trainer(createSpectralAnalyzer(SAMPLE_RATE, FFT_SIZE, FFTBackendType::Auto), config);
+    auto samples = whiteNoise(FFT_SIZE, 0.3f, 4);
+    trainer.startTraining();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(trainer.addSample(samples.data(), samples.size()));
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(FFT_SIZE));
+}
+BENCHMARK(BM_PatternTrainerAddSample);
+
+/**
+ * @brief A full training session of arg 0 frames ending in finishTraining()
+ */
+void BM_PatternTrainerSession(benchmark::State& state) {
+    constexpr size_t FFT_SIZE = 2048;
+    size_t frames = static_cast<size_t>(state.range(0));
+    TrainingConfig config;
+    config.maxSamples = frames;
+    config.sampleInterval = std::chrono::milliseconds(0);
+
+    PatternTrainer trainer(createSpectralAnalyzer(SAMPLE_RATE, FFT_SIZE, FFTBackendType::Auto), config);
+    auto samples = whiteNoise(FFT_SIZE * frames, 0.3f, 5);
+
+    for (auto _ : state) {
+        trainer.startTraining();
+        for (size_t i = 0; i < frames; ++i) {
+            trainer.addSample(samples.data() + i * FFT_SIZE, FFT_SIZE);
+        }
+        benchmark::DoNotOptimize(trainer.finishTraining());
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(frames));
+}
+BENCHMARK(BM_PatternTrainerSession)->ArgName("frames")->Arg(10)->Arg(100);
+
+} // anonymous namespace
@@ -0,0 +1,90 @@
+/**
+ * @file bench_ipc.cpp
+ * @brief micmap_bench: app-to-driver command channel over loopback
+ *
+ * Runs the driver's command server in-process on 127.0.0.1, so the timings
+ * cover the sockets and the kernel's loopback path but not SteamVR. The
+ * target for command delivery is well under 100 us.
+ */
+
+#include "micmap/common/command_channel.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+using namespace micmap::common;
+
+namespace {
+
+/**
+ * @brief One click command: send, handle on the server thread, ack
+ *
+ * Iteration time is the full round trip seen by the app. The counters
+ * report the one-way delivery time (send to handler), taken from the
+ * record's timestamps, as mean and maximum in microseconds.
+ */
+void BM_CommandRoundTrip(benchmark::State& state) {
+    std::atomic<uint64_t> handled{0};
+    CommandServer server([&handled](const CommandRecord&) {
+        handled.fetch_add(1, std::memory_order_relaxed);
+        return CommandStatus::Ok;
+    });
+    if (!server.start("127.0.0.1", 0)) {
+        state.SkipWithError(server.getLastError().c_str());
+        return;
+    }
+    CommandClient client;
+    if (!client.open("127.0.0.1", server.getPort())) {
+        state.SkipWithError(client.getLastError().c_str());
+        return;
+    }
+
+    uint64_t deliveryTotal = 0;
+    uint64_t deliveryMax = 0;
+    uint64_t lost = 0;
+    CommandRecord ack;
+    for (auto _ : state) {
+        if (!client.send(CommandAction::Click, CommandButton::Trigger, 100, ack)) {
+            ++lost;
+            continue;
+        }
+        uint64_t delivery = ack.handledUs - ack.sentUs;
+        deliveryTotal += delivery;
+        deliveryMax = std::max(deliveryMax, delivery);
+    }
+
+    double delivered = static_cast<double>(state.iterations() - lost);
+    state.counters["delivery_us"] = delivered > 0 ? static_cast<double>(deliveryTotal) / delivered : 0.0;
+    state.counters["delivery_max_us"] = static_cast<double>(deliveryMax);
+    state.counters["lost"] = static_cast<double>(lost);
+    benchmark::DoNotOptimize(handled.load());
+}
+BENCHMARK(BM_CommandRoundTrip)->UseRealTime()->Unit(benchmark::kMicrosecond);
+
+/**
+ * @brief Encoding and decoding one record, the per-command protocol cost
+ */
+void BM_CommandRecordCodec(benchmark::State& state) {
+    CommandRecord command;
+    command.action = CommandAction::Click;
+    command.button = CommandButton::Trigger;
+    command.durationMs = 100;
+    uint8_t wire[COMMAND_RECORD_SIZE];
+    CommandRecord decoded;
+
+    for (auto _ : state) {
+        command.sequence++;
+        command.sentUs = command.sequence;
+        encodeCommandRecord(command, wire);
+        benchmark::DoNotOptimize(wire);
+        bool ok = decodeCommandRecord(wire, sizeof(wire), decoded);
+        benchmark::DoNotOptimize(ok);
+        benchmark::DoNotOptimize(decoded);
+    }
+}
+BENCHMARK(BM_CommandRecordCodec);
+
+} // anonymous namespace
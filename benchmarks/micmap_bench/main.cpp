@@ -0,0 +1,23 @@
+/**
+ * @file main.cpp
+ * @brief micmap_bench entry point
+ *
+ * Same as benchmark_main, but with library logging limited to warnings so
+ * per-iteration info messages do not distort the timings.
+ */
+
+#include "micmap/common/logger.hpp"
+
+#include <benchmark/benchmark.h>
+
+int main(int argc, char** argv) {
+    micmap::common::Logger::getLogger()->setMinLevel(micmap::common::LogLevel::Warning);
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
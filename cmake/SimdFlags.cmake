@@ -0,0 +1,29 @@
+# SimdFlags.cmake
+# Helpers for compiling ISA-specific kernel translation units.
+#
+# Kernels for instruction sets above the compiler baseline live in their own
+# source files and are compiled with the matching flags; callers pick the
+# implementation at runtime through micmap/common/cpu_features.hpp.
+
+include_guard(GLOBAL)
+
+# micmap_add_avx2_sources(<target> <source>...)
+#
+# Adds sources compiled with AVX2 enabled to <target> and defines
+# MICMAP_HAVE_AVX2 for the whole target. Does nothing on non-x86 hosts.
+function(micmap_add_avx2_sources target)
+    # Checked here rather than at include time: with a global include guard,
+    # variables set by the first includer are not visible to sibling
+    # directories.
+    if(NOT CMAKE_SYSTEM_PROCESSOR MATCHES "^(x86_64|AMD64|amd64|x86|i[3-6]86)$")
+        return()
+    endif()
+
+    target_sources(${target} PRIVATE ${ARGN})
+    if(MSVC)
+        set_source_files_properties(${ARGN} PROPERTIES COMPILE_OPTIONS "/arch:AVX2")
+    else()
+        set_source_files_properties(${ARGN} PROPERTIES COMPILE_OPTIONS "-mavx2")
+    endif()
+    target_compile_definitions(${target} PRIVATE MICMAP_HAVE_AVX2=1)
+endfunction()
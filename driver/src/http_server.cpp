@@ -95,9 +95,68 @@ bool HttpServer::Start() {
     }
 
     DriverLog("HttpServer started successfully on port %d\n", port_);
+
+    StartCommandServer();
     return true;
 }
 
+void HttpServer::StartCommandServer() {
+    commandServer_ = std::make_unique<micmap::common::CommandServer>(
+        [this](const micmap::common::CommandRecord& command) { return HandleCommand(command); });
+
+    // Same number as the HTTP port, so clients need no second discovery
+    if (!commandServer_->start(host_, port_)) {
+        DriverLog("Command channel unavailable, HTTP only: %s\n", commandServer_->getLastError().c_str());
+        commandServer_.reset();
+        return;
+    }
+    DriverLog("Command channel listening on UDP %s:%d\n", host_.c_str(), commandServer_->getPort());
+}
+
+micmap::common::CommandStatus HttpServer::HandleCommand(const micmap::common::CommandRecord& command) {
+    using micmap::common::CommandAction;
+    using micmap::common::CommandButton;
+    using micmap::common::CommandStatus;
+
+    uint64_t delayUs = micmap::common::commandTimestampUs() - command.sentUs;
+    DriverLog("Command %u: %s %s (%llu us after send)\n", command.sequence,
+              micmap::common::commandActionToString(command.action),
+              micmap::common::commandButtonToString(command.button),
+              static_cast<unsigned long long>(delayUs));
+
+    if (!controller_ || !controller_->IsActive()) {
+        return CommandStatus::NotActive;
+    }
+
+    int duration = command.durationMs;
+    switch (command.action) {
+        case CommandAction::Click:
+            switch (command.button) {
+                case CommandButton::System: controller_->ClickSystemButton(duration); return CommandStatus::Ok;
+                case CommandButton::A: controller_->ClickAButton(duration); return CommandStatus::Ok;
+                case CommandButton::Trigger: controller_->ClickTrigger(duration); return CommandStatus::Ok;
+            }
+            break;
+        case CommandAction::Press:
+            switch (command.button) {
+                case CommandButton::System: controller_->PressSystemButton(); return CommandStatus::Ok;
+                case CommandButton::A: controller_->PressAButton(); return CommandStatus::Ok;
+                case CommandButton::Trigger: controller_->PressTrigger(); return CommandStatus::Ok;
+            }
+            break;
+        case CommandAction::Release:
+            switch (command.button) {
+                case CommandButton::System: controller_->ReleaseSystemButton(); return CommandStatus::Ok;
+                case CommandButton::A: controller_->ReleaseAButton(); return CommandStatus::Ok;
+                case CommandButton::Trigger: controller_->ReleaseTrigger(); return CommandStatus::Ok;
+            }
+            break;
+        default:
+            break;
+    }
+    return CommandStatus::BadCommand;
+}
+
 void HttpServer::Stop() {
     if (!running_) {
         return;
@@ -107,6 +166,11 @@ void HttpServer::Stop() {
 
     running_ = false;
 
+    if (commandServer_) {
+        commandServer_->stop();
+        commandServer_.reset();
+    }
+
     if (server_) {
         server_->stop();
     }
@@ -132,6 +196,7 @@ void HttpServer::SetupRoutes() {
         json += "\"driver\":\"micmap\",";
         json += "\"version\":\"0.1.0\",";
         json += "\"port\":" + std::to_string(port_) + ",";
+        json += "\"command_port\":" + std::to_string(commandServer_ ? commandServer_->getPort() : 0) + ",";
         json += "\"controller_active\":" + std::string(controllerActive ? "true" : "false");
         json += "}";
         
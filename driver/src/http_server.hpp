@@ -3,11 +3,15 @@
  * @brief HTTP server for receiving commands from MicMap application
  *
  * This server listens on localhost for HTTP requests from the MicMap
- * application and triggers button events on the virtual controller.
+ * application and triggers button events on the virtual controller. Next to
+ * it, a datagram command channel takes the same button commands as binary
+ * records, without HTTP parsing or JSON on the way.
  */
 
 #pragma once
 
+#include "micmap/common/command_channel.hpp"
+
 #include <string>
 #include <thread>
 #include <atomic>
@@ -31,6 +35,10 @@ class VirtualController;
  * - POST /press - Press button down
  * - POST /release - Release button
  * - GET /status - Get driver status
+ *
+ * Once the HTTP port is bound, the command channel listens on the UDP port
+ * with the same number (reported as command_port by /status, 0 if it could
+ * not be bound). HTTP remains the interface for status and tooling.
  */
 class HttpServer {
 public:
@@ -76,6 +84,8 @@ public:
 private:
     void SetupRoutes();
     void ServerThread();
+    void StartCommandServer();
+    micmap::common::CommandStatus HandleCommand(const micmap::common::CommandRecord& command);
 
     VirtualController* controller_;
     int port_;
@@ -84,6 +94,8 @@ private:
     std::unique_ptr<httplib::Server> server_;
     std::thread serverThread_;
     std::atomic<bool> running_{false};
+
+    std::unique_ptr<micmap::common::CommandServer> commandServer_;
 };
 
 } // namespace micmap::driver
\ No newline at end of file
@@ -0,0 +1,209 @@
+#pragma once
+
+/**
+ * @file analysis_worker.hpp
+ * @brief Bounded queue and thread that run detection off the capture thread
+ *
+ * The capture thread only converts a packet and copies it into a wait-free
+ * queue; a worker thread drains the queue and runs the analysis. A slow
+ * analysis step then delays detection instead of the device's buffer, and
+ * a backpressure policy decides what happens when the worker falls behind.
+ */
+
+#include "audio_buffer.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace micmap::audio {
+
+/**
+ * @brief What the worker does with audio it cannot keep up with
+ */
+enum class BackpressurePolicy {
+    DropOldest,  ///< Keep at most maxBacklogMs queued, dropping the oldest audio
+    Coalesce     ///< Keep all queued audio and deliver it in one call
+};
+
+/**
+ * @brief Parse a policy name ("drop-oldest", "coalesce")
+ * @return false if the name is unknown; policy is left unchanged
+ */
+bool parseBackpressurePolicy(std::string_view name, BackpressurePolicy& policy);
+
+/**
+ * @brief Analysis worker configuration
+ */
+struct AnalysisWorkerConfig {
+    uint32_t sampleRate = 48000;  ///< Rate of the queued audio in Hz
+    size_t streams = 1;           ///< Planar streams pushed in lockstep (mono mix or mic channels)
+    BackpressurePolicy policy = BackpressurePolicy::DropOldest;
+    int queueMs = 500;            ///< Audio the queue holds; the capture thread drops what does not fit
+    int maxBacklogMs = 100;       ///< DropOldest: newest audio kept when the worker falls behind
+    int blockMs = 10;             ///< DropOldest: most audio per handler call
+    int lateMs = 50;              ///< Backlog above which delivered frames count as late
+};
+
+/**
+ * @brief Counters of an AnalysisWorker, in frames (samples per stream)
+ */
+struct AnalysisWorkerStats {
+    uint64_t enqueuedFrames = 0;   ///< Accepted by push()
+    uint64_t processedFrames = 0;  ///< Delivered to the handler
+    uint64_t droppedFrames = 0;    ///< Rejected by a full queue or dropped as oldest backlog
+    uint64_t lateFrames = 0;       ///< Delivered while the backlog exceeded lateMs
+    uint64_t batches = 0;          ///< Handler calls
+    size_t maxBacklogFrames = 0;   ///< Largest backlog the worker found
+};
+
+/**
+ * @brief Single-producer queue of planar audio drained by a worker thread
+ *
+ * Each stream has its own wait-free AudioBuffer. push() is called from the
+ * capture thread and never blocks or allocates: it writes the same number
+ * of frames to every stream, as many as fit, and counts the rest as
+ * dropped. The worker reads the frames present in every stream and hands
+ * them to the handler on its own thread.
+ *
+ * With DropOldest the worker discards all but the newest maxBacklogMs of a
+ * backlog before delivering it in blocks of at most blockMs, so detection
+ * catches up with the present after a stall. With Coalesce nothing queued
+ * is discarded and the whole backlog goes to the handler in one call, which
+ * amortizes per-call work. Under either policy a stall longer than the queue
+ * drops the newest audio at push() until the worker resumes.
+ *
+ * The worker sleeps on a condition variable with a short timeout; push()
+ * notifies it without taking the lock, so a missed wakeup costs at most
+ * that timeout.
+ */
+class AnalysisWorker {
+public:
+    /**
+     * @brief Receives planar frames on the worker thread
+     * @param streams One pointer per stream, valid during the call only
+     * @param frames Frames per stream, at most maxBatchFrames()
+     */
+    using Handler = std::function<void(const float* const* streams, size_t frames)>;
+
+    /// Most streams one worker carries
+    static constexpr size_t MAX_STREAMS = 16;
+
+    /**
+     * @throws std::invalid_argument if the rate is zero, streams is not in
+     *         [1, MAX_STREAMS], a duration is not positive, or the handler
+     *         is empty
+     */
+    AnalysisWorker(const AnalysisWorkerConfig& config, Handler handler);
+
+    /**
+     * @brief Stops the worker, discarding queued audio
+     */
+    ~AnalysisWorker();
+
+    AnalysisWorker(const AnalysisWorker&) = delete;
+    AnalysisWorker& operator=(const AnalysisWorker&) = delete;
+
+    /**
+     * @brief Start the worker thread
+     * @return false if it is already running
+     */
+    bool start();
+
+    /**
+     * @brief Stop and join the worker thread
+     *
+     * Audio still queued stays queued and is delivered after start().
+     * Must not be called from the handler.
+     */
+    void stop();
+
+    bool isRunning() const { return running_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Queue frames from the capture thread
+     * @param streams config.streams planar pointers
+     * @param frames Frames per stream
+     * @return Frames queued; the rest were dropped
+     *
+     * Only one thread may push. Does not block or allocate.
+     */
+    size_t push(const float* const* streams, size_t frames);
+
+    /**
+     * @brief Queue a single-stream packet
+     */
+    size_t push(const float* samples, size_t count) { return push(&samples, count); }
+
+    /**
+     * @brief Wait until every queued frame has been handled
+     * @return false if the timeout passed first or the worker is stopped
+     */
+    bool waitIdle(int timeoutMs);
+
+    /**
+     * @brief Most frames in one handler call
+     */
+    size_t maxBatchFrames() const { return batchFrames_; }
+
+    /**
+     * @brief Snapshot of the counters
+     */
+    AnalysisWorkerStats getStats() const;
+
+    /**
+     * @brief Zero the counters
+     */
+    void resetStats();
+
+    const AnalysisWorkerConfig& getConfig() const { return config_; }
+
+private:
+    /// Longest sleep without a push notification
+    static constexpr int WAKE_INTERVAL_MS = 5;
+
+    void run();
+
+    /**
+     * @brief Deliver the queued frames
+     * @return Frames delivered
+     */
+    size_t drain();
+
+    size_t available() const;
+
+    AnalysisWorkerConfig config_;
+    Handler handler_;
+    std::vector<AudioBuffer> queues_;
+    size_t backlogFrames_;
+    size_t batchFrames_;
+    size_t lateFrames_;
+
+    std::vector<std::vector<float>> scratch_;
+    const float* planes_[MAX_STREAMS] = {};
+
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> busy_{false};
+    std::mutex wakeMutex_;
+    std::condition_variable wake_;
+
+    // Written by the capture thread
+    std::atomic<uint64_t> enqueued_{0};
+    std::atomic<uint64_t> rejected_{0};
+
+    // Written by the worker thread
+    std::atomic<uint64_t> processed_{0};
+    std::atomic<uint64_t> trimmed_{0};
+    std::atomic<uint64_t> late_{0};
+    std::atomic<uint64_t> batches_{0};
+    std::atomic<size_t> maxBacklog_{0};
+};
+
+} // namespace micmap::audio
@@ -7,48 +7,69 @@
 
 #include <vector>
 #include <cstddef>
+#include <cstdint>
 #include <mutex>
 #include <atomic>
 
 namespace micmap::audio {
 
+/**
+ * @brief Concurrency mode of an AudioBuffer
+ */
+enum class AudioBufferMode {
+    Locked,         ///< Mutex-protected, safe for any number of readers and writers
+    SingleProducer  ///< Wait-free, exactly one writer thread and one reader thread
+};
+
 /**
  * @brief Thread-safe ring buffer for audio samples
+ *
+ * In Locked mode every operation takes an internal mutex. In SingleProducer
+ * mode no lock is taken: write() must only be called from one thread and
+ * read()/peek()/clear() only from one other thread. The read and write
+ * indices live on separate cache lines and are published with
+ * acquire/release ordering, so the capture thread never waits on the
+ * analysis thread.
  */
 class AudioBuffer {
 public:
     /**
      * @brief Construct an audio buffer
      * @param capacity Maximum number of samples to store
+     * @param mode Concurrency mode (default: Locked)
      */
-    explicit AudioBuffer(size_t capacity);
-    
+    explicit AudioBuffer(size_t capacity, AudioBufferMode mode = AudioBufferMode::Locked);
+
     ~AudioBuffer() = default;
-    
+
     // Non-copyable
     AudioBuffer(const AudioBuffer&) = delete;
     AudioBuffer& operator=(const AudioBuffer&) = delete;
-    
-    // Movable
+
+    // Movable (not while other threads are using either buffer)
     AudioBuffer(AudioBuffer&&) noexcept;
     AudioBuffer& operator=(AudioBuffer&&) noexcept;
-    
+
     /**
      * @brief Write samples to the buffer
      * @param samples Pointer to sample data
      * @param count Number of samples to write
      * @return Number of samples actually written
+     *
+     * Samples that do not fit are dropped and counted as overflow.
      */
     size_t write(const float* samples, size_t count);
-    
+
     /**
      * @brief Read samples from the buffer
      * @param samples Pointer to output buffer
      * @param count Maximum number of samples to read
      * @return Number of samples actually read
+     *
+     * Requested samples that were not available are counted as underflow.
      */
     size_t read(float* samples, size_t count);
-    
+
     /**
      * @brief Peek at samples without removing them
      * @param samples Pointer to output buffer
@@ -56,43 +77,91 @@ public:
      * @return Number of samples actually peeked
      */
     size_t peek(float* samples, size_t count) const;
-    
+
+    /**
+     * @brief Drop the oldest samples without copying them out
+     * @param count Maximum number of samples to drop
+     * @return Number of samples actually dropped
+     *
+     * In SingleProducer mode this is a reader-side operation.
+     */
+    size_t discard(size_t count);
+
     /**
      * @brief Get the number of samples available for reading
      */
     size_t available() const;
-    
+
     /**
      * @brief Get the remaining capacity for writing
      */
     size_t space() const;
-    
+
     /**
      * @brief Get the total capacity of the buffer
      */
     size_t capacity() const;
-    
+
     /**
      * @brief Clear all samples from the buffer
+     *
+     * In SingleProducer mode this is a reader-side operation.
      */
     void clear();
-    
+
     /**
      * @brief Check if the buffer is empty
      */
     bool empty() const;
-    
+
     /**
      * @brief Check if the buffer is full
      */
     bool full() const;
 
+    /**
+     * @brief Get the concurrency mode
+     */
+    AudioBufferMode mode() const;
+
+    /**
+     * @brief Get the number of samples dropped because the buffer was full
+     */
+    uint64_t overflowCount() const;
+
+    /**
+     * @brief Get the number of samples requested by read() that were not available
+     */
+    uint64_t underflowCount() const;
+
+    /**
+     * @brief Reset the overflow and underflow counters
+     */
+    void resetCounters();
+
 private:
-    std::vector<float> buffer_;
-    size_t capacity_;
-    std::atomic<size_t> readPos_;
-    std::atomic<size_t> writePos_;
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    size_t writeImpl(const float* samples, size_t count);
+    size_t readImpl(float* samples, size_t count, bool consume);
+
+    std::vector<float> buffer_;     // Power-of-two sized storage
+    size_t capacity_;               // Usable capacity requested by the caller
+    size_t mask_;                   // buffer_.size() - 1
+    AudioBufferMode mode_;
+
+    // Producer-owned: write index and the producer's last view of the read index
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> writePos_;
+    size_t cachedReadPos_;
+
+    // Consumer-owned: read index and the consumer's last view of the write index
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> readPos_;
+    mutable size_t cachedWritePos_;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> overflowCount_;
+    std::atomic<uint64_t> underflowCount_;
+
     mutable std::mutex mutex_;
 };
 
-} // namespace micmap::audio
\ No newline at end of file
+} // namespace micmap::audio
@@ -23,6 +23,15 @@ namespace micmap::audio {
  */
 using AudioCallback = std::function<void(const float*, size_t)>;
 
+/**
+ * @brief Callback type for per-channel audio data
+ * @param samples Planar samples (normalized float -1.0 to 1.0): channels
+ *                blocks of frames samples, channel after channel
+ * @param frames Number of samples per channel
+ * @param channels Number of channels
+ */
+using MultiChannelCallback = std::function<void(const float*, size_t, uint16_t)>;
+
 /**
  * @brief Interface for audio capture
  */
@@ -68,8 +77,9 @@ public:
     virtual bool isCapturing() const = 0;
     
     /**
-     * @brief Get audio data from the buffer
-     * @param buffer Vector to fill with audio samples
+     * @brief Drain buffered audio into caller-owned storage
+     * @param buffer Vector to fill with audio samples; it is resized to the
+     *               number of samples returned, reusing its capacity
      * @return True if data was available
      */
     virtual bool getAudioBuffer(std::vector<float>& buffer) = 0;
@@ -86,6 +96,16 @@ public:
      */
     virtual void setAudioCallback(AudioCallback callback) = 0;
     
+    /**
+     * @brief Set callback for the device's channels without a downmix
+     * @param callback Function to call with every packet's channels
+     *
+     * Called from the capture thread right after the audio callback, with
+     * the same packet deinterleaved instead of mixed to mono. The channel
+     * count is the device's (see AudioDevice::channels).
+     */
+    virtual void setMultiChannelCallback(MultiChannelCallback callback) = 0;
+    
     /**
      * @brief Get the sample rate of the current device
      * @return Sample rate in Hz
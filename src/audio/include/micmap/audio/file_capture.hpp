@@ -0,0 +1,40 @@
+#pragma once
+
+/**
+ * @file file_capture.hpp
+ * @brief WAV file replay backend for IAudioCapture
+ */
+
+#include "audio_capture.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace micmap::audio {
+
+/**
+ * @brief Configuration for file-backed audio capture
+ */
+struct FileCaptureConfig {
+    std::string path;               ///< WAV file to replay
+    uint32_t periodFrames = 480;    ///< Frames per callback (480 = 10 ms at 48 kHz)
+    bool realTime = true;           ///< Pace packets at the file's sample rate; false = as fast as possible
+    bool loop = false;              ///< Restart from the beginning at end of file
+};
+
+/**
+ * @brief Create an audio capture that replays a WAV file
+ *
+ * The file is exposed as a single device. Packets are downmixed to mono and
+ * delivered through setAudioCallback(), and unmixed through
+ * setMultiChannelCallback(), from a background thread, exactly like the live
+ * backend. Without looping, isCapturing() turns false once the whole
+ * file has been delivered.
+ *
+ * @param config File capture configuration
+ * @return Unique pointer to the audio capture interface
+ */
+std::unique_ptr<IAudioCapture> createFileCapture(const FileCaptureConfig& config);
+
+} // namespace micmap::audio
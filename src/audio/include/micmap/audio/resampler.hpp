@@ -0,0 +1,114 @@
+#pragma once
+
+/**
+ * @file resampler.hpp
+ * @brief Polyphase sample rate conversion to a fixed analysis rate
+ *
+ * Capture devices run at 44.1, 48 or 96 kHz. Converting every device to one
+ * analysis rate keeps the detector's cost and its trained profiles
+ * independent of the device.
+ */
+
+#include "audio_capture.hpp"
+#include "sample_convert.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace micmap::audio {
+
+/**
+ * @brief Streaming rational-ratio resampler with a polyphase FIR filter
+ *
+ * The ratio outputRate / inputRate is reduced to L / M. Conceptually the
+ * input is upsampled by L, low-pass filtered and decimated by M; the
+ * polyphase form only computes the filter outputs that are kept, each as a
+ * single dot product over the input history. The Kaiser-windowed sinc
+ * filter cuts off just below the lower of the two Nyquist frequencies.
+ *
+ * Output is continuous across process() calls whatever the block sizes.
+ * Equal rates pass samples through unchanged.
+ */
+class Resampler {
+public:
+    /**
+     * @param inputRate Input sample rate in Hz
+     * @param outputRate Output sample rate in Hz
+     * @param level Kernel level for the filter dot products, clamped to
+     *              what the CPU supports as for convertToMono()
+     * @throws std::invalid_argument if a rate is zero or the reduced ratio
+     *         needs more than MAX_PHASES filter phases
+     */
+    Resampler(uint32_t inputRate, uint32_t outputRate,
+              common::SimdLevel level = getConversionSimdLevel());
+
+    /**
+     * @brief Convert the next block of input
+     * @param input Input samples
+     * @param count Number of input samples
+     * @param output Buffer with room for maxOutput(count) samples
+     * @return Number of output samples written
+     *
+     * Does not allocate.
+     */
+    size_t process(const float* input, size_t count, float* output);
+
+    /**
+     * @brief Upper bound on the output of one process() call
+     */
+    size_t maxOutput(size_t count) const;
+
+    /**
+     * @brief Forget the input history, as if newly constructed
+     */
+    void reset();
+
+    uint32_t getInputRate() const { return inputRate_; }
+    uint32_t getOutputRate() const { return outputRate_; }
+
+    /**
+     * @brief Filter taps applied per output sample (0 when passing through)
+     */
+    size_t getTapsPerPhase() const { return taps_; }
+
+    /// Largest reduced upsampling factor accepted
+    static constexpr uint32_t MAX_PHASES = 1024;
+
+private:
+    using DotKernel = float (*)(const float* coefficients, const float* samples, size_t count);
+
+    uint32_t inputRate_;
+    uint32_t outputRate_;
+    uint32_t up_ = 1;                   // L
+    uint32_t down_ = 1;                 // M
+    size_t taps_ = 0;                   // Per phase, a multiple of 8
+    DotKernel dot_ = nullptr;
+    std::vector<float> coefficients_;   // taps_ per phase, time-reversed
+    std::vector<float> history_;        // taps_ - 1 past samples, then new input
+    size_t fill_ = 0;                   // Valid samples in history_
+    uint64_t position_ = 0;             // Next output in 1/L input samples from history_[0]
+};
+
+/**
+ * @brief Wrap a capture so it delivers audio at a fixed sample rate
+ *
+ * Packets from @p capture are resampled to @p outputRate before they reach
+ * the audio callback and getAudioBuffer(), and each channel of its
+ * multi-channel packets before they reach the multi-channel callback.
+ * getSampleRate() and the sampleRate of getCurrentDevice() report
+ * @p outputRate, so a detector
+ * created from them keeps working when the device rate changes. Everything
+ * else is forwarded. The resampler is rebuilt for the device's rate on
+ * every startCapture().
+ *
+ * @param capture Capture to wrap
+ * @param outputRate Sample rate delivered to the application in Hz
+ * @return The wrapping capture
+ * @throws std::invalid_argument if capture is null or outputRate is zero
+ */
+std::unique_ptr<IAudioCapture> createResamplingCapture(std::unique_ptr<IAudioCapture> capture,
+                                                       uint32_t outputRate);
+
+} // namespace micmap::audio
@@ -0,0 +1,80 @@
+#pragma once
+
+/**
+ * @file sample_convert.hpp
+ * @brief Interleaved PCM to mono or planar float conversion kernels
+ *
+ * Portable (OS-independent) conversion used by the capture backends. The
+ * best implementation for the running CPU is selected at runtime; every
+ * SIMD kernel produces results bit-identical to the scalar reference.
+ */
+
+#include "micmap/common/cpu_features.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace micmap::audio {
+
+/**
+ * @brief Interleaved sample formats delivered by capture devices
+ */
+enum class SampleFormat {
+    Unknown,
+    Float32,    ///< 32-bit IEEE float
+    Int16,      ///< 16-bit signed PCM
+    Int24,      ///< 24-bit signed PCM packed in 3 bytes, little-endian
+    Int32       ///< 32-bit signed PCM
+};
+
+/**
+ * @brief Get the size in bytes of one sample of a format (0 if unknown)
+ */
+size_t bytesPerSample(SampleFormat format);
+
+/**
+ * @brief Convert interleaved multi-channel samples to mono float
+ *
+ * Each output sample is the average of the frame's channels, normalized to
+ * [-1.0, 1.0). Unknown formats produce silence.
+ *
+ * @param format Sample format of the input
+ * @param data Interleaved input samples (frames * channels samples)
+ * @param frames Number of frames to convert
+ * @param channels Number of interleaved channels (must be > 0)
+ * @param output Output buffer with room for frames samples
+ */
+void convertToMono(SampleFormat format, const void* data, size_t frames,
+                   uint16_t channels, float* output);
+
+/**
+ * @brief Convert to mono float using a specific kernel level
+ *
+ * Falls back to the best available kernel below @p level if the CPU does not
+ * support it or it was not compiled in. Intended for tests and benchmarks.
+ */
+void convertToMono(SampleFormat format, const void* data, size_t frames,
+                   uint16_t channels, float* output, common::SimdLevel level);
+
+/**
+ * @brief Convert interleaved multi-channel samples to planar float
+ *
+ * Keeps every channel instead of mixing them: channel c of frame i goes to
+ * output[c * frames + i], normalized as by convertToMono(). Unknown formats
+ * produce silence.
+ *
+ * @param format Sample format of the input
+ * @param data Interleaved input samples (frames * channels samples)
+ * @param frames Number of frames to convert
+ * @param channels Number of interleaved channels
+ * @param output Output buffer with room for frames * channels samples
+ */
+void deinterleave(SampleFormat format, const void* data, size_t frames,
+                  uint16_t channels, float* output);
+
+/**
+ * @brief Get the kernel level convertToMono() uses on this machine
+ */
+common::SimdLevel getConversionSimdLevel();
+
+} // namespace micmap::audio
@@ -0,0 +1,111 @@
+#pragma once
+
+/**
+ * @file wav_reader.hpp
+ * @brief Streaming reader for RIFF/WAVE files
+ */
+
+#include "sample_convert.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace micmap::audio {
+
+/**
+ * @brief Format information of an open WAV file
+ */
+struct WavInfo {
+    uint32_t sampleRate = 0;        ///< Sample rate in Hz
+    uint16_t channels = 0;          ///< Number of interleaved channels
+    uint16_t bitsPerSample = 0;     ///< Container bits per sample
+    SampleFormat format = SampleFormat::Unknown;
+    uint64_t totalFrames = 0;       ///< Number of frames in the data chunk
+};
+
+/**
+ * @brief Reads PCM16/24/32 and float32 WAV files as mono or planar float
+ *
+ * Supports plain PCM, IEEE float and WAVE_FORMAT_EXTENSIBLE headers with any
+ * channel count. Samples are streamed from disk and downmixed or
+ * deinterleaved with the same kernels as the live capture path.
+ */
+class WavReader {
+public:
+    WavReader() = default;
+    ~WavReader() = default;
+
+    // Non-copyable
+    WavReader(const WavReader&) = delete;
+    WavReader& operator=(const WavReader&) = delete;
+
+    /**
+     * @brief Open a WAV file and parse its header
+     * @param path Path to the file
+     * @return True if the file is a supported WAV file
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief Close the file
+     */
+    void close();
+
+    /**
+     * @brief Check if a file is open
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Get the format of the open file
+     */
+    const WavInfo& getInfo() const;
+
+    /**
+     * @brief Read frames and downmix them to mono float
+     * @param output Buffer with room for frames samples
+     * @param frames Maximum number of frames to read
+     * @return Number of frames read (0 at end of file)
+     */
+    size_t readMono(float* output, size_t frames);
+
+    /**
+     * @brief Read frames as mono float and as separate channels
+     * @param mono Buffer with room for frames samples, or null
+     * @param planar Buffer with room for frames * channels samples, or null;
+     *               receives the unmixed channels laid out by deinterleave()
+     *               for the number of frames read
+     * @param frames Maximum number of frames to read
+     * @return Number of frames read (0 at end of file)
+     */
+    size_t readFrames(float* mono, float* planar, size_t frames);
+
+    /**
+     * @brief Seek back to the first frame
+     */
+    bool rewind();
+
+    /**
+     * @brief Get the index of the next frame to be read
+     */
+    uint64_t getPosition() const;
+
+    /**
+     * @brief Get a description of the last error
+     */
+    const std::string& getLastError() const;
+
+private:
+    bool fail(const std::string& message);
+
+    std::ifstream file_;
+    WavInfo info_;
+    uint64_t dataOffset_ = 0;
+    uint64_t position_ = 0;
+    std::vector<uint8_t> raw_;
+    std::string lastError_;
+};
+
+} // namespace micmap::audio
@@ -0,0 +1,216 @@
+/**
+ * @file analysis_worker.cpp
+ * @brief Bounded queue and thread that run detection off the capture thread
+ */
+
+#include "micmap/audio/analysis_worker.hpp"
+#include "micmap/common/logger.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <stdexcept>
+#include <utility>
+
+namespace micmap::audio {
+
+namespace {
+
+size_t framesFor(int ms, uint32_t sampleRate) {
+    return std::max<size_t>(1, static_cast<size_t>(ms) * sampleRate / 1000);
+}
+
+} // anonymous namespace
+
+bool parseBackpressurePolicy(std::string_view name, BackpressurePolicy& policy) {
+    if (name == "drop-oldest") {
+        policy = BackpressurePolicy::DropOldest;
+        return true;
+    }
+    if (name == "coalesce") {
+        policy = BackpressurePolicy::Coalesce;
+        return true;
+    }
+    return false;
+}
+
+AnalysisWorker::AnalysisWorker(const AnalysisWorkerConfig& config, Handler handler)
+    : config_(config)
+    , handler_(std::move(handler)) {
+    if (config_.sampleRate == 0) {
+        throw std::invalid_argument("AnalysisWorker: sample rate must be positive");
+    }
+    if (config_.streams == 0 || config_.streams > MAX_STREAMS) {
+        throw std::invalid_argument("AnalysisWorker: streams must be between 1 and 16");
+    }
+    if (config_.queueMs <= 0 || config_.maxBacklogMs <= 0 || config_.blockMs <= 0 || config_.lateMs <= 0) {
+        throw std::invalid_argument("AnalysisWorker: durations must be positive");
+    }
+    if (!handler_) {
+        throw std::invalid_argument("AnalysisWorker: handler is empty");
+    }
+
+    size_t capacity = framesFor(config_.queueMs, config_.sampleRate);
+    backlogFrames_ = std::min(framesFor(config_.maxBacklogMs, config_.sampleRate), capacity);
+    lateFrames_ = framesFor(config_.lateMs, config_.sampleRate);
+    batchFrames_ = config_.policy == BackpressurePolicy::Coalesce
+        ? capacity
+        : std::min(framesFor(config_.blockMs, config_.sampleRate), backlogFrames_);
+
+    queues_.reserve(config_.streams);
+    scratch_.reserve(config_.streams);
+    for (size_t s = 0; s < config_.streams; ++s) {
+        queues_.emplace_back(capacity, AudioBufferMode::SingleProducer);
+        scratch_.emplace_back(batchFrames_);
+        planes_[s] = scratch_[s].data();
+    }
+}
+
+AnalysisWorker::~AnalysisWorker() {
+    stop();
+}
+
+bool AnalysisWorker::start() {
+    if (running_.exchange(true, std::memory_order_acq_rel)) {
+        return false;
+    }
+    thread_ = std::thread(&AnalysisWorker::run, this);
+    return true;
+}
+
+void AnalysisWorker::stop() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        running_.store(false, std::memory_order_release);
+    }
+    wake_.notify_one();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+size_t AnalysisWorker::push(const float* const* streams, size_t frames) {
+    // Streams only gain space while we write, so the smallest is a safe bound
+    size_t space = frames;
+    for (const auto& queue : queues_) {
+        space = std::min(space, queue.space());
+    }
+    if (space > 0) {
+        for (size_t s = 0; s < queues_.size(); ++s) {
+            queues_[s].write(streams[s], space);
+        }
+        enqueued_.fetch_add(space, std::memory_order_relaxed);
+        wake_.notify_one();
+    }
+    if (space < frames) {
+        rejected_.fetch_add(frames - space, std::memory_order_relaxed);
+    }
+    return space;
+}
+
+bool AnalysisWorker::waitIdle(int timeoutMs) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (isRunning()) {
+        // The worker marks itself busy before it takes frames off the queue
+        if (available() == 0 && !busy_.load()) {
+            return true;
+        }
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+}
+
+AnalysisWorkerStats AnalysisWorker::getStats() const {
+    AnalysisWorkerStats stats;
+    stats.enqueuedFrames = enqueued_.load(std::memory_order_relaxed);
+    stats.processedFrames = processed_.load(std::memory_order_relaxed);
+    stats.droppedFrames = rejected_.load(std::memory_order_relaxed) + trimmed_.load(std::memory_order_relaxed);
+    stats.lateFrames = late_.load(std::memory_order_relaxed);
+    stats.batches = batches_.load(std::memory_order_relaxed);
+    stats.maxBacklogFrames = maxBacklog_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void AnalysisWorker::resetStats() {
+    enqueued_.store(0, std::memory_order_relaxed);
+    rejected_.store(0, std::memory_order_relaxed);
+    processed_.store(0, std::memory_order_relaxed);
+    trimmed_.store(0, std::memory_order_relaxed);
+    late_.store(0, std::memory_order_relaxed);
+    batches_.store(0, std::memory_order_relaxed);
+    maxBacklog_.store(0, std::memory_order_relaxed);
+}
+
+size_t AnalysisWorker::available() const {
+    // The producer fills the streams in order, so the smallest count is
+    // the number of complete frames
+    size_t frames = queues_[0].available();
+    for (size_t s = 1; s < queues_.size(); ++s) {
+        frames = std::min(frames, queues_[s].available());
+    }
+    return frames;
+}
+
+void AnalysisWorker::run() {
+    MICMAP_LOG_DEBUG("Analysis worker started (", config_.streams, " streams, ",
+                     batchFrames_, " frames per batch)");
+    while (running_.load(std::memory_order_acquire)) {
+        if (drain() > 0) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(wakeMutex_);
+        if (!running_.load(std::memory_order_acquire)) {
+            break;
+        }
+        wake_.wait_for(lock, std::chrono::milliseconds(WAKE_INTERVAL_MS));
+    }
+    MICMAP_LOG_DEBUG("Analysis worker stopped");
+}
+
+size_t AnalysisWorker::drain() {
+    busy_.store(true);
+    size_t backlog = available();
+    if (backlog == 0) {
+        busy_.store(false);
+        return 0;
+    }
+    if (backlog > maxBacklog_.load(std::memory_order_relaxed)) {
+        maxBacklog_.store(backlog, std::memory_order_relaxed);
+    }
+
+    if (config_.policy == BackpressurePolicy::DropOldest && backlog > backlogFrames_) {
+        size_t excess = backlog - backlogFrames_;
+        for (auto& queue : queues_) {
+            queue.discard(excess);
+        }
+        trimmed_.fetch_add(excess, std::memory_order_relaxed);
+        backlog = backlogFrames_;
+    }
+
+    // Frames pushed after this point wait for the next pass
+    size_t delivered = 0;
+    while (delivered < backlog) {
+        size_t frames = std::min(batchFrames_, backlog - delivered);
+        for (size_t s = 0; s < queues_.size(); ++s) {
+            queues_[s].read(scratch_[s].data(), frames);
+        }
+        if (backlog - delivered > lateFrames_) {
+            late_.fetch_add(frames, std::memory_order_relaxed);
+        }
+        try {
+            handler_(planes_, frames);
+        } catch (const std::exception& e) {
+            MICMAP_LOG_ERROR("Analysis handler failed: ", e.what());
+        }
+        delivered += frames;
+        processed_.fetch_add(frames, std::memory_order_relaxed);
+        batches_.fetch_add(1, std::memory_order_relaxed);
+    }
+    busy_.store(false);
+    return delivered;
+}
+
+} // namespace micmap::audio
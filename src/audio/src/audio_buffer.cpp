@@ -10,21 +10,51 @@
 
 namespace micmap::audio {
 
-AudioBuffer::AudioBuffer(size_t capacity)
-    : buffer_(capacity)
+namespace {
+
+/**
+ * @brief Round up to the next power of two (minimum 1)
+ */
+size_t nextPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+} // anonymous namespace
+
+AudioBuffer::AudioBuffer(size_t capacity, AudioBufferMode mode)
+    : buffer_(nextPowerOfTwo(capacity))
     , capacity_(capacity)
+    , mask_(buffer_.size() - 1)
+    , mode_(mode)
+    , writePos_(0)
+    , cachedReadPos_(0)
     , readPos_(0)
-    , writePos_(0) {
+    , cachedWritePos_(0)
+    , overflowCount_(0)
+    , underflowCount_(0) {
 }
 
 AudioBuffer::AudioBuffer(AudioBuffer&& other) noexcept
     : buffer_(std::move(other.buffer_))
     , capacity_(other.capacity_)
+    , mask_(other.mask_)
+    , mode_(other.mode_)
+    , writePos_(other.writePos_.load())
+    , cachedReadPos_(other.cachedReadPos_)
     , readPos_(other.readPos_.load())
-    , writePos_(other.writePos_.load()) {
+    , cachedWritePos_(other.cachedWritePos_)
+    , overflowCount_(other.overflowCount_.load())
+    , underflowCount_(other.underflowCount_.load()) {
     other.capacity_ = 0;
-    other.readPos_ = 0;
+    other.mask_ = 0;
     other.writePos_ = 0;
+    other.cachedReadPos_ = 0;
+    other.readPos_ = 0;
+    other.cachedWritePos_ = 0;
 }
 
 AudioBuffer& AudioBuffer::operator=(AudioBuffer&& other) noexcept {
@@ -32,11 +62,20 @@ AudioBuffer& AudioBuffer::operator=(AudioBuffer&& other) noexcept {
         std::lock_guard<std::mutex> lock(mutex_);
         buffer_ = std::move(other.buffer_);
         capacity_ = other.capacity_;
-        readPos_ = other.readPos_.load();
+        mask_ = other.mask_;
+        mode_ = other.mode_;
         writePos_ = other.writePos_.load();
+        cachedReadPos_ = other.cachedReadPos_;
+        readPos_ = other.readPos_.load();
+        cachedWritePos_ = other.cachedWritePos_;
+        overflowCount_ = other.overflowCount_.load();
+        underflowCount_ = other.underflowCount_.load();
         other.capacity_ = 0;
-        other.readPos_ = 0;
+        other.mask_ = 0;
         other.writePos_ = 0;
+        other.cachedReadPos_ = 0;
+        other.readPos_ = 0;
+        other.cachedWritePos_ = 0;
     }
     return *this;
 }
@@ -45,84 +84,141 @@ size_t AudioBuffer::write(const float* samples, size_t count) {
     if (!samples || count == 0) {
         return 0;
     }
-    
+
+    if (mode_ == AudioBufferMode::SingleProducer) {
+        return writeImpl(samples, count);
+    }
+
     std::lock_guard<std::mutex> lock(mutex_);
-    
-    size_t availableSpace = space();
-    size_t toWrite = std::min(count, availableSpace);
-    
+    return writeImpl(samples, count);
+}
+
+size_t AudioBuffer::read(float* samples, size_t count) {
+    if (!samples || count == 0) {
+        return 0;
+    }
+
+    if (mode_ == AudioBufferMode::SingleProducer) {
+        return readImpl(samples, count, true);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    return readImpl(samples, count, true);
+}
+
+size_t AudioBuffer::peek(float* samples, size_t count) const {
+    if (!samples || count == 0) {
+        return 0;
+    }
+
+    // readImpl() does not modify the buffer when consume == false; it only
+    // refreshes the consumer's cached write index, which is mutable.
+    auto* self = const_cast<AudioBuffer*>(this);
+
+    if (mode_ == AudioBufferMode::SingleProducer) {
+        return self->readImpl(samples, count, false);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    return self->readImpl(samples, count, false);
+}
+
+size_t AudioBuffer::discard(size_t count) {
+    if (count == 0) {
+        return 0;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_, std::defer_lock);
+    if (mode_ == AudioBufferMode::Locked) {
+        lock.lock();
+    }
+
+    const size_t readPos = readPos_.load(std::memory_order_relaxed);
+    size_t availableData = cachedWritePos_ - readPos;
+    if (availableData < count) {
+        cachedWritePos_ = writePos_.load(std::memory_order_acquire);
+        availableData = cachedWritePos_ - readPos;
+    }
+
+    size_t toDiscard = std::min(count, availableData);
+    readPos_.store(readPos + toDiscard, std::memory_order_release);
+    return toDiscard;
+}
+
+size_t AudioBuffer::writeImpl(const float* samples, size_t count) {
+    const size_t writePos = writePos_.load(std::memory_order_relaxed);
+
+    // Only reload the consumer's index when the cached view says we are short
+    size_t freeSpace = capacity_ - (writePos - cachedReadPos_);
+    if (freeSpace < count) {
+        cachedReadPos_ = readPos_.load(std::memory_order_acquire);
+        freeSpace = capacity_ - (writePos - cachedReadPos_);
+    }
+
+    size_t toWrite = std::min(count, freeSpace);
+    if (toWrite < count) {
+        overflowCount_.fetch_add(count - toWrite, std::memory_order_relaxed);
+    }
+
     if (toWrite == 0) {
         return 0;
     }
-    
-    size_t writeIdx = writePos_ % capacity_;
-    size_t firstPart = std::min(toWrite, capacity_ - writeIdx);
+
+    size_t writeIdx = writePos & mask_;
+    size_t firstPart = std::min(toWrite, buffer_.size() - writeIdx);
     size_t secondPart = toWrite - firstPart;
-    
+
     std::memcpy(buffer_.data() + writeIdx, samples, firstPart * sizeof(float));
     if (secondPart > 0) {
         std::memcpy(buffer_.data(), samples + firstPart, secondPart * sizeof(float));
     }
-    
-    writePos_ += toWrite;
+
+    // Publish the samples to the consumer
+    writePos_.store(writePos + toWrite, std::memory_order_release);
     return toWrite;
 }
 
-size_t AudioBuffer::read(float* samples, size_t count) {
-    if (!samples || count == 0) {
-        return 0;
+size_t AudioBuffer::readImpl(float* samples, size_t count, bool consume) {
+    const size_t readPos = readPos_.load(std::memory_order_relaxed);
+
+    // Only reload the producer's index when the cached view says we are short
+    size_t availableData = cachedWritePos_ - readPos;
+    if (availableData < count) {
+        cachedWritePos_ = writePos_.load(std::memory_order_acquire);
+        availableData = cachedWritePos_ - readPos;
     }
-    
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    size_t availableData = available();
+
     size_t toRead = std::min(count, availableData);
-    
+    if (consume && toRead < count) {
+        underflowCount_.fetch_add(count - toRead, std::memory_order_relaxed);
+    }
+
     if (toRead == 0) {
         return 0;
     }
-    
-    size_t readIdx = readPos_ % capacity_;
-    size_t firstPart = std::min(toRead, capacity_ - readIdx);
+
+    size_t readIdx = readPos & mask_;
+    size_t firstPart = std::min(toRead, buffer_.size() - readIdx);
     size_t secondPart = toRead - firstPart;
-    
+
     std::memcpy(samples, buffer_.data() + readIdx, firstPart * sizeof(float));
     if (secondPart > 0) {
         std::memcpy(samples + firstPart, buffer_.data(), secondPart * sizeof(float));
     }
-    
-    readPos_ += toRead;
-    return toRead;
-}
 
-size_t AudioBuffer::peek(float* samples, size_t count) const {
-    if (!samples || count == 0) {
-        return 0;
-    }
-    
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    size_t availableData = writePos_ - readPos_;
-    size_t toPeek = std::min(count, availableData);
-    
-    if (toPeek == 0) {
-        return 0;
+    if (consume) {
+        // Hand the space back to the producer
+        readPos_.store(readPos + toRead, std::memory_order_release);
     }
-    
-    size_t readIdx = readPos_ % capacity_;
-    size_t firstPart = std::min(toPeek, capacity_ - readIdx);
-    size_t secondPart = toPeek - firstPart;
-    
-    std::memcpy(samples, buffer_.data() + readIdx, firstPart * sizeof(float));
-    if (secondPart > 0) {
-        std::memcpy(samples + firstPart, buffer_.data(), secondPart * sizeof(float));
-    }
-    
-    return toPeek;
+    return toRead;
 }
 
 size_t AudioBuffer::available() const {
-    return writePos_ - readPos_;
+    // Load the read index first: the write index only grows, so the
+    // difference can never go negative even if both sides are active.
+    size_t readPos = readPos_.load(std::memory_order_acquire);
+    size_t writePos = writePos_.load(std::memory_order_acquire);
+    return std::min(writePos - readPos, capacity_);
 }
 
 size_t AudioBuffer::space() const {
@@ -134,9 +230,15 @@ size_t AudioBuffer::capacity() const {
 }
 
 void AudioBuffer::clear() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    readPos_ = 0;
-    writePos_ = 0;
+    std::unique_lock<std::mutex> lock(mutex_, std::defer_lock);
+    if (mode_ == AudioBufferMode::Locked) {
+        lock.lock();
+    }
+
+    // Discard everything published so far; the consumer's cached view of the
+    // write index must never fall behind its own read index.
+    cachedWritePos_ = writePos_.load(std::memory_order_acquire);
+    readPos_.store(cachedWritePos_, std::memory_order_release);
 }
 
 bool AudioBuffer::empty() const {
@@ -147,4 +249,21 @@ bool AudioBuffer::full() const {
     return available() >= capacity_;
 }
 
-} // namespace micmap::audio
\ No newline at end of file
+AudioBufferMode AudioBuffer::mode() const {
+    return mode_;
+}
+
+uint64_t AudioBuffer::overflowCount() const {
+    return overflowCount_.load(std::memory_order_relaxed);
+}
+
+uint64_t AudioBuffer::underflowCount() const {
+    return underflowCount_.load(std::memory_order_relaxed);
+}
+
+void AudioBuffer::resetCounters() {
+    overflowCount_.store(0, std::memory_order_relaxed);
+    underflowCount_.store(0, std::memory_order_relaxed);
+}
+
+} // namespace micmap::audio
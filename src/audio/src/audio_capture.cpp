@@ -4,6 +4,8 @@
  */
 
 #include "micmap/audio/audio_capture.hpp"
+#include "micmap/audio/audio_buffer.hpp"
+#include "micmap/audio/sample_convert.hpp"
 #include "micmap/common/logger.hpp"
 
 #ifdef _WIN32
@@ -29,35 +31,24 @@ namespace micmap::audio {
 
 using Microsoft::WRL::ComPtr;
 
-/**
- * @brief Audio format types that WASAPI may return
- */
-enum class AudioFormatType {
-    Unknown,
-    Float32,
-    Int16,
-    Int24,
-    Int32
-};
-
 /**
  * @brief Determine the audio format type from WAVEFORMATEX
  */
-static AudioFormatType getFormatType(const WAVEFORMATEX* format) {
+static SampleFormat getFormatType(const WAVEFORMATEX* format) {
     if (!format) {
-        return AudioFormatType::Unknown;
+        return SampleFormat::Unknown;
     }
     
     if (format->wFormatTag == WAVE_FORMAT_IEEE_FLOAT) {
-        return AudioFormatType::Float32;
+        return SampleFormat::Float32;
     }
     
     if (format->wFormatTag == WAVE_FORMAT_PCM) {
         switch (format->wBitsPerSample) {
-            case 16: return AudioFormatType::Int16;
-            case 24: return AudioFormatType::Int24;
-            case 32: return AudioFormatType::Int32;
-            default: return AudioFormatType::Unknown;
+            case 16: return SampleFormat::Int16;
+            case 24: return SampleFormat::Int24;
+            case 32: return SampleFormat::Int32;
+            default: return SampleFormat::Unknown;
         }
     }
     
@@ -65,49 +56,22 @@ static AudioFormatType getFormatType(const WAVEFORMATEX* format) {
         const WAVEFORMATEXTENSIBLE* ext = reinterpret_cast<const WAVEFORMATEXTENSIBLE*>(format);
         
         if (IsEqualGUID(ext->SubFormat, KSDATAFORMAT_SUBTYPE_IEEE_FLOAT)) {
-            return AudioFormatType::Float32;
+            return SampleFormat::Float32;
         }
         
         if (IsEqualGUID(ext->SubFormat, KSDATAFORMAT_SUBTYPE_PCM)) {
-            switch (ext->Samples.wValidBitsPerSample) {
-                case 16: return AudioFormatType::Int16;
-                case 24: return AudioFormatType::Int24;
-                case 32: return AudioFormatType::Int32;
-                default: return AudioFormatType::Unknown;
+            // Samples are left-justified in their container (e.g. 24 valid
+            // bits in 32), so the container size decides the layout
+            switch (format->wBitsPerSample) {
+                case 16: return SampleFormat::Int16;
+                case 24: return SampleFormat::Int24;
+                case 32: return SampleFormat::Int32;
+                default: return SampleFormat::Unknown;
             }
         }
     }
     
-    return AudioFormatType::Unknown;
-}
-
-/**
- * @brief Convert 16-bit PCM sample to float
- */
-static inline float int16ToFloat(int16_t sample) {
-    return static_cast<float>(sample) / 32768.0f;
-}
-
-/**
- * @brief Convert 24-bit PCM sample (stored in 3 bytes) to float
- */
-static inline float int24ToFloat(const uint8_t* bytes) {
-    // 24-bit samples are stored as 3 bytes, little-endian
-    int32_t sample = static_cast<int32_t>(bytes[0]) |
-                     (static_cast<int32_t>(bytes[1]) << 8) |
-                     (static_cast<int32_t>(bytes[2]) << 16);
-    // Sign extend from 24 bits to 32 bits
-    if (sample & 0x800000) {
-        sample |= static_cast<int32_t>(0xFF000000);
-    }
-    return static_cast<float>(sample) / 8388608.0f;  // 2^23
-}
-
-/**
- * @brief Convert 32-bit PCM sample to float
- */
-static inline float int32ToFloat(int32_t sample) {
-    return static_cast<float>(sample) / 2147483648.0f;  // 2^31
+    return SampleFormat::Unknown;
 }
 
 /**
@@ -190,8 +154,9 @@ public:
         , channels_(0)
         , sourceChannels_(0)
         , bytesPerFrame_(0)
-        , formatType_(AudioFormatType::Unknown)
-        , notificationClient_(nullptr) {
+        , formatType_(SampleFormat::Unknown)
+        , notificationClient_(nullptr)
+        , history_(0) {
         // Initialize COM for this thread
         HRESULT hr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
         comInitialized_ = SUCCEEDED(hr) || hr == S_FALSE;
@@ -368,7 +333,7 @@ public:
                         format->nChannels, " channels, ", 
                         format->wBitsPerSample, " bits");
         
-        if (formatType_ == AudioFormatType::Unknown) {
+        if (formatType_ == SampleFormat::Unknown) {
             MICMAP_LOG_ERROR("Unsupported audio format");
             CoTaskMemFree(format);
             return false;
@@ -419,6 +384,17 @@ public:
             return false;
         }
         
+        // Size the conversion scratch and history once so the capture
+        // thread never allocates. No packet can exceed the endpoint buffer.
+        UINT32 bufferFrames = 0;
+        hr = audioClient_->GetBufferSize(&bufferFrames);
+        if (FAILED(hr) || bufferFrames == 0) {
+            bufferFrames = sampleRate_;
+        }
+        monoScratch_.assign(bufferFrames, 0.0f);
+        planarScratch_.assign(static_cast<size_t>(bufferFrames) * sourceChannels_, 0.0f);
+        history_ = AudioBuffer(sampleRate_);
+        
         // Start capture
         hr = audioClient_->Start();
         if (FAILED(hr)) {
@@ -434,7 +410,8 @@ public:
         // Start capture thread
         captureThread_ = std::thread(&WASAPIAudioCapture::captureLoop, this);
         
-        MICMAP_LOG_INFO("Audio capture started (output: mono float32)");
+        MICMAP_LOG_INFO("Audio capture started (output: mono float32, ",
+                        common::simdLevelToString(getConversionSimdLevel()), " conversion)");
         return true;
     }
     
@@ -474,15 +451,14 @@ public:
     }
     
     bool getAudioBuffer(std::vector<float>& buffer) override {
-        std::lock_guard<std::mutex> lock(bufferMutex_);
-        
-        if (audioBuffer_.empty()) {
+        size_t count = history_.available();
+        if (count == 0) {
             return false;
         }
         
-        buffer = std::move(audioBuffer_);
-        audioBuffer_.clear();
-        return true;
+        buffer.resize(count);
+        buffer.resize(history_.read(buffer.data(), count));
+        return !buffer.empty();
     }
     
     AudioDevice getCurrentDevice() const override {
@@ -494,6 +470,11 @@ public:
         audioCallback_ = std::move(callback);
     }
     
+    void setMultiChannelCallback(MultiChannelCallback callback) override {
+        std::lock_guard<std::mutex> lock(callbackMutex_);
+        multiChannelCallback_ = std::move(callback);
+    }
+    
     uint32_t getSampleRate() const override {
         return sampleRate_;
     }
@@ -552,37 +533,45 @@ private:
                 break;
             }
             
-            // Convert to mono float samples
-            std::vector<float> monoSamples(numFrames);
+            if (numFrames > monoScratch_.size()) {
+                // Not expected: packets are bounded by the endpoint buffer
+                MICMAP_LOG_WARNING("Capture packet of ", numFrames,
+                                   " frames exceeds scratch buffer, growing");
+                monoScratch_.resize(numFrames);
+            }
+            float* monoSamples = monoScratch_.data();
             
+            // Convert to mono float samples
             if (flags & AUDCLNT_BUFFERFLAGS_SILENT) {
-                // Fill with silence
-                std::fill(monoSamples.begin(), monoSamples.end(), 0.0f);
+                std::fill(monoSamples, monoSamples + numFrames, 0.0f);
             } else {
-                // Convert based on format type
-                convertToMonoFloat(data, numFrames, monoSamples);
+                convertToMono(formatType_, data, numFrames, sourceChannels_, monoSamples);
             }
             
-            // Store in buffer
-            {
-                std::lock_guard<std::mutex> lock(bufferMutex_);
-                audioBuffer_.insert(audioBuffer_.end(), monoSamples.begin(), monoSamples.end());
-                
-                // Limit buffer size (keep last 1 second of mono samples)
-                size_t maxSize = sampleRate_;
-                if (audioBuffer_.size() > maxSize) {
-                    audioBuffer_.erase(
-                        audioBuffer_.begin(),
-                        audioBuffer_.begin() + static_cast<ptrdiff_t>(audioBuffer_.size() - maxSize)
-                    );
-                }
+            // Keep the last second of mono samples, dropping the oldest
+            size_t space = history_.space();
+            if (space < numFrames) {
+                history_.discard(numFrames - space);
             }
+            history_.write(monoSamples, numFrames);
             
-            // Call callback if set
+            // Call callbacks if set
             {
                 std::lock_guard<std::mutex> lock(callbackMutex_);
                 if (audioCallback_) {
-                    audioCallback_(monoSamples.data(), monoSamples.size());
+                    audioCallback_(monoSamples, numFrames);
+                }
+                if (multiChannelCallback_) {
+                    size_t planarCount = static_cast<size_t>(numFrames) * sourceChannels_;
+                    if (planarCount > planarScratch_.size()) {
+                        planarScratch_.resize(planarCount);
+                    }
+                    if (flags & AUDCLNT_BUFFERFLAGS_SILENT) {
+                        std::fill(planarScratch_.begin(), planarScratch_.begin() + planarCount, 0.0f);
+                    } else {
+                        deinterleave(formatType_, data, numFrames, sourceChannels_, planarScratch_.data());
+                    }
+                    multiChannelCallback_(planarScratch_.data(), numFrames, sourceChannels_);
                 }
             }
             
@@ -590,83 +579,6 @@ private:
         }
     }
     
-    /**
-     * @brief Convert audio data to mono float format
-     */
-    void convertToMonoFloat(const BYTE* data, UINT32 numFrames, std::vector<float>& output) {
-        switch (formatType_) {
-            case AudioFormatType::Float32:
-                convertFloat32ToMono(reinterpret_cast<const float*>(data), numFrames, output);
-                break;
-            case AudioFormatType::Int16:
-                convertInt16ToMono(reinterpret_cast<const int16_t*>(data), numFrames, output);
-                break;
-            case AudioFormatType::Int24:
-                convertInt24ToMono(data, numFrames, output);
-                break;
-            case AudioFormatType::Int32:
-                convertInt32ToMono(reinterpret_cast<const int32_t*>(data), numFrames, output);
-                break;
-            default:
-                std::fill(output.begin(), output.end(), 0.0f);
-                break;
-        }
-    }
-    
-    /**
-     * @brief Convert float32 multi-channel to mono
-     */
-    void convertFloat32ToMono(const float* data, UINT32 numFrames, std::vector<float>& output) {
-        for (UINT32 i = 0; i < numFrames; ++i) {
-            float sum = 0.0f;
-            for (uint16_t ch = 0; ch < sourceChannels_; ++ch) {
-                sum += data[i * sourceChannels_ + ch];
-            }
-            output[i] = sum / static_cast<float>(sourceChannels_);
-        }
-    }
-    
-    /**
-     * @brief Convert int16 multi-channel to mono float
-     */
-    void convertInt16ToMono(const int16_t* data, UINT32 numFrames, std::vector<float>& output) {
-        for (UINT32 i = 0; i < numFrames; ++i) {
-            float sum = 0.0f;
-            for (uint16_t ch = 0; ch < sourceChannels_; ++ch) {
-                sum += int16ToFloat(data[i * sourceChannels_ + ch]);
-            }
-            output[i] = sum / static_cast<float>(sourceChannels_);
-        }
-    }
-    
-    /**
-     * @brief Convert int24 multi-channel to mono float
-     */
-    void convertInt24ToMono(const BYTE* data, UINT32 numFrames, std::vector<float>& output) {
-        const size_t bytesPerSample = 3;
-        for (UINT32 i = 0; i < numFrames; ++i) {
-            float sum = 0.0f;
-            for (uint16_t ch = 0; ch < sourceChannels_; ++ch) {
-                const BYTE* samplePtr = data + (i * sourceChannels_ + ch) * bytesPerSample;
-                sum += int24ToFloat(samplePtr);
-            }
-            output[i] = sum / static_cast<float>(sourceChannels_);
-        }
-    }
-    
-    /**
-     * @brief Convert int32 multi-channel to mono float
-     */
-    void convertInt32ToMono(const int32_t* data, UINT32 numFrames, std::vector<float>& output) {
-        for (UINT32 i = 0; i < numFrames; ++i) {
-            float sum = 0.0f;
-            for (uint16_t ch = 0; ch < sourceChannels_; ++ch) {
-                sum += int32ToFloat(data[i * sourceChannels_ + ch]);
-            }
-            output[i] = sum / static_cast<float>(sourceChannels_);
-        }
-    }
-    
     /**
      * @brief Get device information from IMMDevice
      */
@@ -733,12 +645,14 @@ private:
     std::atomic<bool> capturing_;
     std::atomic<bool> deviceLost_;
     
-    // Audio buffer
-    std::vector<float> audioBuffer_;
-    std::mutex bufferMutex_;
+    // Conversion scratch (sized from the endpoint buffer) and sample history
+    std::vector<float> monoScratch_;
+    std::vector<float> planarScratch_;  // Deinterleaved channels, only filled for the multi-channel callback
+    AudioBuffer history_;
     
-    // Callback
+    // Callbacks
     AudioCallback audioCallback_;
+    MultiChannelCallback multiChannelCallback_;
     std::mutex callbackMutex_;
     
     // Format information
@@ -746,7 +660,7 @@ private:
     uint16_t channels_;          // Output channels (always 1 for mono)
     uint16_t sourceChannels_;    // Source device channels
     uint16_t bytesPerFrame_;
-    AudioFormatType formatType_;
+    SampleFormat formatType_;
     
     bool comInitialized_ = false;
 };
@@ -769,6 +683,7 @@ public:
     bool getAudioBuffer(std::vector<float>&) override { return false; }
     AudioDevice getCurrentDevice() const override { return {}; }
     void setAudioCallback(AudioCallback) override {}
+    void setMultiChannelCallback(MultiChannelCallback) override {}
     uint32_t getSampleRate() const override { return 0; }
     uint16_t getChannels() const override { return 0; }
 };
@@ -0,0 +1,230 @@
+/**
+ * @file file_capture.cpp
+ * @brief WAV file replay implementation of IAudioCapture
+ */
+
+#include "micmap/audio/file_capture.hpp"
+#include "micmap/audio/audio_buffer.hpp"
+#include "micmap/audio/wav_reader.hpp"
+#include "micmap/common/logger.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+namespace micmap::audio {
+
+namespace {
+
+std::wstring toWide(const std::string& text) {
+    // Paths are only used as identifiers here; a byte-wise widening is enough
+    return std::wstring(text.begin(), text.end());
+}
+
+std::string fileName(const std::string& path) {
+    size_t slash = path.find_last_of("/\\");
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+} // anonymous namespace
+
+/**
+ * @brief Replays a WAV file through the IAudioCapture interface
+ */
+class FileAudioCapture : public IAudioCapture {
+public:
+    explicit FileAudioCapture(const FileCaptureConfig& config)
+        : config_(config)
+        , capturing_(false)
+        , history_(0) {
+        if (config_.periodFrames == 0) {
+            config_.periodFrames = 480;
+        }
+
+        if (!reader_.open(config_.path)) {
+            MICMAP_LOG_ERROR("File capture: ", reader_.getLastError());
+            return;
+        }
+
+        const WavInfo& info = reader_.getInfo();
+        device_.id = toWide(config_.path);
+        device_.name = toWide(fileName(config_.path));
+        device_.sampleRate = info.sampleRate;
+        device_.channels = info.channels;
+        device_.bitsPerSample = info.bitsPerSample;
+        device_.isDefault = true;
+
+        MICMAP_LOG_INFO("File capture: ", config_.path, " (", info.sampleRate, " Hz, ",
+                        info.channels, " channels, ", info.bitsPerSample, " bits, ",
+                        info.totalFrames, " frames)");
+    }
+
+    ~FileAudioCapture() override {
+        stopCapture();
+    }
+
+    std::vector<AudioDevice> enumerateDevices() override {
+        if (!reader_.isOpen()) {
+            return {};
+        }
+        return {device_};
+    }
+
+    bool selectDevice(const std::wstring& namePattern) override {
+        return reader_.isOpen() && device_.name.find(namePattern) != std::wstring::npos;
+    }
+
+    bool selectDeviceById(const std::wstring& deviceId) override {
+        return reader_.isOpen() && deviceId == device_.id;
+    }
+
+    bool startCapture() override {
+        if (capturing_) {
+            return true;
+        }
+
+        if (!reader_.isOpen()) {
+            MICMAP_LOG_ERROR("File capture: no file loaded");
+            return false;
+        }
+
+        // A previous run may have ended on its own at end of file
+        if (captureThread_.joinable()) {
+            captureThread_.join();
+        }
+
+        if (reader_.getPosition() >= reader_.getInfo().totalFrames) {
+            reader_.rewind();
+        }
+
+        monoScratch_.assign(config_.periodFrames, 0.0f);
+        planarScratch_.assign(config_.periodFrames * reader_.getInfo().channels, 0.0f);
+        history_ = AudioBuffer(reader_.getInfo().sampleRate);
+
+        capturing_ = true;
+        captureThread_ = std::thread(&FileAudioCapture::captureLoop, this);
+        return true;
+    }
+
+    void stopCapture() override {
+        capturing_ = false;
+        if (captureThread_.joinable()) {
+            captureThread_.join();
+        }
+    }
+
+    bool isCapturing() const override {
+        return capturing_;
+    }
+
+    bool getAudioBuffer(std::vector<float>& buffer) override {
+        size_t count = history_.available();
+        if (count == 0) {
+            return false;
+        }
+
+        buffer.resize(count);
+        buffer.resize(history_.read(buffer.data(), count));
+        return !buffer.empty();
+    }
+
+    AudioDevice getCurrentDevice() const override {
+        return device_;
+    }
+
+    void setAudioCallback(AudioCallback callback) override {
+        std::lock_guard<std::mutex> lock(callbackMutex_);
+        audioCallback_ = std::move(callback);
+    }
+
+    void setMultiChannelCallback(MultiChannelCallback callback) override {
+        std::lock_guard<std::mutex> lock(callbackMutex_);
+        multiChannelCallback_ = std::move(callback);
+    }
+
+    uint32_t getSampleRate() const override {
+        return reader_.getInfo().sampleRate;
+    }
+
+    uint16_t getChannels() const override {
+        return 1;  // Always mono output, like the live backend
+    }
+
+private:
+    /**
+     * @brief Deliver the file packet by packet until EOF or stop
+     */
+    void captureLoop() {
+        using Clock = std::chrono::steady_clock;
+
+        const double sampleRate = static_cast<double>(reader_.getInfo().sampleRate);
+        const auto startTime = Clock::now();
+        uint64_t framesDelivered = 0;
+
+        while (capturing_) {
+            // The file is decoded once into both the mix and the channels
+            size_t frames = reader_.readFrames(monoScratch_.data(), planarScratch_.data(),
+                                               monoScratch_.size());
+            if (frames == 0) {
+                if (config_.loop && reader_.getInfo().totalFrames > 0) {
+                    reader_.rewind();
+                    continue;
+                }
+                MICMAP_LOG_INFO("File capture: end of file");
+                break;
+            }
+
+            if (config_.realTime) {
+                // Pace against the absolute schedule so sleep jitter does not accumulate
+                auto due = startTime + std::chrono::duration_cast<Clock::duration>(
+                    std::chrono::duration<double>(static_cast<double>(framesDelivered) / sampleRate));
+                std::this_thread::sleep_until(due);
+            }
+
+            size_t space = history_.space();
+            if (space < frames) {
+                history_.discard(frames - space);
+            }
+            history_.write(monoScratch_.data(), frames);
+
+            {
+                std::lock_guard<std::mutex> lock(callbackMutex_);
+                if (audioCallback_) {
+                    audioCallback_(monoScratch_.data(), frames);
+                }
+                if (multiChannelCallback_) {
+                    multiChannelCallback_(planarScratch_.data(), frames, reader_.getInfo().channels);
+                }
+            }
+
+            framesDelivered += frames;
+        }
+
+        capturing_ = false;
+    }
+
+    FileCaptureConfig config_;
+    WavReader reader_;
+    AudioDevice device_{};
+
+    // Capture state
+    std::thread captureThread_;
+    std::atomic<bool> capturing_;
+
+    // Packet scratch and sample history
+    std::vector<float> monoScratch_;
+    std::vector<float> planarScratch_;
+    AudioBuffer history_;
+
+    // Callbacks
+    AudioCallback audioCallback_;
+    MultiChannelCallback multiChannelCallback_;
+    std::mutex callbackMutex_;
+};
+
+std::unique_ptr<IAudioCapture> createFileCapture(const FileCaptureConfig& config) {
+    return std::make_unique<FileAudioCapture>(config);
+}
+
+} // namespace micmap::audio
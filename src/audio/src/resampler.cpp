@@ -0,0 +1,197 @@
+/**
+ * @file resampler.cpp
+ * @brief Polyphase filter design, streaming conversion and kernel dispatch
+ */
+
+#include "micmap/audio/resampler.hpp"
+#include "resampler_kernels.hpp"
+#include "micmap/common/logger.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+namespace micmap::audio {
+
+using common::SimdLevel;
+
+namespace detail {
+
+float resampleDotScalar(const float* coefficients, const float* samples, size_t count) {
+    float lanes[8] = {};
+    for (size_t i = 0; i < count; i += 8) {
+        for (size_t j = 0; j < 8; ++j) {
+            lanes[j] += coefficients[i + j] * samples[i + j];
+        }
+    }
+    float s0 = lanes[0] + lanes[4];
+    float s1 = lanes[1] + lanes[5];
+    float s2 = lanes[2] + lanes[6];
+    float s3 = lanes[3] + lanes[7];
+    return (s0 + s2) + (s1 + s3);
+}
+
+} // namespace detail
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+
+// Filter length in output samples on each side of the centre when
+// decimating, or input samples when interpolating
+constexpr size_t HALF_TAPS = 16;
+
+// Cutoff as a fraction of the lower Nyquist frequency, and the Kaiser
+// window's beta (about 80 dB stopband attenuation)
+constexpr double CUTOFF = 0.9;
+constexpr double KAISER_BETA = 8.0;
+
+// Input is copied into the history in blocks of this many samples
+constexpr size_t BLOCK_SAMPLES = 1024;
+
+detail::ResampleDotKernel kernelFor(SimdLevel level) {
+    switch (level) {
+#ifdef MICMAP_HAVE_AVX2
+        case SimdLevel::AVX2: return detail::resampleDotAVX2;
+#endif
+#if MICMAP_AUDIO_HAVE_SSE2
+        case SimdLevel::SSE2: return detail::resampleDotSSE2;
+#endif
+#if MICMAP_AUDIO_HAVE_NEON
+        case SimdLevel::NEON: return detail::resampleDotNEON;
+#endif
+        default: return detail::resampleDotScalar;
+    }
+}
+
+/**
+ * @brief Zeroth-order modified Bessel function of the first kind
+ */
+double besselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    for (int k = 1; k < 50; ++k) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+        if (term < sum * 1e-12) {
+            break;
+        }
+    }
+    return sum;
+}
+
+} // anonymous namespace
+
+Resampler::Resampler(uint32_t inputRate, uint32_t outputRate, SimdLevel level)
+    : inputRate_(inputRate)
+    , outputRate_(outputRate)
+    , dot_(kernelFor(detail::resolveSimdLevel(level))) {
+    if (inputRate_ == 0 || outputRate_ == 0) {
+        throw std::invalid_argument("Resampler rates must be positive");
+    }
+    if (inputRate_ == outputRate_) {
+        return;
+    }
+
+    const uint32_t divisor = std::gcd(inputRate_, outputRate_);
+    up_ = outputRate_ / divisor;
+    down_ = inputRate_ / divisor;
+    if (up_ > MAX_PHASES) {
+        throw std::invalid_argument("Resampler ratio " + std::to_string(outputRate_) + "/" +
+                                    std::to_string(inputRate_) + " needs too many filter phases");
+    }
+
+    // Taps per phase span HALF_TAPS periods of the lower rate on each side
+    const double decimation = std::max(1.0, static_cast<double>(down_) / up_);
+    taps_ = static_cast<size_t>(std::ceil(2.0 * HALF_TAPS * decimation));
+    taps_ = (taps_ + 7) / 8 * 8;
+
+    // Prototype low-pass at the upsampled rate L * inputRate
+    const size_t length = taps_ * up_;
+    const double cutoff = CUTOFF * 0.5 / std::max(up_, down_);   // Cycles per upsampled sample
+    const double centre = 0.5 * static_cast<double>(length - 1);
+    const double windowNorm = besselI0(KAISER_BETA);
+    std::vector<double> prototype(length);
+    double sum = 0.0;
+    for (size_t n = 0; n < length; ++n) {
+        double t = static_cast<double>(n) - centre;
+        double sinc = t == 0.0 ? 1.0 : std::sin(2.0 * PI * cutoff * t) / (2.0 * PI * cutoff * t);
+        double r = t / (centre + 1.0);
+        double window = besselI0(KAISER_BETA * std::sqrt(std::max(0.0, 1.0 - r * r))) / windowNorm;
+        prototype[n] = sinc * window;
+        sum += prototype[n];
+    }
+
+    // Unity gain at DC for every phase on average; each phase stores its
+    // taps time-reversed so the dot product runs forward over the history
+    coefficients_.resize(length);
+    const double gain = static_cast<double>(up_) / sum;
+    for (size_t phase = 0; phase < up_; ++phase) {
+        float* row = coefficients_.data() + phase * taps_;
+        for (size_t k = 0; k < taps_; ++k) {
+            row[taps_ - 1 - k] = static_cast<float>(prototype[phase + k * up_] * gain);
+        }
+    }
+
+    history_.resize(taps_ - 1 + BLOCK_SAMPLES);
+    reset();
+
+    MICMAP_LOG_DEBUG("Created resampler ", inputRate_, " -> ", outputRate_, " Hz: ",
+                     up_, "/", down_, ", ", taps_, " taps per phase");
+}
+
+size_t Resampler::process(const float* input, size_t count, float* output) {
+    if (!input || count == 0) {
+        return 0;
+    }
+    if (taps_ == 0) {
+        std::memcpy(output, input, count * sizeof(float));
+        return count;
+    }
+
+    const size_t keep = taps_ - 1;
+    size_t produced = 0;
+    while (count > 0) {
+        size_t n = std::min(count, history_.size() - fill_);
+        std::memcpy(history_.data() + fill_, input, n * sizeof(float));
+        fill_ += n;
+        input += n;
+        count -= n;
+
+        // Every output whose newest input sample has arrived
+        for (uint64_t newest = position_ / up_; newest < fill_; newest = position_ / up_) {
+            const float* row = coefficients_.data() + (position_ % up_) * taps_;
+            output[produced++] = dot_(row, history_.data() + newest - keep, taps_);
+            position_ += down_;
+        }
+
+        size_t consumed = fill_ - keep;
+        std::memmove(history_.data(), history_.data() + consumed, keep * sizeof(float));
+        fill_ = keep;
+        position_ -= static_cast<uint64_t>(consumed) * up_;
+    }
+    return produced;
+}
+
+size_t Resampler::maxOutput(size_t count) const {
+    if (taps_ == 0) {
+        return count;
+    }
+    return static_cast<size_t>((static_cast<uint64_t>(count) * up_ + down_ - 1) / down_) + 1;
+}
+
+void Resampler::reset() {
+    if (taps_ == 0) {
+        return;
+    }
+
+    // Zero history before the first input; output lags by half the filter
+    std::fill(history_.begin(), history_.end(), 0.0f);
+    fill_ = taps_ - 1;
+    position_ = static_cast<uint64_t>(fill_) * up_;
+}
+
+} // namespace micmap::audio
@@ -0,0 +1,29 @@
+/**
+ * @file resampler_avx2.cpp
+ * @brief AVX2 resampler filter kernel
+ *
+ * Compiled with AVX2 enabled (see cmake/SimdFlags.cmake) and only called
+ * after runtime detection confirms CPU support.
+ */
+
+#include "resampler_kernels.hpp"
+
+#include <immintrin.h>
+
+namespace micmap::audio::detail {
+
+float resampleDotAVX2(const float* coefficients, const float* samples, size_t count) {
+    __m256 acc = _mm256_setzero_ps();
+    for (size_t i = 0; i < count; i += 8) {
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps(coefficients + i),
+                                               _mm256_loadu_ps(samples + i)));
+    }
+
+    // Same reduction order as the scalar kernel
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(1, 1, 1, 1)));
+    return _mm_cvtss_f32(sum);
+}
+
+} // namespace micmap::audio::detail
@@ -0,0 +1,38 @@
+#pragma once
+
+/**
+ * @file resampler_kernels.hpp
+ * @brief Internal declarations shared by the per-ISA resampler kernels
+ */
+
+#include "sample_convert_kernels.hpp"
+
+#include <cstddef>
+
+namespace micmap::audio::detail {
+
+/**
+ * @brief Dot product of count coefficients and samples; count is a multiple of 8
+ *
+ * Every kernel keeps eight running sums, lane i adding the products at
+ * i, i + 8, ..., and reduces them in the same order:
+ * ((s0 + s4) + (s2 + s6)) + ((s1 + s5) + (s3 + s7)). The SIMD kernels thus
+ * differ from the scalar one only where the compiler fuses multiply-adds.
+ */
+using ResampleDotKernel = float (*)(const float* coefficients, const float* samples, size_t count);
+
+float resampleDotScalar(const float* coefficients, const float* samples, size_t count);
+
+#if MICMAP_AUDIO_HAVE_SSE2
+float resampleDotSSE2(const float* coefficients, const float* samples, size_t count);
+#endif
+
+#ifdef MICMAP_HAVE_AVX2
+float resampleDotAVX2(const float* coefficients, const float* samples, size_t count);
+#endif
+
+#if MICMAP_AUDIO_HAVE_NEON
+float resampleDotNEON(const float* coefficients, const float* samples, size_t count);
+#endif
+
+} // namespace micmap::audio::detail
@@ -0,0 +1,29 @@
+/**
+ * @file resampler_neon.cpp
+ * @brief NEON resampler filter kernel (AArch64)
+ */
+
+#include "resampler_kernels.hpp"
+
+#if MICMAP_AUDIO_HAVE_NEON
+
+#include <arm_neon.h>
+
+namespace micmap::audio::detail {
+
+float resampleDotNEON(const float* coefficients, const float* samples, size_t count) {
+    float32x4_t lo = vdupq_n_f32(0.0f);
+    float32x4_t hi = vdupq_n_f32(0.0f);
+    for (size_t i = 0; i < count; i += 8) {
+        lo = vaddq_f32(lo, vmulq_f32(vld1q_f32(coefficients + i), vld1q_f32(samples + i)));
+        hi = vaddq_f32(hi, vmulq_f32(vld1q_f32(coefficients + i + 4), vld1q_f32(samples + i + 4)));
+    }
+
+    float32x4_t sum = vaddq_f32(lo, hi);
+    float32x2_t half = vadd_f32(vget_low_f32(sum), vget_high_f32(sum));
+    return vget_lane_f32(vpadd_f32(half, half), 0);
+}
+
+} // namespace micmap::audio::detail
+
+#endif // MICMAP_AUDIO_HAVE_NEON
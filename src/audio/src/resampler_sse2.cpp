@@ -0,0 +1,32 @@
+/**
+ * @file resampler_sse2.cpp
+ * @brief SSE2 resampler filter kernel (x86 baseline)
+ */
+
+#include "resampler_kernels.hpp"
+
+#if MICMAP_AUDIO_HAVE_SSE2
+
+#include <emmintrin.h>
+
+namespace micmap::audio::detail {
+
+float resampleDotSSE2(const float* coefficients, const float* samples, size_t count) {
+    __m128 lo = _mm_setzero_ps();
+    __m128 hi = _mm_setzero_ps();
+    for (size_t i = 0; i < count; i += 8) {
+        lo = _mm_add_ps(lo, _mm_mul_ps(_mm_loadu_ps(coefficients + i), _mm_loadu_ps(samples + i)));
+        hi = _mm_add_ps(hi, _mm_mul_ps(_mm_loadu_ps(coefficients + i + 4),
+                                       _mm_loadu_ps(samples + i + 4)));
+    }
+
+    // (s0 + s4, s1 + s5, s2 + s6, s3 + s7), then lanes 0 + 2 and 1 + 3
+    __m128 sum = _mm_add_ps(lo, hi);
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(1, 1, 1, 1)));
+    return _mm_cvtss_f32(sum);
+}
+
+} // namespace micmap::audio::detail
+
+#endif // MICMAP_AUDIO_HAVE_SSE2
@@ -0,0 +1,228 @@
+/**
+ * @file resampling_capture.cpp
+ * @brief IAudioCapture decorator that delivers a fixed sample rate
+ */
+
+#include "micmap/audio/resampler.hpp"
+#include "micmap/common/logger.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+
+namespace micmap::audio {
+
+namespace {
+
+// Device packets are resampled in blocks of at most this many samples, so
+// the output scratch is sized once per startCapture()
+constexpr size_t MAX_BLOCK_SAMPLES = 4096;
+
+class ResamplingCapture : public IAudioCapture {
+public:
+    ResamplingCapture(std::unique_ptr<IAudioCapture> capture, uint32_t outputRate)
+        : capture_(std::move(capture))
+        , outputRate_(outputRate)
+        , history_(outputRate) {
+        if (!capture_ || outputRate_ == 0) {
+            throw std::invalid_argument("Resampling capture needs a capture and a positive rate");
+        }
+        capture_->setAudioCallback([this](const float* samples, size_t count) {
+            onAudio(samples, count);
+        });
+        capture_->setMultiChannelCallback([this](const float* samples, size_t frames, uint16_t channels) {
+            onChannels(samples, frames, channels);
+        });
+    }
+
+    ~ResamplingCapture() override {
+        // The wrapped capture's thread calls into this object
+        capture_->stopCapture();
+        capture_->setAudioCallback(nullptr);
+        capture_->setMultiChannelCallback(nullptr);
+    }
+
+    std::vector<AudioDevice> enumerateDevices() override {
+        return capture_->enumerateDevices();
+    }
+
+    bool selectDevice(const std::wstring& namePattern) override {
+        return capture_->selectDevice(namePattern);
+    }
+
+    bool selectDeviceById(const std::wstring& deviceId) override {
+        return capture_->selectDeviceById(deviceId);
+    }
+
+    bool startCapture() override {
+        if (capture_->isCapturing()) {
+            return true;
+        }
+
+        uint32_t inputRate = capture_->getSampleRate();
+        if (inputRate == 0) {
+            MICMAP_LOG_ERROR("Resampling capture: no device sample rate");
+            return false;
+        }
+
+        try {
+            resampler_ = std::make_unique<Resampler>(inputRate, outputRate_);
+        } catch (const std::invalid_argument& e) {
+            MICMAP_LOG_ERROR("Resampling capture: ", e.what());
+            return false;
+        }
+        output_.assign(resampler_->maxOutput(MAX_BLOCK_SAMPLES), 0.0f);
+        history_.clear();
+        buildChannelResamplers(std::max<uint16_t>(capture_->getCurrentDevice().channels, 1));
+
+        if (inputRate != outputRate_) {
+            MICMAP_LOG_INFO("Resampling capture from ", inputRate, " Hz to ", outputRate_, " Hz");
+        }
+        return capture_->startCapture();
+    }
+
+    void stopCapture() override {
+        capture_->stopCapture();
+    }
+
+    bool isCapturing() const override {
+        return capture_->isCapturing();
+    }
+
+    bool getAudioBuffer(std::vector<float>& buffer) override {
+        size_t count = history_.available();
+        if (count == 0) {
+            return false;
+        }
+
+        buffer.resize(count);
+        buffer.resize(history_.read(buffer.data(), count));
+        return !buffer.empty();
+    }
+
+    AudioDevice getCurrentDevice() const override {
+        AudioDevice device = capture_->getCurrentDevice();
+        if (device.sampleRate > 0) {
+            device.sampleRate = outputRate_;
+        }
+        return device;
+    }
+
+    void setAudioCallback(AudioCallback callback) override {
+        std::lock_guard<std::mutex> lock(callbackMutex_);
+        audioCallback_ = std::move(callback);
+    }
+
+    void setMultiChannelCallback(MultiChannelCallback callback) override {
+        std::lock_guard<std::mutex> lock(callbackMutex_);
+        multiChannelCallback_ = std::move(callback);
+    }
+
+    uint32_t getSampleRate() const override {
+        return outputRate_;
+    }
+
+    uint16_t getChannels() const override {
+        return capture_->getChannels();
+    }
+
+private:
+    /**
+     * @brief Resample one device packet and deliver it (capture thread)
+     */
+    void onAudio(const float* samples, size_t count) {
+        while (count > 0) {
+            size_t n = std::min(count, MAX_BLOCK_SAMPLES);
+            deliver(output_.data(), resampler_->process(samples, n, output_.data()));
+            samples += n;
+            count -= n;
+        }
+    }
+
+    /**
+     * @brief Resample every channel of one device packet and deliver them (capture thread)
+     *
+     * The channels' resamplers advance in lockstep, so every block yields
+     * the same number of samples per channel.
+     */
+    void onChannels(const float* samples, size_t frames, uint16_t channels) {
+        {
+            std::lock_guard<std::mutex> lock(callbackMutex_);
+            if (!multiChannelCallback_) {
+                return;
+            }
+        }
+        if (channels != channelResamplers_.size()) {
+            MICMAP_LOG_WARNING("Resampling capture: device delivered ", channels,
+                               " channels, expected ", channelResamplers_.size());
+            buildChannelResamplers(channels);
+        }
+
+        for (size_t offset = 0; offset < frames; offset += MAX_BLOCK_SAMPLES) {
+            size_t n = std::min(frames - offset, MAX_BLOCK_SAMPLES);
+            size_t produced = 0;
+            for (uint16_t c = 0; c < channels; ++c) {
+                produced = channelResamplers_[c]->process(samples + c * frames + offset, n,
+                                                          channelOutput_.data() + c * produced);
+            }
+            if (produced > 0) {
+                std::lock_guard<std::mutex> lock(callbackMutex_);
+                if (multiChannelCallback_) {
+                    multiChannelCallback_(channelOutput_.data(), produced, channels);
+                }
+            }
+        }
+    }
+
+    void buildChannelResamplers(uint16_t channels) {
+        uint32_t inputRate = resampler_ ? resampler_->getInputRate() : outputRate_;
+        channelResamplers_.clear();
+        for (uint16_t c = 0; c < channels; ++c) {
+            channelResamplers_.push_back(std::make_unique<Resampler>(inputRate, outputRate_));
+        }
+        channelOutput_.assign(static_cast<size_t>(channels) * output_.size(), 0.0f);
+    }
+
+    void deliver(const float* samples, size_t count) {
+        if (count == 0) {
+            return;
+        }
+
+        size_t space = history_.space();
+        if (space < count) {
+            history_.discard(count - space);
+        }
+        history_.write(samples, count);
+
+        std::lock_guard<std::mutex> lock(callbackMutex_);
+        if (audioCallback_) {
+            audioCallback_(samples, count);
+        }
+    }
+
+    std::unique_ptr<IAudioCapture> capture_;
+    uint32_t outputRate_;
+
+    // Capture-thread state, rebuilt by startCapture()
+    std::unique_ptr<Resampler> resampler_;
+    std::vector<float> output_;
+    std::vector<std::unique_ptr<Resampler>> channelResamplers_;    // One per device channel
+    std::vector<float> channelOutput_;                              // Planar, output_.size() per channel
+
+    // Resampled history for getAudioBuffer(), one second long
+    AudioBuffer history_;
+
+    // Callbacks
+    AudioCallback audioCallback_;
+    MultiChannelCallback multiChannelCallback_;
+    std::mutex callbackMutex_;
+};
+
+} // anonymous namespace
+
+std::unique_ptr<IAudioCapture> createResamplingCapture(std::unique_ptr<IAudioCapture> capture,
+                                                       uint32_t outputRate) {
+    return std::make_unique<ResamplingCapture>(std::move(capture), outputRate);
+}
+
+} // namespace micmap::audio
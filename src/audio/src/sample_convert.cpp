@@ -0,0 +1,216 @@
+/**
+ * @file sample_convert.cpp
+ * @brief Scalar reference conversion and runtime kernel dispatch
+ */
+
+#include "micmap/audio/sample_convert.hpp"
+#include "sample_convert_kernels.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace micmap::audio {
+
+using common::SimdLevel;
+
+namespace detail {
+
+void convertToMonoScalar(SampleFormat format, const uint8_t* data, size_t frames,
+                         uint16_t channels, float* output) {
+    const float divisor = static_cast<float>(channels);
+
+    switch (format) {
+        case SampleFormat::Float32: {
+            const auto* samples = reinterpret_cast<const float*>(data);
+            for (size_t i = 0; i < frames; ++i) {
+                float sum = 0.0f;
+                for (uint16_t ch = 0; ch < channels; ++ch) {
+                    sum += samples[i * channels + ch];
+                }
+                output[i] = sum / divisor;
+            }
+            break;
+        }
+        case SampleFormat::Int16: {
+            const auto* samples = reinterpret_cast<const int16_t*>(data);
+            for (size_t i = 0; i < frames; ++i) {
+                float sum = 0.0f;
+                for (uint16_t ch = 0; ch < channels; ++ch) {
+                    sum += int16ToFloat(samples[i * channels + ch]);
+                }
+                output[i] = sum / divisor;
+            }
+            break;
+        }
+        case SampleFormat::Int24: {
+            const size_t bytes = 3;
+            for (size_t i = 0; i < frames; ++i) {
+                float sum = 0.0f;
+                for (uint16_t ch = 0; ch < channels; ++ch) {
+                    sum += int24ToFloat(data + (i * channels + ch) * bytes);
+                }
+                output[i] = sum / divisor;
+            }
+            break;
+        }
+        case SampleFormat::Int32: {
+            const auto* samples = reinterpret_cast<const int32_t*>(data);
+            for (size_t i = 0; i < frames; ++i) {
+                float sum = 0.0f;
+                for (uint16_t ch = 0; ch < channels; ++ch) {
+                    sum += int32ToFloat(samples[i * channels + ch]);
+                }
+                output[i] = sum / divisor;
+            }
+            break;
+        }
+        default:
+            std::fill(output, output + frames, 0.0f);
+            break;
+    }
+}
+
+SimdLevel resolveSimdLevel(SimdLevel requested) {
+#ifdef MICMAP_HAVE_AVX2
+    if (requested == SimdLevel::AVX2 && common::isSimdLevelSupported(SimdLevel::AVX2)) {
+        return SimdLevel::AVX2;
+    }
+#endif
+#if MICMAP_AUDIO_HAVE_SSE2
+    if ((requested == SimdLevel::AVX2 || requested == SimdLevel::SSE2) &&
+        common::isSimdLevelSupported(SimdLevel::SSE2)) {
+        return SimdLevel::SSE2;
+    }
+#endif
+#if MICMAP_AUDIO_HAVE_NEON
+    if (requested == SimdLevel::NEON && common::isSimdLevelSupported(SimdLevel::NEON)) {
+        return SimdLevel::NEON;
+    }
+#endif
+    return SimdLevel::Scalar;
+}
+
+} // namespace detail
+
+namespace {
+
+/**
+ * @brief Scatter one channel of interleaved samples, converted by decode
+ */
+template <typename Decode>
+void deinterleaveWith(const uint8_t* data, size_t frames, uint16_t channels,
+                      size_t bytes, float* output, Decode decode) {
+    const size_t frameBytes = bytes * channels;
+    for (uint16_t ch = 0; ch < channels; ++ch) {
+        float* planar = output + static_cast<size_t>(ch) * frames;
+        const uint8_t* sample = data + ch * bytes;
+        for (size_t i = 0; i < frames; ++i, sample += frameBytes) {
+            planar[i] = decode(sample);
+        }
+    }
+}
+
+detail::ConvertKernel kernelFor(SimdLevel level) {
+    switch (level) {
+#ifdef MICMAP_HAVE_AVX2
+        case SimdLevel::AVX2: return detail::convertToMonoAVX2;
+#endif
+#if MICMAP_AUDIO_HAVE_SSE2
+        case SimdLevel::SSE2: return detail::convertToMonoSSE2;
+#endif
+#if MICMAP_AUDIO_HAVE_NEON
+        case SimdLevel::NEON: return detail::convertToMonoNEON;
+#endif
+        default: return detail::convertToMonoScalar;
+    }
+}
+
+void convertWith(detail::ConvertKernel kernel, SampleFormat format, const void* data,
+                 size_t frames, uint16_t channels, float* output) {
+    if (!data || !output || frames == 0) {
+        return;
+    }
+
+    if (channels == 0) {
+        std::fill(output, output + frames, 0.0f);
+        return;
+    }
+
+    if (channels > detail::MAX_SIMD_CHANNELS) {
+        kernel = detail::convertToMonoScalar;
+    }
+
+    kernel(format, static_cast<const uint8_t*>(data), frames, channels, output);
+}
+
+} // anonymous namespace
+
+size_t bytesPerSample(SampleFormat format) {
+    switch (format) {
+        case SampleFormat::Float32: return 4;
+        case SampleFormat::Int16: return 2;
+        case SampleFormat::Int24: return 3;
+        case SampleFormat::Int32: return 4;
+        default: return 0;
+    }
+}
+
+void deinterleave(SampleFormat format, const void* data, size_t frames,
+                  uint16_t channels, float* output) {
+    if (!data || !output || frames == 0 || channels == 0) {
+        return;
+    }
+
+    // Memory bound: each channel is a strided walk over the packet, which
+    // stays in cache at capture packet sizes
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    switch (format) {
+        case SampleFormat::Float32:
+            deinterleaveWith(bytes, frames, channels, 4, output, [](const uint8_t* p) {
+                float value;
+                std::memcpy(&value, p, sizeof(value));
+                return value;
+            });
+            break;
+        case SampleFormat::Int16:
+            deinterleaveWith(bytes, frames, channels, 2, output, [](const uint8_t* p) {
+                int16_t value;
+                std::memcpy(&value, p, sizeof(value));
+                return detail::int16ToFloat(value);
+            });
+            break;
+        case SampleFormat::Int24:
+            deinterleaveWith(bytes, frames, channels, 3, output, [](const uint8_t* p) {
+                return detail::int24ToFloat(p);
+            });
+            break;
+        case SampleFormat::Int32:
+            deinterleaveWith(bytes, frames, channels, 4, output, [](const uint8_t* p) {
+                int32_t value;
+                std::memcpy(&value, p, sizeof(value));
+                return detail::int32ToFloat(value);
+            });
+            break;
+        default:
+            std::fill(output, output + frames * channels, 0.0f);
+            break;
+    }
+}
+
+common::SimdLevel getConversionSimdLevel() {
+    static const SimdLevel level = detail::resolveSimdLevel(common::detectSimdLevel());
+    return level;
+}
+
+void convertToMono(SampleFormat format, const void* data, size_t frames,
+                   uint16_t channels, float* output) {
+    static const detail::ConvertKernel kernel = kernelFor(getConversionSimdLevel());
+    convertWith(kernel, format, data, frames, channels, output);
+}
+
+void convertToMono(SampleFormat format, const void* data, size_t frames,
+                   uint16_t channels, float* output, common::SimdLevel level) {
+    convertWith(kernelFor(detail::resolveSimdLevel(level)), format, data, frames, channels, output);
+}
+
+} // namespace micmap::audio
@@ -0,0 +1,153 @@
+/**
+ * @file sample_convert_avx2.cpp
+ * @brief AVX2 conversion kernels
+ *
+ * Compiled with AVX2 enabled (see cmake/SimdFlags.cmake) and only called
+ * after runtime detection confirms CPU support.
+ */
+
+#include "sample_convert_kernels.hpp"
+
+#include <immintrin.h>
+
+namespace micmap::audio::detail {
+
+namespace {
+
+void toFloatAVX2(SampleFormat format, const uint8_t* input, size_t count, float* output) {
+    size_t i = 0;
+
+    switch (format) {
+        case SampleFormat::Int16: {
+            const auto* samples = reinterpret_cast<const int16_t*>(input);
+            const __m256 scale = _mm256_set1_ps(1.0f / 32768.0f);
+            for (; i + 8 <= count; i += 8) {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(samples + i));
+                __m256i wide = _mm256_cvtepi16_epi32(v);
+                _mm256_storeu_ps(output + i, _mm256_mul_ps(_mm256_cvtepi32_ps(wide), scale));
+            }
+            break;
+        }
+        case SampleFormat::Int24: {
+            // Move each 3-byte sample into the top of a 32-bit lane, then an
+            // arithmetic shift sign-extends it. Each 16-byte load covers 4
+            // samples (12 bytes), so stop while a full load is still in bounds.
+            const __m256i shuffle = _mm256_setr_epi8(
+                -1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11,
+                -1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+            const __m256 scale = _mm256_set1_ps(1.0f / 8388608.0f);
+            for (; i + 10 <= count; i += 8) {
+                const uint8_t* bytes = input + i * 3;
+                __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes));
+                __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + 12));
+                __m256i packed = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+                __m256i wide = _mm256_srai_epi32(_mm256_shuffle_epi8(packed, shuffle), 8);
+                _mm256_storeu_ps(output + i, _mm256_mul_ps(_mm256_cvtepi32_ps(wide), scale));
+            }
+            break;
+        }
+        case SampleFormat::Int32: {
+            const auto* samples = reinterpret_cast<const int32_t*>(input);
+            const __m256 scale = _mm256_set1_ps(1.0f / 2147483648.0f);
+            for (; i + 8 <= count; i += 8) {
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(samples + i));
+                _mm256_storeu_ps(output + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale));
+            }
+            break;
+        }
+        default:
+            break;
+    }
+
+    toFloatScalar(format, input, i, count, output);
+}
+
+void downmixAVX2(const float* input, size_t frames, uint16_t channels, float* output) {
+    const __m256 zero = _mm256_setzero_ps();
+    size_t i = 0;
+
+    switch (channels) {
+        case 1:
+            for (; i + 8 <= frames; i += 8) {
+                _mm256_storeu_ps(output + i, _mm256_add_ps(zero, _mm256_loadu_ps(input + i)));
+            }
+            break;
+
+        case 2: {
+            const __m256 half = _mm256_set1_ps(0.5f);
+            for (; i + 8 <= frames; i += 8) {
+                __m256 a = _mm256_loadu_ps(input + i * 2);
+                __m256 b = _mm256_loadu_ps(input + i * 2 + 8);
+                // In-lane deinterleave yields frames in order 0 1 4 5 | 2 3 6 7
+                __m256 left = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+                __m256 right = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+                __m256 mono = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(zero, left), right), half);
+                mono = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(mono),
+                                                              _MM_SHUFFLE(3, 1, 2, 0)));
+                _mm256_storeu_ps(output + i, mono);
+            }
+            break;
+        }
+
+        case 4: {
+            const __m256 quarter = _mm256_set1_ps(0.25f);
+            for (; i + 8 <= frames; i += 8) {
+                // Lane 0 holds frames 0-3 and lane 1 frames 4-7, so the
+                // per-lane 4x4 transpose leaves the output in frame order
+                const float* f = input + i * 4;
+                __m256 r0 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(f)),
+                                                 _mm_loadu_ps(f + 16), 1);
+                __m256 r1 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(f + 4)),
+                                                 _mm_loadu_ps(f + 20), 1);
+                __m256 r2 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(f + 8)),
+                                                 _mm_loadu_ps(f + 24), 1);
+                __m256 r3 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(f + 12)),
+                                                 _mm_loadu_ps(f + 28), 1);
+                __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+                __m256 t1 = _mm256_unpackhi_ps(r0, r1);
+                __m256 t2 = _mm256_unpacklo_ps(r2, r3);
+                __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+                __m256 c0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+                __m256 c1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+                __m256 c2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+                __m256 c3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+                __m256 sum = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(
+                    _mm256_add_ps(zero, c0), c1), c2), c3);
+                _mm256_storeu_ps(output + i, _mm256_mul_ps(sum, quarter));
+            }
+            break;
+        }
+
+        default: {
+            const bool pow2 = isPowerOfTwo(channels);
+            const __m256 divisor = _mm256_set1_ps(static_cast<float>(channels));
+            const __m256 reciprocal = _mm256_set1_ps(1.0f / static_cast<float>(channels));
+            const int stride = channels;
+            const __m256i offsets = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+                                                       _mm256_set1_epi32(stride));
+            for (; i + 8 <= frames; i += 8) {
+                const float* frame = input + i * static_cast<size_t>(stride);
+                __m256 sum = zero;
+                for (int ch = 0; ch < stride; ++ch) {
+                    sum = _mm256_add_ps(sum, _mm256_i32gather_ps(frame + ch, offsets, 4));
+                }
+                _mm256_storeu_ps(output + i, pow2 ? _mm256_mul_ps(sum, reciprocal)
+                                                  : _mm256_div_ps(sum, divisor));
+            }
+            break;
+        }
+    }
+
+    downmixFramesScalar(input, i, frames, channels, output);
+}
+
+} // anonymous namespace
+
+void convertToMonoAVX2(SampleFormat format, const uint8_t* data, size_t frames,
+                       uint16_t channels, float* output) {
+    convertInBlocks(format, data, frames, channels, output,
+        [](SampleFormat f, const uint8_t* in, size_t n, float* out) { toFloatAVX2(f, in, n, out); },
+        [](const float* in, size_t n, uint16_t c, float* out) { downmixAVX2(in, n, c, out); });
+}
+
+} // namespace micmap::audio::detail
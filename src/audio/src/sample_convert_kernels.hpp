@@ -0,0 +1,188 @@
+#pragma once
+
+/**
+ * @file sample_convert_kernels.hpp
+ * @brief Internal declarations shared by the per-ISA conversion kernels
+ *
+ * Everything defined (not just declared) here has internal linkage: the
+ * header is included by translation units compiled with different
+ * instruction set flags, and a shared inline definition could otherwise be
+ * resolved to a copy containing instructions the CPU does not support.
+ */
+
+#include "micmap/audio/sample_convert.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MICMAP_AUDIO_HAVE_SSE2 1
+#else
+#define MICMAP_AUDIO_HAVE_SSE2 0
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define MICMAP_AUDIO_HAVE_NEON 1
+#else
+#define MICMAP_AUDIO_HAVE_NEON 0
+#endif
+
+namespace micmap::audio::detail {
+
+/**
+ * @brief Signature shared by all conversion kernels
+ */
+using ConvertKernel = void (*)(SampleFormat format, const uint8_t* data, size_t frames,
+                               uint16_t channels, float* output);
+
+/// Integer input is converted to float in blocks of this many samples
+constexpr size_t CONVERT_BLOCK_SAMPLES = 1024;
+
+/// SIMD kernels handle at most this many channels; wider layouts use the reference
+constexpr uint16_t MAX_SIMD_CHANNELS = 256;
+
+/**
+ * @brief Clamp a requested level to what is both compiled in and supported
+ */
+common::SimdLevel resolveSimdLevel(common::SimdLevel requested);
+
+void convertToMonoScalar(SampleFormat format, const uint8_t* data, size_t frames,
+                         uint16_t channels, float* output);
+
+#if MICMAP_AUDIO_HAVE_SSE2
+void convertToMonoSSE2(SampleFormat format, const uint8_t* data, size_t frames,
+                       uint16_t channels, float* output);
+#endif
+
+#ifdef MICMAP_HAVE_AVX2
+void convertToMonoAVX2(SampleFormat format, const uint8_t* data, size_t frames,
+                       uint16_t channels, float* output);
+#endif
+
+#if MICMAP_AUDIO_HAVE_NEON
+void convertToMonoNEON(SampleFormat format, const uint8_t* data, size_t frames,
+                       uint16_t channels, float* output);
+#endif
+
+namespace {
+
+/**
+ * @brief Convert 16-bit PCM sample to float
+ */
+inline float int16ToFloat(int16_t sample) {
+    return static_cast<float>(sample) / 32768.0f;
+}
+
+/**
+ * @brief Convert 24-bit PCM sample (stored in 3 bytes) to float
+ */
+inline float int24ToFloat(const uint8_t* bytes) {
+    // 24-bit samples are stored as 3 bytes, little-endian
+    int32_t sample = static_cast<int32_t>(bytes[0]) |
+                     (static_cast<int32_t>(bytes[1]) << 8) |
+                     (static_cast<int32_t>(bytes[2]) << 16);
+    // Sign extend from 24 bits to 32 bits
+    if (sample & 0x800000) {
+        sample |= static_cast<int32_t>(0xFF000000);
+    }
+    return static_cast<float>(sample) / 8388608.0f;  // 2^23
+}
+
+/**
+ * @brief Convert 32-bit PCM sample to float
+ */
+inline float int32ToFloat(int32_t sample) {
+    return static_cast<float>(sample) / 2147483648.0f;  // 2^31
+}
+
+/**
+ * @brief Check whether a channel count is a power of two
+ *
+ * Averaging over a power-of-two channel count may multiply by the
+ * reciprocal instead of dividing: both round the same exact quotient, so
+ * the result stays bit-identical to the reference.
+ */
+inline bool isPowerOfTwo(uint16_t value) {
+    return value != 0 && (value & (value - 1)) == 0;
+}
+
+/**
+ * @brief Scalar downmix of interleaved float frames [begin, end)
+ *
+ * Matches the reference exactly: the sum starts at 0.0f and adds channels
+ * in order before dividing by the channel count.
+ */
+inline void downmixFramesScalar(const float* input, size_t begin, size_t end,
+                                uint16_t channels, float* output) {
+    const float divisor = static_cast<float>(channels);
+    for (size_t i = begin; i < end; ++i) {
+        float sum = 0.0f;
+        for (uint16_t ch = 0; ch < channels; ++ch) {
+            sum += input[i * channels + ch];
+        }
+        output[i] = sum / divisor;
+    }
+}
+
+/**
+ * @brief Scalar integer-to-float conversion of samples [begin, end)
+ */
+inline void toFloatScalar(SampleFormat format, const uint8_t* input, size_t begin, size_t end,
+                          float* output) {
+    switch (format) {
+        case SampleFormat::Int16: {
+            const auto* samples = reinterpret_cast<const int16_t*>(input);
+            for (size_t i = begin; i < end; ++i) {
+                output[i] = int16ToFloat(samples[i]);
+            }
+            break;
+        }
+        case SampleFormat::Int24:
+            for (size_t i = begin; i < end; ++i) {
+                output[i] = int24ToFloat(input + i * 3);
+            }
+            break;
+        case SampleFormat::Int32: {
+            const auto* samples = reinterpret_cast<const int32_t*>(input);
+            for (size_t i = begin; i < end; ++i) {
+                output[i] = int32ToFloat(samples[i]);
+            }
+            break;
+        }
+        default:
+            std::fill(output + begin, output + end, 0.0f);
+            break;
+    }
+}
+
+/**
+ * @brief Drive a (toFloat, downmix) kernel pair over a whole buffer
+ *
+ * Float input is downmixed in place; integer input is first converted to
+ * float in cache-sized blocks so each ISA only needs one downmix kernel.
+ */
+template <typename ToFloat, typename Downmix>
+inline void convertInBlocks(SampleFormat format, const uint8_t* data, size_t frames,
+                            uint16_t channels, float* output,
+                            ToFloat toFloat, Downmix downmix) {
+    if (format == SampleFormat::Float32) {
+        downmix(reinterpret_cast<const float*>(data), frames, channels, output);
+        return;
+    }
+
+    alignas(32) float block[CONVERT_BLOCK_SAMPLES];
+    const size_t framesPerBlock = CONVERT_BLOCK_SAMPLES / channels;
+    const size_t frameBytes = bytesPerSample(format) * channels;
+
+    for (size_t done = 0; done < frames; ) {
+        size_t count = std::min(framesPerBlock, frames - done);
+        toFloat(format, data + done * frameBytes, count * channels, block);
+        downmix(block, count, channels, output + done);
+        done += count;
+    }
+}
+
+} // anonymous namespace
+
+} // namespace micmap::audio::detail
@@ -0,0 +1,113 @@
+/**
+ * @file sample_convert_neon.cpp
+ * @brief NEON conversion kernels (AArch64)
+ */
+
+#include "sample_convert_kernels.hpp"
+
+#if MICMAP_AUDIO_HAVE_NEON
+
+#include <arm_neon.h>
+
+namespace micmap::audio::detail {
+
+namespace {
+
+void toFloatNEON(SampleFormat format, const uint8_t* input, size_t count, float* output) {
+    size_t i = 0;
+
+    switch (format) {
+        case SampleFormat::Int16: {
+            const auto* samples = reinterpret_cast<const int16_t*>(input);
+            const float32x4_t scale = vdupq_n_f32(1.0f / 32768.0f);
+            for (; i + 8 <= count; i += 8) {
+                int16x8_t v = vld1q_s16(samples + i);
+                int32x4_t lo = vmovl_s16(vget_low_s16(v));
+                int32x4_t hi = vmovl_s16(vget_high_s16(v));
+                vst1q_f32(output + i, vmulq_f32(vcvtq_f32_s32(lo), scale));
+                vst1q_f32(output + i + 4, vmulq_f32(vcvtq_f32_s32(hi), scale));
+            }
+            break;
+        }
+        case SampleFormat::Int32: {
+            const auto* samples = reinterpret_cast<const int32_t*>(input);
+            const float32x4_t scale = vdupq_n_f32(1.0f / 2147483648.0f);
+            for (; i + 4 <= count; i += 4) {
+                vst1q_f32(output + i, vmulq_f32(vcvtq_f32_s32(vld1q_s32(samples + i)), scale));
+            }
+            break;
+        }
+        default:
+            break;
+    }
+
+    toFloatScalar(format, input, i, count, output);
+}
+
+void downmixNEON(const float* input, size_t frames, uint16_t channels, float* output) {
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    size_t i = 0;
+
+    switch (channels) {
+        case 1:
+            for (; i + 4 <= frames; i += 4) {
+                vst1q_f32(output + i, vaddq_f32(zero, vld1q_f32(input + i)));
+            }
+            break;
+
+        case 2: {
+            const float32x4_t half = vdupq_n_f32(0.5f);
+            for (; i + 4 <= frames; i += 4) {
+                float32x4x2_t lr = vld2q_f32(input + i * 2);
+                float32x4_t sum = vaddq_f32(vaddq_f32(zero, lr.val[0]), lr.val[1]);
+                vst1q_f32(output + i, vmulq_f32(sum, half));
+            }
+            break;
+        }
+
+        case 4: {
+            const float32x4_t quarter = vdupq_n_f32(0.25f);
+            for (; i + 4 <= frames; i += 4) {
+                float32x4x4_t c = vld4q_f32(input + i * 4);
+                float32x4_t sum = vaddq_f32(vaddq_f32(vaddq_f32(
+                    vaddq_f32(zero, c.val[0]), c.val[1]), c.val[2]), c.val[3]);
+                vst1q_f32(output + i, vmulq_f32(sum, quarter));
+            }
+            break;
+        }
+
+        default: {
+            const bool pow2 = isPowerOfTwo(channels);
+            const float32x4_t divisor = vdupq_n_f32(static_cast<float>(channels));
+            const float32x4_t reciprocal = vdupq_n_f32(1.0f / static_cast<float>(channels));
+            const size_t stride = channels;
+            for (; i + 4 <= frames; i += 4) {
+                const float* frame = input + i * stride;
+                float32x4_t sum = zero;
+                for (size_t ch = 0; ch < stride; ++ch) {
+                    float lanes[4] = {frame[ch], frame[stride + ch],
+                                      frame[2 * stride + ch], frame[3 * stride + ch]};
+                    sum = vaddq_f32(sum, vld1q_f32(lanes));
+                }
+                vst1q_f32(output + i, pow2 ? vmulq_f32(sum, reciprocal)
+                                           : vdivq_f32(sum, divisor));
+            }
+            break;
+        }
+    }
+
+    downmixFramesScalar(input, i, frames, channels, output);
+}
+
+} // anonymous namespace
+
+void convertToMonoNEON(SampleFormat format, const uint8_t* data, size_t frames,
+                       uint16_t channels, float* output) {
+    convertInBlocks(format, data, frames, channels, output,
+        [](SampleFormat f, const uint8_t* in, size_t n, float* out) { toFloatNEON(f, in, n, out); },
+        [](const float* in, size_t n, uint16_t c, float* out) { downmixNEON(in, n, c, out); });
+}
+
+} // namespace micmap::audio::detail
+
+#endif // MICMAP_AUDIO_HAVE_NEON
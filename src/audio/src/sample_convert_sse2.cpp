@@ -0,0 +1,123 @@
+/**
+ * @file sample_convert_sse2.cpp
+ * @brief SSE2 conversion kernels (x86 baseline)
+ */
+
+#include "sample_convert_kernels.hpp"
+
+#if MICMAP_AUDIO_HAVE_SSE2
+
+#include <emmintrin.h>
+
+namespace micmap::audio::detail {
+
+namespace {
+
+void toFloatSSE2(SampleFormat format, const uint8_t* input, size_t count, float* output) {
+    size_t i = 0;
+
+    switch (format) {
+        case SampleFormat::Int16: {
+            const auto* samples = reinterpret_cast<const int16_t*>(input);
+            const __m128 scale = _mm_set1_ps(1.0f / 32768.0f);
+            for (; i + 8 <= count; i += 8) {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(samples + i));
+                // Sign-extend by placing each sample in the high half and shifting back
+                __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+                __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+                _mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+                _mm_storeu_ps(output + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+            }
+            break;
+        }
+        case SampleFormat::Int32: {
+            const auto* samples = reinterpret_cast<const int32_t*>(input);
+            const __m128 scale = _mm_set1_ps(1.0f / 2147483648.0f);
+            for (; i + 4 <= count; i += 4) {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(samples + i));
+                _mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(v), scale));
+            }
+            break;
+        }
+        default:
+            // 24-bit unpacking needs byte shuffles (SSSE3); use the scalar path
+            break;
+    }
+
+    toFloatScalar(format, input, i, count, output);
+}
+
+void downmixSSE2(const float* input, size_t frames, uint16_t channels, float* output) {
+    const __m128 zero = _mm_setzero_ps();
+    size_t i = 0;
+
+    switch (channels) {
+        case 1:
+            for (; i + 4 <= frames; i += 4) {
+                _mm_storeu_ps(output + i, _mm_add_ps(zero, _mm_loadu_ps(input + i)));
+            }
+            break;
+
+        case 2: {
+            const __m128 half = _mm_set1_ps(0.5f);
+            for (; i + 4 <= frames; i += 4) {
+                __m128 a = _mm_loadu_ps(input + i * 2);
+                __m128 b = _mm_loadu_ps(input + i * 2 + 4);
+                __m128 left = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+                __m128 right = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+                __m128 sum = _mm_add_ps(_mm_add_ps(zero, left), right);
+                _mm_storeu_ps(output + i, _mm_mul_ps(sum, half));
+            }
+            break;
+        }
+
+        case 4: {
+            const __m128 quarter = _mm_set1_ps(0.25f);
+            for (; i + 4 <= frames; i += 4) {
+                __m128 c0 = _mm_loadu_ps(input + i * 4);
+                __m128 c1 = _mm_loadu_ps(input + i * 4 + 4);
+                __m128 c2 = _mm_loadu_ps(input + i * 4 + 8);
+                __m128 c3 = _mm_loadu_ps(input + i * 4 + 12);
+                _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+                __m128 sum = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_add_ps(zero, c0), c1), c2), c3);
+                _mm_storeu_ps(output + i, _mm_mul_ps(sum, quarter));
+            }
+            break;
+        }
+
+        default: {
+            // Vectorize across frames, gathering one channel at a time
+            const bool pow2 = isPowerOfTwo(channels);
+            const __m128 divisor = _mm_set1_ps(static_cast<float>(channels));
+            const __m128 reciprocal = _mm_set1_ps(1.0f / static_cast<float>(channels));
+            const size_t stride = channels;
+            for (; i + 4 <= frames; i += 4) {
+                const float* frame = input + i * stride;
+                __m128 sum = zero;
+                for (size_t ch = 0; ch < stride; ++ch) {
+                    sum = _mm_add_ps(sum, _mm_setr_ps(frame[ch], frame[stride + ch],
+                                                      frame[2 * stride + ch],
+                                                      frame[3 * stride + ch]));
+                }
+                _mm_storeu_ps(output + i, pow2 ? _mm_mul_ps(sum, reciprocal)
+                                               : _mm_div_ps(sum, divisor));
+            }
+            break;
+        }
+    }
+
+    downmixFramesScalar(input, i, frames, channels, output);
+}
+
+} // anonymous namespace
+
+void convertToMonoSSE2(SampleFormat format, const uint8_t* data, size_t frames,
+                       uint16_t channels, float* output) {
+    convertInBlocks(format, data, frames, channels, output,
+        [](SampleFormat f, const uint8_t* in, size_t n, float* out) { toFloatSSE2(f, in, n, out); },
+        [](const float* in, size_t n, uint16_t c, float* out) { downmixSSE2(in, n, c, out); });
+}
+
+} // namespace micmap::audio::detail
+
+#endif // MICMAP_AUDIO_HAVE_SSE2
@@ -0,0 +1,205 @@
+/**
+ * @file wav_reader.cpp
+ * @brief RIFF/WAVE reader implementation
+ */
+
+#include "micmap/audio/wav_reader.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace micmap::audio {
+
+namespace {
+
+constexpr uint16_t WAV_FORMAT_PCM = 0x0001;
+constexpr uint16_t WAV_FORMAT_IEEE_FLOAT = 0x0003;
+constexpr uint16_t WAV_FORMAT_EXTENSIBLE = 0xFFFE;
+
+uint16_t readLE16(const uint8_t* bytes) {
+    return static_cast<uint16_t>(bytes[0] | (bytes[1] << 8));
+}
+
+uint32_t readLE32(const uint8_t* bytes) {
+    return static_cast<uint32_t>(bytes[0]) |
+           (static_cast<uint32_t>(bytes[1]) << 8) |
+           (static_cast<uint32_t>(bytes[2]) << 16) |
+           (static_cast<uint32_t>(bytes[3]) << 24);
+}
+
+/**
+ * @brief Map a WAV format tag and container size to a sample format
+ */
+SampleFormat toSampleFormat(uint16_t formatTag, uint16_t bitsPerSample) {
+    if (formatTag == WAV_FORMAT_IEEE_FLOAT) {
+        return bitsPerSample == 32 ? SampleFormat::Float32 : SampleFormat::Unknown;
+    }
+
+    if (formatTag == WAV_FORMAT_PCM) {
+        switch (bitsPerSample) {
+            case 16: return SampleFormat::Int16;
+            case 24: return SampleFormat::Int24;
+            case 32: return SampleFormat::Int32;
+            default: return SampleFormat::Unknown;
+        }
+    }
+
+    return SampleFormat::Unknown;
+}
+
+} // anonymous namespace
+
+bool WavReader::open(const std::string& path) {
+    close();
+
+    file_.open(path, std::ios::binary);
+    if (!file_) {
+        return fail("Cannot open file: " + path);
+    }
+
+    uint8_t riff[12];
+    if (!file_.read(reinterpret_cast<char*>(riff), sizeof(riff)) ||
+        std::memcmp(riff, "RIFF", 4) != 0 || std::memcmp(riff + 8, "WAVE", 4) != 0) {
+        return fail("Not a RIFF/WAVE file: " + path);
+    }
+
+    bool haveFormat = false;
+    uint16_t blockAlign = 0;
+
+    // Walk the chunk list until the data chunk; fmt must precede it
+    uint8_t chunkHeader[8];
+    while (file_.read(reinterpret_cast<char*>(chunkHeader), sizeof(chunkHeader))) {
+        uint32_t chunkSize = readLE32(chunkHeader + 4);
+
+        if (std::memcmp(chunkHeader, "fmt ", 4) == 0) {
+            if (chunkSize < 16) {
+                return fail("Truncated fmt chunk");
+            }
+
+            std::vector<uint8_t> fmt(chunkSize);
+            if (!file_.read(reinterpret_cast<char*>(fmt.data()), chunkSize)) {
+                return fail("Truncated fmt chunk");
+            }
+
+            uint16_t formatTag = readLE16(fmt.data());
+            info_.channels = readLE16(fmt.data() + 2);
+            info_.sampleRate = readLE32(fmt.data() + 4);
+            blockAlign = readLE16(fmt.data() + 12);
+            info_.bitsPerSample = readLE16(fmt.data() + 14);
+
+            if (formatTag == WAV_FORMAT_EXTENSIBLE) {
+                if (chunkSize < 40) {
+                    return fail("Truncated WAVE_FORMAT_EXTENSIBLE header");
+                }
+                // The sub-format GUID starts with the plain format tag
+                formatTag = readLE16(fmt.data() + 24);
+            }
+
+            info_.format = toSampleFormat(formatTag, info_.bitsPerSample);
+            if (info_.format == SampleFormat::Unknown) {
+                return fail("Unsupported WAV sample format (tag " + std::to_string(formatTag) +
+                            ", " + std::to_string(info_.bitsPerSample) + " bits)");
+            }
+            if (info_.channels == 0 || info_.sampleRate == 0 ||
+                blockAlign != info_.channels * bytesPerSample(info_.format)) {
+                return fail("Invalid WAV format header");
+            }
+            haveFormat = true;
+        } else if (std::memcmp(chunkHeader, "data", 4) == 0) {
+            if (!haveFormat) {
+                return fail("data chunk before fmt chunk");
+            }
+            dataOffset_ = static_cast<uint64_t>(file_.tellg());
+            info_.totalFrames = chunkSize / blockAlign;
+            position_ = 0;
+            return true;
+        } else {
+            // Skip unknown chunks (LIST, fact, ...); chunks are word-aligned
+            file_.seekg(static_cast<std::streamoff>(chunkSize + (chunkSize & 1)), std::ios::cur);
+        }
+    }
+
+    return fail("No data chunk found");
+}
+
+void WavReader::close() {
+    if (file_.is_open()) {
+        file_.close();
+    }
+    file_.clear();
+    info_ = WavInfo{};
+    dataOffset_ = 0;
+    position_ = 0;
+}
+
+bool WavReader::isOpen() const {
+    return file_.is_open() && dataOffset_ != 0;
+}
+
+const WavInfo& WavReader::getInfo() const {
+    return info_;
+}
+
+size_t WavReader::readMono(float* output, size_t frames) {
+    if (!output) {
+        return 0;
+    }
+    return readFrames(output, nullptr, frames);
+}
+
+size_t WavReader::readFrames(float* mono, float* planar, size_t frames) {
+    if (!isOpen() || (!mono && !planar)) {
+        return 0;
+    }
+
+    uint64_t remaining = info_.totalFrames - position_;
+    size_t toRead = static_cast<size_t>(std::min<uint64_t>(frames, remaining));
+    if (toRead == 0) {
+        return 0;
+    }
+
+    const size_t frameBytes = bytesPerSample(info_.format) * info_.channels;
+    if (raw_.size() < toRead * frameBytes) {
+        raw_.resize(toRead * frameBytes);
+    }
+
+    file_.read(reinterpret_cast<char*>(raw_.data()),
+               static_cast<std::streamsize>(toRead * frameBytes));
+    size_t framesRead = static_cast<size_t>(file_.gcount()) / frameBytes;
+
+    if (mono) {
+        convertToMono(info_.format, raw_.data(), framesRead, info_.channels, mono);
+    }
+    if (planar) {
+        deinterleave(info_.format, raw_.data(), framesRead, info_.channels, planar);
+    }
+    position_ += framesRead;
+    return framesRead;
+}
+
+bool WavReader::rewind() {
+    if (!isOpen()) {
+        return false;
+    }
+
+    file_.clear();
+    file_.seekg(static_cast<std::streamoff>(dataOffset_), std::ios::beg);
+    position_ = 0;
+    return static_cast<bool>(file_);
+}
+
+uint64_t WavReader::getPosition() const {
+    return position_;
+}
+
+const std::string& WavReader::getLastError() const {
+    return lastError_;
+}
+
+bool WavReader::fail(const std::string& message) {
+    close();
+    lastError_ = message;
+    return false;
+}
+
+} // namespace micmap::audio
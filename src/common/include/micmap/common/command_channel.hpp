@@ -0,0 +1,188 @@
+#pragma once
+
+/**
+ * @file command_channel.hpp
+ * @brief Localhost datagram transport for binary command records
+ *
+ * The driver runs a CommandServer next to its HTTP server; the app's driver
+ * client talks to it through a CommandClient. Both use one UDP socket on
+ * the loopback interface and exchange the records of command_protocol.hpp.
+ * Neither class logs: errors are reported through getLastError() so the
+ * driver, which has its own logging, can compile this file as well.
+ */
+
+#include "micmap/common/command_protocol.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace micmap::common {
+
+namespace detail {
+struct DatagramSocket;
+}
+
+/**
+ * @brief Counters of a command server
+ */
+struct CommandServerStats {
+    uint64_t received = 0;    ///< Datagrams read
+    uint64_t handled = 0;     ///< Commands passed to the handler
+    uint64_t duplicates = 0;  ///< Retransmissions answered without handling again
+    uint64_t malformed = 0;   ///< Datagrams that were not command records
+};
+
+/**
+ * @brief Receives command records and acknowledges them
+ *
+ * Commands are handled one at a time on the server thread, in arrival
+ * order. A client retransmits a command whose ack it did not get with the
+ * same sequence number; the server remembers the last command of the last
+ * sender and repeats its ack instead of pressing the button again. Pings
+ * are answered without calling the handler.
+ */
+class CommandServer {
+public:
+    /// Performs a command; runs on the server thread
+    using Handler = std::function<CommandStatus(const CommandRecord&)>;
+
+    /**
+     * @throws std::invalid_argument if the handler is empty
+     */
+    explicit CommandServer(Handler handler);
+    ~CommandServer();
+
+    CommandServer(const CommandServer&) = delete;
+    CommandServer& operator=(const CommandServer&) = delete;
+
+    /**
+     * @brief Bind a UDP socket and start the server thread
+     * @param host IPv4 address or host name to bind
+     * @param port Port to bind (0 = any free port, see getPort())
+     * @return False if the socket could not be bound or the server is running
+     */
+    bool start(const std::string& host, int port);
+
+    /**
+     * @brief Stop the server thread and close the socket
+     */
+    void stop();
+
+    /**
+     * @brief Check if the server thread is running
+     */
+    bool isRunning() const { return running_; }
+
+    /**
+     * @brief Get the bound port, or 0 if not running
+     */
+    int getPort() const { return port_; }
+
+    /**
+     * @brief Get the last error message
+     */
+    std::string getLastError() const;
+
+    /**
+     * @brief Get a snapshot of the counters
+     */
+    CommandServerStats getStats() const;
+
+    /// Longest time stop() waits for the server thread to notice
+    static constexpr int POLL_INTERVAL_MS = 50;
+
+private:
+    void run();
+    void setError(const std::string& error);
+
+    Handler handler_;
+    std::unique_ptr<detail::DatagramSocket> socket_;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<int> port_{0};
+
+    mutable std::mutex stateMutex_;
+    std::string lastError_;
+    CommandServerStats stats_;
+};
+
+/**
+ * @brief Command client configuration
+ */
+struct CommandClientConfig {
+    int ackTimeoutMs = 20;  ///< Wait for an ack before retransmitting
+    int attempts = 3;       ///< Transmissions of one command before giving up
+};
+
+/**
+ * @brief Sends command records and waits for their acknowledgements
+ *
+ * The socket is connected to the server, so on loopback a server that is
+ * not listening is reported at once rather than after the ack timeout.
+ * Not thread-safe: callers serialise send().
+ */
+class CommandClient {
+public:
+    explicit CommandClient(const CommandClientConfig& config = CommandClientConfig{});
+    ~CommandClient();
+
+    CommandClient(const CommandClient&) = delete;
+    CommandClient& operator=(const CommandClient&) = delete;
+
+    /**
+     * @brief Open a UDP socket towards a command server
+     * @return False if the host could not be resolved or the socket opened
+     */
+    bool open(const std::string& host, int port);
+
+    /**
+     * @brief Close the socket
+     */
+    void close();
+
+    /**
+     * @brief Check if the socket is open
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Send a command and wait for its acknowledgement
+     * @param action Action to perform
+     * @param button Button to act on
+     * @param durationMs Hold time of a click
+     * @param ack Receives the driver's acknowledgement
+     * @return False if no ack arrived; check ack.status otherwise
+     *
+     * A command without an ack may still have been performed: the server
+     * can be slow rather than gone. See mayHaveBeenHandled().
+     */
+    bool send(CommandAction action, CommandButton button, uint16_t durationMs, CommandRecord& ack);
+
+    /**
+     * @brief After a failed send(), whether the server may have handled the command
+     *
+     * False only if nothing was sent or the first transmission was refused
+     * because no server listens; the command can then safely be sent
+     * another way. True if it went out and only the ack is missing.
+     */
+    bool mayHaveBeenHandled() const { return mayHaveBeenHandled_; }
+
+    /**
+     * @brief Get the last error message
+     */
+    const std::string& getLastError() const { return lastError_; }
+
+private:
+    CommandClientConfig config_;
+    std::unique_ptr<detail::DatagramSocket> socket_;
+    uint32_t nextSequence_ = 1;
+    bool mayHaveBeenHandled_ = false;
+    std::string lastError_;
+};
+
+} // namespace micmap::common
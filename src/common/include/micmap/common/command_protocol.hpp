@@ -0,0 +1,205 @@
+#pragma once
+
+/**
+ * @file command_protocol.hpp
+ * @brief Binary command records exchanged by the app and the driver
+ *
+ * Button commands travel as fixed-size 32-byte records in single datagrams
+ * instead of HTTP requests, so the driver decodes a handful of fields
+ * rather than parsing, routing and building JSON for every click. The
+ * driver answers each command with an acknowledgement in the same layout.
+ *
+ * Layout (all fields little-endian):
+ *
+ * | Offset | Size | Field                                       |
+ * |--------|------|---------------------------------------------|
+ * | 0      | 4    | Magic "MMC1"                                |
+ * | 4      | 1    | Version                                     |
+ * | 5      | 1    | Type (command or ack)                       |
+ * | 6      | 1    | Action                                      |
+ * | 7      | 1    | Button                                      |
+ * | 8      | 4    | Sequence number                             |
+ * | 12     | 2    | Click duration in ms                        |
+ * | 14     | 1    | Status (acks only)                          |
+ * | 15     | 1    | Reserved, zero                              |
+ * | 16     | 8    | Sender timestamp in us, echoed in the ack   |
+ * | 24     | 8    | Driver timestamp in us when handled (acks)  |
+ *
+ * Timestamps come from the steady clock, which both processes share on
+ * one machine, so handledUs - sentUs is the one-way delivery time.
+ */
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace micmap::common {
+
+constexpr uint32_t COMMAND_MAGIC = 0x31434D4D;  ///< "MMC1" in byte order
+constexpr uint8_t COMMAND_VERSION = 1;
+constexpr size_t COMMAND_RECORD_SIZE = 32;
+
+/**
+ * @brief Whether a record is a request or the driver's answer
+ */
+enum class CommandType : uint8_t {
+    Command = 1,
+    Ack = 2
+};
+
+/**
+ * @brief What the driver should do
+ */
+enum class CommandAction : uint8_t {
+    Ping = 0,     ///< No-op, answered to prove the channel works
+    Click = 1,    ///< Press, then release after durationMs
+    Press = 2,
+    Release = 3
+};
+
+/**
+ * @brief Virtual controller button
+ */
+enum class CommandButton : uint8_t {
+    System = 0,
+    A = 1,
+    Trigger = 2
+};
+
+/**
+ * @brief Result reported in an acknowledgement
+ */
+enum class CommandStatus : uint8_t {
+    Ok = 0,
+    NotActive = 1,   ///< The virtual controller is not active
+    BadCommand = 2   ///< Unknown action or button
+};
+
+/**
+ * @brief One command or acknowledgement
+ */
+struct CommandRecord {
+    CommandType type = CommandType::Command;
+    CommandAction action = CommandAction::Ping;
+    CommandButton button = CommandButton::System;
+    CommandStatus status = CommandStatus::Ok;
+    uint32_t sequence = 0;     ///< Chosen by the sender; the ack carries the same number
+    uint16_t durationMs = 0;   ///< Hold time of a click
+    uint64_t sentUs = 0;       ///< Sender steady clock when sent
+    uint64_t handledUs = 0;    ///< Driver steady clock when handled (acks only)
+};
+
+/**
+ * @brief Current steady clock time in microseconds, as stored in records
+ */
+inline uint64_t commandTimestampUs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/**
+ * @brief Convert a button to the name used by the HTTP routes
+ */
+inline const char* commandButtonToString(CommandButton button) {
+    switch (button) {
+        case CommandButton::System: return "system";
+        case CommandButton::A: return "a";
+        case CommandButton::Trigger: return "trigger";
+        default: return "unknown";
+    }
+}
+
+/**
+ * @brief Parse a button name as used by the HTTP routes
+ * @return False (leaving button unchanged) for an unknown name
+ */
+inline bool parseCommandButton(std::string_view name, CommandButton& button) {
+    if (name == "system") {
+        button = CommandButton::System;
+    } else if (name == "a") {
+        button = CommandButton::A;
+    } else if (name == "trigger") {
+        button = CommandButton::Trigger;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Convert an action to string for logging
+ */
+inline const char* commandActionToString(CommandAction action) {
+    switch (action) {
+        case CommandAction::Ping: return "ping";
+        case CommandAction::Click: return "click";
+        case CommandAction::Press: return "press";
+        case CommandAction::Release: return "release";
+        default: return "unknown";
+    }
+}
+
+namespace detail {
+
+inline void storeLE(uint8_t* out, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i) {
+        out[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+inline uint64_t loadLE(const uint8_t* in, size_t bytes) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; ++i) {
+        value |= static_cast<uint64_t>(in[i]) << (8 * i);
+    }
+    return value;
+}
+
+} // namespace detail
+
+/**
+ * @brief Serialise a record into its 32-byte wire form
+ */
+inline void encodeCommandRecord(const CommandRecord& record, uint8_t (&out)[COMMAND_RECORD_SIZE]) {
+    detail::storeLE(out, COMMAND_MAGIC, 4);
+    out[4] = COMMAND_VERSION;
+    out[5] = static_cast<uint8_t>(record.type);
+    out[6] = static_cast<uint8_t>(record.action);
+    out[7] = static_cast<uint8_t>(record.button);
+    detail::storeLE(out + 8, record.sequence, 4);
+    detail::storeLE(out + 12, record.durationMs, 2);
+    out[14] = static_cast<uint8_t>(record.status);
+    out[15] = 0;
+    detail::storeLE(out + 16, record.sentUs, 8);
+    detail::storeLE(out + 24, record.handledUs, 8);
+}
+
+/**
+ * @brief Parse a received datagram
+ * @return False if it is not a record of this protocol version
+ *
+ * Unknown actions and buttons are accepted so the driver can answer them
+ * with CommandStatus::BadCommand; unknown types are rejected.
+ */
+inline bool decodeCommandRecord(const uint8_t* data, size_t size, CommandRecord& record) {
+    if (size != COMMAND_RECORD_SIZE || detail::loadLE(data, 4) != COMMAND_MAGIC ||
+        data[4] != COMMAND_VERSION) {
+        return false;
+    }
+    if (data[5] != static_cast<uint8_t>(CommandType::Command) &&
+        data[5] != static_cast<uint8_t>(CommandType::Ack)) {
+        return false;
+    }
+    record.type = static_cast<CommandType>(data[5]);
+    record.action = static_cast<CommandAction>(data[6]);
+    record.button = static_cast<CommandButton>(data[7]);
+    record.sequence = static_cast<uint32_t>(detail::loadLE(data + 8, 4));
+    record.durationMs = static_cast<uint16_t>(detail::loadLE(data + 12, 2));
+    record.status = static_cast<CommandStatus>(data[14]);
+    record.sentUs = detail::loadLE(data + 16, 8);
+    record.handledUs = detail::loadLE(data + 24, 8);
+    return true;
+}
+
+} // namespace micmap::common
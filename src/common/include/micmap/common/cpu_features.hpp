@@ -0,0 +1,48 @@
+#pragma once
+
+/**
+ * @file cpu_features.hpp
+ * @brief Runtime CPU feature detection for SIMD kernel dispatch
+ */
+
+namespace micmap::common {
+
+/**
+ * @brief SIMD instruction set levels used by the signal processing kernels
+ */
+enum class SimdLevel {
+    Scalar,     ///< Portable C++ reference implementation
+    SSE2,       ///< x86 SSE2 (baseline on x86-64)
+    AVX2,       ///< x86 AVX2
+    NEON        ///< ARM AArch64 Advanced SIMD
+};
+
+/**
+ * @brief Convert SimdLevel to string for logging
+ */
+inline const char* simdLevelToString(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Scalar: return "Scalar";
+        case SimdLevel::SSE2: return "SSE2";
+        case SimdLevel::AVX2: return "AVX2";
+        case SimdLevel::NEON: return "NEON";
+        default: return "Unknown";
+    }
+}
+
+/**
+ * @brief Check whether the running CPU (and OS) supports a SIMD level
+ *
+ * This only reports hardware support; whether a kernel was compiled for the
+ * level is up to the module that provides it.
+ */
+bool isSimdLevelSupported(SimdLevel level);
+
+/**
+ * @brief Get the best SIMD level supported by the running CPU
+ *
+ * Detection runs once; later calls return the cached result.
+ */
+SimdLevel detectSimdLevel();
+
+} // namespace micmap::common
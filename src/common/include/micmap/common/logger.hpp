@@ -78,6 +78,11 @@ public:
     
     static void log(LogLevel level, std::string_view message);
     
+    /**
+     * @brief Check whether a message at the given level would be emitted
+     */
+    static bool isEnabled(LogLevel level);
+    
     template<typename... Args>
     static void trace(Args&&... args) {
         logFormatted(LogLevel::Trace, std::forward<Args>(args)...);
@@ -111,6 +116,11 @@ public:
 private:
     template<typename... Args>
     static void logFormatted(LogLevel level, Args&&... args) {
+        // Skip formatting entirely for filtered messages so disabled log
+        // statements stay allocation-free on the audio path
+        if (!isEnabled(level)) {
+            return;
+        }
         std::ostringstream oss;
         (oss << ... << std::forward<Args>(args));
         log(level, oss.str());
@@ -5,6 +5,7 @@
  * @brief Common type definitions for MicMap
  */
 
+#include <atomic>
 #include <cstdint>
 #include <string>
 #include <chrono>
@@ -70,4 +71,94 @@ inline Duration elapsed(Timestamp start) {
     return std::chrono::duration_cast<Duration>(now() - start);
 }
 
+/**
+ * @brief Convert a sample count to a duration without overflow or drift
+ * @param samples Number of samples
+ * @param sampleRate Sample rate in Hz (must be non-zero)
+ */
+inline Timestamp::duration samplesToDuration(uint64_t samples, uint32_t sampleRate) {
+    using Ticks = Timestamp::duration;
+    constexpr uint64_t TICKS_PER_SECOND = static_cast<uint64_t>(Ticks::period::den / Ticks::period::num);
+    uint64_t seconds = samples / sampleRate;
+    uint64_t remainder = samples % sampleRate;
+    return Ticks(static_cast<Ticks::rep>(seconds * TICKS_PER_SECOND +
+                                         remainder * TICKS_PER_SECOND / sampleRate));
+}
+
+/**
+ * @brief Source of "now" for temporal logic (durations, windows, cooldowns)
+ *
+ * Components that measure time take a clock instead of reading
+ * std::chrono::steady_clock directly, so the same logic runs in real time
+ * or against the audio sample counter.
+ */
+class IClock {
+public:
+    virtual ~IClock() = default;
+    
+    /**
+     * @brief Current time; only differences between values are meaningful
+     */
+    virtual Timestamp now() const = 0;
+};
+
+/**
+ * @brief Wall-clock time from std::chrono::steady_clock
+ */
+class SteadyClock : public IClock {
+public:
+    Timestamp now() const override {
+        return std::chrono::steady_clock::now();
+    }
+};
+
+/**
+ * @brief Time derived from the number of audio samples processed
+ *
+ * Time advances only when advance() is called, typically by whoever owns
+ * the audio stream, so offline replay is deterministic and can run at any
+ * speed. now() is a plain counter read and may be called from any thread.
+ */
+class SampleClock : public IClock {
+public:
+    /**
+     * @param sampleRate Sample rate in Hz (0 is treated as 1)
+     */
+    explicit SampleClock(uint32_t sampleRate)
+        : sampleRate_(sampleRate > 0 ? sampleRate : 1) {}
+    
+    /**
+     * @brief Advance time by a number of samples
+     */
+    void advance(uint64_t samples) {
+        samples_.fetch_add(samples, std::memory_order_relaxed);
+    }
+    
+    /**
+     * @brief Rewind to time zero
+     */
+    void reset() {
+        samples_.store(0, std::memory_order_relaxed);
+    }
+    
+    /**
+     * @brief Samples counted so far
+     */
+    uint64_t getSampleCount() const {
+        return samples_.load(std::memory_order_relaxed);
+    }
+    
+    uint32_t getSampleRate() const {
+        return sampleRate_;
+    }
+    
+    Timestamp now() const override {
+        return Timestamp(samplesToDuration(getSampleCount(), sampleRate_));
+    }
+    
+private:
+    uint32_t sampleRate_;
+    std::atomic<uint64_t> samples_{0};
+};
+
 } // namespace micmap::common
\ No newline at end of file
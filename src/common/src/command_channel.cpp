@@ -0,0 +1,425 @@
+/**
+ * @file command_channel.cpp
+ * @brief UDP command server and client
+ */
+
+#include "micmap/common/command_channel.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <cerrno>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace micmap::common {
+
+namespace detail {
+
+/**
+ * @brief Sender address of a received datagram
+ */
+struct Peer {
+    sockaddr_storage address{};
+    socklen_t length = sizeof(sockaddr_storage);
+
+    bool operator==(const Peer& other) const {
+        return length == other.length && std::memcmp(&address, &other.address, length) == 0;
+    }
+};
+
+/**
+ * @brief Thin wrapper over a Winsock or POSIX UDP socket
+ */
+struct DatagramSocket {
+#ifdef _WIN32
+    using Handle = SOCKET;
+    static constexpr Handle INVALID = INVALID_SOCKET;
+#else
+    using Handle = int;
+    static constexpr Handle INVALID = -1;
+#endif
+
+    /// Result of receive() besides a byte count
+    static constexpr int TIMEOUT = 0;
+    static constexpr int FAILED = -1;
+
+    Handle handle = INVALID;
+#ifdef _WIN32
+    bool wsaStarted = false;
+#endif
+
+    ~DatagramSocket() {
+        close();
+    }
+
+    /**
+     * @brief Create the socket and bind it (server) or connect it (client)
+     */
+    bool open(const std::string& host, int port, bool bindLocal, std::string& error) {
+#ifdef _WIN32
+        WSADATA wsaData;
+        if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+            error = "WSAStartup failed";
+            return false;
+        }
+        wsaStarted = true;
+#endif
+        addrinfo hints{};
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_DGRAM;
+        hints.ai_protocol = IPPROTO_UDP;
+        addrinfo* result = nullptr;
+        std::string service = std::to_string(port);
+        if (getaddrinfo(host.c_str(), service.c_str(), &hints, &result) != 0 || !result) {
+            error = "Cannot resolve " + host;
+            close();
+            return false;
+        }
+
+        handle = ::socket(result->ai_family, result->ai_socktype, result->ai_protocol);
+        bool ok = handle != INVALID;
+        if (ok) {
+            ok = bindLocal
+                ? ::bind(handle, result->ai_addr, static_cast<socklen_t>(result->ai_addrlen)) == 0
+                : ::connect(handle, result->ai_addr, static_cast<socklen_t>(result->ai_addrlen)) == 0;
+        }
+        freeaddrinfo(result);
+        if (!ok) {
+            error = std::string(bindLocal ? "Cannot bind " : "Cannot connect to ") + host + ":" +
+                    service + " (" + lastSocketError() + ")";
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+        if (handle != INVALID) {
+#ifdef _WIN32
+            ::closesocket(handle);
+#else
+            ::close(handle);
+#endif
+            handle = INVALID;
+        }
+#ifdef _WIN32
+        if (wsaStarted) {
+            WSACleanup();
+            wsaStarted = false;
+        }
+#endif
+    }
+
+    int localPort() const {
+        sockaddr_in address{};
+        socklen_t length = sizeof(address);
+        if (::getsockname(handle, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+            return 0;
+        }
+        return ntohs(address.sin_port);
+    }
+
+    bool send(const uint8_t* data, size_t size, const Peer* to = nullptr) {
+        const char* bytes = reinterpret_cast<const char*>(data);
+        auto sent = to
+            ? ::sendto(handle, bytes, static_cast<int>(size), 0,
+                       reinterpret_cast<const sockaddr*>(&to->address), to->length)
+            : ::send(handle, bytes, static_cast<int>(size), 0);
+        return sent == static_cast<decltype(sent)>(size);
+    }
+
+    /**
+     * @brief Wait up to timeoutMs for one datagram
+     * @return Its size, TIMEOUT, or FAILED
+     */
+    int receive(uint8_t* data, size_t size, int timeoutMs, Peer& from) {
+#ifdef _WIN32
+        WSAPOLLFD pfd{};
+        pfd.fd = handle;
+        pfd.events = POLLRDNORM;
+        int ready = WSAPoll(&pfd, 1, timeoutMs);
+#else
+        pollfd pfd{};
+        pfd.fd = handle;
+        pfd.events = POLLIN;
+        int ready = ::poll(&pfd, 1, timeoutMs);
+        if (ready < 0 && errno == EINTR) {
+            return TIMEOUT;
+        }
+#endif
+        if (ready == 0) {
+            return TIMEOUT;
+        }
+        if (ready < 0) {
+            return FAILED;
+        }
+        from.length = sizeof(from.address);
+        auto received = ::recvfrom(handle, reinterpret_cast<char*>(data), static_cast<int>(size), 0,
+                                   reinterpret_cast<sockaddr*>(&from.address), &from.length);
+        return received < 0 ? FAILED : static_cast<int>(received);
+    }
+
+    /**
+     * @brief True if the last error is an ICMP "port unreachable" report
+     *
+     * On a connected socket it means nobody listens at the other end; on
+     * Windows an unconnected socket reports it too, for an earlier reply
+     * that could not be delivered.
+     */
+    static bool lastErrorIsUnreachable() {
+#ifdef _WIN32
+        int error = WSAGetLastError();
+        return error == WSAECONNRESET || error == WSAECONNREFUSED;
+#else
+        return errno == ECONNREFUSED;
+#endif
+    }
+
+    static std::string lastSocketError() {
+#ifdef _WIN32
+        return "error " + std::to_string(WSAGetLastError());
+#else
+        return std::strerror(errno);
+#endif
+    }
+};
+
+} // namespace detail
+
+// ============================================================================
+// CommandServer
+// ============================================================================
+
+CommandServer::CommandServer(Handler handler)
+    : handler_(std::move(handler)) {
+    if (!handler_) {
+        throw std::invalid_argument("CommandServer: handler is empty");
+    }
+}
+
+CommandServer::~CommandServer() {
+    stop();
+}
+
+bool CommandServer::start(const std::string& host, int port) {
+    if (running_) {
+        setError("Command server is already running");
+        return false;
+    }
+    stop();  // Reap a thread that ended on a socket error
+
+    auto socket = std::make_unique<detail::DatagramSocket>();
+    std::string error;
+    if (!socket->open(host, port, true, error)) {
+        setError(error);
+        return false;
+    }
+    port_ = socket->localPort();
+    socket_ = std::move(socket);
+    running_ = true;
+    thread_ = std::thread(&CommandServer::run, this);
+    return true;
+}
+
+void CommandServer::stop() {
+    running_ = false;
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    socket_.reset();
+    port_ = 0;
+}
+
+std::string CommandServer::getLastError() const {
+    std::lock_guard<std::mutex> lock(stateMutex_);
+    return lastError_;
+}
+
+CommandServerStats CommandServer::getStats() const {
+    std::lock_guard<std::mutex> lock(stateMutex_);
+    return stats_;
+}
+
+void CommandServer::setError(const std::string& error) {
+    std::lock_guard<std::mutex> lock(stateMutex_);
+    lastError_ = error;
+}
+
+void CommandServer::run() {
+    // One spare byte so oversized datagrams do not decode as records
+    uint8_t buffer[COMMAND_RECORD_SIZE + 1];
+    uint8_t lastAck[COMMAND_RECORD_SIZE];
+    detail::Peer lastPeer;
+    uint32_t lastSequence = 0;
+    bool haveLast = false;
+
+    while (running_) {
+        detail::Peer peer;
+        int size = socket_->receive(buffer, sizeof(buffer), POLL_INTERVAL_MS, peer);
+        if (size == detail::DatagramSocket::TIMEOUT) {
+            continue;
+        }
+        if (size == detail::DatagramSocket::FAILED) {
+            if (detail::DatagramSocket::lastErrorIsUnreachable()) {
+                continue;  // A client went away before its ack arrived
+            }
+            setError("Receive failed: " + detail::DatagramSocket::lastSocketError());
+            break;
+        }
+
+        CommandRecord command;
+        bool valid = decodeCommandRecord(buffer, static_cast<size_t>(size), command) &&
+                     command.type == CommandType::Command;
+        {
+            std::lock_guard<std::mutex> lock(stateMutex_);
+            ++stats_.received;
+            if (!valid) {
+                ++stats_.malformed;
+            }
+        }
+        if (!valid) {
+            continue;
+        }
+
+        if (haveLast && command.sequence == lastSequence && peer == lastPeer) {
+            {
+                std::lock_guard<std::mutex> lock(stateMutex_);
+                ++stats_.duplicates;
+            }
+            socket_->send(lastAck, sizeof(lastAck), &peer);
+            continue;
+        }
+
+        CommandRecord ack = command;
+        ack.type = CommandType::Ack;
+        ack.status = CommandStatus::Ok;
+        if (command.action != CommandAction::Ping) {
+            try {
+                ack.status = handler_(command);
+            } catch (const std::exception& e) {
+                setError(std::string("Command handler threw: ") + e.what());
+                ack.status = CommandStatus::BadCommand;
+            }
+            std::lock_guard<std::mutex> lock(stateMutex_);
+            ++stats_.handled;
+        }
+        ack.handledUs = commandTimestampUs();
+
+        encodeCommandRecord(ack, lastAck);
+        lastPeer = peer;
+        lastSequence = command.sequence;
+        haveLast = true;
+        socket_->send(lastAck, sizeof(lastAck), &peer);
+    }
+    running_ = false;
+}
+
+// ============================================================================
+// CommandClient
+// ============================================================================
+
+CommandClient::CommandClient(const CommandClientConfig& config)
+    : config_(config) {
+}
+
+CommandClient::~CommandClient() = default;
+
+bool CommandClient::open(const std::string& host, int port) {
+    close();
+    auto socket = std::make_unique<detail::DatagramSocket>();
+    if (!socket->open(host, port, false, lastError_)) {
+        return false;
+    }
+    socket_ = std::move(socket);
+    return true;
+}
+
+void CommandClient::close() {
+    socket_.reset();
+}
+
+bool CommandClient::isOpen() const {
+    return socket_ != nullptr;
+}
+
+bool CommandClient::send(CommandAction action, CommandButton button, uint16_t durationMs, CommandRecord& ack) {
+    mayHaveBeenHandled_ = false;
+    if (!socket_) {
+        lastError_ = "Command channel is not open";
+        return false;
+    }
+
+    CommandRecord command;
+    command.action = action;
+    command.button = button;
+    command.durationMs = durationMs;
+    command.sequence = nextSequence_++;
+    command.sentUs = commandTimestampUs();
+    uint8_t wire[COMMAND_RECORD_SIZE];
+    encodeCommandRecord(command, wire);
+
+    using Clock = std::chrono::steady_clock;
+    uint8_t buffer[COMMAND_RECORD_SIZE + 1];
+    int attempts = std::max(1, config_.attempts);
+    for (int attempt = 0; attempt < attempts; ++attempt) {
+        // Retransmissions keep the sequence number so the server can tell them apart
+        if (!socket_->send(wire, sizeof(wire))) {
+            lastError_ = "Send failed: " + detail::DatagramSocket::lastSocketError();
+            return false;
+        }
+        mayHaveBeenHandled_ = true;
+
+        auto deadline = Clock::now() + std::chrono::milliseconds(config_.ackTimeoutMs);
+        while (true) {
+            auto remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - Clock::now());
+            if (remaining.count() <= 0) {
+                break;
+            }
+            detail::Peer peer;
+            int size = socket_->receive(buffer, sizeof(buffer), static_cast<int>(remaining.count()), peer);
+            if (size == detail::DatagramSocket::TIMEOUT) {
+                break;
+            }
+            if (size == detail::DatagramSocket::FAILED) {
+                if (detail::DatagramSocket::lastErrorIsUnreachable()) {
+                    // Refused on the first transmission: nothing read it
+                    mayHaveBeenHandled_ = attempt > 0;
+                    lastError_ = "No command server is listening";
+                } else {
+                    lastError_ = "Receive failed: " + detail::DatagramSocket::lastSocketError();
+                }
+                return false;
+            }
+            CommandRecord reply;
+            if (decodeCommandRecord(buffer, static_cast<size_t>(size), reply) &&
+                reply.type == CommandType::Ack && reply.sequence == command.sequence) {
+                ack = reply;
+                return true;
+            }
+            // A late ack of an earlier command: keep waiting for ours
+        }
+    }
+
+    lastError_ = "No acknowledgement after " + std::to_string(attempts) + " attempts";
+    return false;
+}
+
+} // namespace micmap::common
@@ -0,0 +1,101 @@
+/**
+ * @file cpu_features.cpp
+ * @brief Runtime CPU feature detection
+ */
+
+#include "micmap/common/cpu_features.hpp"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <immintrin.h>
+#define MICMAP_CPU_X86 1
+#elif defined(__x86_64__) || defined(__i386__)
+#define MICMAP_CPU_X86 1
+#endif
+
+namespace micmap::common {
+
+namespace {
+
+#ifdef MICMAP_CPU_X86
+
+bool cpuHasSSE2() {
+#ifdef _MSC_VER
+    int info[4] = {};
+    __cpuid(info, 1);
+    return (info[3] & (1 << 26)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse2");
+#endif
+}
+
+bool cpuHasAVX2() {
+#ifdef _MSC_VER
+    int info[4] = {};
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+
+    // AVX needs OS support for saving the YMM registers (OSXSAVE + XCR0)
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx) {
+        return false;
+    }
+    if ((_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    // __builtin_cpu_supports already accounts for OS YMM state support
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // MICMAP_CPU_X86
+
+} // anonymous namespace
+
+bool isSimdLevelSupported(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Scalar:
+            return true;
+#ifdef MICMAP_CPU_X86
+        case SimdLevel::SSE2:
+            return cpuHasSSE2();
+        case SimdLevel::AVX2:
+            return cpuHasAVX2();
+#endif
+#if defined(__aarch64__) || defined(_M_ARM64)
+        case SimdLevel::NEON:
+            // Advanced SIMD is mandatory on AArch64
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+SimdLevel detectSimdLevel() {
+    static const SimdLevel level = []() {
+        if (isSimdLevelSupported(SimdLevel::AVX2)) {
+            return SimdLevel::AVX2;
+        }
+        if (isSimdLevelSupported(SimdLevel::SSE2)) {
+            return SimdLevel::SSE2;
+        }
+        if (isSimdLevelSupported(SimdLevel::NEON)) {
+            return SimdLevel::NEON;
+        }
+        return SimdLevel::Scalar;
+    }();
+    return level;
+}
+
+} // namespace micmap::common
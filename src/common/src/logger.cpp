@@ -78,4 +78,8 @@ void Logger::log(LogLevel level, std::string_view message) {
     }
 }
 
+bool Logger::isEnabled(LogLevel level) {
+    return logger_ && level >= logger_->getMinLevel();
+}
+
 } // namespace micmap::common
\ No newline at end of file
@@ -10,6 +10,7 @@
 #include <memory>
 #include <optional>
 #include <chrono>
+#include <vector>
 
 namespace micmap::core {
 
@@ -20,6 +21,9 @@ struct AudioConfig {
     std::wstring deviceNamePattern = L"Beyond";  ///< Device name pattern to match
     std::wstring deviceId;                        ///< Specific device ID (overrides pattern)
     int bufferSizeMs = 10;                        ///< Audio buffer size in milliseconds
+    int analysisRate = 48000;                     ///< Rate capture is resampled to for detection (0 = device rate)
+    int analysisQueueMs = 0;                      ///< Audio queued for the analysis worker (0 = analyze on the capture thread)
+    std::string backpressure = "drop-oldest";     ///< Worker policy when analysis falls behind ("drop-oldest", "coalesce")
 };
 
 /**
@@ -30,6 +34,15 @@ struct DetectionConfig {
     int minDurationMs = 300;            ///< Minimum detection duration in ms
     int cooldownMs = 300;               ///< Cooldown after trigger in ms
     int fftSize = 2048;                 ///< FFT window size
+    int hopSize = 512;                  ///< Samples between analysis frames
+    std::string fftBackend = "auto";    ///< FFT engine ("auto", "kissfft", "radix4")
+    int cascadeInterval = 4;            ///< Idle frames per FFT in the energy-gated cascade (0 = every frame)
+    std::string filterbank = "none";    ///< Profile feature space ("none" = FFT bins, "mel", "erb")
+    int filterbankBands = 32;           ///< Bands of the mel/ERB filterbank
+    float filterbankMinHz = 50.0f;      ///< Lower edge of the first band
+    float filterbankMaxHz = 16000.0f;   ///< Upper edge of the last band
+    int monitorBins = 0;                ///< Sliding-DFT bins matched while idle (0 = full FFT)
+    int channels = 1;                   ///< Mic channels analysed separately (1 = mono downmix)
 };
 
 /**
@@ -38,6 +51,9 @@ struct DetectionConfig {
 struct SteamVRConfig {
     bool dashboardClickEnabled = true;  ///< Enable dashboard click when open
     std::string customActionBinding;    ///< Custom action binding (optional)
+    int triggerDeadlineMs = 500;        ///< Triggers not sent by then are dropped
+    int driverHealthIntervalMs = 2000;  ///< Idle time before pinging the driver (0 = no pings or background reconnects)
+    bool driverCommandChannel = true;   ///< Send button commands as binary datagrams instead of HTTP when the driver supports it
 };
 
 /**
@@ -45,6 +61,7 @@ struct SteamVRConfig {
  */
 struct TrainingConfig {
     std::string dataFile = "training_data.bin";  ///< Training data filename
+    std::vector<std::string> extraDataFiles;     ///< More profiles matched alongside dataFile (other users, devices or grips)
     std::optional<std::chrono::system_clock::time_point> lastTrainedTimestamp;
 };
 
@@ -0,0 +1,188 @@
+#pragma once
+
+/**
+ * @file trigger_dispatcher.hpp
+ * @brief Asynchronous delivery of triggers to the VR runtime
+ *
+ * Sending a trigger means an HTTP request to the driver or an OpenVR call,
+ * either of which can stall for seconds. The dispatcher takes triggers from
+ * the detection thread without waiting and delivers them on its own thread,
+ * trying each configured route in order until one acknowledges. A route
+ * that may have performed the action without acknowledging it ends the
+ * trigger: sending it again another way could click twice.
+ */
+
+#include "micmap/common/types.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace micmap::core {
+
+/**
+ * @brief What a route did with a trigger
+ */
+enum class RouteOutcome {
+    Delivered,     ///< Performed and acknowledged
+    NotAttempted,  ///< Nothing was sent; the next route may try
+    Unconfirmed    ///< Sent without an acknowledgement; it may have been performed
+};
+
+/**
+ * @brief One way of delivering a trigger, e.g. the driver client
+ */
+struct TriggerRoute {
+    std::string name;                        ///< Shown in logs and results
+    std::function<bool()> available;         ///< Cheap readiness check; empty means always ready
+    std::function<RouteOutcome()> fire;      ///< Performs the action
+};
+
+/**
+ * @brief Trigger dispatcher configuration
+ */
+struct TriggerDispatcherConfig {
+    std::chrono::milliseconds coalesceWindow{300};  ///< Triggers this soon after an accepted one are merged into it
+    std::chrono::milliseconds deadline{500};        ///< Triggers not dispatched by then are dropped
+    size_t queueCapacity = 8;                       ///< Pending triggers before submit() rejects
+    std::shared_ptr<common::IClock> clock;          ///< Time source (nullptr = steady clock)
+};
+
+/**
+ * @brief How a trigger ended
+ */
+enum class TriggerOutcome {
+    Delivered,    ///< A route acknowledged it
+    Failed,       ///< No route was available or none sent it
+    Expired,      ///< Its deadline passed before dispatch, or it was queued at stop()
+    Unconfirmed   ///< A route sent it without an acknowledgement; not retried
+};
+
+/**
+ * @brief Convert an outcome to string
+ */
+inline const char* triggerOutcomeToString(TriggerOutcome outcome) {
+    switch (outcome) {
+        case TriggerOutcome::Delivered: return "Delivered";
+        case TriggerOutcome::Failed: return "Failed";
+        case TriggerOutcome::Expired: return "Expired";
+        case TriggerOutcome::Unconfirmed: return "Unconfirmed";
+        default: return "Unknown";
+    }
+}
+
+/**
+ * @brief Result of one trigger, reported on the dispatcher thread
+ */
+struct TriggerResult {
+    uint64_t id = 0;                          ///< Value returned by submit()
+    TriggerOutcome outcome = TriggerOutcome::Failed;
+    std::string route;                        ///< Route that delivered or sent it, if any
+    std::chrono::microseconds queueDelay{0};  ///< Submit to start of dispatch
+    std::chrono::microseconds latency{0};     ///< Submit to acknowledgement (or failure)
+};
+
+/**
+ * @brief Callback for trigger results
+ */
+using TriggerResultCallback = std::function<void(const TriggerResult&)>;
+
+/**
+ * @brief Counters of a trigger dispatcher
+ */
+struct TriggerDispatcherStats {
+    uint64_t submitted = 0;       ///< submit() calls
+    uint64_t coalesced = 0;       ///< Merged into an earlier trigger
+    uint64_t rejected = 0;        ///< Queue full
+    uint64_t delivered = 0;
+    uint64_t failed = 0;
+    uint64_t expired = 0;
+    uint64_t unconfirmed = 0;     ///< Sent by a route without an acknowledgement
+    uint64_t fallbacks = 0;       ///< Delivered by a route after the first one tried
+    uint64_t deadlineMisses = 0;  ///< Delivered, but later than the deadline
+    std::chrono::microseconds lastLatency{0};   ///< Of the last delivered trigger
+    std::chrono::microseconds maxLatency{0};
+    std::chrono::microseconds totalLatency{0};  ///< Sum over delivered triggers
+};
+
+/**
+ * @brief Interface for the trigger dispatcher
+ *
+ * submit() only records the trigger and wakes the dispatcher thread, so it
+ * can be called from the audio or analysis thread. Triggers are delivered
+ * in order, one at a time. A trigger whose deadline has passed when its
+ * turn comes is dropped: opening the dashboard seconds after the user
+ * covered the mic is worse than not opening it. A route that blocks only
+ * delays later triggers, which then expire or coalesce. Only a route that
+ * reports RouteOutcome::NotAttempted passes the trigger to the next one; a
+ * route that throws counts as Unconfirmed, since it may have acted first.
+ */
+class ITriggerDispatcher {
+public:
+    virtual ~ITriggerDispatcher() = default;
+
+    /**
+     * @brief Replace the delivery routes, tried in order
+     */
+    virtual void setRoutes(std::vector<TriggerRoute> routes) = 0;
+
+    /**
+     * @brief Set the result callback, called on the dispatcher thread
+     */
+    virtual void setResultCallback(TriggerResultCallback callback) = 0;
+
+    /**
+     * @brief Start the dispatcher thread
+     * @return False if it is already running
+     */
+    virtual bool start() = 0;
+
+    /**
+     * @brief Stop the dispatcher thread
+     *
+     * Waits for the trigger being delivered, if any; triggers still queued
+     * expire. Must not be called from a route or the result callback.
+     */
+    virtual void stop() = 0;
+
+    /**
+     * @brief Check if the dispatcher thread is running
+     */
+    virtual bool isRunning() const = 0;
+
+    /**
+     * @brief Queue a trigger without waiting for delivery
+     * @return Trigger id, or 0 if it was coalesced or the queue is full
+     */
+    virtual uint64_t submit() = 0;
+
+    /**
+     * @brief Wait until no trigger is queued or being delivered
+     * @return False if the timeout passed first
+     */
+    virtual bool waitIdle(std::chrono::milliseconds timeout) = 0;
+
+    /**
+     * @brief Get a snapshot of the counters
+     */
+    virtual TriggerDispatcherStats getStats() const = 0;
+
+    /**
+     * @brief Zero the counters
+     */
+    virtual void resetStats() = 0;
+};
+
+/**
+ * @brief Create a trigger dispatcher (not started)
+ * @param config Dispatcher configuration
+ * @return Unique pointer to trigger dispatcher
+ */
+std::unique_ptr<ITriggerDispatcher> createTriggerDispatcher(
+    const TriggerDispatcherConfig& config = TriggerDispatcherConfig{});
+
+} // namespace micmap::core
@@ -69,7 +69,10 @@ std::string toJson(const AppConfig& config) {
         oss << "\"";
     }
     oss << ",\n";
-    oss << "        \"bufferSizeMs\": " << config.audio.bufferSizeMs << "\n";
+    oss << "        \"bufferSizeMs\": " << config.audio.bufferSizeMs << ",\n";
+    oss << "        \"analysisRate\": " << config.audio.analysisRate << ",\n";
+    oss << "        \"analysisQueueMs\": " << config.audio.analysisQueueMs << ",\n";
+    oss << "        \"backpressure\": \"" << config.audio.backpressure << "\"\n";
     oss << "    },\n";
     
     // Detection section
@@ -77,7 +80,16 @@ std::string toJson(const AppConfig& config) {
     oss << "        \"sensitivity\": " << config.detection.sensitivity << ",\n";
     oss << "        \"minDurationMs\": " << config.detection.minDurationMs << ",\n";
     oss << "        \"cooldownMs\": " << config.detection.cooldownMs << ",\n";
-    oss << "        \"fftSize\": " << config.detection.fftSize << "\n";
+    oss << "        \"fftSize\": " << config.detection.fftSize << ",\n";
+    oss << "        \"hopSize\": " << config.detection.hopSize << ",\n";
+    oss << "        \"fftBackend\": \"" << config.detection.fftBackend << "\",\n";
+    oss << "        \"cascadeInterval\": " << config.detection.cascadeInterval << ",\n";
+    oss << "        \"filterbank\": \"" << config.detection.filterbank << "\",\n";
+    oss << "        \"filterbankBands\": " << config.detection.filterbankBands << ",\n";
+    oss << "        \"filterbankMinHz\": " << config.detection.filterbankMinHz << ",\n";
+    oss << "        \"filterbankMaxHz\": " << config.detection.filterbankMaxHz << ",\n";
+    oss << "        \"monitorBins\": " << config.detection.monitorBins << ",\n";
+    oss << "        \"channels\": " << config.detection.channels << "\n";
     oss << "    },\n";
     
     // SteamVR section
@@ -89,12 +101,20 @@ std::string toJson(const AppConfig& config) {
     } else {
         oss << "\"" << config.steamvr.customActionBinding << "\"";
     }
-    oss << "\n";
+    oss << ",\n";
+    oss << "        \"triggerDeadlineMs\": " << config.steamvr.triggerDeadlineMs << ",\n";
+    oss << "        \"driverHealthIntervalMs\": " << config.steamvr.driverHealthIntervalMs << ",\n";
+    oss << "        \"driverCommandChannel\": " << (config.steamvr.driverCommandChannel ? "true" : "false") << "\n";
     oss << "    },\n";
     
     // Training section
     oss << "    \"training\": {\n";
     oss << "        \"dataFile\": \"" << config.training.dataFile << "\",\n";
+    oss << "        \"extraDataFiles\": [";
+    for (size_t i = 0; i < config.training.extraDataFiles.size(); ++i) {
+        oss << (i > 0 ? ", " : "") << "\"" << config.training.extraDataFiles[i] << "\"";
+    }
+    oss << "],\n";
     oss << "        \"lastTrainedTimestamp\": ";
     if (config.training.lastTrainedTimestamp.has_value()) {
         auto time = std::chrono::system_clock::to_time_t(*config.training.lastTrainedTimestamp);
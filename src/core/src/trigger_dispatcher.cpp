@@ -0,0 +1,275 @@
+/**
+ * @file trigger_dispatcher.cpp
+ * @brief Trigger dispatcher implementation
+ */
+
+#include "micmap/core/trigger_dispatcher.hpp"
+#include "micmap/common/logger.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+namespace micmap::core {
+
+namespace {
+
+std::chrono::microseconds toMicros(common::Timestamp::duration duration) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(duration);
+}
+
+} // anonymous namespace
+
+/**
+ * @brief Trigger dispatcher implementation
+ *
+ * The queue is a fixed ring guarded by a mutex that is never held while a
+ * route runs, so submit() waits at most for another short queue update.
+ */
+class TriggerDispatcherImpl : public ITriggerDispatcher {
+public:
+    explicit TriggerDispatcherImpl(const TriggerDispatcherConfig& config)
+        : config_(config)
+        , clock_(config.clock ? config.clock : std::make_shared<common::SteadyClock>())
+        , queue_(std::max<size_t>(config.queueCapacity, 1))
+        , routes_(std::make_shared<const std::vector<TriggerRoute>>()) {
+    }
+
+    ~TriggerDispatcherImpl() override {
+        stop();
+    }
+
+    void setRoutes(std::vector<TriggerRoute> routes) override {
+        auto snapshot = std::make_shared<const std::vector<TriggerRoute>>(std::move(routes));
+        std::lock_guard<std::mutex> lock(mutex_);
+        routes_ = std::move(snapshot);
+    }
+
+    void setResultCallback(TriggerResultCallback callback) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        resultCallback_ = std::move(callback);
+    }
+
+    bool start() override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (running_) {
+            return false;
+        }
+        running_ = true;
+        thread_ = std::thread(&TriggerDispatcherImpl::run, this);
+        return true;
+    }
+
+    void stop() override {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            running_ = false;
+        }
+        wake_.notify_all();
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (count_ > 0) {
+            MICMAP_LOG_DEBUG("Trigger dispatcher stopped with ", count_, " triggers queued");
+            stats_.expired += count_;
+            count_ = 0;
+        }
+        idle_.notify_all();
+    }
+
+    bool isRunning() const override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return running_;
+    }
+
+    uint64_t submit() override {
+        auto now = clock_->now();
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++stats_.submitted;
+
+        if (hasAccepted_ && now - lastAccepted_ < config_.coalesceWindow) {
+            ++stats_.coalesced;
+            return 0;
+        }
+        if (count_ == queue_.size()) {
+            ++stats_.rejected;
+            return 0;
+        }
+
+        uint64_t id = nextId_++;
+        queue_[(head_ + count_) % queue_.size()] = Pending{id, now};
+        ++count_;
+        hasAccepted_ = true;
+        lastAccepted_ = now;
+        wake_.notify_one();
+        return id;
+    }
+
+    bool waitIdle(std::chrono::milliseconds timeout) override {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return idle_.wait_for(lock, timeout, [this] { return count_ == 0 && !busy_; });
+    }
+
+    TriggerDispatcherStats getStats() const override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+
+    void resetStats() override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_ = TriggerDispatcherStats{};
+    }
+
+private:
+    struct Pending {
+        uint64_t id = 0;
+        common::Timestamp submitted{};
+    };
+
+    void run() {
+        MICMAP_LOG_DEBUG("Trigger dispatcher started");
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            wake_.wait(lock, [this] { return !running_ || count_ > 0; });
+            if (!running_) {
+                break;
+            }
+
+            Pending pending = queue_[head_];
+            head_ = (head_ + 1) % queue_.size();
+            --count_;
+            busy_ = true;
+            auto routes = routes_;
+            auto callback = resultCallback_;
+            lock.unlock();
+
+            bool fellBack = false;
+            TriggerResult result = deliver(pending, *routes, fellBack);
+            if (callback) {
+                callback(result);
+            }
+
+            lock.lock();
+            record(result, fellBack);
+            busy_ = false;
+            if (count_ == 0) {
+                idle_.notify_all();
+            }
+        }
+        MICMAP_LOG_DEBUG("Trigger dispatcher stopped");
+    }
+
+    TriggerResult deliver(const Pending& pending, const std::vector<TriggerRoute>& routes, bool& fellBack) {
+        TriggerResult result;
+        result.id = pending.id;
+        auto start = clock_->now();
+        result.queueDelay = toMicros(start - pending.submitted);
+
+        if (start - pending.submitted > config_.deadline) {
+            MICMAP_LOG_WARNING("Trigger ", pending.id, " expired after ",
+                               result.queueDelay.count() / 1000, " ms in the queue");
+            result.outcome = TriggerOutcome::Expired;
+            result.latency = result.queueDelay;
+            return result;
+        }
+
+        bool tried = false;
+        for (const auto& route : routes) {
+            if (route.available && !route.available()) {
+                continue;
+            }
+            RouteOutcome outcome = RouteOutcome::NotAttempted;
+            try {
+                if (route.fire) {
+                    outcome = route.fire();
+                }
+            } catch (const std::exception& e) {
+                MICMAP_LOG_ERROR("Trigger route ", route.name, " threw: ", e.what());
+                outcome = RouteOutcome::Unconfirmed;
+            }
+            if (outcome == RouteOutcome::Delivered) {
+                result.outcome = TriggerOutcome::Delivered;
+                result.route = route.name;
+                fellBack = tried;
+                break;
+            }
+            if (outcome == RouteOutcome::Unconfirmed) {
+                // Another route could perform the action a second time
+                result.outcome = TriggerOutcome::Unconfirmed;
+                result.route = route.name;
+                break;
+            }
+            MICMAP_LOG_WARNING("Trigger route ", route.name, " failed, trying the next one");
+            tried = true;
+        }
+        result.latency = toMicros(clock_->now() - pending.submitted);
+
+        if (result.outcome == TriggerOutcome::Delivered) {
+            MICMAP_LOG_DEBUG("Trigger ", pending.id, " delivered via ", result.route, " in ",
+                             result.latency.count(), " us");
+        } else if (result.outcome == TriggerOutcome::Unconfirmed) {
+            MICMAP_LOG_WARNING("Trigger ", pending.id, " sent via ", result.route,
+                               " but not acknowledged; not trying other routes");
+        } else {
+            MICMAP_LOG_WARNING("Trigger ", pending.id, " could not be delivered");
+        }
+        return result;
+    }
+
+    void record(const TriggerResult& result, bool fellBack) {
+        switch (result.outcome) {
+            case TriggerOutcome::Delivered:
+                ++stats_.delivered;
+                if (fellBack) {
+                    ++stats_.fallbacks;
+                }
+                if (result.latency > config_.deadline) {
+                    ++stats_.deadlineMisses;
+                }
+                stats_.lastLatency = result.latency;
+                stats_.maxLatency = std::max(stats_.maxLatency, result.latency);
+                stats_.totalLatency += result.latency;
+                break;
+            case TriggerOutcome::Failed:
+                ++stats_.failed;
+                break;
+            case TriggerOutcome::Expired:
+                ++stats_.expired;
+                break;
+            case TriggerOutcome::Unconfirmed:
+                ++stats_.unconfirmed;
+                break;
+        }
+    }
+
+    TriggerDispatcherConfig config_;
+    std::shared_ptr<common::IClock> clock_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable idle_;
+    std::thread thread_;
+    bool running_ = false;
+    bool busy_ = false;
+
+    std::vector<Pending> queue_;
+    size_t head_ = 0;
+    size_t count_ = 0;
+    uint64_t nextId_ = 1;
+    bool hasAccepted_ = false;
+    common::Timestamp lastAccepted_{};
+
+    std::shared_ptr<const std::vector<TriggerRoute>> routes_;
+    TriggerResultCallback resultCallback_;
+    TriggerDispatcherStats stats_;
+};
+
+std::unique_ptr<ITriggerDispatcher> createTriggerDispatcher(const TriggerDispatcherConfig& config) {
+    return std::make_unique<TriggerDispatcherImpl>(config);
+}
+
+} // namespace micmap::core
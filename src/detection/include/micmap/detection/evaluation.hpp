@@ -0,0 +1,152 @@
+#pragma once
+
+/**
+ * @file evaluation.hpp
+ * @brief Offline scoring of detector output against labelled recordings
+ */
+
+#include "noise_detector.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace micmap::detection {
+
+/**
+ * @brief One labelled time span of a recording
+ */
+struct LabelSegment {
+    double startSec = 0.0;      ///< Segment start in seconds
+    double endSec = 0.0;        ///< Segment end in seconds
+    std::string label;          ///< Label text, e.g. "covered", "speech"
+    bool covered = false;       ///< True if the mic is covered (should trigger)
+};
+
+/**
+ * @brief Read an Audacity-style label file
+ * @param path File with one "start<TAB>end<TAB>label" line per segment
+ * @param segments Receives the segments, sorted by start time
+ * @return True if the file was read; false if it is missing or malformed
+ *
+ * A segment counts as covered if its label starts with "covered"
+ * (case-insensitive). Everything outside covered segments is expected not to
+ * trigger.
+ */
+bool loadLabelFile(const std::filesystem::path& path, std::vector<LabelSegment>& segments);
+
+/**
+ * @brief Settings for evaluateRecording()
+ */
+struct EvaluationConfig {
+    int minDurationMs = 300;        ///< Detector minimum detection duration
+    int triggerToleranceMs = 250;   ///< Triggers this long after a covered segment still count
+};
+
+/**
+ * @brief Scores of one recording, or several merged together
+ */
+struct EvaluationResult {
+    double durationSec = 0.0;       ///< Audio replayed
+    double coveredSec = 0.0;        ///< Audio inside covered segments
+
+    // Frame level: one frame per detector hop
+    size_t frames = 0;
+    size_t truePositiveFrames = 0;
+    size_t falsePositiveFrames = 0;
+    size_t falseNegativeFrames = 0;
+
+    // Event level
+    size_t coveredSegments = 0;     ///< Covered segments in the labels
+    size_t detectedSegments = 0;    ///< Covered segments that triggered
+    size_t triggers = 0;            ///< Triggers fired
+    size_t falseTriggers = 0;       ///< Triggers outside every covered segment
+
+    std::vector<double> latenciesMs;    ///< Cover start to trigger, per detected segment
+
+    /**
+     * @brief Fraction of detected frames that were covered (1 if none detected)
+     */
+    double framePrecision() const;
+
+    /**
+     * @brief Fraction of covered frames that were detected (1 if none covered)
+     */
+    double frameRecall() const;
+
+    /**
+     * @brief Fraction of triggers that hit a covered segment (1 if none fired)
+     */
+    double eventPrecision() const;
+
+    /**
+     * @brief Fraction of covered segments that triggered (1 if none labelled)
+     */
+    double eventRecall() const;
+
+    /**
+     * @brief False triggers per hour of uncovered audio
+     */
+    double falseTriggersPerHour() const;
+
+    /**
+     * @brief Add another result's counts and latencies to this one
+     */
+    void merge(const EvaluationResult& other);
+};
+
+/**
+ * @brief Replay a recording through a detector and score it
+ * @param detector Detector with training data loaded and its default
+ *                 sample clock; its temporal state should be fresh. Its
+ *                 minimum detection duration is set to config.minDurationMs.
+ * @param hopSize Detector hop size in samples
+ * @param samples Mono samples at the detector's sample rate
+ * @param count Number of samples
+ * @param sampleRate Sample rate in Hz
+ * @param labels Label segments of the recording (empty: nothing is covered)
+ * @param config Evaluation settings
+ * @return Scores of the recording
+ *
+ * A frame counts as covered if the middle of its newest hop lies in a
+ * covered segment. A trigger fires once per detection run, on the first frame
+ * the detector confirms as white noise, as the application does.
+ */
+EvaluationResult evaluateRecording(INoiseDetector& detector, size_t hopSize,
+                                   const float* samples, size_t count, uint32_t sampleRate,
+                                   const std::vector<LabelSegment>& labels,
+                                   const EvaluationConfig& config = EvaluationConfig{});
+
+/**
+ * @brief Replay a multi-channel recording through a detector and score it
+ * @param detector Detector configured for channelCount channels, prepared
+ *                 as for the mono overload
+ * @param hopSize Detector hop size in samples
+ * @param channels One pointer per channel to count samples
+ * @param channelCount Number of channels
+ * @param count Number of samples per channel
+ * @param sampleRate Sample rate in Hz
+ * @param labels Label segments of the recording (empty: nothing is covered)
+ * @param config Evaluation settings
+ * @return Scores of the recording
+ *
+ * Frames are fed through INoiseDetector::analyzeChannelsInto() and scored
+ * as by the mono overload.
+ */
+EvaluationResult evaluateRecording(INoiseDetector& detector, size_t hopSize,
+                                   const float* const* channels, size_t channelCount,
+                                   size_t count, uint32_t sampleRate,
+                                   const std::vector<LabelSegment>& labels,
+                                   const EvaluationConfig& config = EvaluationConfig{});
+
+/**
+ * @brief Percentile of a set of values by linear interpolation
+ * @param values Values (copied and sorted internally)
+ * @param percentile Percentile in [0, 100]
+ * @return The percentile, or 0 for an empty set
+ */
+double percentileOf(std::vector<double> values, double percentile);
+
+} // namespace micmap::detection
@@ -0,0 +1,87 @@
+#pragma once
+
+/**
+ * @file fft_backend.hpp
+ * @brief Pluggable real-input FFT engines used by the spectral analyzer
+ */
+
+#include "micmap/common/cpu_features.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+
+namespace micmap::detection {
+
+/**
+ * @brief Available FFT engines
+ */
+enum class FFTBackendType {
+    Auto,       ///< Fastest engine available (currently Radix4)
+    KissFFT,    ///< KissFFT kiss_fftr
+    Radix4      ///< In-tree radix-4 real FFT with SIMD butterflies
+};
+
+/**
+ * @brief Convert FFTBackendType to its configuration string
+ */
+inline const char* fftBackendTypeToString(FFTBackendType type) {
+    switch (type) {
+        case FFTBackendType::Auto: return "auto";
+        case FFTBackendType::KissFFT: return "kissfft";
+        case FFTBackendType::Radix4: return "radix4";
+        default: return "unknown";
+    }
+}
+
+/**
+ * @brief Parse a configuration string ("auto", "kissfft", "radix4")
+ * @param name Backend name
+ * @param type Receives the parsed type on success
+ * @return True if the name was recognized
+ */
+bool parseFFTBackendType(std::string_view name, FFTBackendType& type);
+
+/**
+ * @brief Interface for a forward real-to-complex FFT of fixed size
+ */
+class IFFTBackend {
+public:
+    virtual ~IFFTBackend() = default;
+
+    /**
+     * @brief Compute the forward FFT of one frame
+     * @param input getSize() real samples
+     * @param window Optional getSize() window coefficients multiplied into the
+     *               input before the transform (nullptr for none)
+     * @param output getSize() / 2 + 1 complex bins as interleaved (re, im)
+     *               float pairs, unnormalized
+     *
+     * Does not allocate.
+     */
+    virtual void forward(const float* input, const float* window, float* output) = 0;
+
+    /**
+     * @brief Get the transform size in samples
+     */
+    virtual size_t getSize() const = 0;
+
+    /**
+     * @brief Get the engine implementing this backend (never Auto)
+     */
+    virtual FFTBackendType getType() const = 0;
+};
+
+/**
+ * @brief Create an FFT backend
+ * @param type Engine to use; Auto selects the fastest
+ * @param size Transform size (must be a power of 2)
+ * @param level Highest SIMD level the engine may use; lower levels are used
+ *              if the CPU or build does not support it
+ * @return Unique pointer to the backend
+ * @throws std::invalid_argument if size is not a power of 2
+ */
+std::unique_ptr<IFFTBackend> createFFTBackend(FFTBackendType type, size_t size,
+                                              common::SimdLevel level = common::detectSimdLevel());
+
+} // namespace micmap::detection
@@ -0,0 +1,127 @@
+#pragma once
+
+/**
+ * @file filterbank.hpp
+ * @brief Mel/ERB band filterbank that reduces a magnitude spectrum to a few bands
+ *
+ * A finger over the microphone changes the broad shape of the spectrum, not
+ * its fine detail. Summarizing the FFT bins in a few perceptual bands keeps
+ * that shape while making profiles and per-frame matching much smaller.
+ */
+
+#include "spectral_features.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace micmap::detection {
+
+/**
+ * @brief Frequency scale on which the band edges are spaced evenly
+ */
+enum class FilterbankScale {
+    Mel,    ///< 2595 * log10(1 + f / 700)
+    ERB     ///< ERB-rate: 21.4 * log10(1 + 0.00437 * f)
+};
+
+/**
+ * @brief Parse a scale name ("mel" or "erb")
+ * @param name Name as used in config files and on the command line
+ * @param scale Receives the scale if the name is known
+ * @return True if the name was recognized
+ */
+bool parseFilterbankScale(std::string_view name, FilterbankScale& scale);
+
+/**
+ * @brief Layout of the band filterbank
+ *
+ * Bands are triangular and overlap their neighbours by half. Each band is
+ * normalized to unit weight, so its value is a weighted mean magnitude.
+ */
+struct FilterbankConfig {
+    bool enabled = false;                       ///< Match in band space instead of FFT bins
+    FilterbankScale scale = FilterbankScale::Mel;
+    size_t bands = 32;                          ///< Number of bands (>= 1)
+    float minFrequency = 50.0f;                 ///< Lower edge of the first band in Hz
+    float maxFrequency = 16000.0f;              ///< Upper edge of the last band in Hz (clamped to Nyquist)
+};
+
+/**
+ * @brief Sparse band filterbank over the bins of one FFT size
+ *
+ * Every band covers a contiguous run of bins, so applying the filterbank is
+ * a sparse matrix-vector product: one short dot product per band, computed
+ * with the spectral feature kernels.
+ */
+class Filterbank {
+public:
+    /**
+     * @param config Band layout; enabled is ignored
+     * @param sampleRate Audio sample rate in Hz
+     * @param fftSize FFT size the magnitude spectra come from
+     * @param level Kernel level for the band sums
+     * @throws std::invalid_argument for zero bands, a zero FFT size or sample
+     *         rate, or an empty frequency range
+     */
+    Filterbank(const FilterbankConfig& config, uint32_t sampleRate, size_t fftSize,
+               common::SimdLevel level = getSpectralFeatureSimdLevel());
+
+    /**
+     * @brief Reduce a magnitude spectrum to band values
+     * @param magnitudes fftSize / 2 + 1 magnitudes
+     * @param bands getNumBands() outputs
+     */
+    void apply(const float* magnitudes, float* bands) const;
+
+    size_t getNumBands() const { return ranges_.size(); }
+    FilterbankScale getScale() const { return scale_; }
+
+    /**
+     * @brief Lower edge of the first band in Hz
+     */
+    float getMinFrequency() const { return minFrequency_; }
+
+    /**
+     * @brief Upper edge of the last band in Hz, after clamping to Nyquist
+     */
+    float getMaxFrequency() const { return maxFrequency_; }
+
+    /**
+     * @brief Centre frequency of a band in Hz
+     */
+    float getCenterFrequency(size_t band) const;
+
+    /**
+     * @brief Number of filter weights, i.e. the multiply-adds per apply()
+     */
+    size_t getNumWeights() const { return weights_.size(); }
+
+    /**
+     * @brief Convert a frequency in Hz to the scale
+     */
+    static float toScale(FilterbankScale scale, float frequency);
+
+    /**
+     * @brief Convert a scale value back to Hz
+     */
+    static float fromScale(FilterbankScale scale, float value);
+
+private:
+    struct BandRange {
+        size_t firstBin;    // First bin with a non-zero weight
+        size_t offset;      // Index of its weight in weights_
+        size_t count;       // Consecutive bins in the band
+    };
+
+    const SpectralFeatureKernels& kernels_;
+    FilterbankScale scale_;
+    float minFrequency_;
+    float maxFrequency_;
+    std::vector<BandRange> ranges_;
+    std::vector<float> weights_;
+    std::vector<float> centers_;
+};
+
+} // namespace micmap::detection
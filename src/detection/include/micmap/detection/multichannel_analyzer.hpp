@@ -0,0 +1,112 @@
+#pragma once
+
+/**
+ * @file multichannel_analyzer.hpp
+ * @brief Per-channel spectra and inter-channel coherence of one STFT frame
+ *
+ * Headsets with two or more mics deliver them as separate channels. Mixing
+ * them to mono dilutes a single covered mic with the others, and loses the
+ * most telling cue: a covered mic stops hearing what the others hear.
+ */
+
+#include "spectral_analyzer.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace micmap::detection {
+
+/**
+ * @brief Band and smoothing of the inter-channel coherence
+ *
+ * Two mics a few centimetres apart hear room sound and any source in the
+ * room coherently at low and mid frequencies. Noise made at one mic, such
+ * as a hand covering it, is only heard by that mic, so the coherence of the
+ * pair drops.
+ */
+struct CoherenceConfig {
+    float minFrequency = 100.0f;    ///< Lower edge of the measured band in Hz
+    float maxFrequency = 2000.0f;   ///< Upper edge of the measured band in Hz
+    float smoothing = 0.7f;         ///< Weight of the previous spectra per frame, in [0, 1)
+};
+
+/**
+ * @brief Spectra of several channels' frames plus their mean coherence
+ *
+ * All channels go through one FFT plan and one window. Their transforms are
+ * laid out back to back, so the magnitudes of every channel are computed by
+ * one kernel pass, and each channel's spectrum equals what the FFT spectral
+ * analyzer returns for that channel alone. For every pair of channels the
+ * auto- and cross-spectra over the coherence band are smoothed across
+ * frames with the coherence() feature kernel.
+ */
+class MultiChannelAnalyzer {
+public:
+    /**
+     * @param sampleRate Audio sample rate in Hz
+     * @param fftSize Frame length in samples (power of 2)
+     * @param channels Number of channels (>= 1)
+     * @param coherence Coherence band and smoothing
+     * @param backend FFT engine shared by the channels
+     * @param level Kernel level for the magnitudes, features and coherence
+     * @throws std::invalid_argument if channels is zero, the band holds no
+     *         bin or the smoothing is outside [0, 1)
+     */
+    MultiChannelAnalyzer(uint32_t sampleRate, size_t fftSize, size_t channels,
+                         const CoherenceConfig& coherence = CoherenceConfig{},
+                         FFTBackendType backend = FFTBackendType::Auto,
+                         common::SimdLevel level = getSpectralFeatureSimdLevel());
+
+    /**
+     * @brief Analyze the same frame of every channel
+     * @param frames One pointer per channel to fftSize samples
+     * @param magnitudes getChannels() * getNumBins() floats, channel after
+     *                   channel, or null
+     * @param features getChannels() entries, or null
+     * @return Mean coherence over all channel pairs after this frame, in
+     *         [0, 1]; 1 with a single channel
+     *
+     * Does not allocate.
+     */
+    float analyzeInto(const float* const* frames, float* magnitudes, SpectralFeatures* features);
+
+    /**
+     * @brief Forget the smoothed spectra
+     */
+    void reset();
+
+    /**
+     * @brief Coherence returned by the latest analyzeInto()
+     */
+    float getCoherence() const { return coherence_; }
+
+    size_t getChannels() const { return channels_; }
+    size_t getFFTSize() const { return fftSize_; }
+    size_t getNumBins() const { return numBins_; }
+
+    /**
+     * @brief Bins the coherence is measured over
+     */
+    size_t getCoherenceBins() const { return bandBins_; }
+
+private:
+    const SpectralFeatureKernels& kernels_;
+    size_t fftSize_;
+    size_t numBins_;
+    size_t channels_;
+    float resolution_;
+    float decay_;
+    size_t bandStart_ = 0;
+    size_t bandBins_ = 0;
+    float coherence_ = 1.0f;
+
+    std::unique_ptr<IFFTBackend> fft_;
+    std::vector<float> window_;
+    std::vector<float> transforms_;     // channels_ * 2 * numBins_ interleaved bins
+    std::vector<float> magnitudes_;     // Scratch when the caller passes none
+    std::vector<float> pairState_;      // 4 * bandBins_ per channel pair
+};
+
+} // namespace micmap::detection
@@ -6,6 +6,10 @@
  */
 
 #include "spectral_analyzer.hpp"
+#include "spectral_features.hpp"
+#include "filterbank.hpp"
+#include "multichannel_analyzer.hpp"
+#include "micmap/common/types.hpp"
 
 #include <memory>
 #include <filesystem>
@@ -18,7 +22,9 @@ namespace micmap::detection {
  * @brief Training data for white noise detection
  */
 struct TrainingData {
-    std::vector<float> spectralProfile;     ///< Average magnitude spectrum
+    std::vector<float> spectralProfile;     ///< Average magnitude spectrum (per band with a filterbank)
+    std::vector<float> logMean;             ///< Per-bin mean of log magnitudes (empty for v1 profiles)
+    std::vector<float> logVariance;         ///< Per-bin variance of log magnitudes (empty for v1 profiles)
     float energyThreshold;                   ///< Minimum energy level
     float correlationThreshold;              ///< Minimum correlation for match
     uint32_t sampleRate;                     ///< Audio sample rate
@@ -34,6 +40,134 @@ struct DetectionResult {
     float spectralFlatness; ///< Spectral flatness measure
     float correlation;      ///< Correlation with trained profile
     bool isWhiteNoise;      ///< True if above detection threshold
+    float coherence;        ///< Mean inter-channel coherence (1 for a single channel)
+};
+
+/**
+ * @brief Decision thresholds of the spike-gated detector
+ *
+ * Detection starts when a spike has armed the gate and at least startHits of
+ * the frames in the last hitWindowMs had confidence >= highConfidence. It
+ * continues while at least stopHits of them do. Windows are converted to
+ * whole hops; the defaults are 12 and 10 hops of 512 samples at 48 kHz.
+ *
+ * With several channels, the channels decorrelating while the loudest one
+ * is in a profile's trained energy range arms the gate as a spike does: a
+ * covered mic stops hearing the room the other mics hear, even when the
+ * cover is too gentle to spike.
+ */
+struct DetectionThresholds {
+    static constexpr int MAX_HIT_FRAMES = 64;   ///< Longest hit window in frames
+    
+    float highConfidence = 0.60f;       ///< Confidence counted as a hit
+    int startHits = 4;                  ///< Hits needed to start detecting
+    int stopHits = 2;                   ///< Hits needed to keep detecting
+    float spikeThresholdDb = -10.0f;    ///< Hop energy that arms the spike gate
+    int spikeWindowMs = 500;            ///< How long a spike keeps the gate armed
+    float decorrelationThreshold = 0.3f;    ///< Inter-channel coherence that arms the gate
+    int hitWindowMs = 128;              ///< Frames counted for start/stopHits, up to MAX_HIT_FRAMES
+    int energyWindowMs = 107;           ///< Hop energies the energy consistency is measured over
+};
+
+/**
+ * @brief Energy-gated analysis cascade
+ *
+ * The hop energy of every frame is measured first. While no spike has armed
+ * the gate and nothing is being detected, detection cannot start. The FFT
+ * and profile match are then skipped for frames whose energy is outside the
+ * trained range or whose energy terms alone rule out a high-confidence hit;
+ * those frames count as misses. Other idle frames are analysed every
+ * idleInterval frames and reuse the last profile match in between.
+ */
+struct CascadeConfig {
+    bool enabled = false;   ///< Run the cascade instead of analysing every frame
+    int idleInterval = 4;   ///< Frames per full analysis while idle (>= 1)
+};
+
+/**
+ * @brief Sparse-bin monitoring of idle frames
+ *
+ * While no spike has armed the gate and nothing is being detected, frames
+ * are matched on a few of the profile's most discriminative bins, tracked
+ * by a SlidingDFTAnalyzer, instead of running the FFT and the full profile
+ * match. The gate and any detection still use the full spectrum. Runs
+ * after the cascade's energy gate when both are enabled.
+ */
+struct MonitorConfig {
+    bool enabled = false;   ///< Match idle frames on sparse bins
+    size_t bins = 16;       ///< Bins tracked (>= 1), picked from the first profile
+};
+
+/**
+ * @brief Frames handled by each stage of the analysis cascade
+ *
+ * Every frame is counted in exactly one stage. Without the cascade and
+ * monitoring all frames are analysed.
+ */
+struct CascadeStats {
+    uint64_t frames = 0;        ///< Frames processed
+    uint64_t energyOnly = 0;    ///< Ruled out by the energy gate alone
+    uint64_t reused = 0;        ///< Idle frames that reused the last profile match
+    uint64_t monitored = 0;     ///< Idle frames matched on the sparse monitor bins
+    uint64_t analyzed = 0;      ///< Frames that ran the FFT and profile match
+};
+
+/**
+ * @brief How a frame's spectrum is matched against the trained profile
+ */
+enum class ProfileMatch {
+    Auto,           ///< Mahalanobis when the profile has per-bin variances, else Correlation
+    Correlation,    ///< Pearson correlation combined with the log-shape error
+    Mahalanobis     ///< Variance-weighted log-spectrum distance (diagonal covariance)
+};
+
+/**
+ * @brief Configuration for the FFT-based noise detector
+ */
+struct NoiseDetectorConfig {
+    uint32_t sampleRate = 48000;    ///< Audio sample rate in Hz
+    size_t fftSize = 2048;          ///< Analysis window length (power of 2)
+    size_t hopSize = 512;           ///< Samples between analysis frames (<= fftSize)
+    
+    /// Spectral feature kernel level; Scalar selects the exact libm reference
+    common::SimdLevel featureLevel = getSpectralFeatureSimdLevel();
+    
+    /// FFT engine used for every analysis frame
+    FFTBackendType fftBackend = FFTBackendType::Auto;
+    
+    /// Decision thresholds; hit counts must be within [1, frames in hitWindowMs]
+    DetectionThresholds thresholds;
+    
+    /// Time source for the spike window and detection duration. When null
+    /// the detector keeps its own SampleClock, advanced by hopSize per
+    /// analysis frame, so decisions depend only on the audio fed in. A
+    /// shared clock must be advanced by its owner.
+    std::shared_ptr<common::IClock> clock;
+    
+    /// FFT skipping while detection cannot start; off analyses every frame
+    CascadeConfig cascade;
+    
+    /// Sparse-bin matching while idle; needs hopSize to divide fftSize and
+    /// cannot be combined with a filterbank
+    MonitorConfig monitor;
+    
+    /// Profile matching; Mahalanobis needs a profile trained with variances
+    ProfileMatch profileMatch = ProfileMatch::Auto;
+    
+    /// Train and match profiles on mel/ERB bands instead of FFT bins. Band
+    /// profiles only load into a detector with the same band layout
+    FilterbankConfig filterbank;
+    
+    /// Mic channels fed to analyzeChannelsInto() and addTrainingChannels(),
+    /// at most MAX_CHANNELS. Every multi-channel frame is analysed in full,
+    /// so more than one channel cannot be combined with the cascade or
+    /// monitoring. analyze() and analyzeInto() still take mono audio
+    size_t channels = 1;
+    
+    /// Inter-channel coherence measured with more than one channel
+    CoherenceConfig coherence;
+    
+    static constexpr size_t MAX_CHANNELS = 8;   ///< Most channels analysed separately
 };
 
 /**
@@ -52,11 +186,25 @@ public:
     
     /**
      * @brief Add training samples
-     * @param samples Audio samples
+     * @param samples Audio samples (any packet size)
      * @param count Number of samples
+     *
+     * Samples are framed with the same window and hop as analyze(), so each
+     * completed frame contributes one training spectrum.
      */
     virtual void addTrainingSample(const float* samples, size_t count) = 0;
     
+    /**
+     * @brief Add training samples of every mic channel
+     * @param channels One pointer per configured channel to count samples
+     * @param count Number of samples per channel
+     *
+     * Channels are framed in lockstep. Each completed frame contributes the
+     * spectrum of its loudest channel, i.e. the covered mic, so the profile
+     * matches one covered mic rather than a mix of covered and open ones.
+     */
+    virtual void addTrainingChannels(const float* const* channels, size_t count) = 0;
+    
     /**
      * @brief Finish training and compute profile
      * @return True if training was successful
@@ -73,18 +221,58 @@ public:
     
     /**
      * @brief Analyze audio samples for white noise
-     * @param samples Audio samples
+     * @param samples Audio samples (any packet size)
      * @param count Number of samples
-     * @return Detection result
+     * @return Result of the most recent analysis frame
+     *
+     * Samples are buffered internally and analyzed in overlapping frames of
+     * fftSize samples every hopSize samples. If the packet does not complete
+     * a frame, the previous frame's result is returned.
      */
     virtual DetectionResult analyze(const float* samples, size_t count) = 0;
     
+    /**
+     * @brief Analyze audio samples and report every completed frame
+     * @param samples Audio samples (any packet size)
+     * @param count Number of samples
+     * @param results Caller-owned array receiving one result per frame
+     * @param maxResults Capacity of results; further frames are still
+     *                   analyzed but not reported
+     * @return Number of results written
+     *
+     * Equivalent to analyze() but does not allocate once the detector has
+     * warmed up, and exposes each hop's result instead of only the last.
+     * A packet of count samples completes at most count / hopSize + 1 frames.
+     */
+    virtual size_t analyzeInto(const float* samples, size_t count,
+                               DetectionResult* results, size_t maxResults) = 0;
+    
+    /**
+     * @brief Analyze every mic channel and report every completed frame
+     * @param channels One pointer per configured channel to count samples
+     * @param count Number of samples per channel
+     * @param results Caller-owned array receiving one result per frame
+     * @param maxResults Capacity of results
+     * @return Number of results written
+     *
+     * Like analyzeInto(), but without a downmix: the channels share one FFT
+     * plan, the frame is scored on the loudest channel's hop energy and
+     * spectrum, and the channels' coherence is reported and can arm the
+     * gate (see DetectionThresholds). With one configured channel this is
+     * analyzeInto() on channels[0]. Does not allocate once warmed up.
+     */
+    virtual size_t analyzeChannelsInto(const float* const* channels, size_t count,
+                                       DetectionResult* results, size_t maxResults) = 0;
+    
     // Persistence
     
     /**
      * @brief Save training data to file
      * @param path File path
      * @return True if save was successful
+     *
+     * Saves the first profile, which is the one finishTraining() or
+     * loadTrainingData() produced.
      */
     virtual bool saveTrainingData(const std::filesystem::path& path) = 0;
     
@@ -92,9 +280,37 @@ public:
      * @brief Load training data from file
      * @param path File path
      * @return True if load was successful
+     *
+     * Replaces all stored profiles with the loaded one, as finishTraining()
+     * does with the trained one. Fails for a profile trained at another
+     * sample rate or FFT size, or with another band layout.
      */
     virtual bool loadTrainingData(const std::filesystem::path& path) = 0;
     
+    /**
+     * @brief Load another profile to match alongside the stored ones
+     * @param path File written by saveTrainingData()
+     * @return True if the profile was added
+     *
+     * Profiles for several users, devices or grips can be stored at once.
+     * Each frame is matched against all of them and scored with the best
+     * match's thresholds. The profile must load as in loadTrainingData(),
+     * and with no profile stored this is loadTrainingData().
+     */
+    virtual bool addTrainingData(const std::filesystem::path& path) = 0;
+    
+    /**
+     * @brief Get the number of stored profiles
+     */
+    virtual size_t getProfileCount() const = 0;
+    
+    /**
+     * @brief Get the profile that scored the latest analysed frame
+     * @return Index in the order the profiles were stored, or -1 before the
+     *         first frame with training data
+     */
+    virtual int getActiveProfile() const = 0;
+    
     /**
      * @brief Check if training data is loaded
      * @return True if training data is available
@@ -133,13 +349,46 @@ public:
     
     /**
      * @brief Get the training data
-     * @return Current training data
+     * @return The first stored profile, or empty data before training
      */
     virtual const TrainingData& getTrainingData() const = 0;
+    
+    /**
+     * @brief Get the number of frames each cascade stage has handled
+     * @return Counts since the detector was created
+     */
+    virtual CascadeStats getCascadeStats() const = 0;
+    
+    /**
+     * @brief Get the profile matching in effect for the current training data
+     * @return Correlation or Mahalanobis; Auto is resolved against the profile
+     */
+    virtual ProfileMatch getProfileMatch() const = 0;
 };
 
+/**
+ * @brief Most frames one analyzeInto() or analyzeChannelsInto() call completes
+ * @param count Samples (per channel) passed in the call
+ * @param hopSize The detector's hop size
+ *
+ * A result array this large always receives the newest frame.
+ */
+inline size_t maxFramesPerCall(size_t count, size_t hopSize) {
+    return hopSize > 0 ? count / hopSize + 1 : 1;
+}
+
 /**
  * @brief Create an FFT-based noise detector
+ * @param config Detector configuration
+ * @return Unique pointer to noise detector
+ * @throws std::invalid_argument if the sizes, thresholds, cascade
+ *         interval, enabled filterbank or monitor, channel count or
+ *         coherence band are invalid
+ */
+std::unique_ptr<INoiseDetector> createFFTDetector(const NoiseDetectorConfig& config);
+
+/**
+ * @brief Create an FFT-based noise detector with a hop of fftSize / 4
  * @param sampleRate Audio sample rate in Hz
  * @param fftSize FFT window size
  * @return Unique pointer to noise detector
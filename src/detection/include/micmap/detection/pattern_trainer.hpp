@@ -6,6 +6,7 @@
  */
 
 #include "spectral_analyzer.hpp"
+#include "micmap/common/types.hpp"
 
 #include <vector>
 #include <memory>
@@ -28,6 +29,11 @@ struct TrainingConfig {
     float minEnergy = 0.01f;                ///< Minimum energy threshold for valid sample
     float maxEnergy = 1.0f;                 ///< Maximum energy threshold
     std::chrono::milliseconds sampleInterval{100};  ///< Interval between samples
+    
+    /// Time source for sampleInterval and the session duration. When null
+    /// the trainer counts the samples passed to addSample() at the
+    /// analyzer's sample rate.
+    std::shared_ptr<common::IClock> clock;
 };
 
 /**
@@ -101,6 +107,12 @@ public:
      */
     const std::vector<float>& getSpectralProfile() const;
     
+    /**
+     * @brief Get the per-bin variance of the accepted spectra
+     * @return Variance of each magnitude bin (before profile normalization)
+     */
+    const std::vector<float>& getSpectralVariance() const;
+    
     /**
      * @brief Get the computed energy threshold
      * @return Energy threshold
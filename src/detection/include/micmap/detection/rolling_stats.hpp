@@ -0,0 +1,114 @@
+#pragma once
+
+/**
+ * @file rolling_stats.hpp
+ * @brief Constant-time statistics over the most recent detection frames
+ *
+ * The detector keeps the hop energies and high-confidence hits of the last
+ * few hundred milliseconds. These windows update in O(1) per frame, so
+ * their length is a tuning choice rather than a per-frame cost.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace micmap::detection {
+
+/**
+ * @brief Mean and variance of the last capacity() values
+ *
+ * Keeps the values in a ring and a running sum and sum of squares in
+ * double precision. Adding a value replaces the oldest once the window is
+ * full. The sums are recomputed from the ring once per lap, so rounding
+ * error cannot build up over a long stream, and when the dropped value
+ * dominated them, as after a loud spike, so the error it leaves does not
+ * swamp the quieter values that remain.
+ */
+class RollingStats {
+public:
+    /**
+     * @param capacity Values in the window (at least 1)
+     */
+    explicit RollingStats(size_t capacity = 1);
+
+    /**
+     * @brief Add one value, dropping the oldest when full
+     */
+    void add(float value);
+
+    /**
+     * @brief Forget all values, keeping the capacity
+     */
+    void reset();
+
+    size_t capacity() const { return values_.size(); }
+
+    /**
+     * @brief Values in the window, at most capacity()
+     */
+    size_t count() const { return count_; }
+
+    /**
+     * @brief Mean of the window, or 0 if it is empty
+     */
+    double mean() const;
+
+    /**
+     * @brief Population variance of the window, or 0 if it is empty
+     */
+    double variance() const;
+
+private:
+    /// Dropped square that recomputes the sums, relative to the rest
+    static constexpr double CANCELLATION_RATIO = 1e4;
+
+    void recompute();
+
+    std::vector<float> values_;
+    size_t next_ = 0;
+    size_t count_ = 0;
+    double sum_ = 0.0;
+    double sumSquares_ = 0.0;
+};
+
+/**
+ * @brief Number of hits among the last length() frames
+ *
+ * A 64-bit shift register: each frame shifts in one bit and the count is a
+ * population count, whatever the window length.
+ */
+class HitWindow {
+public:
+    /// Longest window in frames
+    static constexpr size_t MAX_LENGTH = 64;
+
+    /**
+     * @param length Frames in the window, clamped to [1, MAX_LENGTH]
+     */
+    explicit HitWindow(size_t length = MAX_LENGTH);
+
+    /**
+     * @brief Record the newest frame, dropping the oldest
+     */
+    void push(bool hit) { bits_ = ((bits_ << 1) | (hit ? 1u : 0u)) & mask_; }
+
+    /**
+     * @brief Forget all frames; they count as misses
+     */
+    void reset() { bits_ = 0; }
+
+    size_t length() const { return length_; }
+
+    /**
+     * @brief Hits among the last length() frames
+     */
+    int count() const;
+
+private:
+    size_t length_;
+    uint64_t mask_;
+    uint64_t bits_ = 0;
+};
+
+} // namespace micmap::detection
@@ -0,0 +1,120 @@
+#pragma once
+
+/**
+ * @file sliding_dft.hpp
+ * @brief Sparse-bin spectral analyzer updated once per hop
+ *
+ * Idle monitoring only needs a few discriminative frequencies. This
+ * analyzer tracks a chosen set of FFT bins across consecutive STFT frames
+ * for a fraction of the cost of a full transform.
+ */
+
+#include "spectral_analyzer.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace micmap::detection {
+
+/**
+ * @brief Sliding DFT over a sparse set of bins, same scale as the FFT analyzer
+ *
+ * Each frame is hopSize samples after the previous one. Only the newest hop
+ * is transformed: one partial DFT per tracked bin, computed with dotRows()
+ * over a precomputed basis. The partials of the last fftSize / hopSize hops
+ * are kept in a ring and recombined with fixed phase rotations, so the
+ * result does not drift however long the analyzer runs. The Hann window is
+ * applied in the frequency domain from the neighbouring bins, which are
+ * tracked as well.
+ *
+ * analyzeInto() therefore expects consecutive frames, as StreamingSTFT
+ * emits them. After reset() the next frame is transformed in full.
+ *
+ * Magnitudes match the FFT analyzer's up to its symmetric rather than
+ * periodic window. Bins that are not tracked are reported as zero, and the
+ * flatness and centroid cover the tracked bins only.
+ */
+class SlidingDFTAnalyzer : public ISpectralAnalyzer {
+public:
+    /**
+     * @param sampleRate Audio sample rate in Hz
+     * @param fftSize Frame length in samples
+     * @param hopSize Samples between consecutive frames; must divide fftSize
+     * @param bins Bins to track, each within [1, fftSize / 2 - 1]
+     * @param level Kernel level for the partial DFTs and features
+     * @throws std::invalid_argument if the sizes or bins are invalid
+     */
+    SlidingDFTAnalyzer(uint32_t sampleRate, size_t fftSize, size_t hopSize,
+                       const std::vector<size_t>& bins,
+                       common::SimdLevel level = getSpectralFeatureSimdLevel());
+
+    SpectralResult analyze(const float* samples, size_t count) override;
+    SpectralFeatures analyzeInto(const float* samples, size_t count,
+                                 float* magnitudes, size_t magnitudeCount) override;
+
+    /**
+     * @brief Magnitudes of the tracked bins from the latest frame
+     * @param output getBins().size() values in the order of getBins()
+     *
+     * Cheaper than reading them out of a full-size spectrum.
+     */
+    void getBinMagnitudes(float* output) const;
+
+    /**
+     * @brief Forget past hops; the next frame is transformed in full
+     */
+    void reset();
+
+    /**
+     * @brief Tracked bins in ascending order
+     */
+    const std::vector<size_t>& getBins() const { return bins_; }
+
+    size_t getHopSize() const { return hopSize_; }
+    size_t getFFTSize() const override { return fftSize_; }
+    size_t getNumBins() const override { return fftSize_ / 2 + 1; }
+    uint32_t getSampleRate() const override { return sampleRate_; }
+    float getFrequencyResolution() const override;
+    float binToFrequency(size_t bin) const override;
+    size_t frequencyToBin(float frequency) const override;
+
+private:
+    void transformHop(const float* hop, float* partial) const;
+    const float* selectFrame(const float* samples, size_t count);
+
+    const SpectralFeatureKernels& kernels_;
+    uint32_t sampleRate_;
+    size_t fftSize_;
+    size_t hopSize_;
+    size_t hops_;                       // Hops per frame, the ring length
+    std::vector<size_t> bins_;
+    std::vector<size_t> tracked_;       // bins_ and their neighbours, ascending
+    std::vector<size_t> lower_;         // Index in tracked_ of bin - 1, bin, bin + 1
+    std::vector<float> basis_;          // cos and -sin rows of hopSize per tracked bin
+    std::vector<float> rotation_;       // (re, im) per hop age and tracked bin
+    std::vector<float> ring_;           // (re, im) partial per hop and tracked bin
+    size_t oldest_ = 0;                 // Ring slot of the oldest hop
+    bool primed_ = false;
+    std::vector<float> spectrum_;       // (re, im) per tracked bin, scratch
+    std::vector<float> binMagnitudes_;
+    std::vector<float> paddedSamples_;
+};
+
+/**
+ * @brief Pick the bins of a trained log spectrum that best identify it
+ * @param logMean Per-bin mean of the training log magnitudes
+ * @param logVariance Per-bin variance of the same (may be empty)
+ * @param count Bins to pick
+ * @return Up to count bins in [1, logMean.size() - 2], ascending
+ *
+ * A bin scores by how far its log mean lies from the average level, in
+ * units of its training standard deviation. The highest-scoring bins are
+ * taken alternately from above and below the average so that the shape is
+ * kept, at least two bins apart.
+ */
+std::vector<size_t> selectDiscriminativeBins(const std::vector<float>& logMean,
+                                             const std::vector<float>& logVariance,
+                                             size_t count);
+
+} // namespace micmap::detection
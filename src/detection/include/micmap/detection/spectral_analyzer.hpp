@@ -5,6 +5,10 @@
  * @brief FFT-based spectral analysis for audio signals
  */
 
+#include "micmap/common/cpu_features.hpp"
+#include "micmap/detection/fft_backend.hpp"
+#include "micmap/detection/spectral_features.hpp"
+
 #include <vector>
 #include <cstddef>
 #include <memory>
@@ -12,12 +16,20 @@
 
 namespace micmap::detection {
 
+/**
+ * @brief Scalar features of one analysis frame
+ */
+struct SpectralFeatures {
+    float spectralFlatness = 0.0f;      ///< Spectral flatness measure (0-1)
+    float spectralCentroid = 0.0f;      ///< Spectral centroid frequency
+    float energy = 0.0f;                ///< Total signal energy
+};
+
 /**
  * @brief Result of spectral analysis
  */
 struct SpectralResult {
     std::vector<float> magnitudes;      ///< Magnitude spectrum
-    std::vector<float> phases;          ///< Phase spectrum (optional)
     float spectralFlatness;             ///< Spectral flatness measure (0-1)
     float spectralCentroid;             ///< Spectral centroid frequency
     float energy;                       ///< Total signal energy
@@ -38,12 +50,33 @@ public:
      */
     virtual SpectralResult analyze(const float* samples, size_t count) = 0;
     
+    /**
+     * @brief Analyze audio samples into a caller-owned magnitude buffer
+     * @param samples Input audio samples
+     * @param count Number of samples
+     * @param magnitudes Output buffer for the magnitude spectrum
+     * @param magnitudeCount Size of the output buffer; bins beyond it are dropped
+     * @return Scalar features of the frame
+     *
+     * Performs the same analysis as analyze() without allocating, so it can be
+     * called from the real-time detection path. Pass a buffer of getNumBins()
+     * floats to receive the full spectrum.
+     */
+    virtual SpectralFeatures analyzeInto(const float* samples, size_t count,
+                                         float* magnitudes, size_t magnitudeCount) = 0;
+    
     /**
      * @brief Get the FFT size
      * @return FFT size in samples
      */
     virtual size_t getFFTSize() const = 0;
     
+    /**
+     * @brief Get the number of magnitude bins produced per frame
+     * @return fftSize / 2 + 1
+     */
+    virtual size_t getNumBins() const = 0;
+    
     /**
      * @brief Get the sample rate
      * @return Sample rate in Hz
@@ -79,4 +112,26 @@ public:
  */
 std::unique_ptr<ISpectralAnalyzer> createKissFFTAnalyzer(uint32_t sampleRate, size_t fftSize = 2048);
 
+/**
+ * @brief Create a KissFFT-based spectral analyzer with specific feature kernels
+ * @param sampleRate Audio sample rate in Hz
+ * @param fftSize FFT window size (must be power of 2)
+ * @param featureLevel Spectral feature kernel level (see getSpectralFeatureKernels())
+ * @return Unique pointer to spectral analyzer
+ */
+std::unique_ptr<ISpectralAnalyzer> createKissFFTAnalyzer(uint32_t sampleRate, size_t fftSize,
+                                                         common::SimdLevel featureLevel);
+
+/**
+ * @brief Create a spectral analyzer on a specific FFT backend
+ * @param sampleRate Audio sample rate in Hz
+ * @param fftSize FFT window size (must be power of 2)
+ * @param backend FFT engine (FFTBackendType::Auto selects the fastest)
+ * @param featureLevel Spectral feature kernel level; also caps the FFT's SIMD level
+ * @return Unique pointer to spectral analyzer
+ */
+std::unique_ptr<ISpectralAnalyzer> createSpectralAnalyzer(uint32_t sampleRate, size_t fftSize,
+                                                          FFTBackendType backend,
+                                                          common::SimdLevel featureLevel = getSpectralFeatureSimdLevel());
+
 } // namespace micmap::detection
\ No newline at end of file
@@ -0,0 +1,170 @@
+#pragma once
+
+/**
+ * @file spectral_features.hpp
+ * @brief Vectorized per-frame spectral feature kernels
+ *
+ * The spectral analyzer and noise detector compute every per-frame feature
+ * through one of these kernel tables. The best table for the running CPU is
+ * selected at runtime.
+ *
+ * The Scalar table is the exact reference: it uses libm and the same
+ * accumulation precision as the original detector code. The SIMD tables use
+ * a polynomial logarithm (fastLog) and float accumulators, so their results
+ * differ from the reference by a small bounded amount.
+ */
+
+#include "micmap/common/cpu_features.hpp"
+
+#include <cstddef>
+
+namespace micmap::detection {
+
+/**
+ * @brief Feature kernels for one instruction set level
+ */
+struct SpectralFeatureKernels {
+    common::SimdLevel level;    ///< Level these kernels were built for
+
+    /**
+     * @brief Magnitudes of interleaved complex bins
+     *
+     * output[i] = sqrt(re^2 + im^2) * scale, where bins holds count
+     * (re, im) pairs.
+     */
+    void (*magnitudes)(const float* bins, size_t count, float scale, float* output);
+
+    /**
+     * @brief Mean of squares (signal energy) of count samples
+     */
+    float (*meanSquare)(const float* samples, size_t count);
+
+    /**
+     * @brief Spectral flatness: geometric mean / arithmetic mean, clamped to [0, 1]
+     *
+     * Only values above 1e-10 take part. The result is 0 if no value qualifies.
+     */
+    float (*flatness)(const float* magnitudes, size_t count);
+
+    /**
+     * @brief Spectral centroid in bins: sum(i * m[i]) / sum(m[i])
+     *
+     * The result is 0 for an (almost) silent spectrum. Multiply by the
+     * frequency resolution to get Hz.
+     */
+    float (*centroid)(const float* magnitudes, size_t count);
+
+    /**
+     * @brief Pearson correlation against a pre-centered reference
+     * @param values Live values
+     * @param centeredReference Reference minus its mean
+     * @param referenceSumSq Sum of squares of centeredReference
+     * @param count Number of values
+     * @return Correlation in [-1, 1], or 0 if either side has no variance
+     */
+    float (*correlation)(const float* values, const float* centeredReference,
+                         float referenceSumSq, size_t count);
+
+    /**
+     * @brief Mean squared difference of zero-mean log spectra
+     * @param values Live magnitudes (log(x + 1e-10) is taken)
+     * @param centeredLogReference Zero-mean log reference spectrum
+     * @param count Number of bins
+     * @param scratch Caller buffer of count floats for the live log spectrum
+     */
+    float (*logShapeMse)(const float* values, const float* centeredLogReference,
+                         size_t count, float* scratch);
+
+    /**
+     * @brief Variance-weighted log-spectrum distance with the best gain removed
+     * @param values Live magnitudes (log(x + 1e-10) is taken)
+     * @param logMean Per-bin mean of the reference log spectra
+     * @param inverseVariance Per-bin 1 / variance of the reference log spectra
+     * @param inverseVarianceSum Sum of inverseVariance over the count bins
+     * @param count Number of bins
+     * @return Mean over bins of w * (log x - logMean - g)^2, where w is the
+     *         inverse variance and g the weighted mean offset (the level
+     *         difference). About 1 for a spectrum drawn from the reference;
+     *         0 for count == 0 or a non-positive inverseVarianceSum.
+     *
+     * A diagonal-covariance Mahalanobis distance in the log domain. It is
+     * computed in a single pass: with r = log x - logMean, the sums of w*r
+     * and w*r^2 give the fitted offset and the distance together.
+     */
+    float (*logMahalanobis)(const float* values, const float* logMean,
+                            const float* inverseVariance, float inverseVarianceSum,
+                            size_t count);
+
+    /**
+     * @brief Log spectrum: output[i] = log(values[i] + 1e-10)
+     * @return Mean of the output values, or 0 for count == 0
+     */
+    float (*logSpectrum)(const float* values, size_t count, float* output);
+
+    /**
+     * @brief Dot product of every row of a matrix with one vector
+     * @param matrix First row; row r starts at matrix + r * rowStride
+     * @param rows Number of rows
+     * @param rowStride Floats between the starts of consecutive rows
+     * @param vector count values shared by all rows
+     * @param count Values per row taking part
+     * @param output rows results
+     *
+     * Rows are processed in blocks that share each load of the vector, so
+     * matching a spectrum against many stored profiles reads it once per
+     * block instead of once per profile.
+     */
+    void (*dotRows)(const float* matrix, size_t rows, size_t rowStride,
+                    const float* vector, size_t count, float* output);
+
+    /**
+     * @brief Smooth two channels' auto- and cross-spectra and measure their coherence
+     * @param first count interleaved (re, im) bins of one channel
+     * @param second count interleaved (re, im) bins of the other channel
+     * @param count Number of bins
+     * @param decay Weight of the previous estimates, in [0, 1)
+     * @param state 4 * count floats updated in place: the smoothed powers
+     *              of first and second, then the real and imaginary parts
+     *              of their cross-spectrum, count values each
+     * @return Mean over bins of the magnitude-squared coherence
+     *         |Sxy|^2 / (Sxx * Syy), in [0, 1]; 0 for count == 0
+     *
+     * Each estimate becomes decay * previous + (1 - decay) * current. A
+     * single frame is always fully coherent, so the smoothing is what makes
+     * the measure meaningful. Bins where either channel is silent count
+     * as incoherent.
+     */
+    float (*coherence)(const float* first, const float* second, size_t count,
+                       float decay, float* state);
+};
+
+/**
+ * @brief Get the kernels for the best level available on this machine
+ */
+const SpectralFeatureKernels& getSpectralFeatureKernels();
+
+/**
+ * @brief Get the kernels for a specific level
+ *
+ * Falls back to the best available level below @p level if the CPU does not
+ * support it or it was not compiled in. SimdLevel::Scalar always selects the
+ * exact reference kernels.
+ */
+const SpectralFeatureKernels& getSpectralFeatureKernels(common::SimdLevel level);
+
+/**
+ * @brief Get the level getSpectralFeatureKernels() uses on this machine
+ */
+common::SimdLevel getSpectralFeatureSimdLevel();
+
+/**
+ * @brief Polynomial natural logarithm used by the SIMD kernels
+ *
+ * Accepts positive, finite input; values below the smallest normal float
+ * are clamped to it. The absolute error is below 2e-7 for x in [0.5, 2].
+ * Elsewhere the relative error is below 1e-7. The SIMD kernels evaluate
+ * the same polynomial lane by lane.
+ */
+float fastLog(float x);
+
+} // namespace micmap::detection
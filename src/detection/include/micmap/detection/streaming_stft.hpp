@@ -0,0 +1,116 @@
+#pragma once
+
+/**
+ * @file streaming_stft.hpp
+ * @brief Sliding-window STFT front end that decouples analysis from packet size
+ */
+
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include <vector>
+
+namespace micmap::detection {
+
+/**
+ * @brief Streaming short-time Fourier transform framer
+ *
+ * Accepts audio in packets of any size and emits analysis frames of
+ * fftSize samples every hopSize samples, with fftSize - hopSize samples of
+ * overlap between consecutive frames. Frame cadence and per-frame cost
+ * therefore depend only on the configured hop, not on the device period.
+ *
+ * Until fftSize samples have been seen, the oldest part of the window is
+ * zero-filled.
+ */
+class StreamingSTFT {
+public:
+    /**
+     * @brief Construct a framer
+     * @param fftSize Analysis window length in samples
+     * @param hopSize Samples between consecutive frames (clamped to [1, fftSize])
+     */
+    StreamingSTFT(size_t fftSize, size_t hopSize);
+
+    /**
+     * @brief Feed samples and invoke a handler for every completed frame
+     *
+     * The handler is called as handler(const float* frame, const float* hop)
+     * where frame points to fftSize samples (oldest first) and hop points to
+     * the newest hopSize samples inside that frame. Both pointers stay valid
+     * until the next call to process() or reset(); a packet that completes
+     * a frame with its last sample leaves that frame readable afterwards,
+     * which lets several framers be advanced in lockstep.
+     *
+     * @param samples Input audio samples
+     * @param count Number of samples
+     * @param handler Frame handler
+     * @return Number of frames emitted
+     */
+    template <typename FrameHandler>
+    size_t process(const float* samples, size_t count, FrameHandler&& handler) {
+        size_t frames = 0;
+        float* hopStart = window_.data() + (fftSize_ - hopSize_);
+
+        while (count > 0) {
+            if (slidePending_) {
+                // Slide the window; the newest hop is refilled in place
+                std::memmove(window_.data(), window_.data() + hopSize_,
+                             (fftSize_ - hopSize_) * sizeof(float));
+                slidePending_ = false;
+            }
+
+            size_t n = std::min(count, hopSize_ - hopFill_);
+            std::memcpy(hopStart + hopFill_, samples, n * sizeof(float));
+            hopFill_ += n;
+            samples += n;
+            count -= n;
+
+            if (hopFill_ == hopSize_) {
+                handler(static_cast<const float*>(window_.data()),
+                        static_cast<const float*>(hopStart));
+                ++frames;
+                ++totalFrames_;
+                hopFill_ = 0;
+                slidePending_ = true;
+            }
+        }
+
+        return frames;
+    }
+
+    /**
+     * @brief Discard all buffered samples
+     */
+    void reset();
+
+    /**
+     * @brief Get the analysis window length
+     */
+    size_t getFFTSize() const { return fftSize_; }
+
+    /**
+     * @brief Get the hop between frames
+     */
+    size_t getHopSize() const { return hopSize_; }
+
+    /**
+     * @brief Get the number of samples buffered towards the next frame
+     */
+    size_t getPendingSamples() const { return hopFill_; }
+
+    /**
+     * @brief Get the number of frames emitted since construction or reset
+     */
+    size_t getTotalFrames() const { return totalFrames_; }
+
+private:
+    size_t fftSize_;
+    size_t hopSize_;
+    size_t hopFill_ = 0;
+    size_t totalFrames_ = 0;
+    bool slidePending_ = false;     // The last frame is still in place
+    std::vector<float> window_;
+};
+
+} // namespace micmap::detection
@@ -0,0 +1,158 @@
+#pragma once
+
+/**
+ * @file training_stats.hpp
+ * @brief Streaming statistics for training sessions of any length
+ *
+ * Training sees one spectrum and one energy per accepted frame. These
+ * accumulators summarize them in constant memory per statistic, so a long
+ * session costs no more per frame than a short one.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace micmap::detection {
+
+/**
+ * @brief Running count, mean, variance and range of a scalar (Welford)
+ */
+class RunningMoments {
+public:
+    /**
+     * @brief Add one value
+     */
+    void add(double value);
+
+    /**
+     * @brief Forget all values
+     */
+    void reset();
+
+    size_t count() const { return count_; }
+
+    /**
+     * @brief Mean of the values, or 0 if there are none
+     */
+    double mean() const { return mean_; }
+
+    /**
+     * @brief Population variance, or 0 for fewer than two values
+     */
+    double variance() const;
+
+    /**
+     * @brief Population standard deviation
+     */
+    double stdDev() const;
+
+    /**
+     * @brief Smallest value, or 0 if there are none
+     */
+    double min() const { return count_ > 0 ? min_ : 0.0; }
+
+    /**
+     * @brief Largest value, or 0 if there are none
+     */
+    double max() const { return count_ > 0 ? max_ : 0.0; }
+
+private:
+    size_t count_ = 0;
+    double mean_ = 0.0;
+    double m2_ = 0.0;
+    double min_ = 0.0;
+    double max_ = 0.0;
+};
+
+/**
+ * @brief Per-bin running mean and variance of fixed-size spectra (Welford)
+ */
+class SpectrumMoments {
+public:
+    /**
+     * @param bins Values per spectrum
+     */
+    explicit SpectrumMoments(size_t bins = 0);
+
+    /**
+     * @brief Change the number of bins and forget all spectra
+     */
+    void resize(size_t bins);
+
+    /**
+     * @brief Forget all spectra, keeping the number of bins
+     */
+    void reset();
+
+    /**
+     * @brief Add one spectrum of bins() values
+     */
+    void add(const float* spectrum);
+
+    size_t bins() const { return mean_.size(); }
+    size_t count() const { return count_; }
+
+    /**
+     * @brief Per-bin mean of the spectra added so far
+     */
+    const std::vector<double>& mean() const { return mean_; }
+
+    /**
+     * @brief Population variance of one bin, or 0 for fewer than two spectra
+     */
+    double variance(size_t bin) const;
+
+private:
+    size_t count_ = 0;
+    std::vector<double> mean_;
+    std::vector<double> m2_;
+};
+
+/**
+ * @brief Streaming quantile estimate in constant memory (P-square algorithm)
+ *
+ * Implements Jain and Chlamtac's P-square estimator: five markers track the
+ * minimum, the quantile, the maximum and two midpoints, and are adjusted
+ * with piecewise-parabolic interpolation as values arrive. With five values
+ * or fewer the exact quantile is returned.
+ */
+class P2Quantile {
+public:
+    /**
+     * @param quantile Quantile to track, clamped to [0, 1] (0.05 = 5th percentile)
+     */
+    explicit P2Quantile(double quantile = 0.5);
+
+    /**
+     * @brief Add one value
+     */
+    void add(double value);
+
+    /**
+     * @brief Forget all values
+     */
+    void reset();
+
+    size_t count() const { return count_; }
+
+    /**
+     * @brief Current estimate, or 0 if no value was added
+     */
+    double value() const;
+
+private:
+    static constexpr int MARKERS = 5;
+
+    double parabolic(int i, double direction) const;
+    double linear(int i, int direction) const;
+
+    double quantile_;
+    size_t count_ = 0;
+    double heights_[MARKERS] = {};      ///< Marker heights (first values until full)
+    double positions_[MARKERS] = {};    ///< Actual marker positions, 1-based
+    double desired_[MARKERS] = {};      ///< Desired marker positions
+    double increments_[MARKERS] = {};   ///< Desired position step per value
+};
+
+} // namespace micmap::detection
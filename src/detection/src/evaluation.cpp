@@ -0,0 +1,261 @@
+/**
+ * @file evaluation.cpp
+ * @brief Offline scoring of detector output against labelled recordings
+ */
+
+#include "micmap/detection/evaluation.hpp"
+#include "micmap/common/logger.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+namespace micmap::detection {
+
+namespace {
+
+bool startsWithCovered(const std::string& label) {
+    static constexpr char PREFIX[] = "covered";
+    constexpr size_t LENGTH = sizeof(PREFIX) - 1;
+    if (label.size() < LENGTH) {
+        return false;
+    }
+    for (size_t i = 0; i < LENGTH; ++i) {
+        if (std::tolower(static_cast<unsigned char>(label[i])) != PREFIX[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+double ratioOrOne(size_t numerator, size_t denominator) {
+    return denominator == 0 ? 1.0 : static_cast<double>(numerator) / static_cast<double>(denominator);
+}
+
+} // anonymous namespace
+
+bool loadLabelFile(const std::filesystem::path& path, std::vector<LabelSegment>& segments) {
+    std::ifstream file(path);
+    if (!file) {
+        return false;
+    }
+
+    segments.clear();
+    std::string line;
+    size_t lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        if (line.empty() || line[0] == '#' || line.find_first_not_of(" \t\r") == std::string::npos) {
+            continue;
+        }
+
+        // Audacity writes "start\tend\tlabel"; "\\" lines carry spectral
+        // selection data and are skipped
+        if (line[0] == '\\') {
+            continue;
+        }
+
+        std::istringstream fields(line);
+        LabelSegment segment;
+        if (!(fields >> segment.startSec >> segment.endSec) || segment.endSec < segment.startSec) {
+            MICMAP_LOG_ERROR("Malformed label at ", path.string(), ":", lineNumber);
+            return false;
+        }
+        std::getline(fields >> std::ws, segment.label);
+        while (!segment.label.empty() && std::isspace(static_cast<unsigned char>(segment.label.back()))) {
+            segment.label.pop_back();
+        }
+        segment.covered = startsWithCovered(segment.label);
+        segments.push_back(std::move(segment));
+    }
+
+    std::sort(segments.begin(), segments.end(), [](const LabelSegment& a, const LabelSegment& b) {
+        return a.startSec < b.startSec;
+    });
+    return true;
+}
+
+double EvaluationResult::framePrecision() const {
+    return ratioOrOne(truePositiveFrames, truePositiveFrames + falsePositiveFrames);
+}
+
+double EvaluationResult::frameRecall() const {
+    return ratioOrOne(truePositiveFrames, truePositiveFrames + falseNegativeFrames);
+}
+
+double EvaluationResult::eventPrecision() const {
+    return ratioOrOne(triggers - falseTriggers, triggers);
+}
+
+double EvaluationResult::eventRecall() const {
+    return ratioOrOne(detectedSegments, coveredSegments);
+}
+
+double EvaluationResult::falseTriggersPerHour() const {
+    double uncoveredHours = (durationSec - coveredSec) / 3600.0;
+    return uncoveredHours > 0.0 ? static_cast<double>(falseTriggers) / uncoveredHours : 0.0;
+}
+
+void EvaluationResult::merge(const EvaluationResult& other) {
+    durationSec += other.durationSec;
+    coveredSec += other.coveredSec;
+    frames += other.frames;
+    truePositiveFrames += other.truePositiveFrames;
+    falsePositiveFrames += other.falsePositiveFrames;
+    falseNegativeFrames += other.falseNegativeFrames;
+    coveredSegments += other.coveredSegments;
+    detectedSegments += other.detectedSegments;
+    triggers += other.triggers;
+    falseTriggers += other.falseTriggers;
+    latenciesMs.insert(latenciesMs.end(), other.latenciesMs.begin(), other.latenciesMs.end());
+}
+
+namespace {
+
+/**
+ * @brief Score a recording; analyzeHop(position, frame) feeds the detector
+ *        the hop starting at position and returns the frames it completed
+ */
+template <typename AnalyzeHop>
+EvaluationResult scoreRecording(INoiseDetector& detector, size_t hopSize, size_t count,
+                                uint32_t sampleRate, const std::vector<LabelSegment>& labels,
+                                const EvaluationConfig& config, AnalyzeHop&& analyzeHop) {
+    EvaluationResult result;
+    if (hopSize == 0 || sampleRate == 0) {
+        return result;
+    }
+
+    const double rate = static_cast<double>(sampleRate);
+    result.durationSec = static_cast<double>(count) / rate;
+
+    // Covered spans in samples, clipped to the recording
+    struct Span {
+        size_t start;
+        size_t end;
+        bool triggered;
+    };
+    std::vector<Span> covered;
+    for (const auto& segment : labels) {
+        if (!segment.covered) {
+            continue;
+        }
+        auto start = static_cast<size_t>(std::max(0.0, segment.startSec) * rate);
+        auto end = std::min(count, static_cast<size_t>(segment.endSec * rate));
+        if (end > start) {
+            covered.push_back({start, end, false});
+            result.coveredSec += static_cast<double>(end - start) / rate;
+        }
+    }
+    result.coveredSegments = covered.size();
+
+    auto coveredAt = [&covered](size_t position) {
+        for (const auto& span : covered) {
+            if (position >= span.start && position < span.end) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    const size_t toleranceSamples =
+        static_cast<size_t>(static_cast<double>(config.triggerToleranceMs) * rate / 1000.0);
+
+    // The detector measures the duration on its sample clock, so its
+    // decisions match real-time capture however fast the replay runs
+    detector.setMinDetectionDuration(config.minDurationMs);
+
+    // Feed one hop at a time so that every call completes at most one frame
+    // and the frame's position in the recording is known exactly
+    bool detecting = false;
+    DetectionResult frame{};
+
+    for (size_t position = 0; position + hopSize <= count; position += hopSize) {
+        if (analyzeHop(position, frame) == 0) {
+            continue;
+        }
+
+        size_t hopEnd = position + hopSize;
+        bool isCovered = coveredAt(position + hopSize / 2);
+        bool isDetected = frame.isWhiteNoise;
+
+        ++result.frames;
+        if (isDetected && isCovered) {
+            ++result.truePositiveFrames;
+        } else if (isDetected) {
+            ++result.falsePositiveFrames;
+        } else if (isCovered) {
+            ++result.falseNegativeFrames;
+        }
+
+        // Trigger on the first confirmed frame of each detection run
+        bool rising = isDetected && !detecting;
+        detecting = isDetected;
+        if (!rising) {
+            continue;
+        }
+
+        // Attribute the trigger to the covered segment it falls in, if any
+        ++result.triggers;
+        bool hit = false;
+        for (auto& span : covered) {
+            if (hopEnd >= span.start && hopEnd <= span.end + toleranceSamples) {
+                hit = true;
+                if (!span.triggered) {
+                    span.triggered = true;
+                    ++result.detectedSegments;
+                    result.latenciesMs.push_back(
+                        static_cast<double>(hopEnd - span.start) * 1000.0 / rate);
+                }
+                break;
+            }
+        }
+        if (!hit) {
+            ++result.falseTriggers;
+        }
+    }
+
+    return result;
+}
+
+} // anonymous namespace
+
+EvaluationResult evaluateRecording(INoiseDetector& detector, size_t hopSize,
+                                   const float* samples, size_t count, uint32_t sampleRate,
+                                   const std::vector<LabelSegment>& labels,
+                                   const EvaluationConfig& config) {
+    return scoreRecording(detector, hopSize, count, sampleRate, labels, config,
+                          [&](size_t position, DetectionResult& frame) {
+        return detector.analyzeInto(samples + position, hopSize, &frame, 1);
+    });
+}
+
+EvaluationResult evaluateRecording(INoiseDetector& detector, size_t hopSize,
+                                   const float* const* channels, size_t channelCount,
+                                   size_t count, uint32_t sampleRate,
+                                   const std::vector<LabelSegment>& labels,
+                                   const EvaluationConfig& config) {
+    std::vector<const float*> hop(channelCount);
+    return scoreRecording(detector, hopSize, count, sampleRate, labels, config,
+                          [&](size_t position, DetectionResult& frame) {
+        for (size_t c = 0; c < channelCount; ++c) {
+            hop[c] = channels[c] + position;
+        }
+        return detector.analyzeChannelsInto(hop.data(), hopSize, &frame, 1);
+    });
+}
+
+double percentileOf(std::vector<double> values, double percentile) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    double rank = std::clamp(percentile, 0.0, 100.0) / 100.0 * static_cast<double>(values.size() - 1);
+    size_t lower = static_cast<size_t>(rank);
+    size_t upper = std::min(lower + 1, values.size() - 1);
+    double fraction = rank - static_cast<double>(lower);
+    return values[lower] + (values[upper] - values[lower]) * fraction;
+}
+
+} // namespace micmap::detection
@@ -0,0 +1,107 @@
+/**
+ * @file fft_backend.cpp
+ * @brief FFT backend factory and KissFFT backend
+ */
+
+#include "micmap/detection/fft_backend.hpp"
+#include "fft_radix4_kernels.hpp"
+#include "micmap/common/logger.hpp"
+
+// KissFFT headers
+#include "kiss_fft.h"
+#include "kiss_fftr.h"
+
+#include <stdexcept>
+#include <vector>
+
+namespace micmap::detection {
+
+static_assert(sizeof(kiss_fft_cpx) == 2 * sizeof(float),
+              "FFT backends write interleaved float pairs");
+
+namespace {
+
+/**
+ * @brief kiss_fftr wrapper; the window is applied into a scratch frame
+ */
+class KissFFTBackend : public IFFTBackend {
+public:
+    explicit KissFFTBackend(size_t size)
+        : size_(size)
+        , scratch_(size)
+        , config_(nullptr) {
+        config_ = kiss_fftr_alloc(static_cast<int>(size_), 0, nullptr, nullptr);
+        if (!config_) {
+            throw std::runtime_error("Failed to allocate KissFFT configuration");
+        }
+        MICMAP_LOG_DEBUG("Created KissFFT backend: ", size_, " points");
+    }
+
+    ~KissFFTBackend() override {
+        if (config_) {
+            kiss_fftr_free(config_);
+            config_ = nullptr;
+        }
+    }
+
+    // Non-copyable
+    KissFFTBackend(const KissFFTBackend&) = delete;
+    KissFFTBackend& operator=(const KissFFTBackend&) = delete;
+
+    void forward(const float* input, const float* window, float* output) override {
+        const float* frame = input;
+        if (window) {
+            for (size_t i = 0; i < size_; ++i) {
+                scratch_[i] = input[i] * window[i];
+            }
+            frame = scratch_.data();
+        }
+        kiss_fftr(config_, frame, reinterpret_cast<kiss_fft_cpx*>(output));
+    }
+
+    size_t getSize() const override {
+        return size_;
+    }
+
+    FFTBackendType getType() const override {
+        return FFTBackendType::KissFFT;
+    }
+
+private:
+    size_t size_;
+    std::vector<float> scratch_;
+    kiss_fftr_cfg config_;
+};
+
+} // anonymous namespace
+
+bool parseFFTBackendType(std::string_view name, FFTBackendType& type) {
+    if (name == "auto") {
+        type = FFTBackendType::Auto;
+    } else if (name == "kissfft") {
+        type = FFTBackendType::KissFFT;
+    } else if (name == "radix4") {
+        type = FFTBackendType::Radix4;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+std::unique_ptr<IFFTBackend> createFFTBackend(FFTBackendType type, size_t size,
+                                              common::SimdLevel level) {
+    if (size == 0 || (size & (size - 1)) != 0) {
+        throw std::invalid_argument("FFT size must be a power of 2");
+    }
+
+    switch (type) {
+        case FFTBackendType::KissFFT:
+            return std::make_unique<KissFFTBackend>(size);
+        case FFTBackendType::Auto:
+        case FFTBackendType::Radix4:
+        default:
+            return detail::createRadix4Backend(size, level);
+    }
+}
+
+} // namespace micmap::detection
@@ -0,0 +1,244 @@
+/**
+ * @file fft_radix4.cpp
+ * @brief In-tree radix-4 real FFT backend
+ *
+ * A real transform of N samples is computed as a complex transform of
+ * M = N / 2 points z[j] = x[2j] + i x[2j+1], followed by a post-processing
+ * pass that splits the even and odd halves back apart:
+ *
+ *   X[k] = Fe[k] + W(N, k) Fo[k],  k = 0 .. M
+ *   Fe[k] = (Z[k] + conj(Z[M-k])) / 2
+ *   Fo[k] = (Z[k] - conj(Z[M-k])) / 2i
+ *
+ * The complex transform is an iterative decimation-in-time FFT on split
+ * real/imaginary buffers. The first pass fuses windowing, the even/odd
+ * packing, the bit-reversal permutation and the two twiddle-free stages.
+ * The remaining stages run two at a time in the per-ISA kernels.
+ */
+
+#include "fft_radix4_kernels.hpp"
+#include "micmap/common/logger.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace micmap::detection {
+
+namespace detail {
+
+void fftStagesScalar(float* re, float* im, const float* twiddleRe,
+                     const float* twiddleIm, size_t m) {
+    fftStages<ScalarOps>(re, im, twiddleRe, twiddleIm, m);
+}
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+
+/**
+ * @brief Smallest complex size handled by the FFT path; below it a direct DFT is used
+ */
+constexpr size_t MIN_COMPLEX_SIZE = 4;
+
+FFTStagesKernel stagesKernelFor(common::SimdLevel level) {
+    switch (level) {
+#ifdef MICMAP_HAVE_AVX2
+        case common::SimdLevel::AVX2: return fftStagesAVX2;
+#endif
+#if MICMAP_DETECTION_HAVE_SSE2
+        case common::SimdLevel::SSE2: return fftStagesSSE2;
+#endif
+#if MICMAP_DETECTION_HAVE_NEON
+        case common::SimdLevel::NEON: return fftStagesNEON;
+#endif
+        default: return fftStagesScalar;
+    }
+}
+
+class Radix4Backend : public IFFTBackend {
+public:
+    Radix4Backend(size_t size, common::SimdLevel level)
+        : size_(size)
+        , complexSize_(size / 2)
+        , level_(resolveSimdLevel(level))
+        , stages_(stagesKernelFor(level_)) {
+
+        if (complexSize_ < MIN_COMPLEX_SIZE) {
+            MICMAP_LOG_DEBUG("Created radix-4 FFT backend: ", size_, " point direct DFT");
+            return;
+        }
+
+        re_.resize(complexSize_);
+        im_.resize(complexSize_);
+
+        bitReverse_.resize(complexSize_);
+        size_t bits = 0;
+        while ((size_t{1} << bits) < complexSize_) {
+            ++bits;
+        }
+        for (size_t i = 0; i < complexSize_; ++i) {
+            uint32_t reversed = 0;
+            for (size_t b = 0; b < bits; ++b) {
+                if (i & (size_t{1} << b)) {
+                    reversed |= uint32_t{1} << (bits - 1 - b);
+                }
+            }
+            bitReverse_[i] = reversed;
+        }
+
+        // Stage twiddles: entries [h, 2h) hold W(2h, k)
+        twiddleRe_.assign(complexSize_, 0.0f);
+        twiddleIm_.assign(complexSize_, 0.0f);
+        for (size_t h = 1; h < complexSize_; h *= 2) {
+            for (size_t k = 0; k < h; ++k) {
+                double angle = -PI * static_cast<double>(k) / static_cast<double>(h);
+                twiddleRe_[h + k] = static_cast<float>(std::cos(angle));
+                twiddleIm_[h + k] = static_cast<float>(std::sin(angle));
+            }
+        }
+
+        // Real post-processing twiddles W(N, k), k = 0 .. M
+        postRe_.resize(complexSize_ + 1);
+        postIm_.resize(complexSize_ + 1);
+        for (size_t k = 0; k <= complexSize_; ++k) {
+            double angle = -2.0 * PI * static_cast<double>(k) / static_cast<double>(size_);
+            postRe_[k] = static_cast<float>(std::cos(angle));
+            postIm_[k] = static_cast<float>(std::sin(angle));
+        }
+
+        MICMAP_LOG_DEBUG("Created radix-4 FFT backend: ", size_, " points, ",
+                         common::simdLevelToString(level_), " stages");
+    }
+
+    void forward(const float* input, const float* window, float* output) override {
+        if (complexSize_ < MIN_COMPLEX_SIZE) {
+            directDFT(input, window, output);
+            return;
+        }
+
+        if (window) {
+            firstPass<true>(input, window);
+        } else {
+            firstPass<false>(input, nullptr);
+        }
+        stages_(re_.data(), im_.data(), twiddleRe_.data(), twiddleIm_.data(), complexSize_);
+        postProcess(output);
+    }
+
+    size_t getSize() const override {
+        return size_;
+    }
+
+    FFTBackendType getType() const override {
+        return FFTBackendType::Radix4;
+    }
+
+private:
+    /**
+     * @brief Window, pack, permute and run the two twiddle-free stages
+     */
+    template <bool Windowed>
+    void firstPass(const float* input, const float* window) {
+        float* re = re_.data();
+        float* im = im_.data();
+        const uint32_t* reverse = bitReverse_.data();
+
+        auto loadPoint = [&](uint32_t j, float& real, float& imag) {
+            real = input[2 * j];
+            imag = input[2 * j + 1];
+            if constexpr (Windowed) {
+                real *= window[2 * j];
+                imag *= window[2 * j + 1];
+            }
+        };
+
+        for (size_t p = 0; p < complexSize_; p += 4) {
+            float ar, ai, br, bi, cr, ci, dr, di;
+            loadPoint(reverse[p], ar, ai);
+            loadPoint(reverse[p + 1], br, bi);
+            loadPoint(reverse[p + 2], cr, ci);
+            loadPoint(reverse[p + 3], dr, di);
+
+            float a1r = ar + br, a1i = ai + bi;
+            float b1r = ar - br, b1i = ai - bi;
+            float c1r = cr + dr, c1i = ci + di;
+            float d1r = cr - dr, d1i = ci - di;
+
+            re[p] = a1r + c1r;
+            im[p] = a1i + c1i;
+            re[p + 2] = a1r - c1r;
+            im[p + 2] = a1i - c1i;
+            re[p + 1] = b1r + d1i;
+            im[p + 1] = b1i - d1r;
+            re[p + 3] = b1r - d1i;
+            im[p + 3] = b1i + d1r;
+        }
+    }
+
+    /**
+     * @brief Split the packed complex spectrum into the real-input spectrum
+     */
+    void postProcess(float* output) const {
+        const float* re = re_.data();
+        const float* im = im_.data();
+
+        for (size_t k = 0; k <= complexSize_; ++k) {
+            size_t a = (k == complexSize_) ? 0 : k;
+            size_t b = (k == 0) ? 0 : complexSize_ - k;
+            float ar = re[a], ai = im[a];
+            float br = re[b], bi = im[b];
+
+            float evenR = 0.5f * (ar + br);
+            float evenI = 0.5f * (ai - bi);
+            float oddR = 0.5f * (ai + bi);
+            float oddI = -0.5f * (ar - br);
+
+            float wr = postRe_[k];
+            float wi = postIm_[k];
+            output[2 * k] = evenR + oddR * wr - oddI * wi;
+            output[2 * k + 1] = evenI + oddR * wi + oddI * wr;
+        }
+    }
+
+    /**
+     * @brief Direct DFT for sizes too small for the butterfly passes
+     */
+    void directDFT(const float* input, const float* window, float* output) const {
+        for (size_t k = 0; k <= size_ / 2; ++k) {
+            double real = 0.0;
+            double imag = 0.0;
+            for (size_t n = 0; n < size_; ++n) {
+                double x = window ? input[n] * window[n] : input[n];
+                double angle = -2.0 * PI * static_cast<double>(k * n) / static_cast<double>(size_);
+                real += x * std::cos(angle);
+                imag += x * std::sin(angle);
+            }
+            output[2 * k] = static_cast<float>(real);
+            output[2 * k + 1] = static_cast<float>(imag);
+        }
+    }
+
+    size_t size_;
+    size_t complexSize_;
+    common::SimdLevel level_;
+    FFTStagesKernel stages_;
+
+    std::vector<float> re_;
+    std::vector<float> im_;
+    std::vector<uint32_t> bitReverse_;
+    std::vector<float> twiddleRe_;
+    std::vector<float> twiddleIm_;
+    std::vector<float> postRe_;
+    std::vector<float> postIm_;
+};
+
+} // anonymous namespace
+
+std::unique_ptr<IFFTBackend> createRadix4Backend(size_t size, common::SimdLevel level) {
+    return std::make_unique<Radix4Backend>(size, level);
+}
+
+} // namespace detail
+
+} // namespace micmap::detection
@@ -0,0 +1,18 @@
+/**
+ * @file fft_radix4_avx2.cpp
+ * @brief AVX2 radix-4 FFT stages
+ *
+ * Compiled with AVX2 enabled (see cmake/SimdFlags.cmake) and only called
+ * after runtime detection confirms CPU support.
+ */
+
+#include "fft_radix4_kernels.hpp"
+
+namespace micmap::detection::detail {
+
+void fftStagesAVX2(float* re, float* im, const float* twiddleRe,
+                   const float* twiddleIm, size_t m) {
+    fftStages<AVX2Ops, SSE2Ops>(re, im, twiddleRe, twiddleIm, m);
+}
+
+} // namespace micmap::detection::detail
@@ -0,0 +1,197 @@
+#pragma once
+
+/**
+ * @file fft_radix4_kernels.hpp
+ * @brief Internal butterfly kernels for the in-tree radix-4 FFT
+ *
+ * The complex transform works on split (structure-of-arrays) real and
+ * imaginary buffers in bit-reversed order. The twiddle-free first two
+ * stages are done by the backend while gathering its input. The kernels
+ * here run the remaining stages, two at a time (radix-4) where possible.
+ *
+ * Twiddles are stored per stage: for a stage whose butterflies span h
+ * points, entries [h, 2h) hold exp(-2*pi*i*k / (2h)) for k in [0, h).
+ */
+
+#include "micmap/detection/fft_backend.hpp"
+#include "simd_ops.hpp"
+
+#include <cstddef>
+
+namespace micmap::detection::detail {
+
+/**
+ * @brief Create the radix-4 backend (size already validated)
+ */
+std::unique_ptr<IFFTBackend> createRadix4Backend(size_t size, common::SimdLevel level);
+
+/**
+ * @brief Signature of the per-ISA stage driver
+ * @param re Real parts, m values
+ * @param im Imaginary parts, m values
+ * @param twiddleRe Real parts of the stage twiddle table (m values)
+ * @param twiddleIm Imaginary parts of the stage twiddle table (m values)
+ * @param m Complex transform size (power of 2, >= 4)
+ */
+using FFTStagesKernel = void (*)(float* re, float* im, const float* twiddleRe,
+                                 const float* twiddleIm, size_t m);
+
+void fftStagesScalar(float* re, float* im, const float* twiddleRe,
+                     const float* twiddleIm, size_t m);
+
+#if MICMAP_DETECTION_HAVE_SSE2
+void fftStagesSSE2(float* re, float* im, const float* twiddleRe,
+                   const float* twiddleIm, size_t m);
+#endif
+
+#ifdef MICMAP_HAVE_AVX2
+void fftStagesAVX2(float* re, float* im, const float* twiddleRe,
+                   const float* twiddleIm, size_t m);
+#endif
+
+#if MICMAP_DETECTION_HAVE_NEON
+void fftStagesNEON(float* re, float* im, const float* twiddleRe,
+                   const float* twiddleIm, size_t m);
+#endif
+
+namespace {
+
+/**
+ * @brief Two combined radix-2 stages (spans h and 2h) over the whole buffer
+ *
+ * For each group of 4h points and k in [0, h) with inputs a, b, c, d at
+ * offsets k, k+h, k+2h, k+3h:
+ *   stage h:  a' = a + w1 b,  b' = a - w1 b,  c' = c + w1 d,  d' = c - w1 d
+ *   stage 2h: a'' = a' + w2 c',  c'' = a' - w2 c',
+ *             b'' = b' - i w2 d',  d'' = b' + i w2 d'
+ * where w1 = W(2h, k) and w2 = W(4h, k), using W(4h, k + h) = -i W(4h, k).
+ */
+template <typename Ops>
+void radix4Stage(float* re, float* im, const float* twiddleRe, const float* twiddleIm,
+                 size_t m, size_t h) {
+    using Vec = typename Ops::Vec;
+
+    for (size_t group = 0; group < m; group += 4 * h) {
+        float* r0 = re + group;
+        float* i0 = im + group;
+        for (size_t k = 0; k < h; k += Ops::WIDTH) {
+            Vec w1r = Ops::load(twiddleRe + h + k);
+            Vec w1i = Ops::load(twiddleIm + h + k);
+            Vec w2r = Ops::load(twiddleRe + 2 * h + k);
+            Vec w2i = Ops::load(twiddleIm + 2 * h + k);
+
+            Vec ar = Ops::load(r0 + k),         ai = Ops::load(i0 + k);
+            Vec br = Ops::load(r0 + k + h),     bi = Ops::load(i0 + k + h);
+            Vec cr = Ops::load(r0 + k + 2 * h), ci = Ops::load(i0 + k + 2 * h);
+            Vec dr = Ops::load(r0 + k + 3 * h), di = Ops::load(i0 + k + 3 * h);
+
+            // w1 * b and w1 * d
+            Vec tbr = Ops::sub(Ops::mul(br, w1r), Ops::mul(bi, w1i));
+            Vec tbi = Ops::add(Ops::mul(br, w1i), Ops::mul(bi, w1r));
+            Vec tdr = Ops::sub(Ops::mul(dr, w1r), Ops::mul(di, w1i));
+            Vec tdi = Ops::add(Ops::mul(dr, w1i), Ops::mul(di, w1r));
+
+            Vec a1r = Ops::add(ar, tbr), a1i = Ops::add(ai, tbi);
+            Vec b1r = Ops::sub(ar, tbr), b1i = Ops::sub(ai, tbi);
+            Vec c1r = Ops::add(cr, tdr), c1i = Ops::add(ci, tdi);
+            Vec d1r = Ops::sub(cr, tdr), d1i = Ops::sub(ci, tdi);
+
+            // w2 * c' and w2 * d'
+            Vec tcr = Ops::sub(Ops::mul(c1r, w2r), Ops::mul(c1i, w2i));
+            Vec tci = Ops::add(Ops::mul(c1r, w2i), Ops::mul(c1i, w2r));
+            Vec ter = Ops::sub(Ops::mul(d1r, w2r), Ops::mul(d1i, w2i));
+            Vec tei = Ops::add(Ops::mul(d1r, w2i), Ops::mul(d1i, w2r));
+
+            Ops::store(r0 + k, Ops::add(a1r, tcr));
+            Ops::store(i0 + k, Ops::add(a1i, tci));
+            Ops::store(r0 + k + 2 * h, Ops::sub(a1r, tcr));
+            Ops::store(i0 + k + 2 * h, Ops::sub(a1i, tci));
+
+            // -i * (x + iy) = y - ix
+            Ops::store(r0 + k + h, Ops::add(b1r, tei));
+            Ops::store(i0 + k + h, Ops::sub(b1i, ter));
+            Ops::store(r0 + k + 3 * h, Ops::sub(b1r, tei));
+            Ops::store(i0 + k + 3 * h, Ops::add(b1i, ter));
+        }
+    }
+}
+
+/**
+ * @brief Single radix-2 stage with span h (used when an odd stage remains)
+ */
+template <typename Ops>
+void radix2Stage(float* re, float* im, const float* twiddleRe, const float* twiddleIm,
+                 size_t m, size_t h) {
+    using Vec = typename Ops::Vec;
+
+    for (size_t group = 0; group < m; group += 2 * h) {
+        float* r0 = re + group;
+        float* i0 = im + group;
+        for (size_t k = 0; k < h; k += Ops::WIDTH) {
+            Vec wr = Ops::load(twiddleRe + h + k);
+            Vec wi = Ops::load(twiddleIm + h + k);
+            Vec ar = Ops::load(r0 + k),     ai = Ops::load(i0 + k);
+            Vec br = Ops::load(r0 + k + h), bi = Ops::load(i0 + k + h);
+
+            Vec tr = Ops::sub(Ops::mul(br, wr), Ops::mul(bi, wi));
+            Vec ti = Ops::add(Ops::mul(br, wi), Ops::mul(bi, wr));
+
+            Ops::store(r0 + k, Ops::add(ar, tr));
+            Ops::store(i0 + k, Ops::add(ai, ti));
+            Ops::store(r0 + k + h, Ops::sub(ar, tr));
+            Ops::store(i0 + k + h, Ops::sub(ai, ti));
+        }
+    }
+}
+
+/**
+ * @brief Run one stage with the widest Ops whose width fits the span
+ */
+template <typename Ops, typename NarrowOps, template <typename> class Stage>
+void runStage(float* re, float* im, const float* twiddleRe, const float* twiddleIm,
+              size_t m, size_t h) {
+    if (h >= Ops::WIDTH) {
+        Stage<Ops>::run(re, im, twiddleRe, twiddleIm, m, h);
+    } else if (h >= NarrowOps::WIDTH) {
+        Stage<NarrowOps>::run(re, im, twiddleRe, twiddleIm, m, h);
+    } else {
+        Stage<ScalarOps>::run(re, im, twiddleRe, twiddleIm, m, h);
+    }
+}
+
+template <typename Ops>
+struct Radix4Stage {
+    static void run(float* re, float* im, const float* twiddleRe, const float* twiddleIm,
+                    size_t m, size_t h) {
+        radix4Stage<Ops>(re, im, twiddleRe, twiddleIm, m, h);
+    }
+};
+
+template <typename Ops>
+struct Radix2Stage {
+    static void run(float* re, float* im, const float* twiddleRe, const float* twiddleIm,
+                    size_t m, size_t h) {
+        radix2Stage<Ops>(re, im, twiddleRe, twiddleIm, m, h);
+    }
+};
+
+/**
+ * @brief Run every stage after the first two (spans 4 .. m/2)
+ *
+ * Stages narrower than Ops::WIDTH use NarrowOps (e.g. SSE2 under AVX2),
+ * falling back to ScalarOps below that.
+ */
+template <typename Ops, typename NarrowOps = ScalarOps>
+void fftStages(float* re, float* im, const float* twiddleRe, const float* twiddleIm, size_t m) {
+    size_t h = 4;
+    for (; h * 4 <= m; h *= 4) {
+        runStage<Ops, NarrowOps, Radix4Stage>(re, im, twiddleRe, twiddleIm, m, h);
+    }
+    if (h * 2 == m) {
+        runStage<Ops, NarrowOps, Radix2Stage>(re, im, twiddleRe, twiddleIm, m, h);
+    }
+}
+
+} // anonymous namespace
+
+} // namespace micmap::detection::detail
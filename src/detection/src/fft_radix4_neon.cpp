@@ -0,0 +1,19 @@
+/**
+ * @file fft_radix4_neon.cpp
+ * @brief NEON radix-4 FFT stages (AArch64)
+ */
+
+#include "fft_radix4_kernels.hpp"
+
+#if MICMAP_DETECTION_HAVE_NEON
+
+namespace micmap::detection::detail {
+
+void fftStagesNEON(float* re, float* im, const float* twiddleRe,
+                   const float* twiddleIm, size_t m) {
+    fftStages<NEONOps>(re, im, twiddleRe, twiddleIm, m);
+}
+
+} // namespace micmap::detection::detail
+
+#endif // MICMAP_DETECTION_HAVE_NEON
@@ -0,0 +1,19 @@
+/**
+ * @file fft_radix4_sse2.cpp
+ * @brief SSE2 radix-4 FFT stages (baseline on x86-64)
+ */
+
+#include "fft_radix4_kernels.hpp"
+
+#if MICMAP_DETECTION_HAVE_SSE2
+
+namespace micmap::detection::detail {
+
+void fftStagesSSE2(float* re, float* im, const float* twiddleRe,
+                   const float* twiddleIm, size_t m) {
+    fftStages<SSE2Ops>(re, im, twiddleRe, twiddleIm, m);
+}
+
+} // namespace micmap::detection::detail
+
+#endif // MICMAP_DETECTION_HAVE_SSE2
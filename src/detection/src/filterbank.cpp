@@ -0,0 +1,124 @@
+/**
+ * @file filterbank.cpp
+ * @brief Mel/ERB band filterbank construction and application
+ */
+
+#include "micmap/detection/filterbank.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace micmap::detection {
+
+bool parseFilterbankScale(std::string_view name, FilterbankScale& scale) {
+    if (name == "mel") {
+        scale = FilterbankScale::Mel;
+    } else if (name == "erb") {
+        scale = FilterbankScale::ERB;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+Filterbank::Filterbank(const FilterbankConfig& config, uint32_t sampleRate, size_t fftSize,
+                       common::SimdLevel level)
+    : kernels_(getSpectralFeatureKernels(level))
+    , scale_(config.scale)
+    , minFrequency_(std::max(0.0f, config.minFrequency))
+    , maxFrequency_(std::min(config.maxFrequency, static_cast<float>(sampleRate) / 2.0f)) {
+    if (config.bands == 0 || fftSize == 0 || sampleRate == 0) {
+        throw std::invalid_argument("Filterbank needs at least one band, an FFT size and a sample rate");
+    }
+
+    if (!(minFrequency_ < maxFrequency_)) {
+        throw std::invalid_argument("Filterbank frequency range is empty");
+    }
+
+    // bands + 2 edges evenly spaced on the scale; band k rises from edge k
+    // to its centre at edge k + 1 and falls to edge k + 2
+    const size_t numBins = fftSize / 2 + 1;
+    const float binWidth = static_cast<float>(sampleRate) / static_cast<float>(fftSize);
+    const float scaleMin = toScale(scale_, minFrequency_);
+    const float scaleMax = toScale(scale_, maxFrequency_);
+    std::vector<float> edges(config.bands + 2);
+    for (size_t k = 0; k < edges.size(); ++k) {
+        float t = static_cast<float>(k) / static_cast<float>(config.bands + 1);
+        edges[k] = fromScale(scale_, scaleMin + t * (scaleMax - scaleMin));
+    }
+
+    ranges_.reserve(config.bands);
+    centers_.reserve(config.bands);
+    for (size_t k = 0; k < config.bands; ++k) {
+        const float lower = edges[k];
+        const float center = edges[k + 1];
+        const float upper = edges[k + 2];
+        centers_.push_back(center);
+
+        BandRange range{0, weights_.size(), 0};
+        float sum = 0.0f;
+        for (size_t i = 0; i < numBins; ++i) {
+            float frequency = static_cast<float>(i) * binWidth;
+            float weight = 0.0f;
+            if (frequency > lower && frequency < center) {
+                weight = (frequency - lower) / (center - lower);
+            } else if (frequency >= center && frequency < upper) {
+                weight = (upper - frequency) / (upper - center);
+            }
+            if (weight <= 0.0f) {
+                if (range.count > 0) {
+                    break;
+                }
+                continue;
+            }
+            if (range.count == 0) {
+                range.firstBin = i;
+            }
+            weights_.push_back(weight);
+            sum += weight;
+            ++range.count;
+        }
+
+        // Bands narrower than a bin take the bin nearest their centre
+        if (range.count == 0) {
+            range.firstBin = std::min(numBins - 1, static_cast<size_t>(std::lround(center / binWidth)));
+            range.count = 1;
+            weights_.push_back(1.0f);
+            sum = 1.0f;
+        }
+
+        for (size_t j = 0; j < range.count; ++j) {
+            weights_[range.offset + j] /= sum;
+        }
+        ranges_.push_back(range);
+    }
+}
+
+void Filterbank::apply(const float* magnitudes, float* bands) const {
+    for (size_t k = 0; k < ranges_.size(); ++k) {
+        const BandRange& range = ranges_[k];
+        kernels_.dotRows(weights_.data() + range.offset, 1, range.count,
+                         magnitudes + range.firstBin, range.count, bands + k);
+    }
+}
+
+float Filterbank::getCenterFrequency(size_t band) const {
+    return band < centers_.size() ? centers_[band] : 0.0f;
+}
+
+float Filterbank::toScale(FilterbankScale scale, float frequency) {
+    if (scale == FilterbankScale::ERB) {
+        return 21.4f * std::log10(1.0f + 0.00437f * frequency);
+    }
+    return 2595.0f * std::log10(1.0f + frequency / 700.0f);
+}
+
+float Filterbank::fromScale(FilterbankScale scale, float value) {
+    if (scale == FilterbankScale::ERB) {
+        return (std::pow(10.0f, value / 21.4f) - 1.0f) / 0.00437f;
+    }
+    return 700.0f * (std::pow(10.0f, value / 2595.0f) - 1.0f);
+}
+
+} // namespace micmap::detection
@@ -0,0 +1,116 @@
+/**
+ * @file multichannel_analyzer.cpp
+ * @brief Shared-plan multi-channel spectra and pairwise coherence
+ */
+
+#include "micmap/detection/multichannel_analyzer.hpp"
+#include "micmap/detection/spectral_features.hpp"
+#include "micmap/common/logger.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace micmap::detection {
+
+namespace {
+    constexpr float PI = 3.14159265358979323846f;
+}
+
+MultiChannelAnalyzer::MultiChannelAnalyzer(uint32_t sampleRate, size_t fftSize, size_t channels,
+                                           const CoherenceConfig& coherence, FFTBackendType backend,
+                                           common::SimdLevel level)
+    : kernels_(getSpectralFeatureKernels(level))
+    , fftSize_(fftSize)
+    , numBins_(fftSize / 2 + 1)
+    , channels_(channels)
+    , resolution_(fftSize > 0 ? static_cast<float>(sampleRate) / static_cast<float>(fftSize) : 0.0f)
+    , decay_(coherence.smoothing) {
+    if (channels_ == 0 || sampleRate == 0) {
+        throw std::invalid_argument("Multi-channel analysis needs a sample rate and at least one channel");
+    }
+    if (!(decay_ >= 0.0f && decay_ < 1.0f)) {
+        throw std::invalid_argument("Coherence smoothing must be within [0, 1)");
+    }
+
+    // Validates that the FFT size is a power of 2
+    fft_ = createFFTBackend(backend, fftSize_, level);
+
+    // The band skips DC and Nyquist, whose phase carries no information
+    size_t first = static_cast<size_t>(std::ceil(coherence.minFrequency / resolution_));
+    size_t last = static_cast<size_t>(std::floor(coherence.maxFrequency / resolution_));
+    bandStart_ = std::max<size_t>(first, 1);
+    last = std::min(last, numBins_ - 2);
+    if (last < bandStart_) {
+        throw std::invalid_argument("Coherence band holds no FFT bin");
+    }
+    bandBins_ = last - bandStart_ + 1;
+
+    // Symmetric Hann window, as the FFT spectral analyzer uses
+    window_.resize(fftSize_);
+    for (size_t i = 0; i < fftSize_; ++i) {
+        window_[i] = 0.5f * (1.0f - std::cos(2.0f * PI * static_cast<float>(i) / static_cast<float>(fftSize_ - 1)));
+    }
+
+    transforms_.resize(channels_ * 2 * numBins_, 0.0f);
+    magnitudes_.resize(channels_ * numBins_, 0.0f);
+    pairState_.resize(channels_ * (channels_ - 1) / 2 * 4 * bandBins_, 0.0f);
+
+    MICMAP_LOG_DEBUG("Created ", channels_, " channel analyzer: ", fftSize_, " point ",
+                     fftBackendTypeToString(fft_->getType()), " FFT, coherence over ", bandBins_,
+                     " bins from ", static_cast<float>(bandStart_) * resolution_, " Hz");
+}
+
+float MultiChannelAnalyzer::analyzeInto(const float* const* frames, float* magnitudes,
+                                        SpectralFeatures* features) {
+    float* spectra = magnitudes ? magnitudes : magnitudes_.data();
+    const size_t stride = 2 * numBins_;
+
+    for (size_t c = 0; c < channels_; ++c) {
+        fft_->forward(frames[c], window_.data(), transforms_.data() + c * stride);
+    }
+
+    // One pass over every channel's bins; then the same DC and Nyquist
+    // halving as the single-channel analyzer
+    kernels_.magnitudes(transforms_.data(), channels_ * numBins_, 2.0f / static_cast<float>(fftSize_),
+                        spectra);
+    for (size_t c = 0; c < channels_; ++c) {
+        float* spectrum = spectra + c * numBins_;
+        spectrum[0] *= 0.5f;
+        if (numBins_ > 1) {
+            spectrum[numBins_ - 1] *= 0.5f;
+        }
+        if (features) {
+            features[c].energy = kernels_.meanSquare(frames[c], fftSize_);
+            features[c].spectralFlatness = kernels_.flatness(spectrum + 1, numBins_ - 1);
+            features[c].spectralCentroid = kernels_.centroid(spectrum, numBins_) * resolution_;
+        }
+    }
+
+    if (channels_ < 2) {
+        coherence_ = 1.0f;
+        return coherence_;
+    }
+
+    float sum = 0.0f;
+    size_t pairs = 0;
+    float* state = pairState_.data();
+    for (size_t a = 0; a < channels_; ++a) {
+        for (size_t b = a + 1; b < channels_; ++b) {
+            sum += kernels_.coherence(transforms_.data() + a * stride + 2 * bandStart_,
+                                      transforms_.data() + b * stride + 2 * bandStart_,
+                                      bandBins_, decay_, state);
+            state += 4 * bandBins_;
+            ++pairs;
+        }
+    }
+    coherence_ = sum / static_cast<float>(pairs);
+    return coherence_;
+}
+
+void MultiChannelAnalyzer::reset() {
+    std::fill(pairState_.begin(), pairState_.end(), 0.0f);
+    coherence_ = 1.0f;
+}
+
+} // namespace micmap::detection
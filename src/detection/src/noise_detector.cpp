@@ -4,21 +4,26 @@
  */
 
 #include "micmap/detection/noise_detector.hpp"
+#include "micmap/detection/streaming_stft.hpp"
+#include "micmap/detection/rolling_stats.hpp"
+#include "micmap/detection/sliding_dft.hpp"
+#include "micmap/detection/training_stats.hpp"
 #include "micmap/common/logger.hpp"
 
 #include <fstream>
 #include <cstring>
 #include <algorithm>
-#include <numeric>
 #include <cmath>
 #include <mutex>
+#include <stdexcept>
 
 namespace micmap::detection {
 
 namespace {
     constexpr float EPSILON = 1e-10f;
     constexpr char MAGIC[4] = {'M', 'M', 'A', 'P'};
-    constexpr uint32_t FORMAT_VERSION = 1;
+    constexpr uint32_t FORMAT_VERSION = 3;      // v2 appends the log-domain mean and variance, v3 the band layout
+    constexpr uint32_t MIN_FORMAT_VERSION = 1;  // v1 profiles load without variances
     constexpr int DEFAULT_MIN_DETECTION_DURATION_MS = 300;
 }
 
@@ -31,12 +36,15 @@ struct TrainingDataHeader {
     uint32_t version;           // Format version
     uint32_t sampleRate;        // Audio sample rate
     uint32_t fftSize;           // FFT window size
-    uint32_t profileSize;       // Number of frequency bins
+    uint32_t profileSize;       // Number of frequency bins (per stored vector)
     float energyThreshold;      // Minimum energy
     float correlationThreshold; // Minimum correlation
     float spectralFlatnessThreshold; // Minimum spectral flatness
     int64_t timestamp;          // Training timestamp (Unix time)
-    uint32_t reserved[4];       // Reserved for future use
+    uint32_t bandScale;         // 0 = FFT bins, 1 = mel bands, 2 = ERB bands (v3)
+    float bandMinHz;            // Band range; zero for FFT bins (v3)
+    float bandMaxHz;
+    uint32_t reserved;          // Reserved for future use
 };
 #pragma pack(pop)
 
@@ -48,22 +56,108 @@ struct TrainingDataHeader {
  * - Energy level (must be within expected range)
  * - Cross-correlation with trained profile
  * - Temporal consistency (configurable duration, default 500ms from config)
+ *
+ * Audio is framed by a StreamingSTFT, so every per-frame statistic below
+ * advances once per hop regardless of the device packet size. Durations are
+ * measured on an IClock, by default the count of samples analysed. With
+ * CascadeConfig::enabled, frames run the FFT only when they can matter.
+ *
+ * Several profiles can be stored. Each frame is matched against all of
+ * them through one profile matrix, and the best match scores the frame.
+ * With a filterbank, profiles are trained and matched on its bands rather
+ * than on the FFT bins. With MonitorConfig::enabled, idle frames are
+ * matched on a few bins tracked by a sliding DFT instead.
+ *
+ * With several channels, each channel has its own StreamingSTFT and a
+ * MultiChannelAnalyzer transforms all of them per frame. The loudest
+ * channel's hop and spectrum then go through the same scoring as a mono
+ * frame, and the channels' coherence can arm the gate.
  */
 class FFTNoiseDetector : public INoiseDetector {
 public:
-    FFTNoiseDetector(uint32_t sampleRate, size_t fftSize)
-        : sampleRate_(sampleRate)
-        , fftSize_(fftSize)
+    explicit FFTNoiseDetector(const NoiseDetectorConfig& config)
+        : sampleRate_(config.sampleRate)
+        , fftSize_(config.fftSize)
+        , kernels_(getSpectralFeatureKernels(config.featureLevel))
+        , thresholds_(config.thresholds)
+        , cascade_(config.cascade)
+        , monitor_(config.monitor)
+        , profileMatch_(config.profileMatch)
+        , sampleClock_(config.sampleRate)
+        , sharedClock_(config.clock)
+        , clock_(config.clock ? config.clock.get() : &sampleClock_)
         , sensitivity_(0.7f)
-        , training_(false)
-        , hasTrainingData_(false)
         , minDetectionDurationMs_(DEFAULT_MIN_DETECTION_DURATION_MS)
+        , stft_(config.fftSize, config.hopSize)
+        , trainingStft_(config.fftSize, config.hopSize)
+        , channels_(config.channels)
+        , training_(false)
         , detectionStartTime_()
         , isCurrentlyDetecting_(false) {
         
-        analyzer_ = createKissFFTAnalyzer(sampleRate, fftSize);
+        if (thresholds_.hitWindowMs <= 0 || thresholds_.energyWindowMs <= 0) {
+            throw std::invalid_argument("Detection windows must be positive");
+        }
+        size_t hitFrames = windowFrames(thresholds_.hitWindowMs);
+        if (hitFrames > static_cast<size_t>(DetectionThresholds::MAX_HIT_FRAMES)) {
+            MICMAP_LOG_WARNING("Hit window of ", thresholds_.hitWindowMs, " ms spans ", hitFrames,
+                               " frames, using ", DetectionThresholds::MAX_HIT_FRAMES);
+        }
+        hitWindow_ = HitWindow(hitFrames);
+        energyWindow_ = RollingStats(windowFrames(thresholds_.energyWindowMs));
+        const int window = static_cast<int>(hitWindow_.length());
+        if (thresholds_.startHits < 1 || thresholds_.startHits > window ||
+            thresholds_.stopHits < 1 || thresholds_.stopHits > window) {
+            throw std::invalid_argument("Detection hit thresholds must be within the hit window");
+        }
+        if (cascade_.idleInterval < 1) {
+            throw std::invalid_argument("Cascade idle interval must be at least 1");
+        }
+        if (monitor_.enabled && (monitor_.bins == 0 || config.filterbank.enabled ||
+                                 config.hopSize == 0 || config.fftSize % config.hopSize != 0)) {
+            throw std::invalid_argument("Monitoring needs bins, FFT-bin profiles and a hop that divides the FFT size");
+        }
+        if (channels_ == 0 || channels_ > NoiseDetectorConfig::MAX_CHANNELS) {
+            throw std::invalid_argument("Detector channels must be within [1, MAX_CHANNELS]");
+        }
+        if (channels_ > 1 && (cascade_.enabled || monitor_.enabled)) {
+            throw std::invalid_argument("Multi-channel analysis cannot be combined with the cascade or monitoring");
+        }
+        
+        analyzer_ = createSpectralAnalyzer(sampleRate_, fftSize_, config.fftBackend, kernels_.level);
+        lastResult_ = DetectionResult{};
+        lastResult_.coherence = 1.0f;
+        
+        size_t numBins = analyzer_->getNumBins();
+        featureBins_ = numBins;
+        if (config.filterbank.enabled) {
+            filterbank_ = std::make_unique<Filterbank>(config.filterbank, sampleRate_, fftSize_,
+                                                       kernels_.level);
+            featureBins_ = filterbank_->getNumBands();
+        }
         
-        MICMAP_LOG_DEBUG("Created FFT noise detector: ", fftSize_, " point FFT at ", sampleRate_, " Hz");
+        // Everything the per-frame path touches is sized up front so that
+        // steady-state analysis never allocates
+        magnitudes_.resize(numBins, 0.0f);
+        if (channels_ > 1) {
+            channelAnalyzer_ = std::make_unique<MultiChannelAnalyzer>(
+                sampleRate_, fftSize_, channels_, config.coherence, config.fftBackend, kernels_.level);
+            channelStfts_.assign(channels_, StreamingSTFT(config.fftSize, config.hopSize));
+            trainingChannelStfts_.assign(channels_, StreamingSTFT(config.fftSize, config.hopSize));
+            channelFrames_.assign(channels_, nullptr);
+            channelHops_.assign(channels_, nullptr);
+            channelMagnitudes_.resize(channels_ * numBins, 0.0f);
+            channelFeatures_.resize(channels_);
+        }
+        bands_.resize(filterbank_ ? featureBins_ : 0, 0.0f);
+        logSpectrum_.resize(featureBins_, 0.0f);
+        logSquared_.resize(featureBins_, 0.0f);
+        trainingSpectrum_.resize(featureBins_);
+        trainingLogSpectrum_.resize(featureBins_);
+        
+        MICMAP_LOG_DEBUG("Created FFT noise detector: ", fftSize_, " point FFT, hop ",
+                         stft_.getHopSize(), " at ", sampleRate_, " Hz, matching ", featureBins_,
+                         filterbank_ ? " bands" : " bins", ", ", channels_, " channel(s)");
     }
     
     ~FFTNoiseDetector() override = default;
@@ -74,9 +168,11 @@ public:
         std::lock_guard<std::mutex> lock(mutex_);
         
         training_ = true;
-        trainingSpectra_.clear();
-        trainingEnergies_.clear();
-        trainingFlatnesses_.clear();
+        trainingStft_.reset();
+        for (StreamingSTFT& stft : trainingChannelStfts_) {
+            stft.reset();
+        }
+        resetTrainingStats();
         
         MICMAP_LOG_INFO("Started noise detection training");
     }
@@ -88,21 +184,27 @@ public:
             return;
         }
         
-        auto result = analyzer_->analyze(samples, count);
+        trainingStft_.process(samples, count, [this](const float* frame, const float* hop) {
+            addTrainingFrame(frame, hop);
+        });
+    }
+    
+    void addTrainingChannels(const float* const* channels, size_t count) override {
+        if (channels_ == 1) {
+            addTrainingSample(channels ? channels[0] : nullptr, count);
+            return;
+        }
         
-        // Accept samples with any detectable energy (very low threshold)
-        // The "microphone covered" sound may be quiet and not spectrally flat
-        // We'll learn whatever pattern the user provides during training
-        if (result.energy > 0.00001f) {  // Very low threshold - just needs some signal
-            trainingSpectra_.push_back(result.magnitudes);
-            trainingEnergies_.push_back(result.energy);
-            trainingFlatnesses_.push_back(result.spectralFlatness);
-            
-            MICMAP_LOG_DEBUG("Added training sample: energy=", result.energy,
-                           ", flatness=", result.spectralFlatness);
-        } else {
-            MICMAP_LOG_DEBUG("Rejected training sample (no signal): energy=", result.energy);
+        std::lock_guard<std::mutex> lock(mutex_);
+        
+        if (!training_ || !channels || count == 0) {
+            return;
         }
+        
+        processChannels(trainingChannelStfts_, channels, count, [this]() {
+            size_t loudest = loudestChannel();
+            addTrainingFrame(channelFrames_[loudest], channelHops_[loudest]);
+        });
     }
     
     bool finishTraining() override {
@@ -114,75 +216,79 @@ public:
         
         training_ = false;
         
-        if (trainingSpectra_.empty()) {
+        size_t frameCount = trainingSpectrum_.count();
+        if (frameCount == 0) {
             MICMAP_LOG_ERROR("No valid training samples collected");
             return false;
         }
         
-        if (trainingSpectra_.size() < 5) {
-            MICMAP_LOG_ERROR("Not enough training samples: ", trainingSpectra_.size(), " < 5");
+        if (frameCount < 5) {
+            MICMAP_LOG_ERROR("Not enough training samples: ", frameCount, " < 5");
             return false;
         }
         
-        // Compute average spectral profile
-        size_t profileSize = trainingSpectra_[0].size();
-        trainingData_.spectralProfile.resize(profileSize, 0.0f);
-        
-        for (const auto& spectrum : trainingSpectra_) {
-            for (size_t i = 0; i < profileSize && i < spectrum.size(); ++i) {
-                trainingData_.spectralProfile[i] += spectrum[i];
-            }
-        }
+        Profile profile;
+        TrainingData& data = profile.data;
         
-        float numSamples = static_cast<float>(trainingSpectra_.size());
-        for (float& val : trainingData_.spectralProfile) {
-            val /= numSamples;
+        // Average spectral profile
+        const auto& meanSpectrum = trainingSpectrum_.mean();
+        data.spectralProfile.resize(meanSpectrum.size(), 0.0f);
+        for (size_t i = 0; i < meanSpectrum.size(); ++i) {
+            data.spectralProfile[i] = static_cast<float>(meanSpectrum[i]);
         }
         
         // Normalize profile (L2 normalization)
-        normalizeVector(trainingData_.spectralProfile);
+        normalizeVector(data.spectralProfile);
+        
+        // Diagonal-covariance model of the log spectrum
+        const auto& logMean = trainingLogSpectrum_.mean();
+        data.logMean.resize(logMean.size());
+        data.logVariance.resize(logMean.size());
+        for (size_t i = 0; i < logMean.size(); ++i) {
+            data.logMean[i] = static_cast<float>(logMean[i]);
+            data.logVariance[i] = static_cast<float>(trainingLogSpectrum_.variance(i));
+        }
         
         // Compute energy statistics
-        float energyMean = std::accumulate(trainingEnergies_.begin(), trainingEnergies_.end(), 0.0f)
-                          / static_cast<float>(trainingEnergies_.size());
-        float energyStdDev = computeStdDev(trainingEnergies_, energyMean);
+        float energyMean = static_cast<float>(trainingEnergy_.mean());
+        float energyStdDev = static_cast<float>(trainingEnergy_.stdDev());
         
         // Store energy statistics for detection
-        trainingData_.energyThreshold = std::max(0.000001f, energyMean);
+        data.energyThreshold = std::max(0.000001f, energyMean);
         
-        // Store minimum energy (with margin) - energy must be at least this high
-        float minEnergy = *std::min_element(trainingEnergies_.begin(), trainingEnergies_.end());
-        energyMinThreshold_ = minEnergy * 0.3f;  // 30% of minimum training energy
+        // Store low energy (with margin) - energy must be at least this high.
+        // The 5th percentile ignores the odd quiet frame at the session edges
+        float lowEnergy = static_cast<float>(trainingEnergyLow_.value());
+        profile.energyMinThreshold = lowEnergy * 0.3f;  // 30% of low training energy
         
         // Store energy variance - covered mic has CONSISTENT energy (low variance)
         // This helps distinguish from speech which has high variance
-        energyVarianceThreshold_ = energyStdDev / energyMean;  // Coefficient of variation
+        profile.energyVarianceThreshold = energyStdDev / energyMean;  // Coefficient of variation
         
         // Compute flatness statistics
-        float flatnessMean = std::accumulate(trainingFlatnesses_.begin(), trainingFlatnesses_.end(), 0.0f)
-                            / static_cast<float>(trainingFlatnesses_.size());
-        spectralFlatnessThreshold_ = flatnessMean;
+        float flatnessMean = static_cast<float>(trainingFlatness_.mean());
+        profile.spectralFlatnessThreshold = flatnessMean;
         
         // Correlation threshold
-        trainingData_.correlationThreshold = 0.4f + (1.0f - sensitivity_) * 0.3f;
+        data.correlationThreshold = 0.4f + (1.0f - sensitivity_) * 0.3f;
         
-        MICMAP_LOG_INFO("  Energy min threshold: ", energyMinThreshold_);
-        MICMAP_LOG_INFO("  Energy CV threshold: ", energyVarianceThreshold_);
+        MICMAP_LOG_INFO("  Energy min threshold: ", profile.energyMinThreshold);
+        MICMAP_LOG_INFO("  Energy CV threshold: ", profile.energyVarianceThreshold);
         
-        trainingData_.sampleRate = sampleRate_;
-        trainingData_.trainedAt = std::chrono::system_clock::now();
+        data.sampleRate = sampleRate_;
+        data.trainedAt = std::chrono::system_clock::now();
         
-        hasTrainingData_ = true;
+        // A new training replaces every stored profile
+        profiles_.assign(1, std::move(profile));
+        updateProfileCache();
         
-        MICMAP_LOG_INFO("Training complete: ", trainingSpectra_.size(), " samples");
-        MICMAP_LOG_INFO("  Energy threshold: ", trainingData_.energyThreshold);
-        MICMAP_LOG_INFO("  Correlation threshold: ", trainingData_.correlationThreshold);
-        MICMAP_LOG_INFO("  Flatness threshold: ", spectralFlatnessThreshold_);
+        const Profile& trained = profiles_.front();
+        MICMAP_LOG_INFO("Training complete: ", frameCount, " samples");
+        MICMAP_LOG_INFO("  Energy threshold: ", trained.data.energyThreshold);
+        MICMAP_LOG_INFO("  Correlation threshold: ", trained.data.correlationThreshold);
+        MICMAP_LOG_INFO("  Flatness threshold: ", trained.spectralFlatnessThreshold);
         
-        // Clear training buffers
-        trainingSpectra_.clear();
-        trainingEnergies_.clear();
-        trainingFlatnesses_.clear();
+        resetTrainingStats();
         
         return true;
     }
@@ -196,26 +302,121 @@ public:
     DetectionResult analyze(const float* samples, size_t count) override {
         std::lock_guard<std::mutex> lock(mutex_);
         
-        DetectionResult result{};
-        result.confidence = 0.0f;
-        result.energy = 0.0f;
-        result.spectralFlatness = 0.0f;
-        result.correlation = 0.0f;
-        result.isWhiteNoise = false;
+        if (!samples || count == 0) {
+            updateTemporalState(false);
+            return DetectionResult{};
+        }
+        
+        // Run detection once per completed frame; a packet that does not
+        // complete a frame reports the latest frame's result
+        stft_.process(samples, count, [this](const float* frame, const float* hop) {
+            lastResult_ = analyzeFrame(frame, hop);
+        });
+        
+        return lastResult_;
+    }
+    
+    size_t analyzeInto(const float* samples, size_t count,
+                       DetectionResult* results, size_t maxResults) override {
+        std::lock_guard<std::mutex> lock(mutex_);
         
         if (!samples || count == 0) {
             updateTemporalState(false);
-            return result;
+            return 0;
         }
         
-        // Perform spectral analysis
-        auto spectral = analyzer_->analyze(samples, count);
+        size_t written = 0;
+        stft_.process(samples, count, [&](const float* frame, const float* hop) {
+            lastResult_ = analyzeFrame(frame, hop);
+            if (results && written < maxResults) {
+                results[written++] = lastResult_;
+            }
+        });
         
-        result.energy = spectral.energy;
-        result.spectralFlatness = spectral.spectralFlatness;
+        return written;
+    }
+    
+    size_t analyzeChannelsInto(const float* const* channels, size_t count,
+                               DetectionResult* results, size_t maxResults) override {
+        if (channels_ == 1) {
+            return analyzeInto(channels ? channels[0] : nullptr, count, results, maxResults);
+        }
+        
+        std::lock_guard<std::mutex> lock(mutex_);
+        
+        if (!channels || count == 0) {
+            updateTemporalState(false);
+            return 0;
+        }
+        
+        size_t written = 0;
+        processChannels(channelStfts_, channels, count, [&]() {
+            lastResult_ = analyzeChannelFrame();
+            if (results && written < maxResults) {
+                results[written++] = lastResult_;
+            }
+        });
+        
+        return written;
+    }
+    
+    /**
+     * @brief Run the detection logic on one STFT frame
+     * @param frame fftSize samples, oldest first
+     * @param hop The newest hopSize samples of the frame
+     */
+    DetectionResult analyzeFrame(const float* frame, const float* hop) {
+        // Level tracking uses only the newest hop so spikes are not diluted
+        // by the overlap with previous frames
+        return scoreFrame(frame, kernels_.meanSquare(hop, stft_.getHopSize()), 1.0f);
+    }
+    
+    /**
+     * @brief Run the detection logic on the frames in channelFrames_
+     *
+     * The loudest hop is the mic being covered, if any; it stands in for
+     * the mono frame. All channels are transformed for the coherence.
+     */
+    DetectionResult analyzeChannelFrame() {
+        loudestChannel_ = loudestChannel();
+        float energy = kernels_.meanSquare(channelHops_[loudestChannel_], stft_.getHopSize());
+        float coherence = channelAnalyzer_->analyzeInto(channelFrames_.data(), channelMagnitudes_.data(),
+                                                        channelFeatures_.data());
+        
+        const size_t numBins = magnitudes_.size();
+        const float* spectrum = channelMagnitudes_.data() + loudestChannel_ * numBins;
+        std::copy(spectrum, spectrum + numBins, magnitudes_.begin());
+        return scoreFrame(nullptr, energy, coherence);
+    }
+    
+    /**
+     * @brief Score one frame
+     * @param frame fftSize samples, oldest first, or null for a multi-channel
+     *              frame whose spectrum is already in magnitudes_
+     * @param energy Mean square of the frame's newest hop
+     * @param coherence Inter-channel coherence of the frame (1 for mono)
+     */
+    DetectionResult scoreFrame(const float* frame, float energy, float coherence) {
+        DetectionResult result{};
+        ++cascadeStats_.frames;
+        
+        // The frame ends with its newest hop; the internal clock counts the
+        // audio consumed so far
+        if (!sharedClock_) {
+            sampleClock_.advance(stft_.getHopSize());
+        }
+        
+        result.energy = energy;
+        result.coherence = coherence;
         
         // Without training data, cannot detect
-        if (!hasTrainingData_) {
+        if (profiles_.empty()) {
+            if (cascade_.enabled) {
+                ++cascadeStats_.energyOnly;
+            } else {
+                ++cascadeStats_.analyzed;
+                result.spectralFlatness = frameSpectrum(frame).spectralFlatness;
+            }
             result.confidence = 0.0f;
             result.correlation = 0.0f;
             result.isWhiteNoise = false;
@@ -232,75 +433,112 @@ public:
         // Solution: Require spike to arm detection, then use frequency-based detection
         
         // Convert energy to dB for spike detection
-        float energyDb = (spectral.energy > EPSILON) ?
-            10.0f * std::log10(spectral.energy) : -60.0f;
+        float energyDb = (energy > EPSILON) ?
+            10.0f * std::log10(energy) : -60.0f;
         
         // Track energy history for consistency
-        updateEnergyHistory(spectral.energy);
+        energyWindow_.add(energy);
+        
+        float bestEnergyRatio = 0.0f;
+        for (size_t k = 0; k < profiles_.size(); ++k) {
+            energyRatios_[k] = computeEnergyRatio(energy, profiles_[k].data.energyThreshold);
+            bestEnergyRatio = std::max(bestEnergyRatio, energyRatios_[k]);
+        }
         
         // SPIKE DETECTION: Look for energy near 0dB (very loud)
         // Normal audio: -60 to -25 dB
-        // Spike when touching: > -10 dB (approaching 0dB)
-        bool spikeDetected = energyDb > -10.0f;
+        // Spike when touching: > -10 dB by default (approaching 0dB)
+        bool spikeDetected = energyDb > thresholds_.spikeThresholdDb;
+        
+        // A covered mic stops hearing what the others hear; quiet rooms
+        // decorrelate too, hence the trained energy range
+        bool decorrelated = coherence < thresholds_.decorrelationThreshold && bestEnergyRatio > 0.0f;
         
-        if (spikeDetected && !spikeTriggered_) {
+        if ((spikeDetected || decorrelated) && !spikeTriggered_) {
             spikeTriggered_ = true;
-            spikeTime_ = std::chrono::steady_clock::now();
-            MICMAP_LOG_DEBUG("SPIKE detected! Energy: ", energyDb, " dB");
+            spikeTime_ = clock_->now();
+            if (spikeDetected) {
+                MICMAP_LOG_DEBUG("SPIKE detected! Energy: ", energyDb, " dB");
+            } else {
+                MICMAP_LOG_DEBUG("Channels decorrelated: coherence ", coherence);
+            }
         }
         
         // Check if spike is still valid (within time window)
         bool spikeValid = false;
         if (spikeTriggered_) {
             auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-                std::chrono::steady_clock::now() - spikeTime_).count();
-            // Spike arms detection for 3 seconds
-            spikeValid = elapsed < 500;
+                clock_->now() - spikeTime_).count();
+            // Spike arms detection for spikeWindowMs
+            spikeValid = elapsed < thresholds_.spikeWindowMs;
             if (!spikeValid && !isCurrentlyDetecting_) {
                 spikeTriggered_ = false;  // Spike expired and not detecting
                 MICMAP_LOG_DEBUG("Spike expired");
             }
         }
         
-        // Compute confidence factors
+        // Energy factors of the confidence need no spectrum
         float energyConsistency = computeEnergyConsistency();
         
-        float energyRatio = 0.0f;
-        if (trainingData_.energyThreshold > EPSILON) {
-            float ratio = spectral.energy / trainingData_.energyThreshold;
-            if (ratio >= 0.3f && ratio <= 5.0f) {
-                if (ratio < 1.0f) {
-                    energyRatio = (ratio - 0.3f) / 0.7f;
-                } else {
-                    energyRatio = std::min(1.0f, 0.8f + ratio * 0.04f);
-                }
+        // Spectral stage: the FFT and profile match run on every frame while
+        // detection can start or continue; otherwise see CascadeConfig.
+        // Reused frames keep the similarities of the last analysed frame
+        CascadeStage stage = selectCascadeStage(bestEnergyRatio, energyConsistency);
+        if (stage == CascadeStage::Monitored) {
+            ++cascadeStats_.monitored;
+            matchMonitor(frame);
+        } else if (monitorAnalyzer_) {
+            // The sliding DFT only follows consecutive frames
+            monitorAnalyzer_->reset();
+        }
+        if (stage == CascadeStage::Analyzed) {
+            ++cascadeStats_.analyzed;
+            auto spectral = frameSpectrum(frame);
+            matchProfiles(featureSpectrum());
+            lastSpectralFlatness_ = spectral.spectralFlatness;
+        } else if (stage == CascadeStage::Reused) {
+            ++cascadeStats_.reused;
+        } else if (stage == CascadeStage::EnergyOnly) {
+            ++cascadeStats_.energyOnly;
+        }
+        result.spectralFlatness = lastSpectralFlatness_;
+        
+        // The best spectral match scores the frame with its own thresholds.
+        // Ties, and frames without a spectrum, go to the best energy match
+        size_t active = 0;
+        for (size_t k = 1; k < profiles_.size(); ++k) {
+            float similarity = (stage == CascadeStage::EnergyOnly) ? 0.0f : similarities_[k];
+            float bestSimilarity = (stage == CascadeStage::EnergyOnly) ? 0.0f : similarities_[active];
+            if (similarity > bestSimilarity ||
+                (similarity == bestSimilarity && energyRatios_[k] > energyRatios_[active])) {
+                active = k;
             }
         }
-        
-        float pearsonCorr = computeCorrelation(spectral.magnitudes, trainingData_.spectralProfile);
-        float shapeSimilarity = computeSpectralShapeDistance(spectral.magnitudes, trainingData_.spectralProfile);
-        result.correlation = std::sqrt(pearsonCorr * shapeSimilarity);
+        activeProfile_ = static_cast<int>(active);
+        float energyRatio = energyRatios_[active];
+        result.correlation = (stage == CascadeStage::EnergyOnly) ? 0.0f : similarities_[active];
         
         // Confidence combines all factors
-        result.confidence = 0.35f * energyRatio +
-                           0.35f * energyConsistency +
-                           0.30f * result.correlation;
+        result.confidence = ENERGY_RATIO_WEIGHT * energyRatio +
+                           ENERGY_CONSISTENCY_WEIGHT * energyConsistency +
+                           CORRELATION_WEIGHT * result.correlation;
         
         // Track high-confidence hits in sliding window
-        bool isHighConfidence = result.confidence >= 0.60f;  // 60% threshold for "high"
-        updateConfidenceHistory(isHighConfidence);
+        bool isHighConfidence = stage != CascadeStage::EnergyOnly &&
+                                result.confidence >= thresholds_.highConfidence;
+        hitWindow_.push(isHighConfidence);
         
         // Count high-confidence hits in recent history
-        int highHits = countHighConfidenceHits();
+        int highHits = hitWindow_.count();
         
         // FREQUENCY-BASED DETECTION with SPIKE GATE:
         // - Must have spike to start (or already detecting)
-        // - Start: Need 4+ high hits out of last 12 samples
-        // - Continue: Need 2+ high hits out of last 12
-        // - Stop: Less than 2 high hits
+        // - Start: Need startHits (default 4) high hits in the hit window (12 frames)
+        // - Continue: Need stopHits (default 2) high hits in the hit window
+        // - Stop: Fewer than stopHits high hits
         
-        int startThreshold = 4;
-        int stopThreshold = 2;
+        int startThreshold = thresholds_.startHits;
+        int stopThreshold = thresholds_.stopHits;
         
         bool instantDetection;
         if (isCurrentlyDetecting_) {
@@ -329,10 +567,11 @@ public:
     bool saveTrainingData(const std::filesystem::path& path) override {
         std::lock_guard<std::mutex> lock(mutex_);
         
-        if (!hasTrainingData_) {
+        if (profiles_.empty()) {
             MICMAP_LOG_ERROR("No training data to save");
             return false;
         }
+        const TrainingData& trainingData = profiles_.front().data;
         
         std::ofstream file(path, std::ios::binary);
         if (!file) {
@@ -344,26 +583,40 @@ public:
         TrainingDataHeader header{};
         std::memcpy(header.magic, MAGIC, 4);
         header.version = FORMAT_VERSION;
-        header.sampleRate = trainingData_.sampleRate;
+        header.sampleRate = trainingData.sampleRate;
         header.fftSize = static_cast<uint32_t>(fftSize_);
-        header.profileSize = static_cast<uint32_t>(trainingData_.spectralProfile.size());
-        header.energyThreshold = trainingData_.energyThreshold;
-        header.correlationThreshold = trainingData_.correlationThreshold;
-        header.spectralFlatnessThreshold = spectralFlatnessThreshold_;
+        header.profileSize = static_cast<uint32_t>(trainingData.spectralProfile.size());
+        header.energyThreshold = trainingData.energyThreshold;
+        header.correlationThreshold = trainingData.correlationThreshold;
+        header.spectralFlatnessThreshold = profiles_.front().spectralFlatnessThreshold;
         header.timestamp = std::chrono::duration_cast<std::chrono::seconds>(
-            trainingData_.trainedAt.time_since_epoch()
+            trainingData.trainedAt.time_since_epoch()
         ).count();
-        std::memset(header.reserved, 0, sizeof(header.reserved));
+        header.bandScale = bandScaleCode();
+        header.bandMinHz = filterbank_ ? filterbank_->getMinFrequency() : 0.0f;
+        header.bandMaxHz = filterbank_ ? filterbank_->getMaxFrequency() : 0.0f;
+        header.reserved = 0;
         
         // Write header
         file.write(reinterpret_cast<const char*>(&header), sizeof(header));
         
         // Write spectral profile
         file.write(
-            reinterpret_cast<const char*>(trainingData_.spectralProfile.data()),
-            trainingData_.spectralProfile.size() * sizeof(float)
+            reinterpret_cast<const char*>(trainingData.spectralProfile.data()),
+            trainingData.spectralProfile.size() * sizeof(float)
         );
         
+        // Write the log-domain model; a profile loaded from v1 has none, so
+        // zero variances mark it as absent
+        std::vector<float> logMean = trainingData.logMean;
+        std::vector<float> logVariance = trainingData.logVariance;
+        logMean.resize(header.profileSize, 0.0f);
+        logVariance.resize(header.profileSize, 0.0f);
+        file.write(reinterpret_cast<const char*>(logMean.data()),
+                   logMean.size() * sizeof(float));
+        file.write(reinterpret_cast<const char*>(logVariance.data()),
+                   logVariance.size() * sizeof(float));
+        
         if (!file) {
             MICMAP_LOG_ERROR("Failed to write training data to: ", path.string());
             return false;
@@ -376,6 +629,278 @@ public:
     bool loadTrainingData(const std::filesystem::path& path) override {
         std::lock_guard<std::mutex> lock(mutex_);
         
+        Profile profile;
+        if (!readProfile(path, profile)) {
+            return false;
+        }
+        
+        profiles_.assign(1, std::move(profile));
+        updateProfileCache();
+        
+        const TrainingData& data = profiles_.front().data;
+        MICMAP_LOG_INFO("Loaded training data from: ", path.string());
+        MICMAP_LOG_INFO("  Sample rate: ", data.sampleRate, " Hz");
+        MICMAP_LOG_INFO("  Profile size: ", data.spectralProfile.size(), " bins");
+        MICMAP_LOG_INFO("  Energy threshold: ", data.energyThreshold);
+        MICMAP_LOG_INFO("  Correlation threshold: ", data.correlationThreshold);
+        MICMAP_LOG_INFO("  Profile match: ", useMahalanobis_ ? "Mahalanobis" : "Correlation");
+        
+        return true;
+    }
+    
+    bool addTrainingData(const std::filesystem::path& path) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        
+        Profile profile;
+        if (!readProfile(path, profile)) {
+            return false;
+        }
+        
+        if (!profiles_.empty()) {
+            const TrainingData& first = profiles_.front().data;
+            if (profile.data.sampleRate != first.sampleRate ||
+                profile.data.spectralProfile.size() != first.spectralProfile.size()) {
+                MICMAP_LOG_ERROR("Profile ", path.string(), " does not match the stored profiles (",
+                                 profile.data.sampleRate, " Hz, ", profile.data.spectralProfile.size(),
+                                 " bins)");
+                return false;
+            }
+        }
+        
+        profiles_.push_back(std::move(profile));
+        updateProfileCache();
+        
+        MICMAP_LOG_INFO("Added training data from: ", path.string(), " (",
+                        profiles_.size(), " profiles, ",
+                        useMahalanobis_ ? "Mahalanobis" : "Correlation", " match)");
+        return true;
+    }
+    
+    bool hasTrainingData() const override {
+        return !profiles_.empty();
+    }
+    
+    size_t getProfileCount() const override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return profiles_.size();
+    }
+    
+    int getActiveProfile() const override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return activeProfile_;
+    }
+    
+    // ========== Configuration ==========
+    
+    void setSensitivity(float sensitivity) override {
+        sensitivity_ = std::clamp(sensitivity, 0.0f, 1.0f);
+        
+        // Update correlation threshold if we have training data
+        for (Profile& profile : profiles_) {
+            profile.data.correlationThreshold = 0.3f + (1.0f - sensitivity_) * 0.5f;
+        }
+    }
+    
+    float getSensitivity() const override {
+        return sensitivity_;
+    }
+    
+    void setMinDetectionDuration(int durationMs) override {
+        minDetectionDurationMs_ = std::max(0, durationMs);
+        MICMAP_LOG_DEBUG("Set minimum detection duration to ", minDetectionDurationMs_, " ms");
+    }
+    
+    int getMinDetectionDuration() const override {
+        return minDetectionDurationMs_;
+    }
+    
+    const TrainingData& getTrainingData() const override {
+        static const TrainingData empty{};
+        return profiles_.empty() ? empty : profiles_.front().data;
+    }
+    
+    CascadeStats getCascadeStats() const override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return cascadeStats_;
+    }
+    
+    ProfileMatch getProfileMatch() const override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return useMahalanobis_ ? ProfileMatch::Mahalanobis : ProfileMatch::Correlation;
+    }
+    
+private:
+    // Confidence weights; the correlation is at most 1
+    static constexpr float ENERGY_RATIO_WEIGHT = 0.35f;
+    static constexpr float ENERGY_CONSISTENCY_WEIGHT = 0.35f;
+    static constexpr float CORRELATION_WEIGHT = 0.30f;
+    
+    // Floor of the per-bin log variance, so that bins that hardly varied in
+    // training do not dominate the distance
+    static constexpr float MIN_LOG_VARIANCE = 0.05f;
+    
+    // Decay of the Mahalanobis similarity per unit of excess distance
+    static constexpr float MAHALANOBIS_SCALE = 0.25f;
+    
+    /**
+     * @brief One stored profile and the thresholds trained with it
+     */
+    struct Profile {
+        TrainingData data{};
+        float spectralFlatnessThreshold = 0.3f;
+        float energyMinThreshold = 0.0f;
+        float energyVarianceThreshold = 0.5f;
+    };
+    
+    /**
+     * @brief Per-profile constants of the batched match
+     */
+    struct ProfileTerms {
+        float norm = 0.0f;      // Sum of squares of row 0 (correlation) or sum of w (Mahalanobis)
+        float offset = 0.0f;    // Sum of squares of row 1 (correlation) or sum of w*mu^2 (Mahalanobis)
+    };
+    
+    /**
+     * @brief Spectrum of one frame into magnitudes_
+     */
+    SpectralFeatures analyzeSpectrum(const float* frame) {
+        return analyzer_->analyzeInto(frame, fftSize_, magnitudes_.data(), magnitudes_.size());
+    }
+    
+    /**
+     * @brief Spectrum of the frame being scored into magnitudes_
+     *
+     * A null frame is a multi-channel frame; analyzeChannelFrame() already
+     * put its loudest channel's spectrum into magnitudes_.
+     */
+    SpectralFeatures frameSpectrum(const float* frame) {
+        return frame ? analyzeSpectrum(frame) : channelFeatures_[loudestChannel_];
+    }
+    
+    /**
+     * @brief Feed every channel's samples to its framer in lockstep
+     * @param stfts One framer per channel, all at the same position
+     * @param channels One pointer per channel to count samples
+     * @param count Samples per channel
+     * @param handler Called once per completed frame, with the frames in
+     *                channelFrames_ and their hops in channelHops_
+     *
+     * Each step feeds at most the rest of a hop, so a step completes at
+     * most one frame, and it stays readable until the framer's next call.
+     */
+    template <typename FrameHandler>
+    void processChannels(std::vector<StreamingSTFT>& stfts, const float* const* channels,
+                         size_t count, FrameHandler&& handler) {
+        const size_t hopSize = stfts.front().getHopSize();
+        size_t offset = 0;
+        while (offset < count) {
+            size_t n = std::min(count - offset, hopSize - stfts.front().getPendingSamples());
+            size_t frames = 0;
+            for (size_t c = 0; c < stfts.size(); ++c) {
+                frames = stfts[c].process(channels[c] + offset, n, [&](const float* frame, const float* hop) {
+                    channelFrames_[c] = frame;
+                    channelHops_[c] = hop;
+                });
+            }
+            offset += n;
+            if (frames > 0) {
+                handler();
+            }
+        }
+    }
+    
+    /**
+     * @brief Channel whose newest hop in channelHops_ has the most energy
+     */
+    size_t loudestChannel() const {
+        size_t loudest = 0;
+        float loudestEnergy = -1.0f;
+        for (size_t c = 0; c < channelHops_.size(); ++c) {
+            float energy = kernels_.meanSquare(channelHops_[c], stft_.getHopSize());
+            if (energy > loudestEnergy) {
+                loudest = c;
+                loudestEnergy = energy;
+            }
+        }
+        return loudest;
+    }
+    
+    /**
+     * @brief Values profiles are trained and matched on for the current magnitudes_
+     *
+     * The magnitudes themselves, or their bands with a filterbank.
+     */
+    const std::vector<float>& featureSpectrum() {
+        if (!filterbank_) {
+            return magnitudes_;
+        }
+        filterbank_->apply(magnitudes_.data(), bands_.data());
+        return bands_;
+    }
+    
+    /**
+     * @brief Band layout code stored in profile files
+     */
+    uint32_t bandScaleCode() const {
+        if (!filterbank_) {
+            return 0;
+        }
+        return filterbank_->getScale() == FilterbankScale::ERB ? 2 : 1;
+    }
+    
+    enum class CascadeStage {
+        EnergyOnly,     // Not a hit; no spectrum needed
+        Reused,         // Idle frame scored with the last profile match
+        Monitored,      // Idle frame scored on the sparse monitor bins
+        Analyzed        // FFT and profile match
+    };
+    
+    /**
+     * @brief Pick the cascade stage that handles the current frame
+     *
+     * Every frame is analysed without the cascade, while a spike is armed
+     * and while a detection is running. Otherwise detection cannot start on
+     * this frame and only its hit-window entry matters: frames outside the
+     * trained energy range (a covered mic sounds like the training) or that
+     * cannot reach highConfidence even with a perfect profile match stop at
+     * the energy gate. The rest are monitored on sparse bins if enabled, or
+     * else analysed every idleInterval frames, starting with the first one
+     * past the gate.
+     */
+    CascadeStage selectCascadeStage(float energyRatio, float energyConsistency) {
+        if ((!cascade_.enabled && !monitorAnalyzer_) || spikeTriggered_ || isCurrentlyDetecting_) {
+            idleCountdown_ = 0;
+            return CascadeStage::Analyzed;
+        }
+        
+        if (cascade_.enabled) {
+            float bestConfidence = ENERGY_RATIO_WEIGHT * energyRatio +
+                                   ENERGY_CONSISTENCY_WEIGHT * energyConsistency +
+                                   CORRELATION_WEIGHT;
+            if (energyRatio <= 0.0f || bestConfidence < thresholds_.highConfidence) {
+                // The last match may predate a silence: analyse the next
+                // frame that passes the gate
+                idleCountdown_ = 0;
+                return CascadeStage::EnergyOnly;
+            }
+        }
+        
+        if (monitorAnalyzer_) {
+            return CascadeStage::Monitored;
+        }
+        
+        if (idleCountdown_ > 0) {
+            --idleCountdown_;
+            return CascadeStage::Reused;
+        }
+        idleCountdown_ = cascade_.idleInterval - 1;
+        return CascadeStage::Analyzed;
+    }
+    
+    /**
+     * @brief Read a profile written by saveTrainingData()
+     */
+    bool readProfile(const std::filesystem::path& path, Profile& profile) {
         std::ifstream file(path, std::ios::binary);
         if (!file) {
             MICMAP_LOG_ERROR("Failed to open file for reading: ", path.string());
@@ -393,7 +918,7 @@ public:
         }
         
         // Validate version
-        if (header.version != FORMAT_VERSION) {
+        if (header.version < MIN_FORMAT_VERSION || header.version > FORMAT_VERSION) {
             MICMAP_LOG_ERROR("Unsupported training data version: ", header.version);
             return false;
         }
@@ -404,113 +929,428 @@ public:
             return false;
         }
         
+        // Version 3 records the band layout; older profiles are per FFT bin.
+        // Bands only compare with bands of the same layout
+        uint32_t bandScale = header.version >= 3 ? header.bandScale : 0;
+        if (bandScale != bandScaleCode() ||
+            (filterbank_ && (header.profileSize != featureBins_ ||
+                             std::abs(header.bandMinHz - filterbank_->getMinFrequency()) > 0.5f ||
+                             std::abs(header.bandMaxHz - filterbank_->getMaxFrequency()) > 0.5f))) {
+            MICMAP_LOG_ERROR("Profile ", path.string(), " was trained on a different band layout (",
+                             header.profileSize, bandScale == 0 ? " bins" : " bands", ")");
+            return false;
+        }
+
+        // At another rate or FFT size the same index is another frequency
+        // and the magnitudes are scaled differently
+        if (header.sampleRate != sampleRate_ || header.fftSize != fftSize_ ||
+            header.profileSize != featureBins_) {
+            MICMAP_LOG_ERROR("Profile ", path.string(), " was trained at ", header.sampleRate,
+                             " Hz with a ", header.fftSize, "-point FFT (", header.profileSize,
+                             " values); detector runs at ", sampleRate_, " Hz with a ",
+                             fftSize_, "-point FFT (", featureBins_, " values)");
+            return false;
+        }
+
         // Read spectral profile
-        trainingData_.spectralProfile.resize(header.profileSize);
+        TrainingData& data = profile.data;
+        data.spectralProfile.resize(header.profileSize);
         file.read(
-            reinterpret_cast<char*>(trainingData_.spectralProfile.data()),
+            reinterpret_cast<char*>(data.spectralProfile.data()),
             header.profileSize * sizeof(float)
         );
         
+        // Version 2 adds the log-domain mean and variance per bin
+        if (header.version >= 2) {
+            data.logMean.resize(header.profileSize);
+            data.logVariance.resize(header.profileSize);
+            file.read(reinterpret_cast<char*>(data.logMean.data()),
+                      header.profileSize * sizeof(float));
+            file.read(reinterpret_cast<char*>(data.logVariance.data()),
+                      header.profileSize * sizeof(float));
+        }
+        
         if (!file) {
             MICMAP_LOG_ERROR("Failed to read training data from: ", path.string());
             return false;
         }
         
         // Populate training data
-        trainingData_.sampleRate = header.sampleRate;
-        trainingData_.energyThreshold = header.energyThreshold;
-        trainingData_.correlationThreshold = header.correlationThreshold;
-        spectralFlatnessThreshold_ = header.spectralFlatnessThreshold;
-        trainingData_.trainedAt = std::chrono::system_clock::time_point(
+        data.sampleRate = header.sampleRate;
+        data.energyThreshold = header.energyThreshold;
+        data.correlationThreshold = header.correlationThreshold;
+        profile.spectralFlatnessThreshold = header.spectralFlatnessThreshold;
+        data.trainedAt = std::chrono::system_clock::time_point(
             std::chrono::seconds(header.timestamp)
         );
+        return true;
+    }
+    
+    /**
+     * @brief Energy factor of the confidence against one profile's trained energy
+     */
+    static float computeEnergyRatio(float energy, float trainedEnergy) {
+        if (trainedEnergy <= EPSILON) {
+            return 0.0f;
+        }
         
-        hasTrainingData_ = true;
+        float ratio = energy / trainedEnergy;
+        if (ratio < 0.3f || ratio > 5.0f) {
+            return 0.0f;
+        }
+        if (ratio < 1.0f) {
+            return (ratio - 0.3f) / 0.7f;
+        }
+        return std::min(1.0f, 0.8f + ratio * 0.04f);
+    }
+    
+    /**
+     * @brief Precompute the profile-side terms of the per-frame matching
+     *
+     * The profiles only change in finishTraining(), loadTrainingData() and
+     * addTrainingData(), so the first profile's mean-centered values, their
+     * sum of squares and its zero-mean log spectrum are computed once here
+     * instead of on every frame, as is the matrix for several profiles.
+     */
+    void updateProfileCache() {
+        profileBins_ = profiles_.empty() ? 0 :
+            std::min(profiles_.front().data.spectralProfile.size(), featureBins_);
+        profileCentered_.assign(profileBins_, 0.0f);
+        profileLogCentered_.assign(profileBins_, 0.0f);
+        profileSumSq_ = 0.0f;
+        energyRatios_.assign(profiles_.size(), 0.0f);
+        similarities_.assign(profiles_.size(), 0.0f);
+        activeProfile_ = -1;
+        updateVarianceCache();
+        updateProfileMatrix();
+        updateMonitor();
+        
+        if (profileBins_ == 0) {
+            return;
+        }
         
-        MICMAP_LOG_INFO("Loaded training data from: ", path.string());
-        MICMAP_LOG_INFO("  Sample rate: ", trainingData_.sampleRate, " Hz");
-        MICMAP_LOG_INFO("  Profile size: ", trainingData_.spectralProfile.size(), " bins");
-        MICMAP_LOG_INFO("  Energy threshold: ", trainingData_.energyThreshold);
-        MICMAP_LOG_INFO("  Correlation threshold: ", trainingData_.correlationThreshold);
+        const auto& profile = profiles_.front().data.spectralProfile;
+        float mean = 0.0f;
+        float logMean = 0.0f;
+        for (size_t i = 0; i < profileBins_; ++i) {
+            mean += profile[i];
+            profileLogCentered_[i] = std::log(profile[i] + EPSILON);
+            logMean += profileLogCentered_[i];
+        }
+        mean /= static_cast<float>(profileBins_);
+        logMean /= static_cast<float>(profileBins_);
         
-        return true;
+        for (size_t i = 0; i < profileBins_; ++i) {
+            profileCentered_[i] = profile[i] - mean;
+            profileSumSq_ += profileCentered_[i] * profileCentered_[i];
+            profileLogCentered_[i] -= logMean;
+        }
     }
     
-    bool hasTrainingData() const override {
-        return hasTrainingData_;
+    /**
+     * @brief Whether a profile carries the log-domain model for its bins
+     */
+    bool hasVarianceModel(const TrainingData& data) const {
+        return profileBins_ > 0 && data.logMean.size() >= profileBins_ &&
+               data.logVariance.size() >= profileBins_ &&
+               std::any_of(data.logVariance.begin(), data.logVariance.begin() + profileBins_,
+                           [](float v) { return v > 0.0f; });
     }
     
-    // ========== Configuration ==========
-    
-    void setSensitivity(float sensitivity) override {
-        sensitivity_ = std::clamp(sensitivity, 0.0f, 1.0f);
+    /**
+     * @brief Precompute the inverse variances of the log-domain model
+     *
+     * Also resolves ProfileMatch::Auto: the Mahalanobis match is used when
+     * every profile carries variances, i.e. was trained by this version or
+     * loaded from a version 2 file, so that all profiles score alike.
+     */
+    void updateVarianceCache() {
+        bool hasModel = !profiles_.empty() &&
+                        std::all_of(profiles_.begin(), profiles_.end(), [this](const Profile& p) {
+                            return hasVarianceModel(p.data);
+                        });
+        
+        useMahalanobis_ = hasModel && profileMatch_ != ProfileMatch::Correlation;
+        if (profileMatch_ == ProfileMatch::Mahalanobis && !hasModel && !profiles_.empty()) {
+            MICMAP_LOG_WARNING("Profile has no per-bin variances, using correlation matching");
+        }
         
-        // Update correlation threshold if we have training data
-        if (hasTrainingData_) {
-            trainingData_.correlationThreshold = 0.3f + (1.0f - sensitivity_) * 0.5f;
+        inverseVariance_.assign(useMahalanobis_ ? profileBins_ : 0, 0.0f);
+        inverseVarianceSum_ = 0.0f;
+        for (size_t i = 0; i < inverseVariance_.size(); ++i) {
+            inverseVariance_[i] = 1.0f / std::max(profiles_.front().data.logVariance[i], MIN_LOG_VARIANCE);
+            inverseVarianceSum_ += inverseVariance_[i];
         }
     }
     
-    float getSensitivity() const override {
-        return sensitivity_;
+    /**
+     * @brief Lay out every profile as two rows of one matrix
+     *
+     * Only used with several profiles. Both matches reduce to dot products
+     * of per-profile rows with vectors derived once from the live spectrum:
+     *
+     * - Correlation: row 0 is the mean-centered profile (dotted with the
+     *   spectrum), row 1 the zero-mean log profile (dotted with the
+     *   zero-mean live log spectrum).
+     * - Mahalanobis: row 0 holds the inverse variances w, row 1 holds w
+     *   times the log mean minus its w-weighted average. Shifting the log
+     *   mean does not change the level-fitted distance, and the shift makes
+     *   the sum of row 1 zero.
+     */
+    void updateProfileMatrix() {
+        const size_t count = profiles_.size() > 1 ? profiles_.size() : 0;
+        const size_t bins = profileBins_;
+        profileMatrix_.assign(2 * count * bins, 0.0f);
+        profileTerms_.assign(count, ProfileTerms{});
+        rowProducts_.assign(3 * count, 0.0f);
+        
+        for (size_t k = 0; k < count; ++k) {
+            const TrainingData& data = profiles_[k].data;
+            float* first = profileMatrix_.data() + 2 * k * bins;
+            float* second = first + bins;
+            ProfileTerms& terms = profileTerms_[k];
+            
+            if (useMahalanobis_) {
+                double weightSum = 0.0;
+                double weightedMean = 0.0;
+                for (size_t i = 0; i < bins; ++i) {
+                    first[i] = 1.0f / std::max(data.logVariance[i], MIN_LOG_VARIANCE);
+                    weightSum += first[i];
+                    weightedMean += first[i] * static_cast<double>(data.logMean[i]);
+                }
+                weightedMean /= weightSum;
+                
+                double offset = 0.0;
+                for (size_t i = 0; i < bins; ++i) {
+                    double centered = data.logMean[i] - weightedMean;
+                    second[i] = static_cast<float>(first[i] * centered);
+                    offset += second[i] * centered;
+                }
+                terms.norm = static_cast<float>(weightSum);
+                terms.offset = static_cast<float>(offset);
+            } else {
+                const auto& profile = data.spectralProfile;
+                float mean = 0.0f;
+                float logMean = 0.0f;
+                for (size_t i = 0; i < bins; ++i) {
+                    mean += profile[i];
+                    second[i] = std::log(profile[i] + EPSILON);
+                    logMean += second[i];
+                }
+                mean /= static_cast<float>(bins);
+                logMean /= static_cast<float>(bins);
+                
+                for (size_t i = 0; i < bins; ++i) {
+                    first[i] = profile[i] - mean;
+                    terms.norm += first[i] * first[i];
+                    second[i] -= logMean;
+                    terms.offset += second[i] * second[i];
+                }
+            }
+        }
     }
     
-    void setMinDetectionDuration(int durationMs) override {
-        minDetectionDurationMs_ = std::max(0, durationMs);
-        MICMAP_LOG_DEBUG("Set minimum detection duration to ", minDetectionDurationMs_, " ms");
+    /**
+     * @brief Pick the monitor bins and lay out each profile's values at them
+     *
+     * The bins come from the first profile's log-domain model, or its log
+     * spectrum for profiles without variances. Per profile, row 0 and row 1
+     * hold what the single-profile match needs at those bins: the log mean
+     * and inverse variances (Mahalanobis), or the centered magnitudes and
+     * zero-mean logs (correlation).
+     */
+    void updateMonitor() {
+        monitorAnalyzer_.reset();
+        monitorRows_.clear();
+        monitorTerms_.clear();
+        if (!monitor_.enabled || profileBins_ < 3) {
+            return;
+        }
+        
+        const TrainingData& first = profiles_.front().data;
+        std::vector<float> logMean(profileBins_);
+        std::vector<float> logVariance;
+        if (hasVarianceModel(first)) {
+            std::copy(first.logMean.begin(), first.logMean.begin() + profileBins_, logMean.begin());
+            logVariance.assign(first.logVariance.begin(), first.logVariance.begin() + profileBins_);
+        } else {
+            for (size_t i = 0; i < profileBins_; ++i) {
+                logMean[i] = std::log(first.spectralProfile[i] + EPSILON);
+            }
+        }
+        
+        std::vector<size_t> bins = selectDiscriminativeBins(logMean, logVariance, monitor_.bins);
+        if (bins.empty()) {
+            return;
+        }
+        monitorAnalyzer_ = std::make_unique<SlidingDFTAnalyzer>(sampleRate_, fftSize_, stft_.getHopSize(),
+                                                                bins, kernels_.level);
+        
+        const size_t count = bins.size();
+        monitorMagnitudes_.assign(count, 0.0f);
+        monitorScratch_.assign(count, 0.0f);
+        monitorRows_.assign(2 * count * profiles_.size(), 0.0f);
+        monitorTerms_.assign(profiles_.size(), 0.0f);
+        for (size_t k = 0; k < profiles_.size(); ++k) {
+            const TrainingData& data = profiles_[k].data;
+            float* first = monitorRows_.data() + 2 * k * count;
+            float* second = first + count;
+            if (useMahalanobis_) {
+                for (size_t i = 0; i < count; ++i) {
+                    first[i] = data.logMean[bins[i]];
+                    second[i] = 1.0f / std::max(data.logVariance[bins[i]], MIN_LOG_VARIANCE);
+                    monitorTerms_[k] += second[i];
+                }
+            } else {
+                float mean = 0.0f;
+                float logMeanValue = 0.0f;
+                for (size_t i = 0; i < count; ++i) {
+                    first[i] = data.spectralProfile[bins[i]];
+                    second[i] = std::log(first[i] + EPSILON);
+                    mean += first[i];
+                    logMeanValue += second[i];
+                }
+                mean /= static_cast<float>(count);
+                logMeanValue /= static_cast<float>(count);
+                for (size_t i = 0; i < count; ++i) {
+                    first[i] -= mean;
+                    second[i] -= logMeanValue;
+                    monitorTerms_[k] += first[i] * first[i];
+                }
+            }
+        }
     }
     
-    int getMinDetectionDuration() const override {
-        return minDetectionDurationMs_;
+    /**
+     * @brief Similarity of the monitor bins to every profile into similarities_
+     *
+     * The same matches as matchProfiles(), restricted to the monitor bins.
+     * Only the frame's newest hop is transformed.
+     */
+    void matchMonitor(const float* frame) {
+        monitorAnalyzer_->analyzeInto(frame, fftSize_, nullptr, 0);
+        monitorAnalyzer_->getBinMagnitudes(monitorMagnitudes_.data());
+        
+        const size_t count = monitorMagnitudes_.size();
+        for (size_t k = 0; k < profiles_.size(); ++k) {
+            const float* first = monitorRows_.data() + 2 * k * count;
+            const float* second = first + count;
+            if (useMahalanobis_) {
+                float distance = kernels_.logMahalanobis(monitorMagnitudes_.data(), first, second,
+                                                         monitorTerms_[k], count);
+                similarities_[k] = mahalanobisSimilarity(distance);
+            } else {
+                float pearsonCorr = std::max(0.0f, kernels_.correlation(monitorMagnitudes_.data(), first,
+                                                                        monitorTerms_[k], count));
+                float mse = kernels_.logShapeMse(monitorMagnitudes_.data(), second, count,
+                                                 monitorScratch_.data());
+                similarities_[k] = std::sqrt(pearsonCorr * std::exp(-mse / 2.0f));
+            }
+        }
     }
     
-    const TrainingData& getTrainingData() const override {
-        return trainingData_;
+    /**
+     * @brief Similarity of a spectrum to every profile into similarities_
+     */
+    void matchProfiles(const std::vector<float>& spectrum) {
+        if (profiles_.size() > 1) {
+            matchProfileMatrix(spectrum);
+        } else if (useMahalanobis_) {
+            similarities_[0] = computeMahalanobisSimilarity(spectrum);
+        } else {
+            float pearsonCorr = computeCorrelation(spectrum);
+            float shapeSimilarity = computeSpectralShapeDistance(spectrum);
+            similarities_[0] = std::sqrt(pearsonCorr * shapeSimilarity);
+        }
     }
     
-private:
     /**
-     * @brief Compute Pearson correlation coefficient between two vectors
+     * @brief Match a spectrum against all profiles with batched dot products
      *
-     * This is more discriminative than simple cosine similarity because it
-     * subtracts the mean first, measuring how well the shapes correlate
-     * rather than just the overall magnitude distribution.
+     * The live log spectrum and its statistics are computed once per frame;
+     * each extra profile then costs two or three rows of dotRows() instead
+     * of a full pass with logarithms. See updateProfileMatrix() for the rows.
      */
-    float computeCorrelation(const std::vector<float>& a, const std::vector<float>& b) {
-        if (a.empty() || b.empty()) {
-            return 0.0f;
+    void matchProfileMatrix(const std::vector<float>& spectrum) {
+        const size_t count = profiles_.size();
+        const size_t bins = std::min(spectrum.size(), profileBins_);
+        const size_t stride = 2 * profileBins_;
+        if (bins == 0) {
+            std::fill(similarities_.begin(), similarities_.end(), 0.0f);
+            return;
         }
         
-        size_t minSize = std::min(a.size(), b.size());
+        float* firstProducts = rowProducts_.data();
+        float* secondProducts = firstProducts + count;
+        float* squaredProducts = secondProducts + count;
+        const float* firstRows = profileMatrix_.data();
+        const float* secondRows = firstRows + profileBins_;
         
-        // Compute means
-        float meanA = 0.0f, meanB = 0.0f;
-        for (size_t i = 0; i < minSize; ++i) {
-            meanA += a[i];
-            meanB += b[i];
+        // Zero-mean live log spectrum; both matches ignore the level
+        float logMean = kernels_.logSpectrum(spectrum.data(), bins, logSpectrum_.data());
+        for (size_t i = 0; i < bins; ++i) {
+            logSpectrum_[i] -= logMean;
         }
-        meanA /= static_cast<float>(minSize);
-        meanB /= static_cast<float>(minSize);
-        
-        // Compute Pearson correlation: sum((a-meanA)*(b-meanB)) / (stdA * stdB * n)
-        float sumAB = 0.0f;
-        float sumA2 = 0.0f;
-        float sumB2 = 0.0f;
         
-        for (size_t i = 0; i < minSize; ++i) {
-            float devA = a[i] - meanA;
-            float devB = b[i] - meanB;
-            sumAB += devA * devB;
-            sumA2 += devA * devA;
-            sumB2 += devB * devB;
+        if (useMahalanobis_) {
+            for (size_t i = 0; i < bins; ++i) {
+                logSquared_[i] = logSpectrum_[i] * logSpectrum_[i];
+            }
+            kernels_.dotRows(firstRows, count, stride, logSpectrum_.data(), bins, firstProducts);
+            kernels_.dotRows(secondRows, count, stride, logSpectrum_.data(), bins, secondProducts);
+            kernels_.dotRows(firstRows, count, stride, logSquared_.data(), bins, squaredProducts);
+            
+            for (size_t k = 0; k < count; ++k) {
+                // With r = l - mu: sum w*r^2 and sum w*r (row 1 sums to zero)
+                const ProfileTerms& terms = profileTerms_[k];
+                float weightedSumSq = squaredProducts[k] - 2.0f * secondProducts[k] + terms.offset;
+                float weightedSum = firstProducts[k];
+                float distance = std::max(0.0f, weightedSumSq - weightedSum * weightedSum / terms.norm) /
+                                 static_cast<float>(bins);
+                similarities_[k] = mahalanobisSimilarity(distance);
+            }
+        } else {
+            float mean = 0.0f;
+            for (size_t i = 0; i < bins; ++i) {
+                mean += spectrum[i];
+            }
+            mean /= static_cast<float>(bins);
+            float spectrumSumSq = static_cast<float>(bins) *
+                                  (kernels_.meanSquare(spectrum.data(), bins) - mean * mean);
+            float logSumSq = static_cast<float>(bins) * kernels_.meanSquare(logSpectrum_.data(), bins);
+            kernels_.dotRows(firstRows, count, stride, spectrum.data(), bins, firstProducts);
+            kernels_.dotRows(secondRows, count, stride, logSpectrum_.data(), bins, secondProducts);
+            
+            for (size_t k = 0; k < count; ++k) {
+                // Centered profile rows sum to zero, so dotting them with the
+                // raw spectrum equals dotting with the centered one
+                const ProfileTerms& terms = profileTerms_[k];
+                float denominator = std::sqrt(std::max(0.0f, spectrumSumSq) * terms.norm);
+                float pearsonCorr = denominator < EPSILON ? 0.0f :
+                                    std::max(0.0f, firstProducts[k] / denominator);
+                float mse = std::max(0.0f, logSumSq - 2.0f * secondProducts[k] + terms.offset) /
+                            static_cast<float>(bins);
+                similarities_[k] = std::sqrt(pearsonCorr * std::exp(-mse / 2.0f));
+            }
         }
-        
-        float denominator = std::sqrt(sumA2 * sumB2);
-        if (denominator < EPSILON) {
+    }
+    
+    /**
+     * @brief Compute Pearson correlation between a spectrum and the profile
+     *
+     * This is more discriminative than simple cosine similarity because it
+     * subtracts the mean first, measuring how well the shapes correlate
+     * rather than just the overall magnitude distribution. The profile side
+     * comes from updateProfileCache().
+     */
+    float computeCorrelation(const std::vector<float>& spectrum) {
+        if (spectrum.empty() || profileBins_ == 0) {
             return 0.0f;
         }
         
-        float correlation = sumAB / denominator;
+        size_t minSize = std::min(spectrum.size(), profileBins_);
+        float correlation = kernels_.correlation(spectrum.data(), profileCentered_.data(),
+                                                 profileSumSq_, minSize);
         
         // Pearson correlation ranges from -1 to 1
         // Map to 0-1 range: negative correlation = 0, positive = correlation value
@@ -518,40 +1358,24 @@ private:
     }
     
     /**
-     * @brief Compute spectral shape distance using log-magnitude comparison
+     * @brief Compute spectral shape similarity using log-magnitude comparison
      *
      * This compares the relative shape of spectra in log domain,
-     * which is more perceptually meaningful and discriminative.
+     * which is more perceptually meaningful and discriminative. Only the
+     * live spectrum is converted here; the profile's zero-mean log spectrum
+     * is cached.
      */
-    float computeSpectralShapeDistance(const std::vector<float>& a, const std::vector<float>& b) {
-        if (a.empty() || b.empty()) {
+    float computeSpectralShapeDistance(const std::vector<float>& spectrum) {
+        if (spectrum.empty() || profileBins_ == 0) {
             return 1.0f;  // Maximum distance
         }
         
-        size_t minSize = std::min(a.size(), b.size());
+        size_t minSize = std::min(spectrum.size(), profileBins_);
         
-        // Convert to log domain and normalize
-        std::vector<float> logA(minSize), logB(minSize);
-        float sumLogA = 0.0f, sumLogB = 0.0f;
-        
-        for (size_t i = 0; i < minSize; ++i) {
-            logA[i] = std::log(a[i] + EPSILON);
-            logB[i] = std::log(b[i] + EPSILON);
-            sumLogA += logA[i];
-            sumLogB += logB[i];
-        }
-        
-        // Normalize to zero mean (removes overall level difference)
-        float meanLogA = sumLogA / static_cast<float>(minSize);
-        float meanLogB = sumLogB / static_cast<float>(minSize);
-        
-        // Compute mean squared error of normalized log spectra
-        float mse = 0.0f;
-        for (size_t i = 0; i < minSize; ++i) {
-            float diff = (logA[i] - meanLogA) - (logB[i] - meanLogB);
-            mse += diff * diff;
-        }
-        mse /= static_cast<float>(minSize);
+        // Mean squared error of the zero-mean log spectra (removes overall
+        // level difference), using preallocated scratch for the live logs
+        float mse = kernels_.logShapeMse(spectrum.data(), profileLogCentered_.data(),
+                                         minSize, logSpectrum_.data());
         
         // Convert MSE to similarity (0 = different, 1 = identical)
         // Use exponential decay: similarity = exp(-mse / scale)
@@ -559,6 +1383,61 @@ private:
         return similarity;
     }
     
+    /**
+     * @brief Similarity of a spectrum to the trained log-domain model
+     *
+     * The distance is about 1 for a spectrum like those seen in training, so
+     * only the excess over 1 lowers the similarity. Bins that varied little
+     * in training weigh more than noisy ones, and the overall level is
+     * fitted out as in the log-shape match.
+     */
+    float computeMahalanobisSimilarity(const std::vector<float>& spectrum) {
+        if (spectrum.empty() || profileBins_ == 0) {
+            return 0.0f;
+        }
+        
+        size_t minSize = std::min(spectrum.size(), profileBins_);
+        float distance = kernels_.logMahalanobis(spectrum.data(), profiles_.front().data.logMean.data(),
+                                                 inverseVariance_.data(), inverseVarianceSum_,
+                                                 minSize);
+        return mahalanobisSimilarity(distance);
+    }
+    
+    /**
+     * @brief Map a log-domain Mahalanobis distance to a similarity in [0, 1]
+     */
+    static float mahalanobisSimilarity(float distance) {
+        return std::exp(-std::max(0.0f, distance - 1.0f) / MAHALANOBIS_SCALE);
+    }
+    
+    /**
+     * @brief Analyze one training frame and keep it if it carries signal
+     */
+    void addTrainingFrame(const float* frame, const float* hop) {
+        auto result = analyzer_->analyzeInto(frame, fftSize_, magnitudes_.data(), magnitudes_.size());
+        result.energy = kernels_.meanSquare(hop, trainingStft_.getHopSize());
+        
+        // Accept samples with any detectable energy (very low threshold)
+        // The "microphone covered" sound may be quiet and not spectrally flat
+        // We'll learn whatever pattern the user provides during training
+        if (result.energy > 0.00001f) {  // Very low threshold - just needs some signal
+            const std::vector<float>& features = featureSpectrum();
+            trainingSpectrum_.add(features.data());
+            for (size_t i = 0; i < features.size(); ++i) {
+                logSpectrum_[i] = std::log(features[i] + EPSILON);
+            }
+            trainingLogSpectrum_.add(logSpectrum_.data());
+            trainingEnergy_.add(result.energy);
+            trainingEnergyLow_.add(result.energy);
+            trainingFlatness_.add(result.spectralFlatness);
+            
+            MICMAP_LOG_DEBUG("Added training sample: energy=", result.energy,
+                           ", flatness=", result.spectralFlatness);
+        } else {
+            MICMAP_LOG_DEBUG("Rejected training sample (no signal): energy=", result.energy);
+        }
+    }
+    
     /**
      * @brief L2 normalize a vector in place
      */
@@ -577,17 +1456,14 @@ private:
     }
     
     /**
-     * @brief Compute standard deviation
+     * @brief Forget the accepted training frames
      */
-    float computeStdDev(const std::vector<float>& values, float mean) {
-        if (values.empty()) return 0.0f;
-        
-        float sumSq = 0.0f;
-        for (float v : values) {
-            float diff = v - mean;
-            sumSq += diff * diff;
-        }
-        return std::sqrt(sumSq / static_cast<float>(values.size()));
+    void resetTrainingStats() {
+        trainingSpectrum_.reset();
+        trainingLogSpectrum_.reset();
+        trainingEnergy_.reset();
+        trainingEnergyLow_.reset();
+        trainingFlatness_.reset();
     }
     
     /**
@@ -599,7 +1475,7 @@ private:
      * with the value from config (detection.minDurationMs).
      */
     bool updateTemporalState(bool instantDetection) {
-        auto now = std::chrono::steady_clock::now();
+        auto now = clock_->now();
         
         if (instantDetection) {
             if (!isCurrentlyDetecting_) {
@@ -631,79 +1507,104 @@ private:
     // Configuration
     uint32_t sampleRate_;
     size_t fftSize_;
+    const SpectralFeatureKernels& kernels_;
+    DetectionThresholds thresholds_;
+    CascadeConfig cascade_;
+    MonitorConfig monitor_;
+    ProfileMatch profileMatch_;
+    common::SampleClock sampleClock_;               // Used when no clock is configured
+    std::shared_ptr<common::IClock> sharedClock_;   // Keeps a configured clock alive
+    const common::IClock* clock_;
     float sensitivity_;
     int minDetectionDurationMs_;
     
     // Components
     std::unique_ptr<ISpectralAnalyzer> analyzer_;
+    std::unique_ptr<Filterbank> filterbank_;    // Null when matching FFT bins
+    StreamingSTFT stft_;            // Frames audio passed to analyze()
+    StreamingSTFT trainingStft_;    // Frames audio passed to addTrainingSample()
+    DetectionResult lastResult_;
+    
+    // Multi-channel analysis; empty with a single channel
+    size_t channels_;
+    std::unique_ptr<MultiChannelAnalyzer> channelAnalyzer_;
+    std::vector<StreamingSTFT> channelStfts_;           // Frame analyzeChannelsInto() audio
+    std::vector<StreamingSTFT> trainingChannelStfts_;   // Frame addTrainingChannels() audio
+    std::vector<const float*> channelFrames_;           // Latest frame per channel
+    std::vector<const float*> channelHops_;
+    std::vector<float> channelMagnitudes_;              // Spectra of all channels, channel after channel
+    std::vector<SpectralFeatures> channelFeatures_;
+    size_t loudestChannel_ = 0;
+    
+    // Per-frame scratch, sized once in the constructor
+    std::vector<float> magnitudes_;
+    std::vector<float> bands_;          // Filterbank output
+    size_t featureBins_ = 0;            // Values per profile: FFT bins or bands
+    std::vector<float> logSpectrum_;
+    std::vector<float> logSquared_;
     
     // Training state
     bool training_;
-    std::vector<std::vector<float>> trainingSpectra_;
-    std::vector<float> trainingEnergies_;
-    std::vector<float> trainingFlatnesses_;
+    SpectrumMoments trainingSpectrum_;          // Per-bin moments of accepted spectra
+    SpectrumMoments trainingLogSpectrum_;       // Per-bin moments of their log magnitudes
+    RunningMoments trainingEnergy_;
+    P2Quantile trainingEnergyLow_{0.05};        // 5th percentile of accepted energies
+    RunningMoments trainingFlatness_;
+    
+    // Trained data; the first profile is the one trained, loaded or saved
+    std::vector<Profile> profiles_;
+    std::vector<float> profileCentered_;     // Profile minus its mean
+    std::vector<float> profileLogCentered_;  // Zero-mean log profile
+    float profileSumSq_ = 0.0f;              // Sum of squares of profileCentered_
+    std::vector<float> inverseVariance_;     // Floored 1 / logVariance (Mahalanobis only)
+    float inverseVarianceSum_ = 0.0f;
+    bool useMahalanobis_ = false;            // ProfileMatch resolved for this profile
+    size_t profileBins_ = 0;                 // Bins shared by profile and live spectrum
+    
+    // Several profiles: matrix rows, their constants and per-frame scratch,
+    // sized when the profiles change
+    std::vector<float> profileMatrix_;       // Two rows of profileBins_ per profile
+    std::vector<ProfileTerms> profileTerms_;
+    std::vector<float> rowProducts_;         // dotRows() outputs, three per profile
+    std::vector<float> energyRatios_;        // Energy factor per profile
+    std::vector<float> similarities_;        // Spectral match per profile (reused while idle)
+    int activeProfile_ = -1;
     
-    // Trained data
-    TrainingData trainingData_;
-    float spectralFlatnessThreshold_ = 0.3f;
-    float energyMinThreshold_ = 0.0f;
-    float energyVarianceThreshold_ = 0.5f;
-    bool hasTrainingData_;
+    // Sparse-bin monitor, rebuilt when the profiles change
+    std::unique_ptr<SlidingDFTAnalyzer> monitorAnalyzer_;  // Null when not monitoring
+    std::vector<float> monitorRows_;         // Two rows of monitor bins per profile
+    std::vector<float> monitorTerms_;        // Sum of row 1 (Mahalanobis) or row 0 squares
+    std::vector<float> monitorMagnitudes_;   // Per-frame scratch
+    std::vector<float> monitorScratch_;
     
     // Temporal detection state
-    std::chrono::steady_clock::time_point detectionStartTime_;
+    common::Timestamp detectionStartTime_;
     bool isCurrentlyDetecting_;
     
     // Spike detection state
     bool spikeTriggered_ = false;
-    std::chrono::steady_clock::time_point spikeTime_;
+    common::Timestamp spikeTime_;
+    
+    // Cascade state: the last spectral stage outputs stand in for skipped frames
+    CascadeStats cascadeStats_;
+    int idleCountdown_ = 0;
+    float lastSpectralFlatness_ = 0.0f;
     
     // Energy history for consistency tracking
-    static constexpr size_t ENERGY_HISTORY_SIZE = 10;
-    std::vector<float> energyHistory_;
-    size_t energyHistoryIndex_ = 0;
+    RollingStats energyWindow_;
     
     // Confidence history for frequency-based detection
-    static constexpr size_t CONFIDENCE_HISTORY_SIZE = 12;
-    std::vector<bool> confidenceHistory_;
-    size_t confidenceHistoryIndex_ = 0;
+    HitWindow hitWindow_;
     
     // Thread safety
     mutable std::mutex mutex_;
     
     /**
-     * @brief Update energy history buffer
+     * @brief Whole hops in a window of ms milliseconds (at least 1)
      */
-    void updateEnergyHistory(float energy) {
-        if (energyHistory_.size() < ENERGY_HISTORY_SIZE) {
-            energyHistory_.push_back(energy);
-        } else {
-            energyHistory_[energyHistoryIndex_] = energy;
-            energyHistoryIndex_ = (energyHistoryIndex_ + 1) % ENERGY_HISTORY_SIZE;
-        }
-    }
-    
-    /**
-     * @brief Update confidence history (tracks high/low hits)
-     */
-    void updateConfidenceHistory(bool isHigh) {
-        if (confidenceHistory_.size() < CONFIDENCE_HISTORY_SIZE) {
-            confidenceHistory_.push_back(isHigh);
-        } else {
-            confidenceHistory_[confidenceHistoryIndex_] = isHigh;
-            confidenceHistoryIndex_ = (confidenceHistoryIndex_ + 1) % CONFIDENCE_HISTORY_SIZE;
-        }
-    }
-    
-    /**
-     * @brief Count high-confidence hits in recent history
-     */
-    int countHighConfidenceHits() {
-        int count = 0;
-        for (bool isHigh : confidenceHistory_) {
-            if (isHigh) count++;
-        }
-        return count;
+    size_t windowFrames(int ms) const {
+        double frames = static_cast<double>(ms) * sampleRate_ / (1000.0 * stft_.getHopSize());
+        return std::max<size_t>(1, static_cast<size_t>(std::lround(frames)));
     }
     
     /**
@@ -713,25 +1614,18 @@ private:
      * Speech and game audio have high variance, so this helps distinguish
      */
     float computeEnergyConsistency() {
-        if (energyHistory_.size() < 3) {
+        if (energyWindow_.count() < 3) {
             return 0.5f;  // Not enough data
         }
         
         // Compute coefficient of variation (stddev / mean)
-        float mean = std::accumulate(energyHistory_.begin(), energyHistory_.end(), 0.0f)
-                    / static_cast<float>(energyHistory_.size());
+        float mean = static_cast<float>(energyWindow_.mean());
         
         if (mean < EPSILON) {
             return 0.0f;  // No signal
         }
         
-        float variance = 0.0f;
-        for (float e : energyHistory_) {
-            float diff = e - mean;
-            variance += diff * diff;
-        }
-        variance /= static_cast<float>(energyHistory_.size());
-        float stddev = std::sqrt(variance);
+        float stddev = static_cast<float>(std::sqrt(energyWindow_.variance()));
         float cv = stddev / mean;  // Coefficient of variation
         
         // Lower CV = more consistent = higher score
@@ -742,8 +1636,16 @@ private:
     }
 };
 
+std::unique_ptr<INoiseDetector> createFFTDetector(const NoiseDetectorConfig& config) {
+    return std::make_unique<FFTNoiseDetector>(config);
+}
+
 std::unique_ptr<INoiseDetector> createFFTDetector(uint32_t sampleRate, size_t fftSize) {
-    return std::make_unique<FFTNoiseDetector>(sampleRate, fftSize);
+    NoiseDetectorConfig config;
+    config.sampleRate = sampleRate;
+    config.fftSize = fftSize;
+    config.hopSize = std::max<size_t>(fftSize / 4, 1);
+    return std::make_unique<FFTNoiseDetector>(config);
 }
 
 } // namespace micmap::detection
\ No newline at end of file
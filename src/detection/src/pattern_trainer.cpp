@@ -4,16 +4,21 @@
  */
 
 #include "micmap/detection/pattern_trainer.hpp"
+#include "micmap/detection/training_stats.hpp"
 #include "micmap/common/logger.hpp"
 
 #include <algorithm>
-#include <numeric>
 #include <cmath>
 
 namespace micmap::detection {
 
 namespace {
     constexpr float EPSILON = 1e-10f;
+    
+    // Thresholds sit at the 5th percentile of the accepted samples, which
+    // keeps ~95% of the training data above them without assuming a
+    // normal distribution
+    constexpr double THRESHOLD_QUANTILE = 0.05;
 }
 
 /**
@@ -28,22 +33,45 @@ struct PatternTrainer::Impl {
     bool training = false;
     bool complete = false;
     
-    // Collected training data
-    std::vector<std::vector<float>> spectra;
-    std::vector<float> energies;
-    std::vector<float> spectralFlatnesses;
+    // Collected training data as streaming statistics: O(bins) memory and
+    // constant work per sample however long the session runs
+    SpectrumMoments spectrum;
+    std::vector<float> magnitudes;
+    RunningMoments energy;
+    RunningMoments flatness;
+    P2Quantile energyLow{THRESHOLD_QUANTILE};
+    P2Quantile flatnessLow{THRESHOLD_QUANTILE};
     
     // Computed profile
     std::vector<float> spectralProfile;
+    std::vector<float> spectralVariance;
     float energyThreshold = 0.0f;
     float spectralFlatnessThreshold = 0.0f;
     
-    std::chrono::steady_clock::time_point startTime;
-    std::chrono::steady_clock::time_point lastSampleTime;
+    // Sample-counting clock used when config.clock is null
+    common::SampleClock sampleClock;
+    common::Timestamp startTime;
+    common::Timestamp lastSampleTime;
     
     Impl(std::shared_ptr<ISpectralAnalyzer> analyzer_, const TrainingConfig& config_)
         : analyzer(std::move(analyzer_))
-        , config(config_) {
+        , config(config_)
+        , sampleClock(analyzer ? analyzer->getSampleRate() : 0) {
+        size_t numBins = analyzer ? analyzer->getNumBins() : 0;
+        spectrum.resize(numBins);
+        magnitudes.resize(numBins, 0.0f);
+    }
+    
+    const common::IClock& clock() const {
+        return config.clock ? *config.clock : static_cast<const common::IClock&>(sampleClock);
+    }
+    
+    void resetCollected() {
+        spectrum.reset();
+        energy.reset();
+        flatness.reset();
+        energyLow.reset();
+        flatnessLow.reset();
     }
     
     void reportProgress(const std::string& status) {
@@ -58,20 +86,6 @@ struct PatternTrainer::Impl {
         }
     }
     
-    /**
-     * @brief Compute standard deviation of a vector
-     */
-    float computeStdDev(const std::vector<float>& values, float mean) {
-        if (values.empty()) return 0.0f;
-        
-        float sumSq = 0.0f;
-        for (float v : values) {
-            float diff = v - mean;
-            sumSq += diff * diff;
-        }
-        return std::sqrt(sumSq / static_cast<float>(values.size()));
-    }
-    
     /**
      * @brief Normalize a spectral profile
      */
@@ -105,14 +119,13 @@ void PatternTrainer::startTraining() {
     // Reset all state
     impl_->training = true;
     impl_->complete = false;
-    impl_->spectra.clear();
-    impl_->energies.clear();
-    impl_->spectralFlatnesses.clear();
+    impl_->resetCollected();
     impl_->spectralProfile.clear();
+    impl_->spectralVariance.clear();
     impl_->energyThreshold = 0.0f;
     impl_->spectralFlatnessThreshold = 0.0f;
     impl_->stats = TrainingStats{};
-    impl_->startTime = std::chrono::steady_clock::now();
+    impl_->startTime = impl_->clock().now();
     impl_->lastSampleTime = impl_->startTime;
     
     impl_->reportProgress("Training started - cover the microphone with your finger");
@@ -130,8 +143,13 @@ bool PatternTrainer::addSample(const float* samples, size_t count) {
         return false;
     }
     
+    // Samples count as elapsed time whether or not they are kept
+    if (!impl_->config.clock) {
+        impl_->sampleClock.advance(count);
+    }
+    
     // Check sample interval (rate limiting)
-    auto now = std::chrono::steady_clock::now();
+    auto now = impl_->clock().now();
     auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
         now - impl_->lastSampleTime
     );
@@ -143,7 +161,8 @@ bool PatternTrainer::addSample(const float* samples, size_t count) {
     ++impl_->stats.samplesCollected;
     
     // Analyze the audio
-    auto result = impl_->analyzer->analyze(samples, count);
+    auto result = impl_->analyzer->analyzeInto(samples, count,
+                                               impl_->magnitudes.data(), impl_->magnitudes.size());
     
     // Validate energy bounds
     if (result.energy < impl_->config.minEnergy) {
@@ -172,20 +191,17 @@ bool PatternTrainer::addSample(const float* samples, size_t count) {
     }
     
     // Accept sample
-    impl_->spectra.push_back(result.magnitudes);
-    impl_->energies.push_back(result.energy);
-    impl_->spectralFlatnesses.push_back(result.spectralFlatness);
+    impl_->spectrum.add(impl_->magnitudes.data());
+    impl_->energy.add(result.energy);
+    impl_->flatness.add(result.spectralFlatness);
+    impl_->energyLow.add(result.energy);
+    impl_->flatnessLow.add(result.spectralFlatness);
     ++impl_->stats.samplesAccepted;
     impl_->lastSampleTime = now;
     
     // Update running statistics
-    impl_->stats.averageEnergy = std::accumulate(
-        impl_->energies.begin(), impl_->energies.end(), 0.0f
-    ) / static_cast<float>(impl_->energies.size());
-    
-    impl_->stats.averageSpectralFlatness = std::accumulate(
-        impl_->spectralFlatnesses.begin(), impl_->spectralFlatnesses.end(), 0.0f
-    ) / static_cast<float>(impl_->spectralFlatnesses.size());
+    impl_->stats.averageEnergy = static_cast<float>(impl_->energy.mean());
+    impl_->stats.averageSpectralFlatness = static_cast<float>(impl_->flatness.mean());
     
     impl_->stats.duration = std::chrono::duration_cast<std::chrono::milliseconds>(
         now - impl_->startTime
@@ -221,45 +237,36 @@ bool PatternTrainer::finishTraining() {
     }
     
     // Validate collected data
-    if (impl_->spectra.empty() || impl_->spectra[0].empty()) {
+    if (impl_->spectrum.count() == 0 || impl_->spectrum.bins() == 0) {
         MICMAP_LOG_ERROR("No valid spectra collected");
         impl_->reportProgress("Training failed: no valid spectra");
         return false;
     }
     
-    // Compute average spectral profile
-    size_t profileSize = impl_->spectra[0].size();
+    // Average spectral profile and its per-bin spread
+    const auto& meanSpectrum = impl_->spectrum.mean();
+    size_t profileSize = meanSpectrum.size();
     impl_->spectralProfile.resize(profileSize, 0.0f);
-    
-    for (const auto& spectrum : impl_->spectra) {
-        for (size_t i = 0; i < profileSize && i < spectrum.size(); ++i) {
-            impl_->spectralProfile[i] += spectrum[i];
-        }
-    }
-    
-    float numSamples = static_cast<float>(impl_->spectra.size());
-    for (float& val : impl_->spectralProfile) {
-        val /= numSamples;
+    impl_->spectralVariance.resize(profileSize, 0.0f);
+    for (size_t i = 0; i < profileSize; ++i) {
+        impl_->spectralProfile[i] = static_cast<float>(meanSpectrum[i]);
+        impl_->spectralVariance[i] = static_cast<float>(impl_->spectrum.variance(i));
     }
     
     // Normalize the profile for correlation comparison
     impl_->normalizeProfile(impl_->spectralProfile);
     
-    // Compute energy threshold
-    // Use mean - 2*stddev as lower bound (captures ~95% of training data)
-    float energyMean = impl_->stats.averageEnergy;
-    float energyStdDev = impl_->computeStdDev(impl_->energies, energyMean);
+    // Energy threshold: 5th percentile of the accepted energies, robust to
+    // the odd loud or quiet frame in a way mean - 2 * stddev is not
     impl_->energyThreshold = std::max(
         impl_->config.minEnergy,
-        energyMean - 2.0f * energyStdDev
+        static_cast<float>(impl_->energyLow.value())
     );
     
-    // Compute spectral flatness threshold
-    float flatnessMean = impl_->stats.averageSpectralFlatness;
-    float flatnessStdDev = impl_->computeStdDev(impl_->spectralFlatnesses, flatnessMean);
+    // Spectral flatness threshold, likewise
     impl_->spectralFlatnessThreshold = std::max(
         0.1f,
-        flatnessMean - 2.0f * flatnessStdDev
+        static_cast<float>(impl_->flatnessLow.value())
     );
     
     impl_->complete = true;
@@ -278,10 +285,9 @@ bool PatternTrainer::finishTraining() {
 void PatternTrainer::cancelTraining() {
     impl_->training = false;
     impl_->complete = false;
-    impl_->spectra.clear();
-    impl_->energies.clear();
-    impl_->spectralFlatnesses.clear();
+    impl_->resetCollected();
     impl_->spectralProfile.clear();
+    impl_->spectralVariance.clear();
     impl_->energyThreshold = 0.0f;
     impl_->spectralFlatnessThreshold = 0.0f;
     
@@ -301,6 +307,10 @@ const std::vector<float>& PatternTrainer::getSpectralProfile() const {
     return impl_->spectralProfile;
 }
 
+const std::vector<float>& PatternTrainer::getSpectralVariance() const {
+    return impl_->spectralVariance;
+}
+
 float PatternTrainer::getEnergyThreshold() const {
     return impl_->energyThreshold;
 }
@@ -0,0 +1,102 @@
+/**
+ * @file rolling_stats.cpp
+ * @brief Constant-time statistics over the most recent detection frames
+ */
+
+#include "micmap/detection/rolling_stats.hpp"
+
+#include <algorithm>
+
+namespace micmap::detection {
+
+namespace {
+
+int popcount64(uint64_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(bits);
+#else
+    // Bit-parallel count; MSVC's __popcnt64 needs a POPCNT-capable CPU
+    bits = bits - ((bits >> 1) & 0x5555555555555555ull);
+    bits = (bits & 0x3333333333333333ull) + ((bits >> 2) & 0x3333333333333333ull);
+    bits = (bits + (bits >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return static_cast<int>((bits * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+} // anonymous namespace
+
+// ========== RollingStats ==========
+
+RollingStats::RollingStats(size_t capacity)
+    : values_(std::max<size_t>(capacity, 1), 0.0f) {
+}
+
+void RollingStats::add(float value) {
+    // Dropping a value that dominates the sums leaves mostly rounding error
+    // of that value behind; such drops recompute, as does every lap
+    bool cancelled = false;
+    if (count_ == values_.size()) {
+        double oldest = values_[next_];
+        sum_ -= oldest;
+        sumSquares_ -= oldest * oldest;
+        cancelled = oldest * oldest > CANCELLATION_RATIO * sumSquares_;
+    } else {
+        ++count_;
+    }
+
+    values_[next_] = value;
+    sum_ += value;
+    sumSquares_ += static_cast<double>(value) * value;
+
+    if (++next_ == values_.size()) {
+        next_ = 0;
+        cancelled = true;
+    }
+    if (cancelled) {
+        recompute();
+    }
+}
+
+void RollingStats::reset() {
+    std::fill(values_.begin(), values_.end(), 0.0f);
+    next_ = 0;
+    count_ = 0;
+    sum_ = 0.0;
+    sumSquares_ = 0.0;
+}
+
+double RollingStats::mean() const {
+    return count_ > 0 ? sum_ / static_cast<double>(count_) : 0.0;
+}
+
+double RollingStats::variance() const {
+    if (count_ == 0) {
+        return 0.0;
+    }
+    double mean = sum_ / static_cast<double>(count_);
+    return std::max(0.0, sumSquares_ / static_cast<double>(count_) - mean * mean);
+}
+
+void RollingStats::recompute() {
+    // Slots past count_ are still zero
+    sum_ = 0.0;
+    sumSquares_ = 0.0;
+    for (size_t i = 0; i < values_.size(); ++i) {
+        double value = values_[i];
+        sum_ += value;
+        sumSquares_ += value * value;
+    }
+}
+
+// ========== HitWindow ==========
+
+HitWindow::HitWindow(size_t length)
+    : length_(std::clamp<size_t>(length, 1, MAX_LENGTH))
+    , mask_(length_ == MAX_LENGTH ? ~0ull : (1ull << length_) - 1) {
+}
+
+int HitWindow::count() const {
+    return popcount64(bits_);
+}
+
+} // namespace micmap::detection
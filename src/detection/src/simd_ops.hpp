@@ -0,0 +1,285 @@
+#pragma once
+
+/**
+ * @file simd_ops.hpp
+ * @brief Internal per-ISA vector primitives shared by the detection kernels
+ *
+ * Each Ops struct wraps one instruction set behind the same small interface
+ * (Vec, WIDTH, load/store, arithmetic, compares, horizontal sum), so that
+ * generic kernels can be written once and instantiated per ISA. A struct is
+ * only defined when the including translation unit is compiled with its
+ * instruction set. Everything here has internal linkage for the reasons
+ * given in spectral_features_kernels.hpp.
+ */
+
+#include "micmap/common/cpu_features.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MICMAP_DETECTION_HAVE_SSE2 1
+#include <emmintrin.h>
+#else
+#define MICMAP_DETECTION_HAVE_SSE2 0
+#endif
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define MICMAP_DETECTION_HAVE_NEON 1
+#include <arm_neon.h>
+#else
+#define MICMAP_DETECTION_HAVE_NEON 0
+#endif
+
+namespace micmap::detection::detail {
+
+namespace {
+
+constexpr uint32_t FLOAT_EXPONENT_MASK = 0x7f800000u;
+constexpr uint32_t FLOAT_HALF_BITS = 0x3f000000u;
+
+/**
+ * @brief Clamp a requested level to what is both compiled in and supported
+ */
+inline common::SimdLevel resolveSimdLevel(common::SimdLevel requested) {
+    using common::SimdLevel;
+#ifdef MICMAP_HAVE_AVX2
+    if (requested == SimdLevel::AVX2 && common::isSimdLevelSupported(SimdLevel::AVX2)) {
+        return SimdLevel::AVX2;
+    }
+#endif
+#if MICMAP_DETECTION_HAVE_SSE2
+    if ((requested == SimdLevel::AVX2 || requested == SimdLevel::SSE2) &&
+        common::isSimdLevelSupported(SimdLevel::SSE2)) {
+        return SimdLevel::SSE2;
+    }
+#endif
+#if MICMAP_DETECTION_HAVE_NEON
+    if (requested == SimdLevel::NEON && common::isSimdLevelSupported(SimdLevel::NEON)) {
+        return SimdLevel::NEON;
+    }
+#endif
+    return SimdLevel::Scalar;
+}
+
+/**
+ * @brief One-lane "vector" used for loop tails and narrow stages
+ *
+ * Masks are floats with all bits set, mirroring the SIMD compare results.
+ */
+struct ScalarOps {
+    using Vec = float;
+    static constexpr size_t WIDTH = 1;
+
+    static Vec zero() { return 0.0f; }
+    static Vec set1(float value) { return value; }
+    static Vec ramp() { return 0.0f; }
+    static Vec load(const float* p) { return *p; }
+    static void store(float* p, Vec v) { *p = v; }
+
+    static void loadComplex(const float* p, Vec& real, Vec& imag) {
+        real = p[0];
+        imag = p[1];
+    }
+
+    static Vec add(Vec a, Vec b) { return a + b; }
+    static Vec sub(Vec a, Vec b) { return a - b; }
+    static Vec mul(Vec a, Vec b) { return a * b; }
+    static Vec div(Vec a, Vec b) { return a / b; }
+    static Vec sqrt(Vec a) { return std::sqrt(a); }
+    static Vec max(Vec a, Vec b) { return a > b ? a : b; }
+    static Vec less(Vec a, Vec b) { return mask(a < b); }
+    static Vec greater(Vec a, Vec b) { return mask(a > b); }
+
+    static Vec bitAnd(Vec m, Vec v) {
+        return fromBits(toBits(m) & toBits(v));
+    }
+
+    static Vec exponent(Vec x) {
+        return static_cast<float>(static_cast<int32_t>(toBits(x) >> 23) - 0x7f);
+    }
+
+    static Vec mantissaHalf(Vec x) {
+        return fromBits((toBits(x) & ~FLOAT_EXPONENT_MASK) | FLOAT_HALF_BITS);
+    }
+
+    static float sum(Vec v) { return v; }
+
+private:
+    static uint32_t toBits(float v) {
+        uint32_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        return bits;
+    }
+
+    static float fromBits(uint32_t bits) {
+        float v;
+        std::memcpy(&v, &bits, sizeof(v));
+        return v;
+    }
+
+    static Vec mask(bool set) { return fromBits(set ? 0xffffffffu : 0u); }
+};
+
+#if MICMAP_DETECTION_HAVE_SSE2
+struct SSE2Ops {
+    using Vec = __m128;
+    static constexpr size_t WIDTH = 4;
+
+    static Vec zero() { return _mm_setzero_ps(); }
+    static Vec set1(float value) { return _mm_set1_ps(value); }
+    static Vec ramp() { return _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f); }
+    static Vec load(const float* p) { return _mm_loadu_ps(p); }
+    static void store(float* p, Vec v) { _mm_storeu_ps(p, v); }
+
+    static void loadComplex(const float* p, Vec& real, Vec& imag) {
+        Vec a = _mm_loadu_ps(p);        // r0 i0 r1 i1
+        Vec b = _mm_loadu_ps(p + 4);    // r2 i2 r3 i3
+        real = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        imag = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+    }
+
+    static Vec add(Vec a, Vec b) { return _mm_add_ps(a, b); }
+    static Vec sub(Vec a, Vec b) { return _mm_sub_ps(a, b); }
+    static Vec mul(Vec a, Vec b) { return _mm_mul_ps(a, b); }
+    static Vec div(Vec a, Vec b) { return _mm_div_ps(a, b); }
+    static Vec sqrt(Vec a) { return _mm_sqrt_ps(a); }
+    static Vec max(Vec a, Vec b) { return _mm_max_ps(a, b); }
+    static Vec less(Vec a, Vec b) { return _mm_cmplt_ps(a, b); }
+    static Vec greater(Vec a, Vec b) { return _mm_cmpgt_ps(a, b); }
+    static Vec bitAnd(Vec mask, Vec v) { return _mm_and_ps(mask, v); }
+
+    static Vec exponent(Vec x) {
+        __m128i biased = _mm_srli_epi32(_mm_castps_si128(x), 23);
+        return _mm_cvtepi32_ps(_mm_sub_epi32(biased, _mm_set1_epi32(0x7f)));
+    }
+
+    static Vec mantissaHalf(Vec x) {
+        __m128i bits = _mm_castps_si128(x);
+        bits = _mm_andnot_si128(_mm_set1_epi32(static_cast<int>(FLOAT_EXPONENT_MASK)), bits);
+        bits = _mm_or_si128(bits, _mm_set1_epi32(static_cast<int>(FLOAT_HALF_BITS)));
+        return _mm_castsi128_ps(bits);
+    }
+
+    static float sum(Vec v) {
+        Vec shuffled = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+        Vec sums = _mm_add_ps(v, shuffled);
+        shuffled = _mm_movehl_ps(shuffled, sums);
+        sums = _mm_add_ss(sums, shuffled);
+        return _mm_cvtss_f32(sums);
+    }
+};
+#endif
+
+#if defined(__AVX2__)
+struct AVX2Ops {
+    using Vec = __m256;
+    static constexpr size_t WIDTH = 8;
+
+    static Vec zero() { return _mm256_setzero_ps(); }
+    static Vec set1(float value) { return _mm256_set1_ps(value); }
+    static Vec ramp() { return _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f); }
+    static Vec load(const float* p) { return _mm256_loadu_ps(p); }
+    static void store(float* p, Vec v) { _mm256_storeu_ps(p, v); }
+
+    static void loadComplex(const float* p, Vec& real, Vec& imag) {
+        Vec a = _mm256_loadu_ps(p);         // r0 i0 r1 i1 | r2 i2 r3 i3
+        Vec b = _mm256_loadu_ps(p + 8);     // r4 i4 r5 i5 | r6 i6 r7 i7
+        // In-lane shuffles give r0 r1 r4 r5 | r2 r3 r6 r7; restore the order
+        // by swapping the middle 64-bit pairs
+        Vec re = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        Vec im = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+        real = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(re), _MM_SHUFFLE(3, 1, 2, 0)));
+        imag = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(im), _MM_SHUFFLE(3, 1, 2, 0)));
+    }
+
+    static Vec add(Vec a, Vec b) { return _mm256_add_ps(a, b); }
+    static Vec sub(Vec a, Vec b) { return _mm256_sub_ps(a, b); }
+    static Vec mul(Vec a, Vec b) { return _mm256_mul_ps(a, b); }
+    static Vec div(Vec a, Vec b) { return _mm256_div_ps(a, b); }
+    static Vec sqrt(Vec a) { return _mm256_sqrt_ps(a); }
+    static Vec max(Vec a, Vec b) { return _mm256_max_ps(a, b); }
+    static Vec less(Vec a, Vec b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    static Vec greater(Vec a, Vec b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    static Vec bitAnd(Vec mask, Vec v) { return _mm256_and_ps(mask, v); }
+
+    static Vec exponent(Vec x) {
+        __m256i biased = _mm256_srli_epi32(_mm256_castps_si256(x), 23);
+        return _mm256_cvtepi32_ps(_mm256_sub_epi32(biased, _mm256_set1_epi32(0x7f)));
+    }
+
+    static Vec mantissaHalf(Vec x) {
+        __m256i bits = _mm256_castps_si256(x);
+        bits = _mm256_andnot_si256(_mm256_set1_epi32(static_cast<int>(FLOAT_EXPONENT_MASK)), bits);
+        bits = _mm256_or_si256(bits, _mm256_set1_epi32(static_cast<int>(FLOAT_HALF_BITS)));
+        return _mm256_castsi256_ps(bits);
+    }
+
+    static float sum(Vec v) {
+        __m128 sums = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+        __m128 shuffled = _mm_shuffle_ps(sums, sums, _MM_SHUFFLE(2, 3, 0, 1));
+        sums = _mm_add_ps(sums, shuffled);
+        shuffled = _mm_movehl_ps(shuffled, sums);
+        sums = _mm_add_ss(sums, shuffled);
+        return _mm_cvtss_f32(sums);
+    }
+};
+#endif
+
+#if MICMAP_DETECTION_HAVE_NEON
+struct NEONOps {
+    using Vec = float32x4_t;
+    static constexpr size_t WIDTH = 4;
+
+    static Vec zero() { return vdupq_n_f32(0.0f); }
+    static Vec set1(float value) { return vdupq_n_f32(value); }
+    static Vec ramp() {
+        static const float values[4] = {0.0f, 1.0f, 2.0f, 3.0f};
+        return vld1q_f32(values);
+    }
+    static Vec load(const float* p) { return vld1q_f32(p); }
+    static void store(float* p, Vec v) { vst1q_f32(p, v); }
+
+    static void loadComplex(const float* p, Vec& real, Vec& imag) {
+        float32x4x2_t pairs = vld2q_f32(p);
+        real = pairs.val[0];
+        imag = pairs.val[1];
+    }
+
+    static Vec add(Vec a, Vec b) { return vaddq_f32(a, b); }
+    static Vec sub(Vec a, Vec b) { return vsubq_f32(a, b); }
+    static Vec mul(Vec a, Vec b) { return vmulq_f32(a, b); }
+    static Vec div(Vec a, Vec b) { return vdivq_f32(a, b); }
+    static Vec sqrt(Vec a) { return vsqrtq_f32(a); }
+    static Vec max(Vec a, Vec b) { return vmaxq_f32(a, b); }
+    static Vec less(Vec a, Vec b) { return vreinterpretq_f32_u32(vcltq_f32(a, b)); }
+    static Vec greater(Vec a, Vec b) { return vreinterpretq_f32_u32(vcgtq_f32(a, b)); }
+    static Vec bitAnd(Vec mask, Vec v) {
+        return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(mask), vreinterpretq_u32_f32(v)));
+    }
+
+    static Vec exponent(Vec x) {
+        uint32x4_t biased = vshrq_n_u32(vreinterpretq_u32_f32(x), 23);
+        int32x4_t unbiased = vsubq_s32(vreinterpretq_s32_u32(biased), vdupq_n_s32(0x7f));
+        return vcvtq_f32_s32(unbiased);
+    }
+
+    static Vec mantissaHalf(Vec x) {
+        uint32x4_t bits = vbicq_u32(vreinterpretq_u32_f32(x), vdupq_n_u32(FLOAT_EXPONENT_MASK));
+        bits = vorrq_u32(bits, vdupq_n_u32(FLOAT_HALF_BITS));
+        return vreinterpretq_f32_u32(bits);
+    }
+
+    static float sum(Vec v) { return vaddvq_f32(v); }
+};
+#endif
+
+} // anonymous namespace
+
+} // namespace micmap::detection::detail
@@ -0,0 +1,253 @@
+/**
+ * @file sliding_dft.cpp
+ * @brief Sparse-bin sliding DFT analyzer and discriminative bin selection
+ */
+
+#include "micmap/detection/sliding_dft.hpp"
+#include "micmap/common/logger.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace micmap::detection {
+
+namespace {
+    constexpr double TWO_PI = 6.28318530717958647692;
+
+    // Floor of the training log variance when scoring bins, as in the detector
+    constexpr float MIN_LOG_VARIANCE = 0.05f;
+}
+
+SlidingDFTAnalyzer::SlidingDFTAnalyzer(uint32_t sampleRate, size_t fftSize, size_t hopSize,
+                                       const std::vector<size_t>& bins, common::SimdLevel level)
+    : kernels_(getSpectralFeatureKernels(level))
+    , sampleRate_(sampleRate)
+    , fftSize_(fftSize)
+    , hopSize_(hopSize)
+    , hops_(hopSize > 0 ? fftSize / hopSize : 0)
+    , bins_(bins) {
+    if (sampleRate_ == 0 || fftSize_ < 4 || hopSize_ == 0 || hopSize_ > fftSize_ ||
+        fftSize_ % hopSize_ != 0) {
+        throw std::invalid_argument("Sliding DFT needs a hop size that divides the FFT size");
+    }
+    std::sort(bins_.begin(), bins_.end());
+    bins_.erase(std::unique(bins_.begin(), bins_.end()), bins_.end());
+    if (bins_.empty() || bins_.front() < 1 || bins_.back() > fftSize_ / 2 - 1) {
+        throw std::invalid_argument("Sliding DFT bins must be within [1, fftSize / 2 - 1]");
+    }
+
+    // The window needs each bin's neighbours; adjacent bins share them
+    for (size_t bin : bins_) {
+        for (size_t k = bin - 1; k <= bin + 1; ++k) {
+            if (tracked_.empty() || tracked_.back() < k) {
+                tracked_.push_back(k);
+            }
+        }
+    }
+    for (size_t bin : bins_) {
+        lower_.push_back(static_cast<size_t>(
+            std::lower_bound(tracked_.begin(), tracked_.end(), bin - 1) - tracked_.begin()));
+    }
+
+    // Partial DFT rows over one hop and the rotation that places a hop at
+    // its position in the frame: e^(-j w n) and e^(-j w p h)
+    const size_t count = tracked_.size();
+    basis_.resize(2 * count * hopSize_);
+    rotation_.resize(2 * count * hops_);
+    for (size_t t = 0; t < count; ++t) {
+        const double omega = TWO_PI * static_cast<double>(tracked_[t]) / static_cast<double>(fftSize_);
+        float* cosRow = basis_.data() + 2 * t * hopSize_;
+        float* sinRow = cosRow + hopSize_;
+        for (size_t n = 0; n < hopSize_; ++n) {
+            // Reduce the angle exactly before converting it to radians
+            double angle = TWO_PI * static_cast<double>((tracked_[t] * n) % fftSize_) /
+                           static_cast<double>(fftSize_);
+            cosRow[n] = static_cast<float>(std::cos(angle));
+            sinRow[n] = static_cast<float>(-std::sin(angle));
+        }
+        for (size_t p = 0; p < hops_; ++p) {
+            double angle = omega * static_cast<double>(p * hopSize_);
+            rotation_[2 * (p * count + t)] = static_cast<float>(std::cos(angle));
+            rotation_[2 * (p * count + t) + 1] = static_cast<float>(-std::sin(angle));
+        }
+    }
+
+    ring_.assign(2 * count * hops_, 0.0f);
+    spectrum_.assign(2 * count, 0.0f);
+    binMagnitudes_.assign(bins_.size(), 0.0f);
+    paddedSamples_.resize(fftSize_);
+
+    MICMAP_LOG_DEBUG("Created sliding DFT analyzer: ", bins_.size(), " of ", getNumBins(),
+                     " bins, ", fftSize_, " point frames, hop ", hopSize_);
+}
+
+SpectralResult SlidingDFTAnalyzer::analyze(const float* samples, size_t count) {
+    SpectralResult result;
+    result.magnitudes.resize(getNumBins(), 0.0f);
+    SpectralFeatures features = analyzeInto(samples, count, result.magnitudes.data(),
+                                            result.magnitudes.size());
+    result.spectralFlatness = features.spectralFlatness;
+    result.spectralCentroid = features.spectralCentroid;
+    result.energy = features.energy;
+    return result;
+}
+
+SpectralFeatures SlidingDFTAnalyzer::analyzeInto(const float* samples, size_t count,
+                                                 float* magnitudes, size_t magnitudeCount) {
+    SpectralFeatures features;
+    if (magnitudes) {
+        std::fill(magnitudes, magnitudes + magnitudeCount, 0.0f);
+    }
+    if (!samples || count == 0) {
+        std::fill(binMagnitudes_.begin(), binMagnitudes_.end(), 0.0f);
+        return features;
+    }
+
+    features.energy = kernels_.meanSquare(samples, count);
+    const float* frame = selectFrame(samples, count);
+    const size_t tracked = tracked_.size();
+
+    // Only the newest hop is new; a fresh start transforms every hop
+    if (primed_) {
+        transformHop(frame + fftSize_ - hopSize_, ring_.data() + 2 * tracked * oldest_);
+        oldest_ = (oldest_ + 1) % hops_;
+    } else {
+        for (size_t p = 0; p < hops_; ++p) {
+            transformHop(frame + p * hopSize_, ring_.data() + 2 * tracked * p);
+        }
+        oldest_ = 0;
+        primed_ = true;
+    }
+
+    // Rotate every hop's partial to its position in the frame and sum
+    std::fill(spectrum_.begin(), spectrum_.end(), 0.0f);
+    for (size_t p = 0; p < hops_; ++p) {
+        const float* partial = ring_.data() + 2 * tracked * ((oldest_ + p) % hops_);
+        const float* rotation = rotation_.data() + 2 * tracked * p;
+        for (size_t t = 0; t < tracked; ++t) {
+            float re = partial[2 * t];
+            float im = partial[2 * t + 1];
+            spectrum_[2 * t] += re * rotation[2 * t] - im * rotation[2 * t + 1];
+            spectrum_[2 * t + 1] += re * rotation[2 * t + 1] + im * rotation[2 * t];
+        }
+    }
+
+    // Hann window as -1/4, 1/2, -1/4 over the neighbouring bins, scaled
+    // like the FFT analyzer's magnitudes
+    const float scale = 2.0f / static_cast<float>(fftSize_);
+    float weightedFrequency = 0.0f;
+    float total = 0.0f;
+    for (size_t i = 0; i < bins_.size(); ++i) {
+        const float* below = spectrum_.data() + 2 * lower_[i];
+        float re = 0.5f * below[2] - 0.25f * (below[0] + below[4]);
+        float im = 0.5f * below[3] - 0.25f * (below[1] + below[5]);
+        float magnitude = scale * std::sqrt(re * re + im * im);
+        binMagnitudes_[i] = magnitude;
+        weightedFrequency += magnitude * binToFrequency(bins_[i]);
+        total += magnitude;
+        if (magnitudes && bins_[i] < magnitudeCount) {
+            magnitudes[bins_[i]] = magnitude;
+        }
+    }
+
+    features.spectralFlatness = kernels_.flatness(binMagnitudes_.data(), binMagnitudes_.size());
+    features.spectralCentroid = total > 0.0f ? weightedFrequency / total : 0.0f;
+    return features;
+}
+
+void SlidingDFTAnalyzer::getBinMagnitudes(float* output) const {
+    std::copy(binMagnitudes_.begin(), binMagnitudes_.end(), output);
+}
+
+void SlidingDFTAnalyzer::reset() {
+    primed_ = false;
+    oldest_ = 0;
+}
+
+float SlidingDFTAnalyzer::getFrequencyResolution() const {
+    return static_cast<float>(sampleRate_) / static_cast<float>(fftSize_);
+}
+
+float SlidingDFTAnalyzer::binToFrequency(size_t bin) const {
+    return static_cast<float>(bin) * getFrequencyResolution();
+}
+
+size_t SlidingDFTAnalyzer::frequencyToBin(float frequency) const {
+    if (frequency < 0.0f) return 0;
+    size_t bin = static_cast<size_t>(frequency / getFrequencyResolution() + 0.5f);
+    return std::min(bin, getNumBins() - 1);
+}
+
+void SlidingDFTAnalyzer::transformHop(const float* hop, float* partial) const {
+    kernels_.dotRows(basis_.data(), 2 * tracked_.size(), hopSize_, hop, hopSize_, partial);
+}
+
+const float* SlidingDFTAnalyzer::selectFrame(const float* samples, size_t count) {
+    if (count >= fftSize_) {
+        return samples + (count - fftSize_);
+    }
+
+    // Short input is zero-padded at the beginning, as in the FFT analyzer
+    size_t offset = fftSize_ - count;
+    std::fill(paddedSamples_.begin(), paddedSamples_.begin() + offset, 0.0f);
+    std::copy(samples, samples + count, paddedSamples_.begin() + offset);
+    return paddedSamples_.data();
+}
+
+std::vector<size_t> selectDiscriminativeBins(const std::vector<float>& logMean,
+                                             const std::vector<float>& logVariance,
+                                             size_t count) {
+    std::vector<size_t> selected;
+    const size_t n = logMean.size();
+    if (n < 3 || count == 0) {
+        return selected;
+    }
+
+    // DC and the last bin lack a neighbour on one side
+    double average = 0.0;
+    for (size_t i = 1; i + 1 < n; ++i) {
+        average += logMean[i];
+    }
+    average /= static_cast<double>(n - 2);
+
+    std::vector<std::pair<float, size_t>> above;
+    std::vector<std::pair<float, size_t>> below;
+    for (size_t i = 1; i + 1 < n; ++i) {
+        float variance = i < logVariance.size() ? logVariance[i] : 1.0f;
+        float score = static_cast<float>(logMean[i] - average) /
+                      std::sqrt(std::max(variance, MIN_LOG_VARIANCE));
+        (score >= 0.0f ? above : below).emplace_back(std::abs(score), i);
+    }
+    auto byScore = [](const auto& a, const auto& b) {
+        return a.first > b.first || (a.first == b.first && a.second < b.second);
+    };
+    std::sort(above.begin(), above.end(), byScore);
+    std::sort(below.begin(), below.end(), byScore);
+
+    auto isFree = [&selected](size_t bin) {
+        return std::none_of(selected.begin(), selected.end(), [bin](size_t s) {
+            return (bin > s ? bin - s : s - bin) < 2;
+        });
+    };
+
+    size_t nextAbove = 0;
+    size_t nextBelow = 0;
+    bool fromAbove = true;
+    while (selected.size() < count && (nextAbove < above.size() || nextBelow < below.size())) {
+        auto& side = (fromAbove && nextAbove < above.size()) || nextBelow >= below.size() ? above : below;
+        size_t& next = (&side == &above) ? nextAbove : nextBelow;
+        while (next < side.size() && !isFree(side[next].second)) {
+            ++next;
+        }
+        if (next < side.size()) {
+            selected.push_back(side[next++].second);
+        }
+        fromAbove = !fromAbove;
+    }
+
+    std::sort(selected.begin(), selected.end());
+    return selected;
+}
+
+} // namespace micmap::detection
@@ -0,0 +1,260 @@
+/**
+ * @file spectral_features.cpp
+ * @brief Scalar reference feature kernels and runtime dispatch
+ */
+
+#include "micmap/detection/spectral_features.hpp"
+#include "spectral_features_kernels.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace micmap::detection {
+
+using common::SimdLevel;
+
+namespace detail {
+
+namespace {
+
+void magnitudesScalar(const float* bins, size_t count, float scale, float* output) {
+    for (size_t i = 0; i < count; ++i) {
+        float real = bins[2 * i];
+        float imag = bins[2 * i + 1];
+        output[i] = std::sqrt(real * real + imag * imag) * scale;
+    }
+}
+
+float meanSquareScalar(const float* samples, size_t count) {
+    if (count == 0) {
+        return 0.0f;
+    }
+
+    double sum = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        sum += static_cast<double>(samples[i]) * static_cast<double>(samples[i]);
+    }
+    return static_cast<float>(sum / static_cast<double>(count));
+}
+
+float flatnessScalar(const float* magnitudes, size_t count) {
+    double logSum = 0.0;
+    double sum = 0.0;
+    size_t validCount = 0;
+
+    for (size_t i = 0; i < count; ++i) {
+        float mag = magnitudes[i];
+        if (mag > FEATURE_EPSILON) {
+            logSum += std::log(static_cast<double>(mag));
+            sum += mag;
+            ++validCount;
+        }
+    }
+
+    if (validCount == 0 || sum < FEATURE_EPSILON) {
+        return 0.0f;
+    }
+
+    // Geometric mean = exp(mean(log(x)))
+    double geometricMean = std::exp(logSum / static_cast<double>(validCount));
+    double arithmeticMean = sum / static_cast<double>(validCount);
+    return std::clamp(static_cast<float>(geometricMean / arithmeticMean), 0.0f, 1.0f);
+}
+
+float centroidScalar(const float* magnitudes, size_t count) {
+    float weightedSum = 0.0f;
+    float sum = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        weightedSum += static_cast<float>(i) * magnitudes[i];
+        sum += magnitudes[i];
+    }
+
+    if (sum < FEATURE_EPSILON) {
+        return 0.0f;
+    }
+    return weightedSum / sum;
+}
+
+float correlationScalar(const float* values, const float* centeredReference,
+                        float referenceSumSq, size_t count) {
+    if (count == 0) {
+        return 0.0f;
+    }
+
+    float mean = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        mean += values[i];
+    }
+    mean /= static_cast<float>(count);
+
+    float sumAB = 0.0f;
+    float sumA2 = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        float dev = values[i] - mean;
+        sumAB += dev * centeredReference[i];
+        sumA2 += dev * dev;
+    }
+
+    float denominator = std::sqrt(sumA2 * referenceSumSq);
+    if (denominator < FEATURE_EPSILON) {
+        return 0.0f;
+    }
+    return sumAB / denominator;
+}
+
+float logShapeMseScalar(const float* values, const float* centeredLogReference,
+                        size_t count, float* scratch) {
+    if (count == 0) {
+        return 0.0f;
+    }
+
+    float sumLog = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        scratch[i] = std::log(values[i] + FEATURE_EPSILON);
+        sumLog += scratch[i];
+    }
+    float meanLog = sumLog / static_cast<float>(count);
+
+    float mse = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        float diff = (scratch[i] - meanLog) - centeredLogReference[i];
+        mse += diff * diff;
+    }
+    return mse / static_cast<float>(count);
+}
+
+float logMahalanobisScalar(const float* values, const float* logMean,
+                           const float* inverseVariance, float inverseVarianceSum,
+                           size_t count) {
+    if (count == 0 || inverseVarianceSum <= 0.0f) {
+        return 0.0f;
+    }
+
+    double weightedSum = 0.0;
+    double weightedSumSq = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        double residual = std::log(static_cast<double>(values[i]) + FEATURE_EPSILON) - logMean[i];
+        double weighted = inverseVariance[i] * residual;
+        weightedSum += weighted;
+        weightedSumSq += weighted * residual;
+    }
+
+    double distance = weightedSumSq - weightedSum * weightedSum / inverseVarianceSum;
+    return static_cast<float>(std::max(0.0, distance) / static_cast<double>(count));
+}
+
+float logSpectrumScalar(const float* values, size_t count, float* output) {
+    if (count == 0) {
+        return 0.0f;
+    }
+
+    float sumLog = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        output[i] = std::log(values[i] + FEATURE_EPSILON);
+        sumLog += output[i];
+    }
+    return sumLog / static_cast<float>(count);
+}
+
+void dotRowsScalar(const float* matrix, size_t rows, size_t rowStride,
+                   const float* vector, size_t count, float* output) {
+    for (size_t r = 0; r < rows; ++r) {
+        const float* row = matrix + r * rowStride;
+        float sum = 0.0f;
+        for (size_t i = 0; i < count; ++i) {
+            sum += row[i] * vector[i];
+        }
+        output[r] = sum;
+    }
+}
+
+float coherenceScalar(const float* first, const float* second, size_t count,
+                      float decay, float* state) {
+    if (count == 0) {
+        return 0.0f;
+    }
+
+    float* firstPower = state;
+    float* secondPower = state + count;
+    float* crossReal = state + 2 * count;
+    float* crossImag = state + 3 * count;
+    const float gain = 1.0f - decay;
+
+    float sum = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        float xr = first[2 * i];
+        float xi = first[2 * i + 1];
+        float yr = second[2 * i];
+        float yi = second[2 * i + 1];
+
+        // X * conj(Y)
+        firstPower[i] = decay * firstPower[i] + gain * (xr * xr + xi * xi);
+        secondPower[i] = decay * secondPower[i] + gain * (yr * yr + yi * yi);
+        crossReal[i] = decay * crossReal[i] + gain * (xr * yr + xi * yi);
+        crossImag[i] = decay * crossImag[i] + gain * (xi * yr - xr * yi);
+
+        float cross = crossReal[i] * crossReal[i] + crossImag[i] * crossImag[i];
+        sum += cross / std::max(firstPower[i] * secondPower[i], COHERENCE_FLOOR);
+    }
+    return std::min(1.0f, sum / static_cast<float>(count));
+}
+
+} // anonymous namespace
+
+const SpectralFeatureKernels& scalarFeatureKernels() {
+    static const SpectralFeatureKernels kernels = {
+        SimdLevel::Scalar,
+        magnitudesScalar,
+        meanSquareScalar,
+        flatnessScalar,
+        centroidScalar,
+        correlationScalar,
+        logShapeMseScalar,
+        logMahalanobisScalar,
+        logSpectrumScalar,
+        dotRowsScalar,
+        coherenceScalar
+    };
+    return kernels;
+}
+
+} // namespace detail
+
+namespace {
+
+const SpectralFeatureKernels& kernelsFor(SimdLevel level) {
+    switch (level) {
+#ifdef MICMAP_HAVE_AVX2
+        case SimdLevel::AVX2: return detail::avx2FeatureKernels();
+#endif
+#if MICMAP_DETECTION_HAVE_SSE2
+        case SimdLevel::SSE2: return detail::sse2FeatureKernels();
+#endif
+#if MICMAP_DETECTION_HAVE_NEON
+        case SimdLevel::NEON: return detail::neonFeatureKernels();
+#endif
+        default: return detail::scalarFeatureKernels();
+    }
+}
+
+} // anonymous namespace
+
+common::SimdLevel getSpectralFeatureSimdLevel() {
+    static const SimdLevel level = detail::resolveSimdLevel(common::detectSimdLevel());
+    return level;
+}
+
+const SpectralFeatureKernels& getSpectralFeatureKernels() {
+    static const SpectralFeatureKernels& kernels = kernelsFor(getSpectralFeatureSimdLevel());
+    return kernels;
+}
+
+const SpectralFeatureKernels& getSpectralFeatureKernels(common::SimdLevel level) {
+    return kernelsFor(detail::resolveSimdLevel(level));
+}
+
+float fastLog(float x) {
+    return detail::fastLogScalar(x);
+}
+
+} // namespace micmap::detection
@@ -0,0 +1,19 @@
+/**
+ * @file spectral_features_avx2.cpp
+ * @brief AVX2 spectral feature kernels
+ *
+ * Compiled with AVX2 enabled (see cmake/SimdFlags.cmake) and only called
+ * after runtime detection confirms CPU support.
+ */
+
+#include "spectral_features_kernels.hpp"
+
+namespace micmap::detection::detail {
+
+const SpectralFeatureKernels& avx2FeatureKernels() {
+    static const SpectralFeatureKernels kernels =
+        makeSimdFeatureKernels<AVX2Ops>(common::SimdLevel::AVX2);
+    return kernels;
+}
+
+} // namespace micmap::detection::detail
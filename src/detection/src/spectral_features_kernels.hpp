@@ -0,0 +1,535 @@
+#pragma once
+
+/**
+ * @file spectral_features_kernels.hpp
+ * @brief Internal declarations shared by the per-ISA spectral feature kernels
+ *
+ * As with the audio conversion kernels, everything defined here has internal
+ * linkage because the header is included by translation units compiled with
+ * different instruction set flags.
+ */
+
+#include "micmap/detection/spectral_features.hpp"
+#include "simd_ops.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace micmap::detection::detail {
+
+const SpectralFeatureKernels& scalarFeatureKernels();
+
+#if MICMAP_DETECTION_HAVE_SSE2
+const SpectralFeatureKernels& sse2FeatureKernels();
+#endif
+
+#ifdef MICMAP_HAVE_AVX2
+const SpectralFeatureKernels& avx2FeatureKernels();
+#endif
+
+#if MICMAP_DETECTION_HAVE_NEON
+const SpectralFeatureKernels& neonFeatureKernels();
+#endif
+
+namespace {
+
+/// Values at or below this are treated as silent bins
+constexpr float FEATURE_EPSILON = 1e-10f;
+
+/// Floor of the power product in the coherence; unnormalized FFT powers of
+/// quiet audio are far above it
+constexpr float COHERENCE_FLOOR = 1e-30f;
+
+// Cephes logf: log(1 + x) = x - x^2/2 + x^3 * P(x) for x in [sqrt(1/2) - 1, sqrt(2) - 1]
+constexpr float LOG_SQRT_HALF = 0.707106781186547524f;
+constexpr float LOG_P0 = 7.0376836292e-2f;
+constexpr float LOG_P1 = -1.1514610310e-1f;
+constexpr float LOG_P2 = 1.1676998740e-1f;
+constexpr float LOG_P3 = -1.2420140846e-1f;
+constexpr float LOG_P4 = 1.4249322787e-1f;
+constexpr float LOG_P5 = -1.6668057665e-1f;
+constexpr float LOG_P6 = 2.0000714765e-1f;
+constexpr float LOG_P7 = -2.4999993993e-1f;
+constexpr float LOG_P8 = 3.3333331174e-1f;
+
+// ln(2) split into a coarse part exact in float and a small correction
+constexpr float LOG_LN2_HI = 0.693359375f;
+constexpr float LOG_LN2_LO = -2.12194440e-4f;
+
+/**
+ * @brief Scalar evaluation of the polynomial logarithm
+ *
+ * Operation-for-operation the same as the vector versions, which use it for
+ * loop tails.
+ */
+inline float fastLogScalar(float x) {
+    x = x < std::numeric_limits<float>::min() ? std::numeric_limits<float>::min() : x;
+
+    uint32_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    float e = static_cast<float>(static_cast<int32_t>(bits >> 23) - 0x7f) + 1.0f;
+
+    // Mantissa scaled to [0.5, 1)
+    bits = (bits & ~FLOAT_EXPONENT_MASK) | FLOAT_HALF_BITS;
+    std::memcpy(&x, &bits, sizeof(x));
+
+    // Shift to [sqrt(1/2), sqrt(2)) so the polynomial argument stays small
+    if (x < LOG_SQRT_HALF) {
+        e -= 1.0f;
+        x = x + x - 1.0f;
+    } else {
+        x = x - 1.0f;
+    }
+
+    float z = x * x;
+    float y = LOG_P0;
+    y = y * x + LOG_P1;
+    y = y * x + LOG_P2;
+    y = y * x + LOG_P3;
+    y = y * x + LOG_P4;
+    y = y * x + LOG_P5;
+    y = y * x + LOG_P6;
+    y = y * x + LOG_P7;
+    y = y * x + LOG_P8;
+    y = y * x;
+    y = y * z;
+
+    y += e * LOG_LN2_LO;
+    y += -0.5f * z;
+    x = x + y;
+    x += e * LOG_LN2_HI;
+    return x;
+}
+
+/**
+ * @brief Vector polynomial logarithm, lane-wise identical to fastLogScalar()
+ *
+ * Ops provides the ISA primitives; see makeSimdFeatureKernels().
+ */
+template <typename Ops>
+inline typename Ops::Vec fastLogSimd(typename Ops::Vec x) {
+    using Vec = typename Ops::Vec;
+    const Vec one = Ops::set1(1.0f);
+
+    x = Ops::max(x, Ops::set1(std::numeric_limits<float>::min()));
+    Vec e = Ops::add(Ops::exponent(x), one);
+    x = Ops::mantissaHalf(x);
+
+    Vec small = Ops::less(x, Ops::set1(LOG_SQRT_HALF));
+    Vec tmp = Ops::bitAnd(small, x);
+    x = Ops::sub(x, one);
+    e = Ops::sub(e, Ops::bitAnd(small, one));
+    x = Ops::add(x, tmp);
+
+    Vec z = Ops::mul(x, x);
+    Vec y = Ops::set1(LOG_P0);
+    y = Ops::add(Ops::mul(y, x), Ops::set1(LOG_P1));
+    y = Ops::add(Ops::mul(y, x), Ops::set1(LOG_P2));
+    y = Ops::add(Ops::mul(y, x), Ops::set1(LOG_P3));
+    y = Ops::add(Ops::mul(y, x), Ops::set1(LOG_P4));
+    y = Ops::add(Ops::mul(y, x), Ops::set1(LOG_P5));
+    y = Ops::add(Ops::mul(y, x), Ops::set1(LOG_P6));
+    y = Ops::add(Ops::mul(y, x), Ops::set1(LOG_P7));
+    y = Ops::add(Ops::mul(y, x), Ops::set1(LOG_P8));
+    y = Ops::mul(y, x);
+    y = Ops::mul(y, z);
+
+    y = Ops::add(y, Ops::mul(e, Ops::set1(LOG_LN2_LO)));
+    y = Ops::add(y, Ops::mul(z, Ops::set1(-0.5f)));
+    x = Ops::add(x, y);
+    x = Ops::add(x, Ops::mul(e, Ops::set1(LOG_LN2_HI)));
+    return x;
+}
+
+// Generic vector kernels. Each ISA translation unit instantiates them with
+// its own Ops, so the algorithm is shared while the instructions differ.
+// Loop tails fall back to the same scalar arithmetic.
+
+template <typename Ops>
+void magnitudesSimd(const float* bins, size_t count, float scale, float* output) {
+    using Vec = typename Ops::Vec;
+    const Vec scaleVec = Ops::set1(scale);
+
+    size_t i = 0;
+    for (; i + Ops::WIDTH <= count; i += Ops::WIDTH) {
+        Vec real, imag;
+        Ops::loadComplex(bins + 2 * i, real, imag);
+        Vec power = Ops::add(Ops::mul(real, real), Ops::mul(imag, imag));
+        Ops::store(output + i, Ops::mul(Ops::sqrt(power), scaleVec));
+    }
+    for (; i < count; ++i) {
+        float real = bins[2 * i];
+        float imag = bins[2 * i + 1];
+        output[i] = std::sqrt(real * real + imag * imag) * scale;
+    }
+}
+
+template <typename Ops>
+float meanSquareSimd(const float* samples, size_t count) {
+    using Vec = typename Ops::Vec;
+    if (count == 0) {
+        return 0.0f;
+    }
+
+    Vec acc = Ops::zero();
+    size_t i = 0;
+    for (; i + Ops::WIDTH <= count; i += Ops::WIDTH) {
+        Vec v = Ops::load(samples + i);
+        acc = Ops::add(acc, Ops::mul(v, v));
+    }
+    float sum = Ops::sum(acc);
+    for (; i < count; ++i) {
+        sum += samples[i] * samples[i];
+    }
+    return sum / static_cast<float>(count);
+}
+
+template <typename Ops>
+float flatnessSimd(const float* magnitudes, size_t count) {
+    using Vec = typename Ops::Vec;
+    const Vec epsilon = Ops::set1(FEATURE_EPSILON);
+    const Vec one = Ops::set1(1.0f);
+
+    Vec logAcc = Ops::zero();
+    Vec sumAcc = Ops::zero();
+    Vec countAcc = Ops::zero();
+    size_t i = 0;
+    for (; i + Ops::WIDTH <= count; i += Ops::WIDTH) {
+        Vec v = Ops::load(magnitudes + i);
+        Vec valid = Ops::greater(v, epsilon);
+        logAcc = Ops::add(logAcc, Ops::bitAnd(valid, fastLogSimd<Ops>(v)));
+        sumAcc = Ops::add(sumAcc, Ops::bitAnd(valid, v));
+        countAcc = Ops::add(countAcc, Ops::bitAnd(valid, one));
+    }
+
+    float logSum = Ops::sum(logAcc);
+    float sum = Ops::sum(sumAcc);
+    float validCount = Ops::sum(countAcc);
+    for (; i < count; ++i) {
+        float mag = magnitudes[i];
+        if (mag > FEATURE_EPSILON) {
+            logSum += fastLogScalar(mag);
+            sum += mag;
+            validCount += 1.0f;
+        }
+    }
+
+    if (validCount == 0.0f || sum < FEATURE_EPSILON) {
+        return 0.0f;
+    }
+
+    float geometricMean = std::exp(logSum / validCount);
+    float arithmeticMean = sum / validCount;
+    return std::clamp(geometricMean / arithmeticMean, 0.0f, 1.0f);
+}
+
+template <typename Ops>
+float centroidSimd(const float* magnitudes, size_t count) {
+    using Vec = typename Ops::Vec;
+    const Vec step = Ops::set1(static_cast<float>(Ops::WIDTH));
+
+    Vec index = Ops::ramp();
+    Vec weightedAcc = Ops::zero();
+    Vec sumAcc = Ops::zero();
+    size_t i = 0;
+    for (; i + Ops::WIDTH <= count; i += Ops::WIDTH) {
+        Vec v = Ops::load(magnitudes + i);
+        weightedAcc = Ops::add(weightedAcc, Ops::mul(index, v));
+        sumAcc = Ops::add(sumAcc, v);
+        index = Ops::add(index, step);
+    }
+
+    float weightedSum = Ops::sum(weightedAcc);
+    float sum = Ops::sum(sumAcc);
+    for (; i < count; ++i) {
+        weightedSum += static_cast<float>(i) * magnitudes[i];
+        sum += magnitudes[i];
+    }
+
+    if (sum < FEATURE_EPSILON) {
+        return 0.0f;
+    }
+    return weightedSum / sum;
+}
+
+template <typename Ops>
+float correlationSimd(const float* values, const float* centeredReference,
+                      float referenceSumSq, size_t count) {
+    using Vec = typename Ops::Vec;
+    if (count == 0) {
+        return 0.0f;
+    }
+
+    Vec meanAcc = Ops::zero();
+    size_t i = 0;
+    for (; i + Ops::WIDTH <= count; i += Ops::WIDTH) {
+        meanAcc = Ops::add(meanAcc, Ops::load(values + i));
+    }
+    float mean = Ops::sum(meanAcc);
+    for (; i < count; ++i) {
+        mean += values[i];
+    }
+    mean /= static_cast<float>(count);
+
+    const Vec meanVec = Ops::set1(mean);
+    Vec abAcc = Ops::zero();
+    Vec aaAcc = Ops::zero();
+    i = 0;
+    for (; i + Ops::WIDTH <= count; i += Ops::WIDTH) {
+        Vec dev = Ops::sub(Ops::load(values + i), meanVec);
+        abAcc = Ops::add(abAcc, Ops::mul(dev, Ops::load(centeredReference + i)));
+        aaAcc = Ops::add(aaAcc, Ops::mul(dev, dev));
+    }
+    float sumAB = Ops::sum(abAcc);
+    float sumA2 = Ops::sum(aaAcc);
+    for (; i < count; ++i) {
+        float dev = values[i] - mean;
+        sumAB += dev * centeredReference[i];
+        sumA2 += dev * dev;
+    }
+
+    float denominator = std::sqrt(sumA2 * referenceSumSq);
+    if (denominator < FEATURE_EPSILON) {
+        return 0.0f;
+    }
+    return sumAB / denominator;
+}
+
+template <typename Ops>
+float logShapeMseSimd(const float* values, const float* centeredLogReference,
+                      size_t count, float* scratch) {
+    using Vec = typename Ops::Vec;
+    if (count == 0) {
+        return 0.0f;
+    }
+
+    const Vec epsilon = Ops::set1(FEATURE_EPSILON);
+    Vec logAcc = Ops::zero();
+    size_t i = 0;
+    for (; i + Ops::WIDTH <= count; i += Ops::WIDTH) {
+        Vec logValue = fastLogSimd<Ops>(Ops::add(Ops::load(values + i), epsilon));
+        Ops::store(scratch + i, logValue);
+        logAcc = Ops::add(logAcc, logValue);
+    }
+    float sumLog = Ops::sum(logAcc);
+    for (; i < count; ++i) {
+        scratch[i] = fastLogScalar(values[i] + FEATURE_EPSILON);
+        sumLog += scratch[i];
+    }
+    float meanLog = sumLog / static_cast<float>(count);
+
+    const Vec meanVec = Ops::set1(meanLog);
+    Vec mseAcc = Ops::zero();
+    i = 0;
+    for (; i + Ops::WIDTH <= count; i += Ops::WIDTH) {
+        Vec diff = Ops::sub(Ops::sub(Ops::load(scratch + i), meanVec),
+                            Ops::load(centeredLogReference + i));
+        mseAcc = Ops::add(mseAcc, Ops::mul(diff, diff));
+    }
+    float mse = Ops::sum(mseAcc);
+    for (; i < count; ++i) {
+        float diff = (scratch[i] - meanLog) - centeredLogReference[i];
+        mse += diff * diff;
+    }
+    return mse / static_cast<float>(count);
+}
+
+template <typename Ops>
+float logMahalanobisSimd(const float* values, const float* logMean,
+                         const float* inverseVariance, float inverseVarianceSum,
+                         size_t count) {
+    using Vec = typename Ops::Vec;
+    if (count == 0 || inverseVarianceSum <= 0.0f) {
+        return 0.0f;
+    }
+
+    const Vec epsilon = Ops::set1(FEATURE_EPSILON);
+    Vec sumAcc = Ops::zero();
+    Vec sumSqAcc = Ops::zero();
+    size_t i = 0;
+    for (; i + Ops::WIDTH <= count; i += Ops::WIDTH) {
+        Vec logValue = fastLogSimd<Ops>(Ops::add(Ops::load(values + i), epsilon));
+        Vec residual = Ops::sub(logValue, Ops::load(logMean + i));
+        Vec weighted = Ops::mul(Ops::load(inverseVariance + i), residual);
+        sumAcc = Ops::add(sumAcc, weighted);
+        sumSqAcc = Ops::add(sumSqAcc, Ops::mul(weighted, residual));
+    }
+    float weightedSum = Ops::sum(sumAcc);
+    float weightedSumSq = Ops::sum(sumSqAcc);
+    for (; i < count; ++i) {
+        float residual = fastLogScalar(values[i] + FEATURE_EPSILON) - logMean[i];
+        float weighted = inverseVariance[i] * residual;
+        weightedSum += weighted;
+        weightedSumSq += weighted * residual;
+    }
+
+    float distance = weightedSumSq - weightedSum * weightedSum / inverseVarianceSum;
+    return std::max(0.0f, distance) / static_cast<float>(count);
+}
+
+template <typename Ops>
+float logSpectrumSimd(const float* values, size_t count, float* output) {
+    using Vec = typename Ops::Vec;
+    if (count == 0) {
+        return 0.0f;
+    }
+
+    const Vec epsilon = Ops::set1(FEATURE_EPSILON);
+    Vec logAcc = Ops::zero();
+    size_t i = 0;
+    for (; i + Ops::WIDTH <= count; i += Ops::WIDTH) {
+        Vec logValue = fastLogSimd<Ops>(Ops::add(Ops::load(values + i), epsilon));
+        Ops::store(output + i, logValue);
+        logAcc = Ops::add(logAcc, logValue);
+    }
+    float sumLog = Ops::sum(logAcc);
+    for (; i < count; ++i) {
+        output[i] = fastLogScalar(values[i] + FEATURE_EPSILON);
+        sumLog += output[i];
+    }
+    return sumLog / static_cast<float>(count);
+}
+
+template <typename Ops>
+float dotRowSimd(const float* row, const float* vector, size_t count) {
+    using Vec = typename Ops::Vec;
+    Vec acc = Ops::zero();
+    size_t i = 0;
+    for (; i + Ops::WIDTH <= count; i += Ops::WIDTH) {
+        acc = Ops::add(acc, Ops::mul(Ops::load(row + i), Ops::load(vector + i)));
+    }
+    float sum = Ops::sum(acc);
+    for (; i < count; ++i) {
+        sum += row[i] * vector[i];
+    }
+    return sum;
+}
+
+template <typename Ops>
+void dotRowsSimd(const float* matrix, size_t rows, size_t rowStride,
+                 const float* vector, size_t count, float* output) {
+    using Vec = typename Ops::Vec;
+
+    // Four rows per block share every load of the vector
+    size_t r = 0;
+    for (; r + 4 <= rows; r += 4) {
+        const float* row0 = matrix + r * rowStride;
+        const float* row1 = row0 + rowStride;
+        const float* row2 = row1 + rowStride;
+        const float* row3 = row2 + rowStride;
+        Vec acc0 = Ops::zero();
+        Vec acc1 = Ops::zero();
+        Vec acc2 = Ops::zero();
+        Vec acc3 = Ops::zero();
+        size_t i = 0;
+        for (; i + Ops::WIDTH <= count; i += Ops::WIDTH) {
+            Vec v = Ops::load(vector + i);
+            acc0 = Ops::add(acc0, Ops::mul(Ops::load(row0 + i), v));
+            acc1 = Ops::add(acc1, Ops::mul(Ops::load(row1 + i), v));
+            acc2 = Ops::add(acc2, Ops::mul(Ops::load(row2 + i), v));
+            acc3 = Ops::add(acc3, Ops::mul(Ops::load(row3 + i), v));
+        }
+        float sum0 = Ops::sum(acc0);
+        float sum1 = Ops::sum(acc1);
+        float sum2 = Ops::sum(acc2);
+        float sum3 = Ops::sum(acc3);
+        for (; i < count; ++i) {
+            sum0 += row0[i] * vector[i];
+            sum1 += row1[i] * vector[i];
+            sum2 += row2[i] * vector[i];
+            sum3 += row3[i] * vector[i];
+        }
+        output[r] = sum0;
+        output[r + 1] = sum1;
+        output[r + 2] = sum2;
+        output[r + 3] = sum3;
+    }
+    for (; r < rows; ++r) {
+        output[r] = dotRowSimd<Ops>(matrix + r * rowStride, vector, count);
+    }
+}
+
+template <typename Ops>
+float coherenceSimd(const float* first, const float* second, size_t count,
+                    float decay, float* state) {
+    using Vec = typename Ops::Vec;
+    if (count == 0) {
+        return 0.0f;
+    }
+
+    float* firstPower = state;
+    float* secondPower = state + count;
+    float* crossReal = state + 2 * count;
+    float* crossImag = state + 3 * count;
+    const float gain = 1.0f - decay;
+    const Vec decayVec = Ops::set1(decay);
+    const Vec gainVec = Ops::set1(gain);
+    const Vec floorVec = Ops::set1(COHERENCE_FLOOR);
+
+    Vec acc = Ops::zero();
+    size_t i = 0;
+    for (; i + Ops::WIDTH <= count; i += Ops::WIDTH) {
+        Vec xr, xi, yr, yi;
+        Ops::loadComplex(first + 2 * i, xr, xi);
+        Ops::loadComplex(second + 2 * i, yr, yi);
+
+        Vec xx = Ops::add(Ops::mul(decayVec, Ops::load(firstPower + i)),
+                          Ops::mul(gainVec, Ops::add(Ops::mul(xr, xr), Ops::mul(xi, xi))));
+        Vec yy = Ops::add(Ops::mul(decayVec, Ops::load(secondPower + i)),
+                          Ops::mul(gainVec, Ops::add(Ops::mul(yr, yr), Ops::mul(yi, yi))));
+        Vec re = Ops::add(Ops::mul(decayVec, Ops::load(crossReal + i)),
+                          Ops::mul(gainVec, Ops::add(Ops::mul(xr, yr), Ops::mul(xi, yi))));
+        Vec im = Ops::add(Ops::mul(decayVec, Ops::load(crossImag + i)),
+                          Ops::mul(gainVec, Ops::sub(Ops::mul(xi, yr), Ops::mul(xr, yi))));
+        Ops::store(firstPower + i, xx);
+        Ops::store(secondPower + i, yy);
+        Ops::store(crossReal + i, re);
+        Ops::store(crossImag + i, im);
+
+        Vec cross = Ops::add(Ops::mul(re, re), Ops::mul(im, im));
+        acc = Ops::add(acc, Ops::div(cross, Ops::max(Ops::mul(xx, yy), floorVec)));
+    }
+    float sum = Ops::sum(acc);
+    for (; i < count; ++i) {
+        float xr = first[2 * i];
+        float xi = first[2 * i + 1];
+        float yr = second[2 * i];
+        float yi = second[2 * i + 1];
+        firstPower[i] = decay * firstPower[i] + gain * (xr * xr + xi * xi);
+        secondPower[i] = decay * secondPower[i] + gain * (yr * yr + yi * yi);
+        crossReal[i] = decay * crossReal[i] + gain * (xr * yr + xi * yi);
+        crossImag[i] = decay * crossImag[i] + gain * (xi * yr - xr * yi);
+        float cross = crossReal[i] * crossReal[i] + crossImag[i] * crossImag[i];
+        sum += cross / std::max(firstPower[i] * secondPower[i], COHERENCE_FLOOR);
+    }
+    return std::min(1.0f, sum / static_cast<float>(count));
+}
+
+/**
+ * @brief Build a kernel table from one ISA's primitive operations
+ *
+ * Ops is one of the structs from simd_ops.hpp.
+ */
+template <typename Ops>
+SpectralFeatureKernels makeSimdFeatureKernels(common::SimdLevel level) {
+    return SpectralFeatureKernels{
+        level,
+        magnitudesSimd<Ops>,
+        meanSquareSimd<Ops>,
+        flatnessSimd<Ops>,
+        centroidSimd<Ops>,
+        correlationSimd<Ops>,
+        logShapeMseSimd<Ops>,
+        logMahalanobisSimd<Ops>,
+        logSpectrumSimd<Ops>,
+        dotRowsSimd<Ops>,
+        coherenceSimd<Ops>
+    };
+}
+
+} // anonymous namespace
+
+} // namespace micmap::detection::detail
@@ -0,0 +1,20 @@
+/**
+ * @file spectral_features_neon.cpp
+ * @brief NEON spectral feature kernels (AArch64)
+ */
+
+#include "spectral_features_kernels.hpp"
+
+#if MICMAP_DETECTION_HAVE_NEON
+
+namespace micmap::detection::detail {
+
+const SpectralFeatureKernels& neonFeatureKernels() {
+    static const SpectralFeatureKernels kernels =
+        makeSimdFeatureKernels<NEONOps>(common::SimdLevel::NEON);
+    return kernels;
+}
+
+} // namespace micmap::detection::detail
+
+#endif // MICMAP_DETECTION_HAVE_NEON
@@ -0,0 +1,20 @@
+/**
+ * @file spectral_features_sse2.cpp
+ * @brief SSE2 spectral feature kernels (baseline on x86-64)
+ */
+
+#include "spectral_features_kernels.hpp"
+
+#if MICMAP_DETECTION_HAVE_SSE2
+
+namespace micmap::detection::detail {
+
+const SpectralFeatureKernels& sse2FeatureKernels() {
+    static const SpectralFeatureKernels kernels =
+        makeSimdFeatureKernels<SSE2Ops>(common::SimdLevel::SSE2);
+    return kernels;
+}
+
+} // namespace micmap::detection::detail
+
+#endif // MICMAP_DETECTION_HAVE_SSE2
@@ -0,0 +1,23 @@
+/**
+ * @file streaming_stft.cpp
+ * @brief Sliding-window STFT framer implementation
+ */
+
+#include "micmap/detection/streaming_stft.hpp"
+
+namespace micmap::detection {
+
+StreamingSTFT::StreamingSTFT(size_t fftSize, size_t hopSize)
+    : fftSize_(std::max<size_t>(fftSize, 1))
+    , hopSize_(std::clamp<size_t>(hopSize, 1, fftSize_))
+    , window_(fftSize_, 0.0f) {
+}
+
+void StreamingSTFT::reset() {
+    std::fill(window_.begin(), window_.end(), 0.0f);
+    hopFill_ = 0;
+    totalFrames_ = 0;
+    slidePending_ = false;
+}
+
+} // namespace micmap::detection
@@ -0,0 +1,177 @@
+/**
+ * @file training_stats.cpp
+ * @brief Streaming statistics for training sessions of any length
+ */
+
+#include "micmap/detection/training_stats.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace micmap::detection {
+
+// ========== RunningMoments ==========
+
+void RunningMoments::add(double value) {
+    ++count_;
+    double delta = value - mean_;
+    mean_ += delta / static_cast<double>(count_);
+    m2_ += delta * (value - mean_);
+
+    if (count_ == 1) {
+        min_ = value;
+        max_ = value;
+    } else {
+        min_ = std::min(min_, value);
+        max_ = std::max(max_, value);
+    }
+}
+
+void RunningMoments::reset() {
+    *this = RunningMoments{};
+}
+
+double RunningMoments::variance() const {
+    return count_ > 1 ? m2_ / static_cast<double>(count_) : 0.0;
+}
+
+double RunningMoments::stdDev() const {
+    return std::sqrt(variance());
+}
+
+// ========== SpectrumMoments ==========
+
+SpectrumMoments::SpectrumMoments(size_t bins) {
+    resize(bins);
+}
+
+void SpectrumMoments::resize(size_t bins) {
+    mean_.assign(bins, 0.0);
+    m2_.assign(bins, 0.0);
+    count_ = 0;
+}
+
+void SpectrumMoments::reset() {
+    std::fill(mean_.begin(), mean_.end(), 0.0);
+    std::fill(m2_.begin(), m2_.end(), 0.0);
+    count_ = 0;
+}
+
+void SpectrumMoments::add(const float* spectrum) {
+    ++count_;
+    const double inverseCount = 1.0 / static_cast<double>(count_);
+    const size_t n = mean_.size();
+    for (size_t i = 0; i < n; ++i) {
+        double value = spectrum[i];
+        double delta = value - mean_[i];
+        mean_[i] += delta * inverseCount;
+        m2_[i] += delta * (value - mean_[i]);
+    }
+}
+
+double SpectrumMoments::variance(size_t bin) const {
+    return (count_ > 1 && bin < m2_.size()) ? m2_[bin] / static_cast<double>(count_) : 0.0;
+}
+
+// ========== P2Quantile ==========
+
+P2Quantile::P2Quantile(double quantile)
+    : quantile_(std::clamp(quantile, 0.0, 1.0)) {
+    reset();
+}
+
+void P2Quantile::reset() {
+    count_ = 0;
+    const double p = quantile_;
+    const double desired[MARKERS] = {1.0, 1.0 + 2.0 * p, 1.0 + 4.0 * p, 3.0 + 2.0 * p, 5.0};
+    const double increments[MARKERS] = {0.0, p / 2.0, p, (1.0 + p) / 2.0, 1.0};
+    for (int i = 0; i < MARKERS; ++i) {
+        heights_[i] = 0.0;
+        positions_[i] = static_cast<double>(i + 1);
+        desired_[i] = desired[i];
+        increments_[i] = increments[i];
+    }
+}
+
+void P2Quantile::add(double value) {
+    // The first values initialize the markers
+    if (count_ < MARKERS) {
+        heights_[count_++] = value;
+        if (count_ == MARKERS) {
+            std::sort(heights_, heights_ + MARKERS);
+        }
+        return;
+    }
+    ++count_;
+
+    // Cell containing the value; the extreme markers follow new extremes
+    int cell;
+    if (value < heights_[0]) {
+        heights_[0] = value;
+        cell = 0;
+    } else if (value >= heights_[MARKERS - 1]) {
+        heights_[MARKERS - 1] = value;
+        cell = MARKERS - 2;
+    } else {
+        cell = 0;
+        while (cell < MARKERS - 2 && value >= heights_[cell + 1]) {
+            ++cell;
+        }
+    }
+
+    for (int i = cell + 1; i < MARKERS; ++i) {
+        positions_[i] += 1.0;
+    }
+    for (int i = 0; i < MARKERS; ++i) {
+        desired_[i] += increments_[i];
+    }
+
+    // Move the middle markers towards their desired positions
+    for (int i = 1; i < MARKERS - 1; ++i) {
+        double offset = desired_[i] - positions_[i];
+        if ((offset >= 1.0 && positions_[i + 1] - positions_[i] > 1.0) ||
+            (offset <= -1.0 && positions_[i - 1] - positions_[i] < -1.0)) {
+            int direction = offset > 0.0 ? 1 : -1;
+            double height = parabolic(i, static_cast<double>(direction));
+            if (height <= heights_[i - 1] || height >= heights_[i + 1]) {
+                height = linear(i, direction);
+            }
+            heights_[i] = height;
+            positions_[i] += direction;
+        }
+    }
+}
+
+double P2Quantile::parabolic(int i, double direction) const {
+    double span = positions_[i + 1] - positions_[i - 1];
+    double upper = (positions_[i] - positions_[i - 1] + direction) *
+                   (heights_[i + 1] - heights_[i]) / (positions_[i + 1] - positions_[i]);
+    double lower = (positions_[i + 1] - positions_[i] - direction) *
+                   (heights_[i] - heights_[i - 1]) / (positions_[i] - positions_[i - 1]);
+    return heights_[i] + direction / span * (upper + lower);
+}
+
+double P2Quantile::linear(int i, int direction) const {
+    return heights_[i] + direction * (heights_[i + direction] - heights_[i]) /
+                         (positions_[i + direction] - positions_[i]);
+}
+
+double P2Quantile::value() const {
+    if (count_ == 0) {
+        return 0.0;
+    }
+    if (count_ > MARKERS) {
+        return heights_[2];
+    }
+
+    // Exact quantile of the few values seen, by linear interpolation
+    double sorted[MARKERS];
+    std::copy(heights_, heights_ + count_, sorted);
+    std::sort(sorted, sorted + count_);
+    double rank = quantile_ * static_cast<double>(count_ - 1);
+    size_t lower = static_cast<size_t>(rank);
+    size_t upper = std::min(lower + 1, count_ - 1);
+    return sorted[lower] + (sorted[upper] - sorted[lower]) * (rank - static_cast<double>(lower));
+}
+
+} // namespace micmap::detection
@@ -17,6 +17,8 @@
  * MicMap OpenVR driver via HTTP to inject button events.
  */
 
+#include <chrono>
+#include <cstdint>
 #include <memory>
 #include <functional>
 #include <string>
@@ -69,6 +71,8 @@ struct VREvent {
  */
 using VREventCallback = std::function<void(const VREvent&)>;
 
+class IDriverClient;
+
 /**
  * @brief Interface for VR input handling
  *
@@ -147,6 +151,16 @@ public:
      */
     virtual bool performDashboardAction() = 0;
     
+    /**
+     * @brief Set the driver client used to inject button events
+     * @param client Client shared with the rest of the application
+     *
+     * sendDashboardSelect() clicks through the MicMap driver. Without a
+     * client set, it creates its own on first use, which keeps a second
+     * connection and health thread to the same driver.
+     */
+    virtual void setDriverClient(std::shared_ptr<IDriverClient> client) = 0;
+    
     /**
      * @brief Poll for VR events
      *
@@ -192,6 +206,43 @@ std::unique_ptr<IVRInput> createOpenVRInput();
  */
 std::unique_ptr<IVRInput> createStubVRInput();
 
+/**
+ * @brief Driver client configuration
+ */
+struct DriverClientConfig {
+    std::string host = "127.0.0.1";  ///< Host the driver listens on
+    int startPort = 27015;           ///< First port scanned for the driver
+    int endPort = 27025;             ///< Last port scanned for the driver
+    int requestTimeoutMs = 500;      ///< Connect, read and write timeout of one request
+    int healthIntervalMs = 2000;     ///< Idle time before a health ping (0 = no background pings or reconnects)
+    int reconnectMinMs = 250;        ///< First reconnect delay after the connection is lost
+    int reconnectMaxMs = 8000;       ///< Reconnect delay limit; the delay doubles per failed attempt
+    bool useCommandChannel = true;   ///< Send button commands as binary datagrams when the driver answers them
+    int commandAckTimeoutMs = 20;    ///< Wait for a datagram ack before sending again
+    int commandAttempts = 3;         ///< Datagram sends of one command before it is reported as failed
+};
+
+/**
+ * @brief Request counters and round-trip times of a driver client
+ *
+ * The request and RTT fields cover HTTP requests; the command fields cover
+ * the datagram channel.
+ */
+struct DriverClientStats {
+    uint64_t requests = 0;    ///< Requests sent, including health pings
+    uint64_t failures = 0;    ///< Requests without a response
+    uint64_t reconnects = 0;  ///< Connections re-established after a loss
+    uint64_t portScans = 0;   ///< Scans of the whole port range
+    std::chrono::microseconds lastRtt{0};      ///< Round trip of the last answered request
+    std::chrono::microseconds smoothedRtt{0};  ///< Exponentially smoothed round trip (gain 1/8)
+    std::chrono::microseconds minRtt{0};
+    std::chrono::microseconds maxRtt{0};
+    uint64_t commands = 0;         ///< Button commands sent over the datagram channel
+    uint64_t commandFailures = 0;  ///< Datagram commands without an ack
+    std::chrono::microseconds lastCommandRtt{0};      ///< Round trip of the last acknowledged datagram command
+    std::chrono::microseconds smoothedCommandRtt{0};  ///< Exponentially smoothed datagram round trip (gain 1/8)
+};
+
 /**
  * @brief Interface for communicating with the MicMap driver
  *
@@ -241,6 +292,16 @@ public:
      */
     virtual bool release(const std::string& button = "system") = 0;
 
+    /**
+     * @brief Check whether the last failed button command may still run
+     * @return True if the last click, press or release reached the driver
+     *         over the command channel but was not acknowledged
+     *
+     * The driver is then usually busy rather than gone and performs the
+     * command late, so the caller must not send it again another way.
+     */
+    virtual bool lastCommandMayHaveRun() const = 0;
+
     /**
      * @brief Get driver status
      * @return True if driver is healthy
@@ -258,6 +319,11 @@ public:
      * @return Error message string
      */
     virtual std::string getLastError() const = 0;
+
+    /**
+     * @brief Get request counters and round-trip times
+     */
+    virtual DriverClientStats getStats() const = 0;
 };
 
 /**
@@ -275,4 +341,26 @@ std::unique_ptr<IDriverClient> createDriverClient(
     int startPort = 27015,
     int endPort = 27025);
 
+/**
+ * @brief Create a driver client
+ * @param config Client configuration
+ * @return Unique pointer to driver client interface
+ *
+ * The client keeps one keep-alive connection to the driver. After the
+ * first connect() call a background thread pings the idle connection every
+ * healthIntervalMs and, when a request or ping fails, reconnects with
+ * exponential backoff, trying the last known port before scanning the
+ * range again. Button commands then fail fast while the driver is away
+ * instead of scanning ports themselves.
+ *
+ * With useCommandChannel, click, press and release go to the driver's
+ * datagram command channel on the UDP port with the HTTP port's number
+ * (see micmap/common/command_channel.hpp) once it answers a ping. A command
+ * the channel refuses is sent over HTTP instead; one that went out but got
+ * no ack fails, since the driver may have performed it. Either way later
+ * commands use HTTP until the health thread has probed the channel again.
+ * Status checks always use HTTP.
+ */
+std::unique_ptr<IDriverClient> createDriverClient(const DriverClientConfig& config);
+
 } // namespace micmap::steamvr
\ No newline at end of file
@@ -5,7 +5,8 @@
  * Implementation approach for dashboard interaction:
  *
  * 1. Dashboard closed: Use IVROverlay::ShowDashboard() to open the dashboard
- * 2. Dashboard open: Use the MicMap driver via HTTP to inject button events
+ * 2. Dashboard open: Use the MicMap driver (binary datagrams, or HTTP when the
+ *    driver does not answer them) to inject button events
  *    that simulate HMD button press, activating whatever is under the head-locked
  *    virtual pointer.
  *
@@ -16,10 +17,15 @@
  */
 
 #include "micmap/steamvr/vr_input.hpp"
+#include "micmap/common/command_channel.hpp"
 #include "micmap/common/logger.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <mutex>
+#include <thread>
 
 #ifdef MICMAP_HAS_OPENVR
 #include <openvr.h>
@@ -109,6 +115,10 @@ public:
         }
     }
     
+    void setDriverClient(std::shared_ptr<IDriverClient>) override {
+        // Stub implementation - selection does not go through the driver
+    }
+    
     void pollEvents() override {
         // Stub implementation - no events to poll
     }
@@ -152,16 +162,25 @@ protected:
 
 /**
  * @brief HTTP client for communicating with the MicMap driver
+ *
+ * Keeps one keep-alive httplib::Client to the driver, so a button command
+ * costs a single request on a warm connection rather than a TCP handshake.
+ * A press/release pair with a fixed hold goes out as one /click request,
+ * which the driver expands itself; httplib cannot pipeline separate
+ * requests on one connection.
+ *
+ * requestMutex_ serializes use of the connection. A monitor thread pings
+ * an idle connection and reconnects a lost one with exponential backoff,
+ * trying the last known port before scanning the range.
  */
 class DriverClient : public IDriverClient {
 public:
-    DriverClient(const std::string& host, int startPort, int endPort)
-        : host_(host)
-        , startPort_(startPort)
-        , endPort_(endPort)
+    explicit DriverClient(const DriverClientConfig& config)
+        : config_(config)
+        , commandClient_(common::CommandClientConfig{config.commandAckTimeoutMs, config.commandAttempts})
     {
-        MICMAP_LOG_DEBUG("DriverClient created (host: {}, ports: {}-{})",
-                         host_, startPort_, endPort_);
+        MICMAP_LOG_DEBUG("DriverClient created (host: ", config_.host, ", ports: ",
+                         config_.startPort, "-", config_.endPort, ")");
     }
 
     ~DriverClient() override {
@@ -173,37 +192,27 @@ public:
             return true;
         }
 
-        MICMAP_LOG_INFO("Connecting to MicMap driver...");
-
-        // Try each port in the range
-        for (int port = startPort_; port <= endPort_; ++port) {
-            MICMAP_LOG_DEBUG("Trying port {}...", port);
-            
-            httplib::Client client(host_, port);
-            client.set_connection_timeout(1);  // 1 second timeout
-            client.set_read_timeout(1);
-
-            // Try to get status
-            auto res = client.Get("/health");
-            if (res && res->status == 200) {
-                port_ = port;
-                connected_ = true;
-                MICMAP_LOG_INFO("Connected to MicMap driver on port {}", port_);
-                return true;
-            }
+        bool ok;
+        {
+            std::lock_guard<std::mutex> lock(requestMutex_);
+            ok = connected_ || connectLocked();
         }
-
-        lastError_ = "Could not connect to MicMap driver on any port";
-        MICMAP_LOG_WARNING(lastError_);
-        return false;
+        // Whether or not the driver is up yet, keep the connection alive
+        // from now on
+        startMonitor();
+        return ok;
     }
 
     void disconnect() override {
+        stopMonitor();
+        std::lock_guard<std::mutex> lock(requestMutex_);
         if (connected_) {
             MICMAP_LOG_INFO("Disconnecting from MicMap driver");
-            connected_ = false;
-            port_ = 0;
         }
+        client_.reset();
+        closeCommandChannelLocked();
+        connected_ = false;
+        port_ = 0;
     }
 
     bool isConnected() const override {
@@ -211,141 +220,438 @@ public:
     }
 
     bool click(const std::string& button, int durationMs) override {
-        if (!ensureConnected()) {
-            return false;
+        MICMAP_LOG_DEBUG("Sending click command (button: ", button, ", duration: ", durationMs, "ms)");
+        commandMayHaveRun_ = false;
+        bool ok = false;
+        if (sendDatagram("Click", common::CommandAction::Click, button, durationMs, ok)) {
+            return ok;
         }
+        return sendCommand("Click", "/click?button=" + button + "&duration=" + std::to_string(durationMs));
+    }
 
-        MICMAP_LOG_DEBUG("Sending click command (button: {}, duration: {}ms)",
-                         button, durationMs);
+    bool press(const std::string& button) override {
+        MICMAP_LOG_DEBUG("Sending press command (button: ", button, ")");
+        commandMayHaveRun_ = false;
+        bool ok = false;
+        if (sendDatagram("Press", common::CommandAction::Press, button, 0, ok)) {
+            return ok;
+        }
+        return sendCommand("Press", "/press?button=" + button);
+    }
 
-        httplib::Client client(host_, port_);
-        client.set_connection_timeout(2);
-        client.set_read_timeout(2);
+    bool release(const std::string& button) override {
+        MICMAP_LOG_DEBUG("Sending release command (button: ", button, ")");
+        commandMayHaveRun_ = false;
+        bool ok = false;
+        if (sendDatagram("Release", common::CommandAction::Release, button, 0, ok)) {
+            return ok;
+        }
+        return sendCommand("Release", "/release?button=" + button);
+    }
 
-        std::string path = "/click?button=" + button + "&duration=" + std::to_string(durationMs);
-        auto res = client.Post(path);
+    bool lastCommandMayHaveRun() const override {
+        return commandMayHaveRun_;
+    }
 
-        if (!res) {
-            lastError_ = "HTTP request failed";
-            MICMAP_LOG_ERROR("Click command failed: {}", lastError_);
-            connected_ = false;  // Mark as disconnected to retry
+    bool getStatus() override {
+        if (!ensureConnected()) {
             return false;
         }
 
-        if (res->status != 200) {
-            lastError_ = "Server returned status " + std::to_string(res->status);
-            MICMAP_LOG_ERROR("Click command failed: {}", lastError_);
+        int status = 0;
+        if (!request(false, "/status", status) || status != 200) {
+            setError("Status check failed");
             return false;
         }
-
-        MICMAP_LOG_DEBUG("Click command successful");
         return true;
     }
 
-    bool press(const std::string& button) override {
-        if (!ensureConnected()) {
-            return false;
-        }
+    int getPort() const override {
+        return port_;
+    }
 
-        MICMAP_LOG_DEBUG("Sending press command (button: {})", button);
+    std::string getLastError() const override {
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        return lastError_;
+    }
 
-        httplib::Client client(host_, port_);
-        client.set_connection_timeout(2);
-        client.set_read_timeout(2);
+    DriverClientStats getStats() const override {
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        return stats_;
+    }
 
-        std::string path = "/press?button=" + button;
-        auto res = client.Post(path);
+private:
+    using Clock = std::chrono::steady_clock;
 
-        if (!res) {
-            lastError_ = "HTTP request failed";
-            MICMAP_LOG_ERROR("Press command failed: {}", lastError_);
-            connected_ = false;
+    bool sendCommand(const char* action, const std::string& path) {
+        if (!ensureConnected()) {
             return false;
         }
 
-        if (res->status != 200) {
-            lastError_ = "Server returned status " + std::to_string(res->status);
-            MICMAP_LOG_ERROR("Press command failed: {}", lastError_);
+        int status = 0;
+        if (!request(true, path, status)) {
+            MICMAP_LOG_ERROR(action, " command failed: ", getLastError());
+            return false;
+        }
+        if (status != 200) {
+            setError("Server returned status " + std::to_string(status));
+            MICMAP_LOG_ERROR(action, " command failed: ", getLastError());
             return false;
         }
 
-        MICMAP_LOG_DEBUG("Press command successful");
+        MICMAP_LOG_DEBUG(action, " command successful");
         return true;
     }
 
-    bool release(const std::string& button) override {
-        if (!ensureConnected()) {
+    /**
+     * @brief Send a button command over the datagram channel
+     * @param ok Set to whether the driver performed the command
+     * @return False if the command did not reach the driver (the channel
+     *         is down or nobody listens), so the caller can use HTTP
+     *
+     * The server ignores retransmissions of a command it already handled,
+     * but it cannot recognise the same command arriving over HTTP. A
+     * command that went out and got no ack, usually because the driver is
+     * busy rather than gone, is therefore reported as failed instead of
+     * resent: a repeated system button click would close the dashboard it
+     * just opened. lastCommandMayHaveRun() tells the caller not to resend
+     * it either.
+     */
+    bool sendDatagram(const char* action, common::CommandAction command, const std::string& button,
+                      int durationMs, bool& ok) {
+        common::CommandButton target;
+        if (!commandReady_ || !common::parseCommandButton(button, target)) {
             return false;
         }
 
-        MICMAP_LOG_DEBUG("Sending release command (button: {})", button);
+        std::lock_guard<std::mutex> lock(requestMutex_);
+        if (!commandReady_) {
+            return false;
+        }
+        common::CommandRecord ack;
+        auto start = Clock::now();
+        bool answered = commandClient_.send(command, target,
+                                            static_cast<uint16_t>(std::clamp(durationMs, 0, 65535)), ack);
+        auto rtt = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+        recordCommand(answered, rtt);
+
+        if (!answered) {
+            // Later commands use HTTP until the health thread probes again
+            closeCommandChannelLocked();
+            if (!commandClient_.mayHaveBeenHandled()) {
+                MICMAP_LOG_WARNING("Driver command channel is down (", commandClient_.getLastError(),
+                                   "), using HTTP");
+                return false;
+            }
+            commandMayHaveRun_ = true;
+            setError("No acknowledgement from driver: " + commandClient_.getLastError());
+            MICMAP_LOG_ERROR(action, " command not confirmed, not resending it: ", getLastError());
+            ok = false;
+            return true;
+        }
+        if (ack.status != common::CommandStatus::Ok) {
+            setError(ack.status == common::CommandStatus::NotActive
+                ? "Driver rejected command: controller not active"
+                : "Driver rejected command: bad command");
+            MICMAP_LOG_ERROR(action, " command failed: ", getLastError());
+            ok = false;
+            return true;
+        }
+
+        MICMAP_LOG_DEBUG(action, " command acknowledged in ", rtt.count(), " us");
+        ok = true;
+        return true;
+    }
 
-        httplib::Client client(host_, port_);
-        client.set_connection_timeout(2);
-        client.set_read_timeout(2);
+    /**
+     * @brief Probe the driver's command channel on the connected port
+     *
+     * Called with requestMutex_ held. Drivers without the channel refuse
+     * the ping at once, so the probe costs little on every connect.
+     */
+    void openCommandChannelLocked() {
+        if (!config_.useCommandChannel || commandReady_ || port_ == 0) {
+            return;
+        }
+        common::CommandRecord ack;
+        if (commandClient_.open(config_.host, port_) &&
+            commandClient_.send(common::CommandAction::Ping, common::CommandButton::System, 0, ack)) {
+            commandReady_ = true;
+            MICMAP_LOG_INFO("Using the driver's command channel on UDP port ", port_.load());
+            return;
+        }
+        MICMAP_LOG_DEBUG("Driver command channel unavailable: ", commandClient_.getLastError());
+        commandClient_.close();
+    }
 
-        std::string path = "/release?button=" + button;
-        auto res = client.Post(path);
+    void closeCommandChannelLocked() {
+        commandClient_.close();
+        commandReady_ = false;
+    }
 
-        if (!res) {
-            lastError_ = "HTTP request failed";
-            MICMAP_LOG_ERROR("Release command failed: {}", lastError_);
-            connected_ = false;
+    bool ensureConnected() {
+        if (connected_) {
+            return true;
+        }
+        // The monitor is reconnecting; a button command must not wait for
+        // a port scan
+        if (monitorRunning_) {
+            setError("Not connected to MicMap driver (reconnecting)");
             return false;
         }
+        return connect();
+    }
 
-        if (res->status != 200) {
-            lastError_ = "Server returned status " + std::to_string(res->status);
-            MICMAP_LOG_ERROR("Release command failed: {}", lastError_);
+    /**
+     * @brief Send one request on the persistent connection
+     * @return False if no response arrived; the connection is then dropped
+     */
+    bool request(bool post, const std::string& path, int& status) {
+        std::lock_guard<std::mutex> lock(requestMutex_);
+        if (!client_) {
+            setError("Not connected to MicMap driver");
             return false;
         }
 
-        MICMAP_LOG_DEBUG("Release command successful");
+        auto start = Clock::now();
+        auto res = post ? client_->Post(path) : client_->Get(path);
+        auto end = Clock::now();
+        lastRequest_ = end;
+
+        if (!res) {
+            setError("HTTP request failed");
+            recordRequest(false, {});
+            MICMAP_LOG_WARNING("Lost connection to MicMap driver on port ", port_.load());
+            markLostLocked();
+            return false;
+        }
+        recordRequest(true, std::chrono::duration_cast<std::chrono::microseconds>(end - start));
+        status = res->status;
         return true;
     }
 
-    bool getStatus() override {
-        if (!ensureConnected()) {
-            return false;
+    /**
+     * @brief Find the driver, trying the last known port first
+     *
+     * Called with requestMutex_ held.
+     */
+    bool connectLocked() {
+        if (lastPort_ > 0 && tryPort(lastPort_)) {
+            return true;
         }
 
-        httplib::Client client(host_, port_);
-        client.set_connection_timeout(2);
-        client.set_read_timeout(2);
+        MICMAP_LOG_DEBUG("Scanning for MicMap driver...");
+        {
+            std::lock_guard<std::mutex> lock(stateMutex_);
+            ++stats_.portScans;
+        }
+        for (int port = config_.startPort; port <= config_.endPort; ++port) {
+            if (port != lastPort_ && tryPort(port)) {
+                return true;
+            }
+        }
+
+        setError("Could not connect to MicMap driver on any port");
+        return false;
+    }
 
-        auto res = client.Get("/status");
+    bool tryPort(int port) {
+        auto client = std::make_unique<httplib::Client>(config_.host, port);
+        time_t seconds = config_.requestTimeoutMs / 1000;
+        time_t micros = (config_.requestTimeoutMs % 1000) * 1000;
+        client->set_connection_timeout(seconds, micros);
+        client->set_read_timeout(seconds, micros);
+        client->set_write_timeout(seconds, micros);
+        client->set_keep_alive(true);
 
+        auto start = Clock::now();
+        auto res = client->Get("/health");
+        auto end = Clock::now();
         if (!res || res->status != 200) {
-            lastError_ = "Status check failed";
-            connected_ = false;
             return false;
         }
 
+        client_ = std::move(client);
+        lastRequest_ = end;
+        port_ = port;
+        connected_ = true;
+        recordRequest(true, std::chrono::duration_cast<std::chrono::microseconds>(end - start));
+        if (lastPort_ > 0) {
+            std::lock_guard<std::mutex> lock(stateMutex_);
+            ++stats_.reconnects;
+        }
+        lastPort_ = port;
+        MICMAP_LOG_INFO("Connected to MicMap driver on port ", port);
+        openCommandChannelLocked();
         return true;
     }
 
-    int getPort() const override {
-        return port_;
+    /**
+     * @brief Drop the connection and wake the monitor to reconnect
+     *
+     * Called with requestMutex_ held.
+     */
+    void markLostLocked() {
+        client_.reset();
+        closeCommandChannelLocked();
+        connected_ = false;
+        port_ = 0;
+        {
+            std::lock_guard<std::mutex> lock(monitorMutex_);
+            monitorWake_ = true;
+        }
+        monitorCv_.notify_one();
     }
 
-    std::string getLastError() const override {
-        return lastError_;
+    void startMonitor() {
+        if (config_.healthIntervalMs <= 0) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(monitorMutex_);
+        if (monitorThread_.joinable()) {
+            return;
+        }
+        monitorStop_ = false;
+        monitorRunning_ = true;
+        monitorThread_ = std::thread(&DriverClient::monitor, this);
     }
 
-private:
-    bool ensureConnected() {
-        if (connected_) {
-            return true;
+    void stopMonitor() {
+        std::thread thread;
+        {
+            std::lock_guard<std::mutex> lock(monitorMutex_);
+            monitorStop_ = true;
+            thread = std::move(monitorThread_);
+        }
+        monitorCv_.notify_one();
+        if (thread.joinable()) {
+            thread.join();
+        }
+        monitorRunning_ = false;
+    }
+
+    void monitor() {
+        const auto interval = std::chrono::milliseconds(config_.healthIntervalMs);
+        const auto minDelay = std::chrono::milliseconds(std::max(1, config_.reconnectMinMs));
+        const auto maxDelay = std::chrono::milliseconds(std::max(config_.reconnectMinMs, config_.reconnectMaxMs));
+        auto delay = minDelay;
+        // A lost connection is retried at once; later attempts back off
+        bool retryNow = false;
+
+        std::unique_lock<std::mutex> lock(monitorMutex_);
+        while (!monitorStop_) {
+            if (!retryNow) {
+                monitorCv_.wait_for(lock, connected_ ? interval : delay,
+                                    [this] { return monitorStop_ || monitorWake_; });
+            }
+            retryNow = monitorWake_;
+            monitorWake_ = false;
+            if (monitorStop_) {
+                break;
+            }
+            lock.unlock();
+
+            if (connected_) {
+                pingIfIdle(interval);
+                if (config_.useCommandChannel && !commandReady_) {
+                    std::lock_guard<std::mutex> requestLock(requestMutex_);
+                    openCommandChannelLocked();
+                }
+                delay = minDelay;
+                retryNow = false;
+            } else {
+                bool ok;
+                {
+                    std::lock_guard<std::mutex> requestLock(requestMutex_);
+                    ok = connected_ || connectLocked();
+                }
+                if (ok) {
+                    delay = minDelay;
+                } else if (!retryNow) {
+                    delay = std::min(delay * 2, maxDelay);
+                }
+                retryNow = false;
+            }
+
+            lock.lock();
+        }
+    }
+
+    void pingIfIdle(std::chrono::milliseconds interval) {
+        {
+            std::lock_guard<std::mutex> lock(requestMutex_);
+            if (Clock::now() - lastRequest_ < interval) {
+                return;  // Button traffic already proved the connection
+            }
+        }
+        int status = 0;
+        if (request(false, "/health", status) && status != 200) {
+            MICMAP_LOG_WARNING("MicMap driver health check returned status ", status);
+        }
+    }
+
+    void recordRequest(bool answered, std::chrono::microseconds rtt) {
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        ++stats_.requests;
+        if (!answered) {
+            ++stats_.failures;
+            return;
+        }
+        stats_.lastRtt = rtt;
+        if (stats_.smoothedRtt.count() == 0) {
+            stats_.smoothedRtt = rtt;
+            stats_.minRtt = rtt;
+        } else {
+            stats_.smoothedRtt += (rtt - stats_.smoothedRtt) / 8;
+            stats_.minRtt = std::min(stats_.minRtt, rtt);
+        }
+        stats_.maxRtt = std::max(stats_.maxRtt, rtt);
+    }
+
+    void recordCommand(bool answered, std::chrono::microseconds rtt) {
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        ++stats_.commands;
+        if (!answered) {
+            ++stats_.commandFailures;
+            return;
+        }
+        stats_.lastCommandRtt = rtt;
+        if (stats_.smoothedCommandRtt.count() == 0) {
+            stats_.smoothedCommandRtt = rtt;
+        } else {
+            stats_.smoothedCommandRtt += (rtt - stats_.smoothedCommandRtt) / 8;
         }
-        return connect();
     }
 
-    std::string host_;
-    int startPort_;
-    int endPort_;
-    int port_ = 0;
-    bool connected_ = false;
+    void setError(const std::string& error) {
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        lastError_ = error;
+    }
+
+    DriverClientConfig config_;
+
+    // Connection, guarded by requestMutex_
+    std::mutex requestMutex_;
+    std::unique_ptr<httplib::Client> client_;
+    int lastPort_ = 0;
+    Clock::time_point lastRequest_{};
+    std::atomic<bool> connected_{false};
+    std::atomic<int> port_{0};
+    common::CommandClient commandClient_;
+    std::atomic<bool> commandReady_{false};
+    std::atomic<bool> commandMayHaveRun_{false};
+
+    // Health and reconnect thread
+    std::mutex monitorMutex_;
+    std::condition_variable monitorCv_;
+    std::thread monitorThread_;
+    bool monitorStop_ = false;
+    bool monitorWake_ = false;
+    std::atomic<bool> monitorRunning_{false};
+
+    mutable std::mutex stateMutex_;
     std::string lastError_;
+    DriverClientStats stats_;
 };
 
 // ============================================================================
@@ -494,16 +800,8 @@ public:
             driverClient_ = createDriverClient();
         }
         
-        if (!driverClient_->isConnected()) {
-            if (!driverClient_->connect()) {
-                lastError_ = "Failed to connect to MicMap driver: " + driverClient_->getLastError();
-                MICMAP_LOG_WARNING(lastError_);
-                MICMAP_LOG_WARNING("Make sure the MicMap driver is installed and SteamVR is running");
-                return false;
-            }
-        }
-        
-        // Send click command to the driver - use trigger for laser mouse selection
+        // Send click command to the driver - use trigger for laser mouse selection.
+        // The client connects on first use and fails fast while it reconnects
         if (!driverClient_->click("trigger", 100)) {
             lastError_ = "Failed to send click command: " + driverClient_->getLastError();
             MICMAP_LOG_ERROR(lastError_);
@@ -533,6 +831,10 @@ public:
         }
     }
     
+    void setDriverClient(std::shared_ptr<IDriverClient> client) override {
+        driverClient_ = std::move(client);
+    }
+    
     void pollEvents() override {
         if (!initialized_ || !vrSystem_) {
             return;
@@ -607,7 +909,7 @@ private:
     std::string lastError_;
     VREventCallback eventCallback_;
     std::mutex callbackMutex_;
-    std::unique_ptr<IDriverClient> driverClient_;
+    std::shared_ptr<IDriverClient> driverClient_;
 };
 
 #endif // MICMAP_HAS_OPENVR
@@ -634,7 +936,15 @@ std::unique_ptr<IDriverClient> createDriverClient(
     int startPort,
     int endPort)
 {
-    return std::make_unique<DriverClient>(host, startPort, endPort);
+    DriverClientConfig config;
+    config.host = host;
+    config.startPort = startPort;
+    config.endPort = endPort;
+    return createDriverClient(config);
+}
+
+std::unique_ptr<IDriverClient> createDriverClient(const DriverClientConfig& config) {
+    return std::make_unique<DriverClient>(config);
 }
 
 } // namespace micmap::steamvr
\ No newline at end of file
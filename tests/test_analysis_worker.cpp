@@ -0,0 +1,307 @@
+/**
+ * @file test_analysis_worker.cpp
+ * @brief Tests for the analysis worker queue and its backpressure policies
+ *
+ * Streams a ramp from a producer thread and checks that the worker delivers
+ * every frame in order, then fills a stopped worker past its bounds to check
+ * what each policy keeps and what the counters report. Last, a coalesced
+ * backlog is run through a multi-channel detector as the app does.
+ */
+
+#include "micmap/audio/analysis_worker.hpp"
+#include "micmap/detection/noise_detector.hpp"
+#include "micmap/common/logger.hpp"
+#include "test_common.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace micmap::audio;
+
+namespace {
+
+/// 1 kHz makes every duration in milliseconds a frame count
+AnalysisWorkerConfig smallConfig(BackpressurePolicy policy, size_t streams = 1) {
+    AnalysisWorkerConfig config;
+    config.sampleRate = 1000;
+    config.streams = streams;
+    config.policy = policy;
+    config.queueMs = 500;
+    config.maxBacklogMs = 100;
+    config.blockMs = 10;
+    config.lateMs = 50;
+    return config;
+}
+
+void testOrdering() {
+    constexpr size_t STREAMS = 3;
+    constexpr size_t TOTAL = 200000;
+
+    std::vector<std::vector<float>> received(STREAMS);
+    size_t largestBatch = 0;
+    AnalysisWorkerConfig config;
+    config.streams = STREAMS;
+    config.policy = BackpressurePolicy::Coalesce;
+    config.queueMs = 5000;  // Holds the whole stream: nothing may drop
+    AnalysisWorker worker(config, [&](const float* const* streams, size_t frames) {
+        largestBatch = std::max(largestBatch, frames);
+        for (size_t s = 0; s < STREAMS; ++s) {
+            received[s].insert(received[s].end(), streams[s], streams[s] + frames);
+        }
+    });
+    CHECK(worker.start());
+    CHECK(!worker.start());
+    CHECK(worker.isRunning());
+
+    // Capture-sized packets of varying length from a separate thread
+    std::thread producer([&]() {
+        std::vector<float> planes[STREAMS];
+        size_t next = 0;
+        size_t packet = 1;
+        while (next < TOTAL) {
+            size_t frames = std::min(packet, TOTAL - next);
+            const float* pointers[STREAMS];
+            for (size_t s = 0; s < STREAMS; ++s) {
+                planes[s].resize(frames);
+                for (size_t i = 0; i < frames; ++i) {
+                    planes[s][i] = static_cast<float>((next + i) * STREAMS + s);
+                }
+                pointers[s] = planes[s].data();
+            }
+            CHECK_EQ(worker.push(pointers, frames), frames);
+            next += frames;
+            packet = packet % 997 + 13;
+        }
+    });
+    producer.join();
+    CHECK(worker.waitIdle(5000));
+
+    bool inOrder = true;
+    for (size_t s = 0; s < STREAMS; ++s) {
+        CHECK_EQ(received[s].size(), TOTAL);
+        for (size_t i = 0; i < received[s].size() && inOrder; ++i) {
+            inOrder = received[s][i] == static_cast<float>(i * STREAMS + s);
+        }
+    }
+    CHECK(inOrder);
+    CHECK(largestBatch <= worker.maxBatchFrames());
+
+    AnalysisWorkerStats stats = worker.getStats();
+    CHECK_EQ(stats.enqueuedFrames, uint64_t(TOTAL));
+    CHECK_EQ(stats.processedFrames, uint64_t(TOTAL));
+    CHECK_EQ(stats.droppedFrames, uint64_t(0));
+    CHECK(stats.batches > 0);
+
+    worker.resetStats();
+    CHECK_EQ(worker.getStats().processedFrames, uint64_t(0));
+    worker.stop();
+    CHECK(!worker.isRunning());
+    CHECK(!worker.waitIdle(10));
+}
+
+/// Fills a stopped worker with 600 ms of a ramp, then lets it drain
+std::vector<float> overfill(const AnalysisWorkerConfig& config, std::vector<size_t>& batches,
+                            AnalysisWorkerStats& stats) {
+    std::vector<float> received;
+    AnalysisWorker worker(config, [&](const float* const* streams, size_t frames) {
+        batches.push_back(frames);
+        received.insert(received.end(), streams[0], streams[0] + frames);
+    });
+
+    std::vector<float> ramp(600);
+    for (size_t i = 0; i < ramp.size(); ++i) {
+        ramp[i] = static_cast<float>(i);
+    }
+    CHECK_EQ(worker.push(ramp.data(), 400), size_t(400));
+    CHECK_EQ(worker.push(ramp.data() + 400, 200), size_t(100));  // Queue holds 500 ms
+
+    CHECK(worker.start());
+    CHECK(worker.waitIdle(5000));
+    stats = worker.getStats();
+    return received;
+}
+
+void testDropOldest() {
+    std::vector<size_t> batches;
+    AnalysisWorkerStats stats;
+    std::vector<float> received = overfill(smallConfig(BackpressurePolicy::DropOldest), batches, stats);
+
+    // Only the newest 100 ms survive, in 10 ms blocks
+    CHECK_EQ(received.size(), size_t(100));
+    CHECK_EQ(received.front(), 400.0f);
+    CHECK_EQ(received.back(), 499.0f);
+    CHECK_EQ(batches.size(), size_t(10));
+    CHECK(std::all_of(batches.begin(), batches.end(), [](size_t b) { return b == 10; }));
+
+    CHECK_EQ(stats.enqueuedFrames, uint64_t(500));
+    CHECK_EQ(stats.processedFrames, uint64_t(100));
+    CHECK_EQ(stats.droppedFrames, uint64_t(500));  // 100 rejected, 400 oldest
+    CHECK_EQ(stats.maxBacklogFrames, size_t(500));
+    // Blocks delivered while 100, 90, 80, 70 and 60 ms were still queued
+    CHECK_EQ(stats.lateFrames, uint64_t(50));
+    CHECK_EQ(stats.batches, uint64_t(10));
+}
+
+void testCoalesce() {
+    std::vector<size_t> batches;
+    AnalysisWorkerStats stats;
+    std::vector<float> received = overfill(smallConfig(BackpressurePolicy::Coalesce), batches, stats);
+
+    // Everything queued, in one call
+    CHECK_EQ(received.size(), size_t(500));
+    CHECK_EQ(received.front(), 0.0f);
+    CHECK_EQ(received.back(), 499.0f);
+    CHECK_EQ(batches.size(), size_t(1));
+
+    CHECK_EQ(stats.enqueuedFrames, uint64_t(500));
+    CHECK_EQ(stats.processedFrames, uint64_t(500));
+    CHECK_EQ(stats.droppedFrames, uint64_t(100));
+    CHECK_EQ(stats.lateFrames, uint64_t(500));
+    CHECK_EQ(stats.batches, uint64_t(1));
+}
+
+void testRestart() {
+    std::vector<float> received;
+    AnalysisWorker worker(smallConfig(BackpressurePolicy::DropOldest),
+                          [&](const float* const* streams, size_t frames) {
+        received.insert(received.end(), streams[0], streams[0] + frames);
+    });
+    std::vector<float> packet(30, 1.0f);
+
+    CHECK(worker.start());
+    worker.push(packet.data(), packet.size());
+    CHECK(worker.waitIdle(5000));
+    worker.stop();
+
+    // Audio pushed while stopped waits for the next start
+    packet.assign(30, 2.0f);
+    worker.push(packet.data(), packet.size());
+    CHECK_EQ(received.size(), size_t(30));
+    CHECK(worker.start());
+    CHECK(worker.waitIdle(5000));
+    CHECK_EQ(received.size(), size_t(60));
+    CHECK_EQ(received.back(), 2.0f);
+    CHECK_EQ(worker.getStats().lateFrames, uint64_t(0));
+}
+
+void testConfig() {
+    BackpressurePolicy policy = BackpressurePolicy::DropOldest;
+    CHECK(parseBackpressurePolicy("coalesce", policy));
+    CHECK(policy == BackpressurePolicy::Coalesce);
+    CHECK(parseBackpressurePolicy("drop-oldest", policy));
+    CHECK(policy == BackpressurePolicy::DropOldest);
+    CHECK(!parseBackpressurePolicy("drop-newest", policy));
+    CHECK(policy == BackpressurePolicy::DropOldest);
+
+    auto handler = [](const float* const*, size_t) {};
+    auto throws = [&](AnalysisWorkerConfig config, AnalysisWorker::Handler h) {
+        try {
+            AnalysisWorker worker(config, std::move(h));
+        } catch (const std::invalid_argument&) {
+            return true;
+        }
+        return false;
+    };
+    AnalysisWorkerConfig config;
+    CHECK(!throws(config, handler));
+    CHECK(throws(config, nullptr));
+    config.streams = 0;
+    CHECK(throws(config, handler));
+    config.streams = AnalysisWorker::MAX_STREAMS + 1;
+    CHECK(throws(config, handler));
+    config = AnalysisWorkerConfig{};
+    config.sampleRate = 0;
+    CHECK(throws(config, handler));
+    config = AnalysisWorkerConfig{};
+    config.queueMs = 0;
+    CHECK(throws(config, handler));
+    config = AnalysisWorkerConfig{};
+    config.lateMs = -1;
+    CHECK(throws(config, handler));
+
+    // Blocks never exceed the backlog that DropOldest keeps
+    config = smallConfig(BackpressurePolicy::DropOldest);
+    config.blockMs = 1000;
+    CHECK_EQ(AnalysisWorker(config, handler).maxBatchFrames(), size_t(100));
+    config.policy = BackpressurePolicy::Coalesce;
+    CHECK_EQ(AnalysisWorker(config, handler).maxBatchFrames(), size_t(500));
+}
+
+void testCoalescedDetection() {
+    using namespace micmap::detection;
+    constexpr size_t CHANNELS = 2;
+    constexpr size_t TOTAL = 24000;  // 500 ms at 48 kHz
+
+    // A swelling tone per channel, so every frame has a different energy
+    std::vector<float> planes[CHANNELS];
+    for (size_t c = 0; c < CHANNELS; ++c) {
+        planes[c].resize(TOTAL);
+        for (size_t i = 0; i < TOTAL; ++i) {
+            float gain = 0.01f + 0.5f * static_cast<float>(i) / TOTAL;
+            planes[c][i] = gain * std::sin(0.05f * static_cast<float>(i * (c + 1)));
+        }
+    }
+
+    NoiseDetectorConfig detectorConfig;
+    detectorConfig.sampleRate = 48000;
+    detectorConfig.channels = CHANNELS;
+    auto detector = createFFTDetector(detectorConfig);
+    auto reference = createFFTDetector(detectorConfig);
+
+    // The reference sees the audio hop by hop and keeps its newest frame
+    DetectionResult newest{};
+    size_t frames = 0;
+    for (size_t offset = 0; offset < TOTAL; offset += detectorConfig.hopSize) {
+        const float* hop[CHANNELS] = {planes[0].data() + offset, planes[1].data() + offset};
+        size_t count = std::min(detectorConfig.hopSize, TOTAL - offset);
+        DetectionResult result;
+        if (reference->analyzeChannelsInto(hop, count, &result, 1) == 1) {
+            newest = result;
+            ++frames;
+        }
+    }
+
+    AnalysisWorkerConfig config;
+    config.streams = CHANNELS;
+    config.policy = BackpressurePolicy::Coalesce;
+    config.queueMs = 600;
+    std::vector<DetectionResult> results;
+    size_t produced = 0;
+    size_t calls = 0;
+    AnalysisWorker worker(config, [&](const float* const* streams, size_t count) {
+        produced = detector->analyzeChannelsInto(streams, count, results.data(), results.size());
+        ++calls;
+    });
+    results.resize(maxFramesPerCall(worker.maxBatchFrames(), detectorConfig.hopSize));
+
+    // Queued while stopped: the whole backlog arrives in one call
+    const float* pointers[CHANNELS] = {planes[0].data(), planes[1].data()};
+    CHECK_EQ(worker.push(pointers, TOTAL), TOTAL);
+    CHECK(worker.start());
+    CHECK(worker.waitIdle(5000));
+
+    CHECK_EQ(calls, size_t(1));
+    CHECK(frames > 16);
+    CHECK_EQ(produced, frames);
+    CHECK(produced > 0 && results[produced - 1].energy == newest.energy);
+    CHECK(produced > 0 && results[produced - 1].confidence == newest.confidence);
+    CHECK(results[0].energy != newest.energy);
+}
+
+} // anonymous namespace
+
+int main() {
+    micmap::common::Logger::getLogger()->setMinLevel(micmap::common::LogLevel::Warning);
+
+    testOrdering();
+    testDropOldest();
+    testCoalesce();
+    testRestart();
+    testConfig();
+    testCoalescedDetection();
+
+    return TEST_RESULT("Analysis worker tests");
+}
@@ -0,0 +1,176 @@
+/**
+ * @file test_audio_buffer.cpp
+ * @brief Functional and stress tests for AudioBuffer
+ *
+ * The stress test runs one producer and one consumer thread against the
+ * same buffer in both concurrency modes and verifies that every sample
+ * arrives exactly once and in order.
+ */
+
+#include "micmap/audio/audio_buffer.hpp"
+#include "test_common.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using micmap::audio::AudioBuffer;
+using micmap::audio::AudioBufferMode;
+
+namespace {
+
+// Sequence values stay below 2^24 so they are exactly representable as float
+constexpr uint32_t SEQUENCE_MODULO = 1u << 20;
+
+void testBasicOperations(AudioBufferMode mode) {
+    AudioBuffer buffer(100, mode);
+    CHECK_EQ(buffer.capacity(), size_t(100));
+    CHECK(buffer.empty());
+    CHECK(!buffer.full());
+    CHECK_EQ(buffer.space(), size_t(100));
+
+    std::vector<float> input(60);
+    for (size_t i = 0; i < input.size(); ++i) {
+        input[i] = static_cast<float>(i);
+    }
+
+    CHECK_EQ(buffer.write(input.data(), input.size()), size_t(60));
+    CHECK_EQ(buffer.available(), size_t(60));
+
+    std::vector<float> output(60, -1.0f);
+    CHECK_EQ(buffer.peek(output.data(), 10), size_t(10));
+    CHECK_EQ(output[9], 9.0f);
+    CHECK_EQ(buffer.available(), size_t(60));
+
+    CHECK_EQ(buffer.read(output.data(), 50), size_t(50));
+    CHECK_EQ(output[49], 49.0f);
+    CHECK_EQ(buffer.available(), size_t(10));
+
+    // Wrap around the end of the storage
+    CHECK_EQ(buffer.write(input.data(), 60), size_t(60));
+    CHECK_EQ(buffer.available(), size_t(70));
+    CHECK_EQ(buffer.read(output.data(), 10), size_t(10));
+    CHECK_EQ(output[0], 50.0f);
+    CHECK_EQ(output[9], 59.0f);
+    CHECK_EQ(buffer.read(output.data(), 60), size_t(60));
+    for (size_t i = 0; i < 60; ++i) {
+        CHECK_EQ(output[i], static_cast<float>(i));
+    }
+    CHECK(buffer.empty());
+    CHECK_EQ(buffer.overflowCount(), uint64_t(0));
+    CHECK_EQ(buffer.underflowCount(), uint64_t(0));
+
+    // Overflow: only the requested capacity is usable, not the rounded storage
+    CHECK_EQ(buffer.write(input.data(), 60), size_t(60));
+    CHECK_EQ(buffer.write(input.data(), 60), size_t(40));
+    CHECK(buffer.full());
+    CHECK_EQ(buffer.overflowCount(), uint64_t(20));
+
+    // Underflow
+    std::vector<float> large(150);
+    CHECK_EQ(buffer.read(large.data(), large.size()), size_t(100));
+    CHECK_EQ(buffer.underflowCount(), uint64_t(50));
+
+    buffer.resetCounters();
+    CHECK_EQ(buffer.overflowCount(), uint64_t(0));
+    CHECK_EQ(buffer.underflowCount(), uint64_t(0));
+
+    // Discard drops the oldest samples
+    buffer.write(input.data(), 30);
+    CHECK_EQ(buffer.discard(10), size_t(10));
+    CHECK_EQ(buffer.read(output.data(), 1), size_t(1));
+    CHECK_EQ(output[0], 10.0f);
+    CHECK_EQ(buffer.discard(100), size_t(19));
+    CHECK(buffer.empty());
+
+    buffer.write(input.data(), 30);
+    buffer.clear();
+    CHECK(buffer.empty());
+    CHECK_EQ(buffer.read(output.data(), 1), size_t(0));
+}
+
+void testMove() {
+    AudioBuffer source(16, AudioBufferMode::SingleProducer);
+    float values[4] = {1.0f, 2.0f, 3.0f, 4.0f};
+    source.write(values, 4);
+
+    AudioBuffer moved(std::move(source));
+    CHECK_EQ(moved.available(), size_t(4));
+    CHECK(moved.mode() == AudioBufferMode::SingleProducer);
+
+    float out[4] = {};
+    CHECK_EQ(moved.read(out, 4), size_t(4));
+    CHECK_EQ(out[3], 4.0f);
+}
+
+void testStress(AudioBufferMode mode) {
+    constexpr size_t TOTAL_SAMPLES = 4'000'000;
+    AudioBuffer buffer(1024, mode);
+
+    std::atomic<bool> orderError{false};
+
+    std::thread producer([&]() {
+        std::vector<float> chunk(480);
+        uint32_t sequence = 0;
+        size_t produced = 0;
+        size_t chunkSize = 1;
+        while (produced < TOTAL_SAMPLES) {
+            // Vary the chunk size to exercise every wrap-around position
+            chunkSize = (chunkSize * 7 + 3) % chunk.size() + 1;
+            size_t count = std::min(chunkSize, TOTAL_SAMPLES - produced);
+            for (size_t i = 0; i < count; ++i) {
+                chunk[i] = static_cast<float>((sequence + i) % SEQUENCE_MODULO);
+            }
+
+            size_t offset = 0;
+            while (offset < count) {
+                size_t written = buffer.write(chunk.data() + offset, count - offset);
+                offset += written;
+                if (written == 0) {
+                    std::this_thread::yield();
+                }
+            }
+            sequence = static_cast<uint32_t>((sequence + count) % SEQUENCE_MODULO);
+            produced += count;
+        }
+    });
+
+    std::thread consumer([&]() {
+        std::vector<float> chunk(333);
+        uint32_t expected = 0;
+        size_t consumed = 0;
+        while (consumed < TOTAL_SAMPLES) {
+            size_t count = buffer.read(chunk.data(), chunk.size());
+            if (count == 0) {
+                std::this_thread::yield();
+                continue;
+            }
+            for (size_t i = 0; i < count; ++i) {
+                if (chunk[i] != static_cast<float>(expected)) {
+                    orderError = true;
+                }
+                expected = (expected + 1) % SEQUENCE_MODULO;
+            }
+            consumed += count;
+        }
+    });
+
+    producer.join();
+    consumer.join();
+
+    CHECK(!orderError.load());
+    CHECK(buffer.empty());
+}
+
+} // anonymous namespace
+
+int main() {
+    testBasicOperations(AudioBufferMode::Locked);
+    testBasicOperations(AudioBufferMode::SingleProducer);
+    testMove();
+    testStress(AudioBufferMode::Locked);
+    testStress(AudioBufferMode::SingleProducer);
+
+    return TEST_RESULT("AudioBuffer tests");
+}
@@ -0,0 +1,320 @@
+/**
+ * @file test_channel_coherence.cpp
+ * @brief Tests for multi-channel analysis and the inter-channel coherence cue
+ *
+ * Compares the shared-plan channel spectra with the FFT analyzer, checks the
+ * coherence of identical and independent channels, and runs a two-mic
+ * detector over a gentle cover that the mono mix misses.
+ */
+
+#include "micmap/detection/multichannel_analyzer.hpp"
+#include "micmap/detection/noise_detector.hpp"
+#include "micmap/common/logger.hpp"
+#include "test_common.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace micmap::detection;
+using micmap::common::SimdLevel;
+
+namespace {
+
+constexpr uint32_t SAMPLE_RATE = 48000;
+constexpr size_t FFT_SIZE = 2048;
+
+std::vector<float> whiteNoise(size_t count, float amplitude, std::mt19937& rng) {
+    std::uniform_real_distribution<float> noise(-1.0f, 1.0f);
+    std::vector<float> samples(count);
+    for (float& s : samples) {
+        s = amplitude * noise(rng);
+    }
+    return samples;
+}
+
+void testMatchesSpectralAnalyzer() {
+    std::mt19937 rng(5);
+    const size_t channels = 3;
+    std::vector<std::vector<float>> frames;
+    for (size_t c = 0; c < channels; ++c) {
+        frames.push_back(whiteNoise(FFT_SIZE, 0.1f * static_cast<float>(c + 1), rng));
+    }
+    const float* pointers[channels] = {frames[0].data(), frames[1].data(), frames[2].data()};
+
+    for (SimdLevel level : {SimdLevel::Scalar, getSpectralFeatureSimdLevel()}) {
+        MultiChannelAnalyzer analyzer(SAMPLE_RATE, FFT_SIZE, channels, CoherenceConfig{},
+                                      FFTBackendType::Auto, level);
+        CHECK_EQ(analyzer.getChannels(), channels);
+        CHECK_EQ(analyzer.getNumBins(), FFT_SIZE / 2 + 1);
+        // 100 Hz to 2 kHz at 23.4 Hz per bin
+        CHECK_EQ(analyzer.getCoherenceBins(), size_t(81));
+
+        std::vector<float> magnitudes(channels * analyzer.getNumBins());
+        SpectralFeatures features[channels];
+        analyzer.analyzeInto(pointers, magnitudes.data(), features);
+
+        auto reference = createSpectralAnalyzer(SAMPLE_RATE, FFT_SIZE, FFTBackendType::Auto, level);
+        std::vector<float> expected(reference->getNumBins());
+        for (size_t c = 0; c < channels; ++c) {
+            SpectralFeatures single = reference->analyzeInto(frames[c].data(), FFT_SIZE,
+                                                             expected.data(), expected.size());
+            const float* actual = magnitudes.data() + c * analyzer.getNumBins();
+            for (size_t i = 0; i < expected.size(); ++i) {
+                CHECK_NEAR(actual[i], expected[i], 1e-6);
+            }
+            CHECK_NEAR(features[c].energy, single.energy, 1e-6);
+            CHECK_NEAR(features[c].spectralFlatness, single.spectralFlatness, 1e-5);
+            CHECK_NEAR(features[c].spectralCentroid, single.spectralCentroid, 1e-2);
+        }
+    }
+}
+
+void testCoherence() {
+    std::mt19937 rng(6);
+    MultiChannelAnalyzer analyzer(SAMPLE_RATE, FFT_SIZE, 2);
+
+    // The same signal on both channels, with a gain, is fully coherent
+    for (int frame = 0; frame < 5; ++frame) {
+        auto room = whiteNoise(FFT_SIZE, 0.05f, rng);
+        std::vector<float> scaled(room);
+        for (float& s : scaled) {
+            s *= 0.3f;
+        }
+        const float* pointers[2] = {room.data(), scaled.data()};
+        CHECK_NEAR(analyzer.analyzeInto(pointers, nullptr, nullptr), 1.0, 1e-3);
+    }
+    CHECK_NEAR(analyzer.getCoherence(), 1.0, 1e-3);
+
+    // Independent channels decorrelate within a few frames
+    analyzer.reset();
+    float coherence = 1.0f;
+    for (int frame = 0; frame < 20; ++frame) {
+        auto first = whiteNoise(FFT_SIZE, 0.05f, rng);
+        auto second = whiteNoise(FFT_SIZE, 0.05f, rng);
+        const float* pointers[2] = {first.data(), second.data()};
+        coherence = analyzer.analyzeInto(pointers, nullptr, nullptr);
+    }
+    CHECK(coherence < 0.3f);
+
+    // A single channel has nothing to compare with
+    MultiChannelAnalyzer mono(SAMPLE_RATE, FFT_SIZE, 1);
+    CHECK_EQ(mono.getCoherenceBins(), size_t(81));
+    auto samples = whiteNoise(FFT_SIZE, 0.05f, rng);
+    const float* pointer = samples.data();
+    CHECK_EQ(mono.analyzeInto(&pointer, nullptr, nullptr), 1.0f);
+
+    auto throws = [](uint32_t sampleRate, size_t channels, CoherenceConfig config) {
+        try {
+            MultiChannelAnalyzer analyzer(sampleRate, FFT_SIZE, channels, config);
+            return false;
+        } catch (const std::invalid_argument&) {
+            return true;
+        }
+    };
+    CHECK(!throws(SAMPLE_RATE, 2, CoherenceConfig{}));
+    CHECK(throws(SAMPLE_RATE, 0, CoherenceConfig{}));
+    CHECK(throws(0, 2, CoherenceConfig{}));
+    CHECK(throws(SAMPLE_RATE, 2, CoherenceConfig{100.0f, 2000.0f, 1.0f}));
+    CHECK(throws(SAMPLE_RATE, 2, CoherenceConfig{100.0f, 2000.0f, -0.1f}));
+    CHECK(throws(SAMPLE_RATE, 2, CoherenceConfig{2000.0f, 100.0f, 0.7f}));
+    CHECK(throws(SAMPLE_RATE, 2, CoherenceConfig{30000.0f, 40000.0f, 0.7f}));
+}
+
+/**
+ * @brief Noise of a hand over a mic, at the level the profile is trained on
+ */
+std::vector<float> coverNoise(size_t count, std::mt19937& rng) {
+    std::uniform_real_distribution<float> noise(-1.0f, 1.0f);
+    std::vector<float> samples(count);
+    float state = 0.0f;
+    for (float& s : samples) {
+        state = 0.7f * state + 0.3f * noise(rng);
+        s = 0.4f * state;
+    }
+    return samples;
+}
+
+/**
+ * @brief Two mics in a quiet room
+ *
+ * One second of room sound, a two-second gentle cover of mic 0 (no touch
+ * spike; mic 1 keeps hearing the room), one second of room, two seconds of
+ * a loud cover-like noise in the room that both mics hear, then one more
+ * second of room. Both mics add a little self noise.
+ */
+struct Fixture {
+    std::vector<float> mics[2];
+
+    size_t size() const { return mics[0].size(); }
+};
+
+Fixture makeFixture() {
+    std::mt19937 rng(21);
+    Fixture fixture;
+    auto append = [&](const std::vector<float>& first, const std::vector<float>& second) {
+        auto selfNoise = whiteNoise(first.size() * 2, 0.0003f, rng);
+        for (size_t i = 0; i < first.size(); ++i) {
+            fixture.mics[0].push_back(first[i] + selfNoise[2 * i]);
+            fixture.mics[1].push_back(second[i] + selfNoise[2 * i + 1]);
+        }
+    };
+    auto room = [&](size_t count) {
+        auto sound = whiteNoise(count, 0.003f, rng);
+        append(sound, sound);
+    };
+
+    room(SAMPLE_RATE);
+    append(coverNoise(SAMPLE_RATE * 2, rng), whiteNoise(SAMPLE_RATE * 2, 0.003f, rng));
+    room(SAMPLE_RATE);
+    auto loud = coverNoise(SAMPLE_RATE * 2, rng);
+    append(loud, loud);
+    room(SAMPLE_RATE);
+    return fixture;
+}
+
+/**
+ * @brief Train on a covered mic 0 while mic 1 hears the room
+ */
+void train(INoiseDetector& detector, bool downmix) {
+    std::mt19937 rng(22);
+    auto covered = coverNoise(SAMPLE_RATE * 2, rng);
+    auto room = whiteNoise(covered.size(), 0.003f, rng);
+
+    detector.startTraining();
+    if (downmix) {
+        std::vector<float> mono(covered.size());
+        for (size_t i = 0; i < mono.size(); ++i) {
+            mono[i] = 0.5f * (covered[i] + room[i]);
+        }
+        detector.addTrainingSample(mono.data(), mono.size());
+    } else {
+        const float* channels[2] = {covered.data(), room.data()};
+        detector.addTrainingChannels(channels, covered.size());
+    }
+    CHECK(detector.finishTraining());
+}
+
+struct Replay {
+    size_t coverDetected = 0;
+    size_t otherDetected = 0;
+    float coverCoherence = 0.0f;
+    float loudCoherence = 0.0f;
+};
+
+/**
+ * @brief Replay the fixture in 10 ms packets, as two channels or as their mix
+ */
+Replay replay(INoiseDetector& detector, const Fixture& fixture, size_t hopSize, bool downmix) {
+    Replay replay;
+    size_t coverFrames = 0;
+    size_t loudFrames = 0;
+    std::vector<float> mono(480);
+    DetectionResult results[4];
+    size_t frame = 0;
+    for (size_t offset = 0; offset + 480 <= fixture.size(); offset += 480) {
+        const float* channels[2] = {fixture.mics[0].data() + offset, fixture.mics[1].data() + offset};
+        size_t n = 0;
+        if (downmix) {
+            for (size_t i = 0; i < mono.size(); ++i) {
+                mono[i] = 0.5f * (channels[0][i] + channels[1][i]);
+            }
+            n = detector.analyzeInto(mono.data(), mono.size(), results, 4);
+        } else {
+            n = detector.analyzeChannelsInto(channels, 480, results, 4);
+        }
+        for (size_t i = 0; i < n; ++i, ++frame) {
+            double t = static_cast<double>((frame + 1) * hopSize) / SAMPLE_RATE;
+            bool cover = t >= 1.0 && t < 3.2;
+            if (t >= 1.2 && t < 3.0) {
+                replay.coverCoherence += results[i].coherence;
+                ++coverFrames;
+            } else if (t >= 4.2 && t < 6.0) {
+                replay.loudCoherence += results[i].coherence;
+                ++loudFrames;
+            }
+            if (results[i].isWhiteNoise) {
+                ++(cover ? replay.coverDetected : replay.otherDetected);
+            }
+        }
+    }
+    replay.coverCoherence /= static_cast<float>(std::max<size_t>(coverFrames, 1));
+    replay.loudCoherence /= static_cast<float>(std::max<size_t>(loudFrames, 1));
+    return replay;
+}
+
+void testDetector() {
+    auto fixture = makeFixture();
+
+    NoiseDetectorConfig config;
+    config.sampleRate = SAMPLE_RATE;
+    config.channels = 2;
+    auto stereo = createFFTDetector(config);
+    train(*stereo, false);
+    Replay channels = replay(*stereo, fixture, config.hopSize, false);
+
+    // The covered mic stops hearing the room, so the pair decorrelates and
+    // arms the gate without a touch spike; a loud sound both mics hear
+    // stays coherent and does not
+    CHECK(channels.coverCoherence < 0.3f);
+    CHECK(channels.loudCoherence > 0.9f);
+    CHECK(channels.coverDetected > 20);
+    CHECK_EQ(channels.otherDetected, size_t(0));
+
+    // The mono mix, trained on the mix, has no touch spike to arm on
+    config.channels = 1;
+    auto mono = createFFTDetector(config);
+    train(*mono, true);
+    Replay mixed = replay(*mono, fixture, config.hopSize, true);
+    CHECK_EQ(mixed.coverDetected, size_t(0));
+    CHECK_EQ(mixed.otherDetected, size_t(0));
+    CHECK_EQ(mixed.coverCoherence, 1.0f);
+
+    // One configured channel analyzes channels[0] like analyzeInto()
+    auto single = createFFTDetector(config);
+    auto reference = createFFTDetector(config);
+    train(*single, true);
+    train(*reference, true);
+    const float* first = fixture.mics[0].data() + SAMPLE_RATE;
+    DetectionResult fromChannels[4];
+    DetectionResult fromMono[4];
+    CHECK_EQ(single->analyzeChannelsInto(&first, 4096, fromChannels, 4), size_t(4));
+    CHECK_EQ(reference->analyzeInto(first, 4096, fromMono, 4), size_t(4));
+    CHECK_EQ(fromChannels[3].confidence, fromMono[3].confidence);
+    CHECK_EQ(fromChannels[3].energy, fromMono[3].energy);
+
+    auto throws = [](NoiseDetectorConfig config) {
+        try {
+            createFFTDetector(config);
+            return false;
+        } catch (const std::invalid_argument&) {
+            return true;
+        }
+    };
+    config.channels = 2;
+    CHECK(!throws(config));
+    config.channels = 0;
+    CHECK(throws(config));
+    config.channels = NoiseDetectorConfig::MAX_CHANNELS + 1;
+    CHECK(throws(config));
+    config.channels = 2;
+    config.cascade.enabled = true;
+    CHECK(throws(config));
+    config.cascade.enabled = false;
+    config.monitor.enabled = true;
+    CHECK(throws(config));
+}
+
+} // anonymous namespace
+
+int main() {
+    micmap::common::Logger::getLogger()->setMinLevel(micmap::common::LogLevel::Warning);
+
+    testMatchesSpectralAnalyzer();
+    testCoherence();
+    testDetector();
+
+    return TEST_RESULT("Channel coherence tests");
+}
@@ -0,0 +1,244 @@
+/**
+ * @file test_command_channel.cpp
+ * @brief Tests for the binary command records and their datagram channel
+ *
+ * Round-trips records through the wire format, then runs a command server
+ * and client over loopback to check acknowledgements, retransmissions of
+ * an already handled command, acks that come too late and a missing
+ * server.
+ */
+
+#include "micmap/common/command_channel.hpp"
+#include "micmap/common/logger.hpp"
+#include "test_common.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace micmap::common;
+
+namespace {
+
+void testEncoding() {
+    CommandRecord record;
+    record.type = CommandType::Ack;
+    record.action = CommandAction::Click;
+    record.button = CommandButton::Trigger;
+    record.status = CommandStatus::NotActive;
+    record.sequence = 0x01020304;
+    record.durationMs = 100;
+    record.sentUs = 0x1122334455667788ull;
+    record.handledUs = 42;
+
+    uint8_t wire[COMMAND_RECORD_SIZE];
+    encodeCommandRecord(record, wire);
+    CHECK_EQ(wire[0], uint8_t('M'));
+    CHECK_EQ(wire[3], uint8_t('1'));
+    CHECK_EQ(wire[8], uint8_t(0x04));   // Little-endian
+    CHECK_EQ(wire[16], uint8_t(0x88));
+
+    CommandRecord decoded;
+    CHECK(decodeCommandRecord(wire, sizeof(wire), decoded));
+    CHECK(decoded.type == CommandType::Ack);
+    CHECK(decoded.action == CommandAction::Click);
+    CHECK(decoded.button == CommandButton::Trigger);
+    CHECK(decoded.status == CommandStatus::NotActive);
+    CHECK_EQ(decoded.sequence, uint32_t(0x01020304));
+    CHECK_EQ(decoded.durationMs, uint16_t(100));
+    CHECK_EQ(decoded.sentUs, uint64_t(0x1122334455667788ull));
+    CHECK_EQ(decoded.handledUs, uint64_t(42));
+
+    // Wrong size, magic, version or type
+    CHECK(!decodeCommandRecord(wire, sizeof(wire) - 1, decoded));
+    uint8_t bad[COMMAND_RECORD_SIZE];
+    std::copy(wire, wire + sizeof(wire), bad);
+    bad[0] = 'X';
+    CHECK(!decodeCommandRecord(bad, sizeof(bad), decoded));
+    std::copy(wire, wire + sizeof(wire), bad);
+    bad[4] = COMMAND_VERSION + 1;
+    CHECK(!decodeCommandRecord(bad, sizeof(bad), decoded));
+    std::copy(wire, wire + sizeof(wire), bad);
+    bad[5] = 7;
+    CHECK(!decodeCommandRecord(bad, sizeof(bad), decoded));
+
+    CommandButton button = CommandButton::System;
+    CHECK(parseCommandButton("trigger", button));
+    CHECK(button == CommandButton::Trigger);
+    CHECK(!parseCommandButton("grip", button));
+    CHECK(button == CommandButton::Trigger);
+    CHECK_EQ(std::string(commandButtonToString(CommandButton::A)), std::string("a"));
+}
+
+void testRoundTrip() {
+    std::mutex mutex;
+    std::vector<CommandRecord> handled;
+    CommandServer server([&](const CommandRecord& command) {
+        std::lock_guard<std::mutex> lock(mutex);
+        handled.push_back(command);
+        return command.button == CommandButton::A ? CommandStatus::NotActive : CommandStatus::Ok;
+    });
+    CHECK(server.start("127.0.0.1", 0));
+    CHECK(server.isRunning());
+    CHECK(server.getPort() > 0);
+    CHECK(!server.start("127.0.0.1", 0));
+
+    CommandClient client;
+    CHECK(client.open("127.0.0.1", server.getPort()));
+    CHECK(client.isOpen());
+
+    CommandRecord ack;
+    CHECK(client.send(CommandAction::Ping, CommandButton::System, 0, ack));
+    CHECK(ack.type == CommandType::Ack);
+    CHECK(ack.status == CommandStatus::Ok);
+
+    uint64_t before = commandTimestampUs();
+    CHECK(client.send(CommandAction::Click, CommandButton::Trigger, 100, ack));
+    CHECK(ack.status == CommandStatus::Ok);
+    CHECK(ack.action == CommandAction::Click);
+    CHECK(ack.sentUs >= before);
+    CHECK(ack.handledUs >= ack.sentUs);
+    uint32_t clickSequence = ack.sequence;
+
+    // The driver's answer is reported, not treated as a lost command
+    CHECK(client.send(CommandAction::Press, CommandButton::A, 0, ack));
+    CHECK(ack.status == CommandStatus::NotActive);
+    CHECK(ack.sequence == clickSequence + 1);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        CHECK_EQ(handled.size(), size_t(2));  // Pings are not passed on
+        CHECK(handled[0].action == CommandAction::Click);
+        CHECK(handled[0].button == CommandButton::Trigger);
+        CHECK_EQ(handled[0].durationMs, uint16_t(100));
+        CHECK(handled[1].action == CommandAction::Press);
+    }
+
+    CommandServerStats stats = server.getStats();
+    CHECK_EQ(stats.received, uint64_t(3));
+    CHECK_EQ(stats.handled, uint64_t(2));
+    CHECK_EQ(stats.duplicates, uint64_t(0));
+
+    server.stop();
+    CHECK(!server.isRunning());
+    CHECK_EQ(server.getPort(), 0);
+}
+
+void testRetransmission() {
+    // A handler slower than the ack timeout makes the client send again
+    std::atomic<int> handled{0};
+    CommandServer server([&](const CommandRecord&) {
+        ++handled;
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        return CommandStatus::Ok;
+    });
+    CHECK(server.start("127.0.0.1", 0));
+
+    CommandClientConfig config;
+    config.ackTimeoutMs = 10;
+    config.attempts = 5;
+    CommandClient client(config);
+    CHECK(client.open("127.0.0.1", server.getPort()));
+
+    CommandRecord ack;
+    CHECK(client.send(CommandAction::Click, CommandButton::System, 50, ack));
+    CHECK(ack.status == CommandStatus::Ok);
+
+    // The next command skips any late duplicate acks still queued
+    CHECK(client.send(CommandAction::Release, CommandButton::System, 0, ack));
+    CHECK(ack.action == CommandAction::Release);
+
+    CHECK_EQ(handled.load(), 2);
+    CHECK(server.getStats().duplicates > 0);
+}
+
+void testLateAck() {
+    // A busy driver: the command is performed, but after every attempt
+    // has timed out
+    std::atomic<int> handled{0};
+    CommandServer server([&](const CommandRecord& command) {
+        ++handled;
+        if (command.action == CommandAction::Click) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        return CommandStatus::Ok;
+    });
+    CHECK(server.start("127.0.0.1", 0));
+
+    CommandClientConfig config;
+    config.ackTimeoutMs = 10;
+    config.attempts = 3;
+    CommandClient client(config);
+    CHECK(client.open("127.0.0.1", server.getPort()));
+
+    CommandRecord ack;
+    CHECK(!client.send(CommandAction::Click, CommandButton::System, 100, ack));
+    // Not safe to send again another way: the server has it
+    CHECK(client.mayHaveBeenHandled());
+
+    // Once the server catches up, the retransmissions are only re-acked
+    // and their late acks do not answer the next command
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    CHECK_EQ(handled.load(), 1);
+    CHECK_EQ(server.getStats().duplicates, uint64_t(2));
+
+    CHECK(client.send(CommandAction::Release, CommandButton::System, 0, ack));
+    CHECK(ack.action == CommandAction::Release);
+    CHECK_EQ(handled.load(), 2);
+}
+
+void testNoServer() {
+    // Bind and release a port so nothing listens on it
+    int port = 0;
+    {
+        CommandServer probe([](const CommandRecord&) { return CommandStatus::Ok; });
+        CHECK(probe.start("127.0.0.1", 0));
+        port = probe.getPort();
+    }
+
+    CommandClientConfig config;
+    config.ackTimeoutMs = 20;
+    config.attempts = 2;
+    CommandClient client(config);
+    CommandRecord ack;
+    CHECK(!client.send(CommandAction::Ping, CommandButton::System, 0, ack));
+    CHECK(!client.getLastError().empty());
+    CHECK(!client.mayHaveBeenHandled());
+
+    CHECK(client.open("127.0.0.1", port));
+    auto start = std::chrono::steady_clock::now();
+    CHECK(!client.send(CommandAction::Click, CommandButton::System, 100, ack));
+    CHECK(std::chrono::steady_clock::now() - start < std::chrono::seconds(1));
+    CHECK(!client.getLastError().empty());
+    // Refused: nothing handled it, so another route may send it
+    CHECK(!client.mayHaveBeenHandled());
+
+    client.close();
+    CHECK(!client.isOpen());
+
+    bool threw = false;
+    try {
+        CommandServer server(nullptr);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+} // anonymous namespace
+
+int main() {
+    micmap::common::Logger::getLogger()->setMinLevel(micmap::common::LogLevel::Warning);
+
+    testEncoding();
+    testRoundTrip();
+    testRetransmission();
+    testLateAck();
+    testNoServer();
+
+    return TEST_RESULT("Command channel tests");
+}
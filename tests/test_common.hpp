@@ -0,0 +1,68 @@
+#pragma once
+
+/**
+ * @file test_common.hpp
+ * @brief Minimal assertion helpers shared by the unit tests
+ *
+ * Each test is a plain executable whose exit code is the number of failed
+ * checks, so ctest reports a failure whenever any CHECK does not hold.
+ */
+
+#include <cmath>
+#include <iostream>
+
+namespace micmap::test {
+
+/**
+ * @brief Number of failed checks in the current test executable
+ */
+inline int& failureCount() {
+    static int count = 0;
+    return count;
+}
+
+} // namespace micmap::test
+
+#define CHECK(condition)                                                        \
+    do {                                                                        \
+        if (!(condition)) {                                                     \
+            std::cerr << __FILE__ << ":" << __LINE__                            \
+                      << ": CHECK failed: " #condition "\n";                    \
+            ++micmap::test::failureCount();                                     \
+        }                                                                       \
+    } while (0)
+
+#define CHECK_EQ(actual, expected)                                              \
+    do {                                                                        \
+        const auto& checkActual_ = (actual);                                    \
+        const auto& checkExpected_ = (expected);                                \
+        if (!(checkActual_ == checkExpected_)) {                                \
+            std::cerr << __FILE__ << ":" << __LINE__                            \
+                      << ": CHECK_EQ failed: " #actual " == " #expected         \
+                      << " (" << checkActual_ << " vs " << checkExpected_       \
+                      << ")\n";                                                 \
+            ++micmap::test::failureCount();                                     \
+        }                                                                       \
+    } while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance)                                 \
+    do {                                                                        \
+        const double checkActual_ = static_cast<double>(actual);                \
+        const double checkExpected_ = static_cast<double>(expected);            \
+        if (!(std::fabs(checkActual_ - checkExpected_) <= (tolerance))) {       \
+            std::cerr << __FILE__ << ":" << __LINE__                            \
+                      << ": CHECK_NEAR failed: " #actual " ~ " #expected        \
+                      << " (" << checkActual_ << " vs " << checkExpected_       \
+                      << ")\n";                                                 \
+            ++micmap::test::failureCount();                                     \
+        }                                                                       \
+    } while (0)
+
+/**
+ * @brief Print a summary and return the process exit code
+ */
+#define TEST_RESULT(name)                                                       \
+    (micmap::test::failureCount() == 0                                          \
+        ? (std::cout << name << " - PASSED\n", 0)                               \
+        : (std::cout << name << " - FAILED (" << micmap::test::failureCount()   \
+                     << " checks)\n", 1))
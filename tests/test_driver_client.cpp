@@ -0,0 +1,267 @@
+/**
+ * @file test_driver_client.cpp
+ * @brief Tests for the driver client's persistent connection
+ *
+ * Runs the driver's HTTP routes on a loopback port and checks health pings
+ * on an idle connection, round-trip statistics, fast failure while the
+ * driver is away, reconnect backoff, and reconnecting to the last port
+ * once the driver is back. A busy command channel checks that a click
+ * without an acknowledgement is not repeated by the trigger dispatcher.
+ */
+
+#include "micmap/steamvr/vr_input.hpp"
+#include "micmap/core/trigger_dispatcher.hpp"
+#include "micmap/common/command_channel.hpp"
+#include "micmap/common/logger.hpp"
+#include "test_common.hpp"
+
+#include <httplib.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace micmap::steamvr;
+using namespace std::chrono_literals;
+
+namespace {
+
+/**
+ * @brief The driver's /health and /click routes, counting requests
+ */
+class FakeDriver {
+public:
+    ~FakeDriver() {
+        stop();
+    }
+
+    /**
+     * @param port Port to listen on (0 = any free port, see getPort())
+     */
+    bool start(int port) {
+        server_ = std::make_unique<httplib::Server>();
+        server_->Get("/health", [this](const httplib::Request&, httplib::Response& res) {
+            ++health;
+            res.set_content("OK", "text/plain");
+        });
+        server_->Post("/click", [this](const httplib::Request&, httplib::Response& res) {
+            ++clicks;
+            res.set_content("{\"success\":true}", "application/json");
+        });
+        if (port == 0) {
+            port_ = server_->bind_to_any_port("127.0.0.1");
+        } else {
+            port_ = server_->bind_to_port("127.0.0.1", port) ? port : -1;
+        }
+        if (port_ <= 0) {
+            server_.reset();
+            return false;
+        }
+        thread_ = std::thread([this] { server_->listen_after_bind(); });
+        server_->wait_until_ready();
+        return true;
+    }
+
+    void stop() {
+        if (server_) {
+            server_->stop();
+            thread_.join();
+            server_.reset();
+        }
+    }
+
+    int getPort() const { return port_; }
+
+    std::atomic<int> health{0};
+    std::atomic<int> clicks{0};
+
+private:
+    std::unique_ptr<httplib::Server> server_;
+    std::thread thread_;
+    int port_ = 0;
+};
+
+DriverClientConfig clientConfig(int port) {
+    DriverClientConfig config;
+    // Only the driver's port is scanned, so finding it again after a
+    // restart can only come from trying the last known port first
+    config.startPort = port;
+    config.endPort = port;
+    config.requestTimeoutMs = 200;
+    config.healthIntervalMs = 100;
+    config.reconnectMinMs = 50;
+    config.reconnectMaxMs = 200;
+    config.useCommandChannel = false;
+    return config;
+}
+
+void testHealthPings() {
+    FakeDriver driver;
+    CHECK(driver.start(0));
+    auto client = createDriverClient(clientConfig(driver.getPort()));
+    CHECK(client->connect());
+    CHECK(client->isConnected());
+    CHECK_EQ(client->getPort(), driver.getPort());
+
+    DriverClientStats stats = client->getStats();
+    CHECK_EQ(stats.portScans, uint64_t(1));
+    CHECK_EQ(stats.reconnects, uint64_t(0));
+
+    // An idle connection is pinged every interval
+    int before = driver.health.load();
+    std::this_thread::sleep_for(350ms);
+    CHECK(driver.health.load() - before >= 2);
+
+    // Button traffic proves the connection, so no pings are needed
+    before = driver.health.load();
+    for (int i = 0; i < 15; ++i) {
+        CHECK(client->click("system", 100));
+        std::this_thread::sleep_for(20ms);
+    }
+    CHECK(driver.health.load() - before <= 1);
+    CHECK_EQ(driver.clicks.load(), 15);
+
+    stats = client->getStats();
+    CHECK(stats.requests >= uint64_t(18));
+    CHECK_EQ(stats.failures, uint64_t(0));
+    CHECK(stats.lastRtt.count() > 0);
+    CHECK(stats.minRtt.count() > 0);
+    CHECK(stats.minRtt <= stats.smoothedRtt);
+    CHECK(stats.smoothedRtt <= stats.maxRtt);
+
+    client->disconnect();
+    CHECK(!client->isConnected());
+}
+
+void testReconnect() {
+    FakeDriver driver;
+    CHECK(driver.start(0));
+    int port = driver.getPort();
+    auto client = createDriverClient(clientConfig(port));
+    CHECK(client->connect());
+
+    // The first command finds the driver gone and hands the connection to
+    // the reconnect thread
+    driver.stop();
+    CHECK(!client->click("system", 100));
+    CHECK(!client->isConnected());
+    CHECK(client->getStats().failures >= uint64_t(1));
+
+    // Later commands fail at once instead of scanning ports themselves
+    auto start = std::chrono::steady_clock::now();
+    CHECK(!client->click("system", 100));
+    CHECK(std::chrono::steady_clock::now() - start < 50ms);
+    CHECK(client->getLastError().find("reconnecting") != std::string::npos);
+
+    // Attempts after 0, 50, 150, 350 and 550 ms with the delay doubling up
+    // to 200 ms; a fixed 50 ms delay would make twelve
+    std::this_thread::sleep_for(600ms);
+    uint64_t failedAttempts = client->getStats().portScans - 1;
+    CHECK(failedAttempts >= uint64_t(2));
+    CHECK(failedAttempts <= uint64_t(8));
+    CHECK(!client->isConnected());
+
+    CHECK(driver.start(port));
+    auto deadline = std::chrono::steady_clock::now() + 2s;
+    while (!client->isConnected() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(5ms);
+    }
+    CHECK(client->isConnected());
+    CHECK_EQ(client->getPort(), port);
+    CHECK_EQ(client->getStats().reconnects, uint64_t(1));
+
+    CHECK(client->click("system", 100));
+    CHECK_EQ(driver.clicks.load(), 1);
+    client->disconnect();
+}
+
+void testUnconfirmedClick() {
+    FakeDriver driver;
+    CHECK(driver.start(0));
+
+    // A busy driver: the first click is performed after every ack has
+    // timed out
+    std::atomic<int> handled{0};
+    micmap::common::CommandServer commands([&](const micmap::common::CommandRecord& command) {
+        if (command.action == micmap::common::CommandAction::Click && ++handled == 1) {
+            std::this_thread::sleep_for(100ms);
+        }
+        return micmap::common::CommandStatus::Ok;
+    });
+    CHECK(commands.start("127.0.0.1", driver.getPort()));
+
+    DriverClientConfig config = clientConfig(driver.getPort());
+    config.useCommandChannel = true;
+    config.commandAckTimeoutMs = 10;
+    config.commandAttempts = 3;
+    std::shared_ptr<IDriverClient> client = createDriverClient(config);
+    CHECK(client->connect());
+
+    // The driver route as the application builds it, and a fallback that
+    // would click a second time
+    std::atomic<int> fallback{0};
+    micmap::core::TriggerDispatcherConfig dispatcherConfig;
+    dispatcherConfig.coalesceWindow = 0ms;
+    auto dispatcher = micmap::core::createTriggerDispatcher(dispatcherConfig);
+    dispatcher->setRoutes({
+        {"driver", nullptr, [&] {
+            if (client->click("system", 100)) {
+                return micmap::core::RouteOutcome::Delivered;
+            }
+            return client->lastCommandMayHaveRun() ? micmap::core::RouteOutcome::Unconfirmed
+                                                   : micmap::core::RouteOutcome::NotAttempted;
+        }},
+        {"fallback", nullptr, [&] {
+            ++fallback;
+            return micmap::core::RouteOutcome::Delivered;
+        }}});
+    std::vector<micmap::core::TriggerResult> results;
+    std::mutex resultsMutex;
+    dispatcher->setResultCallback([&](const micmap::core::TriggerResult& result) {
+        std::lock_guard<std::mutex> lock(resultsMutex);
+        results.push_back(result);
+    });
+    CHECK(dispatcher->start());
+
+    CHECK(dispatcher->submit() != 0);
+    CHECK(dispatcher->waitIdle(5000ms));
+    CHECK_EQ(results.size(), size_t(1));
+    if (!results.empty()) {
+        CHECK(results[0].outcome == micmap::core::TriggerOutcome::Unconfirmed);
+        CHECK_EQ(results[0].route, std::string("driver"));
+    }
+    CHECK(client->lastCommandMayHaveRun());
+    CHECK_EQ(fallback.load(), 0);
+    CHECK_EQ(dispatcher->getStats().unconfirmed, uint64_t(1));
+    CHECK_EQ(client->getStats().commandFailures, uint64_t(1));
+
+    // The click was performed once, late, and never resent over HTTP
+    std::this_thread::sleep_for(200ms);
+    CHECK_EQ(handled.load(), 1);
+    CHECK_EQ(driver.clicks.load(), 0);
+
+    // The next click goes through and clears the state
+    CHECK(client->click("system", 100));
+    CHECK(!client->lastCommandMayHaveRun());
+    CHECK_EQ(handled.load() + driver.clicks.load(), 2);
+
+    dispatcher->stop();
+    client->disconnect();
+}
+
+} // anonymous namespace
+
+int main() {
+    // The lost connection and the failed clicks are logged on purpose
+    micmap::common::Logger::getLogger()->setMinLevel(micmap::common::LogLevel::Fatal);
+
+    testHealthPings();
+    testReconnect();
+    testUnconfirmedClick();
+
+    return TEST_RESULT("Driver client tests");
+}
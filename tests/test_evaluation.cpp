@@ -0,0 +1,263 @@
+/**
+ * @file test_evaluation.cpp
+ * @brief Tests for offline detection scoring, configurable thresholds and
+ *        the energy-gated analysis cascade
+ */
+
+#include "micmap/detection/evaluation.hpp"
+#include "micmap/detection/noise_detector.hpp"
+#include "micmap/common/logger.hpp"
+#include "test_common.hpp"
+#include "test_recordings.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+using namespace micmap::detection;
+using micmap::test::RecordingBuilder;
+using micmap::test::touchAndCover;
+using micmap::test::makeTrainedDetector;
+
+namespace {
+
+constexpr uint32_t SAMPLE_RATE = 48000;
+
+void testLabelFile() {
+    auto path = std::filesystem::temp_directory_path() / "micmap_test_labels.txt";
+    {
+        std::ofstream file(path);
+        file << "4.5\t6.0\tspeech\n";
+        file << "1.25\t3.5\tCovered (palm)\n";
+        file << "\\\t100.0\t2000.0\n";
+        file << "\n";
+    }
+
+    std::vector<LabelSegment> labels;
+    CHECK(loadLabelFile(path, labels));
+    CHECK_EQ(labels.size(), size_t(2));
+    if (labels.size() == 2) {
+        CHECK_NEAR(labels[0].startSec, 1.25, 1e-9);
+        CHECK_NEAR(labels[0].endSec, 3.5, 1e-9);
+        CHECK(labels[0].covered);
+        CHECK_EQ(labels[0].label, std::string("Covered (palm)"));
+        CHECK(!labels[1].covered);
+    }
+
+    {
+        std::ofstream file(path);
+        file << "2.0\t1.0\tcovered\n";
+    }
+    CHECK(!loadLabelFile(path, labels));
+    CHECK(!loadLabelFile(path.string() + ".missing", labels));
+    std::filesystem::remove(path);
+}
+
+void testPercentiles() {
+    CHECK_EQ(percentileOf({}, 50.0), 0.0);
+    CHECK_NEAR(percentileOf({3.0, 1.0, 2.0}, 50.0), 2.0, 1e-12);
+    CHECK_NEAR(percentileOf({1.0, 2.0, 3.0, 4.0}, 50.0), 2.5, 1e-12);
+    CHECK_NEAR(percentileOf({1.0, 2.0}, 100.0), 2.0, 1e-12);
+    CHECK_NEAR(percentileOf({1.0, 2.0}, 0.0), 1.0, 1e-12);
+}
+
+void testMetrics() {
+    EvaluationResult a;
+    a.durationSec = 3600.0;
+    a.coveredSec = 1800.0;
+    a.truePositiveFrames = 3;
+    a.falsePositiveFrames = 1;
+    a.falseNegativeFrames = 3;
+    a.coveredSegments = 2;
+    a.detectedSegments = 1;
+    a.triggers = 2;
+    a.falseTriggers = 1;
+    a.latenciesMs = {250.0};
+
+    CHECK_NEAR(a.framePrecision(), 0.75, 1e-12);
+    CHECK_NEAR(a.frameRecall(), 0.5, 1e-12);
+    CHECK_NEAR(a.eventPrecision(), 0.5, 1e-12);
+    CHECK_NEAR(a.eventRecall(), 0.5, 1e-12);
+    CHECK_NEAR(a.falseTriggersPerHour(), 2.0, 1e-12);
+
+    EvaluationResult total;
+    CHECK_EQ(total.eventPrecision(), 1.0);
+    total.merge(a);
+    total.merge(a);
+    CHECK_EQ(total.triggers, size_t(4));
+    CHECK_EQ(total.latenciesMs.size(), size_t(2));
+    CHECK_NEAR(total.falseTriggersPerHour(), 2.0, 1e-12);
+}
+
+/**
+ * @brief Quiet room, touch spike and covered mic (1.0 s - 3.1 s), quiet,
+ *        noisy tone (4.1 s - 5.1 s), quiet
+ *
+ * The tone arrives long after the spike window in audio time, so it must
+ * not trigger no matter how fast the recording is replayed.
+ */
+std::vector<float> makeRecording(uint32_t seed) {
+    return touchAndCover(seed).tone(1.0, 0.1f).quiet(1.0).take();
+}
+
+void testEvaluateRecording() {
+    NoiseDetectorConfig config;
+    config.sampleRate = SAMPLE_RATE;
+    auto recording = makeRecording(12);
+    std::vector<LabelSegment> labels = {
+        {1.0, 3.1, "covered", true},
+        {3.1, 4.1, "quiet", false},
+        {4.1, 5.1, "music", false},
+        {5.1, 6.1, "quiet", false},
+    };
+
+    auto detector = makeTrainedDetector(config);
+    EvaluationResult result = evaluateRecording(*detector, config.hopSize, recording.data(),
+                                                recording.size(), SAMPLE_RATE, labels);
+
+    CHECK_NEAR(result.durationSec, static_cast<double>(recording.size()) / SAMPLE_RATE, 1e-9);
+    CHECK_NEAR(result.coveredSec, 2.1, 1e-3);
+    CHECK_EQ(result.frames, recording.size() / config.hopSize);
+    CHECK_EQ(result.coveredSegments, size_t(1));
+    CHECK_EQ(result.detectedSegments, size_t(1));
+    CHECK_EQ(result.triggers, size_t(1));
+    CHECK_EQ(result.falseTriggers, size_t(0));
+    CHECK_EQ(result.latenciesMs.size(), size_t(1));
+    if (!result.latenciesMs.empty()) {
+        // At least the trigger duration, and well inside the covered span
+        CHECK(result.latenciesMs[0] >= 300.0);
+        CHECK(result.latenciesMs[0] < 1500.0);
+    }
+    CHECK(result.frameRecall() > 0.5);
+    CHECK(result.framePrecision() > 0.9);
+
+    // Without labels the same detection is a false trigger
+    auto unlabelled = makeTrainedDetector(config);
+    EvaluationResult negative = evaluateRecording(*unlabelled, config.hopSize, recording.data(),
+                                                  recording.size(), SAMPLE_RATE, {});
+    CHECK_EQ(negative.triggers, size_t(1));
+    CHECK_EQ(negative.falseTriggers, size_t(1));
+    CHECK(negative.falseTriggersPerHour() > 0.0);
+}
+
+void testThresholds() {
+    NoiseDetectorConfig config;
+    config.sampleRate = SAMPLE_RATE;
+    auto recording = makeRecording(12);
+    std::vector<LabelSegment> labels = {{1.0, 3.1, "covered", true}};
+
+    // A spike gate above 0 dBFS can never arm
+    config.thresholds.spikeThresholdDb = 1.0f;
+    auto gated = makeTrainedDetector(config);
+    EvaluationResult result = evaluateRecording(*gated, config.hopSize, recording.data(),
+                                                recording.size(), SAMPLE_RATE, labels);
+    CHECK_EQ(result.triggers, size_t(0));
+    CHECK_EQ(result.eventRecall(), 0.0);
+
+    auto throws = [](const DetectionThresholds& thresholds) {
+        try {
+            NoiseDetectorConfig invalid;
+            invalid.thresholds = thresholds;
+            createFFTDetector(invalid);
+            return false;
+        } catch (const std::invalid_argument&) {
+            return true;
+        }
+    };
+    // The default 128 ms hit window holds 12 hops of 512 samples at 48 kHz
+    DetectionThresholds thresholds;
+    thresholds.startHits = 13;
+    CHECK(throws(thresholds));
+    thresholds.hitWindowMs = 256;
+    CHECK(!throws(thresholds));
+    thresholds.hitWindowMs = 0;
+    CHECK(throws(thresholds));
+    thresholds = DetectionThresholds{};
+    thresholds.energyWindowMs = -1;
+    CHECK(throws(thresholds));
+}
+
+void testCascade() {
+    NoiseDetectorConfig config;
+    config.sampleRate = SAMPLE_RATE;
+    auto recording = makeRecording(12);
+    std::vector<LabelSegment> labels = {{1.0, 3.1, "covered", true}};
+
+    auto full = makeTrainedDetector(config);
+    EvaluationResult reference = evaluateRecording(*full, config.hopSize, recording.data(),
+                                                   recording.size(), SAMPLE_RATE, labels);
+    CascadeStats fullStats = full->getCascadeStats();
+    CHECK_EQ(fullStats.frames, uint64_t(reference.frames));
+    CHECK_EQ(fullStats.analyzed, fullStats.frames);
+
+    // Skipping the FFT while idle must not change what triggers or when
+    config.cascade.enabled = true;
+    config.cascade.idleInterval = 4;
+    auto cascaded = makeTrainedDetector(config);
+    EvaluationResult result = evaluateRecording(*cascaded, config.hopSize, recording.data(),
+                                                recording.size(), SAMPLE_RATE, labels);
+    CHECK_EQ(result.triggers, reference.triggers);
+    CHECK_EQ(result.falseTriggers, reference.falseTriggers);
+    CHECK_EQ(result.latenciesMs.size(), reference.latenciesMs.size());
+    if (!result.latenciesMs.empty() && !reference.latenciesMs.empty()) {
+        CHECK_NEAR(result.latenciesMs[0], reference.latenciesMs[0], 1e-9);
+    }
+
+    CascadeStats stats = cascaded->getCascadeStats();
+    CHECK_EQ(stats.frames, fullStats.frames);
+    CHECK_EQ(stats.energyOnly + stats.reused + stats.analyzed, stats.frames);
+    CHECK(stats.energyOnly > 0);
+    CHECK(stats.analyzed < stats.frames / 2);
+
+    // The first frame past the energy gate after a silence is analysed,
+    // not scored with a match from before it, whatever the idle phase was
+    auto quiet = RecordingBuilder(13).quiet(0.5).take();
+    for (int phase = 0; phase < config.cascade.idleInterval; ++phase) {
+        auto idle = makeTrainedDetector(config);
+        RecordingBuilder builder(14 + phase);
+        auto before = builder.covered((20.0 + phase) * config.hopSize / SAMPLE_RATE).take();
+        auto after = builder.covered(0.5).take();
+        DetectionResult results[2];
+        idle->analyzeInto(before.data(), before.size(), results, 2);
+        idle->analyzeInto(quiet.data(), quiet.size(), results, 2);
+        CascadeStats last = idle->getCascadeStats();
+        CHECK(last.energyOnly > 0);
+        for (size_t offset = 0; offset + config.hopSize <= after.size(); offset += config.hopSize) {
+            idle->analyzeInto(after.data() + offset, config.hopSize, results, 2);
+            CascadeStats now = idle->getCascadeStats();
+            if (now.energyOnly == last.energyOnly) {
+                CHECK_EQ(now.reused, last.reused);
+                CHECK_EQ(now.analyzed, last.analyzed + 1);
+                break;
+            }
+            last = now;
+        }
+    }
+
+    bool threw = false;
+    try {
+        NoiseDetectorConfig invalid;
+        invalid.cascade.enabled = true;
+        invalid.cascade.idleInterval = 0;
+        createFFTDetector(invalid);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+} // anonymous namespace
+
+int main() {
+    micmap::common::Logger::getLogger()->setMinLevel(micmap::common::LogLevel::Warning);
+
+    testLabelFile();
+    testPercentiles();
+    testMetrics();
+    testEvaluateRecording();
+    testThresholds();
+    testCascade();
+
+    return TEST_RESULT("Evaluation tests");
+}
@@ -0,0 +1,193 @@
+/**
+ * @file test_fft_backend.cpp
+ * @brief Accuracy tests for the pluggable FFT backends
+ *
+ * Compares every backend and SIMD level against a double-precision DFT for
+ * small and medium sizes, and against KissFFT for the large sizes where a
+ * direct DFT is too slow. Also checks that the fused window matches
+ * windowing the input up front.
+ */
+
+#include "micmap/detection/fft_backend.hpp"
+#include "micmap/detection/spectral_analyzer.hpp"
+#include "test_common.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace micmap::detection;
+using micmap::common::SimdLevel;
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+
+std::vector<float> randomFrame(size_t size, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> frame(size);
+    for (float& s : frame) {
+        s = dist(rng);
+    }
+    return frame;
+}
+
+std::vector<double> referenceDFT(const std::vector<float>& input) {
+    size_t n = input.size();
+    std::vector<double> output(2 * (n / 2 + 1));
+    for (size_t k = 0; k <= n / 2; ++k) {
+        double real = 0.0;
+        double imag = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            // Reduce k * i modulo n to keep the angle exact
+            double angle = -2.0 * PI * static_cast<double>((k * i) % n) / static_cast<double>(n);
+            real += input[i] * std::cos(angle);
+            imag += input[i] * std::sin(angle);
+        }
+        output[2 * k] = real;
+        output[2 * k + 1] = imag;
+    }
+    return output;
+}
+
+/**
+ * @brief Largest bin error relative to the frame's RMS bin magnitude
+ */
+template <typename T>
+double relativeError(const std::vector<float>& actual, const std::vector<T>& expected) {
+    double sumSq = 0.0;
+    double maxDiff = 0.0;
+    for (size_t i = 0; i < expected.size(); ++i) {
+        sumSq += static_cast<double>(expected[i]) * static_cast<double>(expected[i]);
+        maxDiff = std::max(maxDiff, std::fabs(actual[i] - static_cast<double>(expected[i])));
+    }
+    double rms = std::sqrt(sumSq / static_cast<double>(expected.size()));
+    return rms > 0.0 ? maxDiff / rms : maxDiff;
+}
+
+std::vector<SimdLevel> levelsToTest() {
+    std::vector<SimdLevel> levels = {SimdLevel::Scalar};
+    for (SimdLevel level : {SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::NEON}) {
+        if (micmap::common::isSimdLevelSupported(level)) {
+            levels.push_back(level);
+        }
+    }
+    return levels;
+}
+
+void testAgainstDFT(FFTBackendType type, SimdLevel level) {
+    for (size_t size = 1; size <= 2048; size *= 2) {
+        auto fft = createFFTBackend(type, size, level);
+        CHECK_EQ(fft->getSize(), size);
+
+        auto frame = randomFrame(size, static_cast<unsigned>(size));
+        std::vector<float> output(2 * (size / 2 + 1));
+        fft->forward(frame.data(), nullptr, output.data());
+
+        double error = relativeError(output, referenceDFT(frame));
+        if (error > 1e-5) {
+            std::cerr << "  " << fftBackendTypeToString(fft->getType()) << "/"
+                      << micmap::common::simdLevelToString(level) << " size " << size
+                      << ": error " << error << "\n";
+        }
+        CHECK(error < 1e-5);
+    }
+}
+
+void testLargeSizesAgainstKissFFT(SimdLevel level) {
+    for (size_t size : {4096, 8192, 16384}) {
+        auto reference = createFFTBackend(FFTBackendType::KissFFT, size);
+        auto fft = createFFTBackend(FFTBackendType::Radix4, size, level);
+
+        auto frame = randomFrame(size, 99);
+        std::vector<float> expected(2 * (size / 2 + 1));
+        std::vector<float> output(expected.size());
+        reference->forward(frame.data(), nullptr, expected.data());
+        fft->forward(frame.data(), nullptr, output.data());
+
+        CHECK(relativeError(output, expected) < 1e-5);
+    }
+}
+
+void testFusedWindow(FFTBackendType type, SimdLevel level) {
+    constexpr size_t SIZE = 1024;
+    auto fft = createFFTBackend(type, SIZE, level);
+
+    auto frame = randomFrame(SIZE, 5);
+    std::vector<float> window(SIZE);
+    std::vector<float> windowed(SIZE);
+    for (size_t i = 0; i < SIZE; ++i) {
+        window[i] = 0.5f * (1.0f - std::cos(2.0f * static_cast<float>(PI) * static_cast<float>(i) /
+                                            static_cast<float>(SIZE - 1)));
+        windowed[i] = frame[i] * window[i];
+    }
+
+    std::vector<float> fused(2 * (SIZE / 2 + 1));
+    std::vector<float> separate(fused.size());
+    fft->forward(frame.data(), window.data(), fused.data());
+    fft->forward(windowed.data(), nullptr, separate.data());
+
+    for (size_t i = 0; i < fused.size(); ++i) {
+        CHECK_EQ(fused[i], separate[i]);
+    }
+}
+
+void testFactory() {
+    CHECK(createFFTBackend(FFTBackendType::Auto, 256)->getType() == FFTBackendType::Radix4);
+    CHECK(createFFTBackend(FFTBackendType::KissFFT, 256)->getType() == FFTBackendType::KissFFT);
+
+    bool threw = false;
+    try {
+        createFFTBackend(FFTBackendType::Radix4, 1000);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    CHECK(threw);
+
+    FFTBackendType type = FFTBackendType::KissFFT;
+    CHECK(parseFFTBackendType("radix4", type));
+    CHECK(type == FFTBackendType::Radix4);
+    CHECK(parseFFTBackendType("auto", type));
+    CHECK(type == FFTBackendType::Auto);
+    CHECK(!parseFFTBackendType("fftw", type));
+    CHECK(type == FFTBackendType::Auto);
+}
+
+void testAnalyzersAgree() {
+    constexpr size_t SIZE = 2048;
+    auto kiss = createSpectralAnalyzer(48000, SIZE, FFTBackendType::KissFFT);
+    auto radix4 = createSpectralAnalyzer(48000, SIZE, FFTBackendType::Radix4);
+
+    // Short input exercises the zero-padding path
+    for (size_t count : {SIZE, SIZE + 300, SIZE / 3}) {
+        auto samples = randomFrame(count, 11);
+        auto a = kiss->analyze(samples.data(), samples.size());
+        auto b = radix4->analyze(samples.data(), samples.size());
+
+        CHECK(relativeError(b.magnitudes, a.magnitudes) < 1e-5);
+        CHECK_NEAR(b.spectralFlatness, a.spectralFlatness, 1e-5);
+        CHECK_NEAR(b.spectralCentroid, a.spectralCentroid, 1e-2);
+        CHECK_EQ(b.energy, a.energy);
+    }
+}
+
+} // anonymous namespace
+
+int main() {
+    testFactory();
+
+    for (SimdLevel level : levelsToTest()) {
+        testAgainstDFT(FFTBackendType::Radix4, level);
+        testLargeSizesAgainstKissFFT(level);
+        testFusedWindow(FFTBackendType::Radix4, level);
+    }
+    testAgainstDFT(FFTBackendType::KissFFT, SimdLevel::Scalar);
+    testFusedWindow(FFTBackendType::KissFFT, SimdLevel::Scalar);
+
+    testAnalyzersAgree();
+
+    return TEST_RESULT("FFT backend tests");
+}
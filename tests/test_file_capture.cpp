@@ -0,0 +1,275 @@
+/**
+ * @file test_file_capture.cpp
+ * @brief Tests for WavReader and the file replay capture backend
+ */
+
+#include "micmap/audio/file_capture.hpp"
+#include "micmap/audio/wav_reader.hpp"
+#include "test_common.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace micmap::audio;
+
+namespace {
+
+void putLE16(std::vector<uint8_t>& out, uint16_t value) {
+    out.push_back(static_cast<uint8_t>(value));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+}
+
+void putLE32(std::vector<uint8_t>& out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+/**
+ * @brief Write a WAV file whose channel c of frame i holds ramp(i) * (c + 1)
+ */
+std::string writeWav(const std::string& name, SampleFormat format, uint16_t channels,
+                     uint32_t sampleRate, uint32_t frames, bool extensible) {
+    const uint16_t bytes = static_cast<uint16_t>(bytesPerSample(format));
+    const uint16_t bits = static_cast<uint16_t>(bytes * 8);
+    const uint16_t tag = (format == SampleFormat::Float32) ? 3 : 1;
+
+    std::vector<uint8_t> data;
+    for (uint32_t i = 0; i < frames; ++i) {
+        float ramp = static_cast<float>(i % 200) / 400.0f - 0.25f;
+        for (uint16_t c = 0; c < channels; ++c) {
+            float value = ramp * static_cast<float>(c + 1);
+            switch (format) {
+                case SampleFormat::Float32: {
+                    uint32_t raw;
+                    std::memcpy(&raw, &value, sizeof(raw));
+                    putLE32(data, raw);
+                    break;
+                }
+                case SampleFormat::Int16:
+                    putLE16(data, static_cast<uint16_t>(static_cast<int16_t>(value * 32767.0f)));
+                    break;
+                case SampleFormat::Int24: {
+                    auto raw = static_cast<uint32_t>(static_cast<int32_t>(value * 8388607.0f));
+                    data.push_back(static_cast<uint8_t>(raw));
+                    data.push_back(static_cast<uint8_t>(raw >> 8));
+                    data.push_back(static_cast<uint8_t>(raw >> 16));
+                    break;
+                }
+                case SampleFormat::Int32:
+                    putLE32(data, static_cast<uint32_t>(static_cast<int32_t>(value * 2147483000.0f)));
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    std::vector<uint8_t> file;
+    const uint32_t fmtSize = extensible ? 40 : 16;
+    file.insert(file.end(), {'R', 'I', 'F', 'F'});
+    putLE32(file, 4 + (8 + fmtSize) + (8 + 6) + (8 + static_cast<uint32_t>(data.size())));
+    file.insert(file.end(), {'W', 'A', 'V', 'E'});
+
+    file.insert(file.end(), {'f', 'm', 't', ' '});
+    putLE32(file, fmtSize);
+    putLE16(file, extensible ? 0xFFFE : tag);
+    putLE16(file, channels);
+    putLE32(file, sampleRate);
+    putLE32(file, sampleRate * channels * bytes);
+    putLE16(file, static_cast<uint16_t>(channels * bytes));
+    putLE16(file, bits);
+    if (extensible) {
+        putLE16(file, 22);
+        putLE16(file, bits);
+        putLE32(file, 0);
+        // Sub-format GUID: format tag followed by the standard suffix
+        putLE16(file, tag);
+        const uint8_t suffix[] = {0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00,
+                                  0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71};
+        file.insert(file.end(), std::begin(suffix), std::end(suffix));
+    }
+
+    // An unrelated chunk with odd size to exercise chunk skipping and padding
+    file.insert(file.end(), {'L', 'I', 'S', 'T'});
+    putLE32(file, 5);
+    file.insert(file.end(), {'a', 'b', 'c', 'd', 'e', 0});
+
+    file.insert(file.end(), {'d', 'a', 't', 'a'});
+    putLE32(file, static_cast<uint32_t>(data.size()));
+    file.insert(file.end(), data.begin(), data.end());
+
+    auto path = (std::filesystem::temp_directory_path() / name).string();
+    std::ofstream out(path, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(file.data()), static_cast<std::streamsize>(file.size()));
+    return path;
+}
+
+float expectedMono(uint32_t frame, uint16_t channels) {
+    float ramp = static_cast<float>(frame % 200) / 400.0f - 0.25f;
+    float sum = 0.0f;
+    for (uint16_t c = 0; c < channels; ++c) {
+        sum += ramp * static_cast<float>(c + 1);
+    }
+    return sum / static_cast<float>(channels);
+}
+
+void testReader() {
+    struct Case { SampleFormat format; uint16_t channels; bool extensible; };
+    const Case cases[] = {
+        {SampleFormat::Int16, 1, false},
+        {SampleFormat::Int16, 2, true},
+        {SampleFormat::Int24, 2, false},
+        {SampleFormat::Int32, 4, true},
+        {SampleFormat::Float32, 1, false},
+        {SampleFormat::Float32, 6, true},
+    };
+
+    for (const auto& c : cases) {
+        const uint32_t frames = 1000;
+        std::string path = writeWav("micmap_test_reader.wav", c.format, c.channels, 16000,
+                                    frames, c.extensible);
+
+        WavReader reader;
+        CHECK(reader.open(path));
+        CHECK_EQ(reader.getInfo().channels, c.channels);
+        CHECK_EQ(reader.getInfo().sampleRate, uint32_t(16000));
+        CHECK_EQ(reader.getInfo().totalFrames, uint64_t(frames));
+        CHECK(reader.getInfo().format == c.format);
+
+        std::vector<float> mono(frames + 10);
+        size_t read = 0;
+        while (size_t n = reader.readMono(mono.data() + read, 333)) {
+            read += n;
+        }
+        CHECK_EQ(read, size_t(frames));
+
+        double maxError = 0.0;
+        for (uint32_t i = 0; i < frames; ++i) {
+            maxError = std::max(maxError, std::fabs(static_cast<double>(mono[i] - expectedMono(i, c.channels))));
+        }
+        CHECK_NEAR(maxError, 0.0, 1e-3);
+
+        CHECK(reader.rewind());
+        float first = 0.0f;
+        CHECK_EQ(reader.readMono(&first, 1), size_t(1));
+        CHECK_NEAR(first, expectedMono(0, c.channels), 1e-3);
+
+        // Separate channels alongside the mix; channel c is the ramp times c + 1
+        CHECK(reader.rewind());
+        std::vector<float> planar(static_cast<size_t>(c.channels) * 300);
+        size_t n = reader.readFrames(mono.data(), planar.data(), 300);
+        CHECK_EQ(n, size_t(300));
+        maxError = 0.0;
+        for (uint16_t ch = 0; ch < c.channels; ++ch) {
+            for (size_t i = 0; i < n; ++i) {
+                float ramp = static_cast<float>(i % 200) / 400.0f - 0.25f;
+                float expected = ramp * static_cast<float>(ch + 1);
+                maxError = std::max(maxError, std::fabs(static_cast<double>(planar[ch * n + i] - expected)));
+            }
+        }
+        CHECK_NEAR(maxError, 0.0, 1e-3);
+        CHECK_NEAR(mono[1], expectedMono(1, c.channels), 1e-3);
+
+        reader.close();
+        std::filesystem::remove(path);
+    }
+
+    WavReader reader;
+    CHECK(!reader.open("/nonexistent/micmap.wav"));
+    CHECK(!reader.getLastError().empty());
+}
+
+void testFastReplay() {
+    const uint32_t frames = 48000 * 5;  // 5 seconds of audio
+    std::string path = writeWav("micmap_test_fast.wav", SampleFormat::Int16, 2, 48000, frames, false);
+
+    FileCaptureConfig config;
+    config.path = path;
+    config.periodFrames = 480;
+    config.realTime = false;
+
+    auto capture = createFileCapture(config);
+    CHECK_EQ(capture->getSampleRate(), uint32_t(48000));
+    CHECK_EQ(capture->getChannels(), uint16_t(1));
+    CHECK_EQ(capture->enumerateDevices().size(), size_t(1));
+
+    std::mutex mutex;
+    std::vector<float> received;
+    size_t maxPacket = 0;
+    capture->setAudioCallback([&](const float* samples, size_t count) {
+        std::lock_guard<std::mutex> lock(mutex);
+        received.insert(received.end(), samples, samples + count);
+        maxPacket = std::max(maxPacket, count);
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    CHECK(capture->startCapture());
+    while (capture->isCapturing()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    capture->stopCapture();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    CHECK_EQ(received.size(), size_t(frames));
+    CHECK_EQ(maxPacket, size_t(480));
+    CHECK(elapsed < std::chrono::seconds(5));
+    for (uint32_t i = 0; i < frames; i += 997) {
+        CHECK_NEAR(received[i], expectedMono(i, 2), 1e-3);
+    }
+
+    // History keeps the most recent second
+    std::vector<float> history;
+    CHECK(capture->getAudioBuffer(history));
+    CHECK_EQ(history.size(), size_t(48000));
+    CHECK_NEAR(history.back(), expectedMono(frames - 1, 2), 1e-3);
+
+    capture.reset();
+    std::filesystem::remove(path);
+}
+
+void testRealTimeReplay() {
+    const uint32_t frames = 16000 / 5;  // 200 ms of audio
+    std::string path = writeWav("micmap_test_rt.wav", SampleFormat::Float32, 1, 16000, frames, false);
+
+    FileCaptureConfig config;
+    config.path = path;
+    config.periodFrames = 160;
+    config.realTime = true;
+
+    auto capture = createFileCapture(config);
+    std::atomic<size_t> received{0};
+    capture->setAudioCallback([&](const float*, size_t count) { received += count; });
+
+    auto start = std::chrono::steady_clock::now();
+    CHECK(capture->startCapture());
+    while (capture->isCapturing()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    CHECK_EQ(received.load(), size_t(frames));
+    // The last packet is due 190 ms after the first
+    CHECK(elapsed >= std::chrono::milliseconds(180));
+
+    capture.reset();
+    std::filesystem::remove(path);
+}
+
+} // anonymous namespace
+
+int main() {
+    testReader();
+    testFastReplay();
+    testRealTimeReplay();
+
+    return TEST_RESULT("File capture tests");
+}
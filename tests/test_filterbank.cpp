@@ -0,0 +1,283 @@
+/**
+ * @file test_filterbank.cpp
+ * @brief Tests for the mel/ERB filterbank and band-space profiles
+ *
+ * Checks the sparse band weights against a dense reference built from the
+ * same triangle definition, then trains, matches, saves and loads profiles
+ * in band space.
+ */
+
+#include "micmap/detection/filterbank.hpp"
+#include "micmap/detection/noise_detector.hpp"
+#include "micmap/common/logger.hpp"
+#include "test_common.hpp"
+#include "test_recordings.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace micmap::detection;
+using micmap::common::SimdLevel;
+using micmap::test::touchAndCover;
+using micmap::test::makeTrainedDetector;
+
+namespace {
+
+constexpr uint32_t SAMPLE_RATE = 48000;
+
+/**
+ * @brief Dense bands x bins weight matrix straight from the triangle definition
+ */
+std::vector<std::vector<float>> denseWeights(const FilterbankConfig& config, size_t fftSize) {
+    const size_t numBins = fftSize / 2 + 1;
+    const float binWidth = static_cast<float>(SAMPLE_RATE) / static_cast<float>(fftSize);
+    const float low = Filterbank::toScale(config.scale, config.minFrequency);
+    const float high = Filterbank::toScale(config.scale, std::min(config.maxFrequency, SAMPLE_RATE / 2.0f));
+
+    std::vector<std::vector<float>> weights(config.bands, std::vector<float>(numBins, 0.0f));
+    for (size_t k = 0; k < config.bands; ++k) {
+        auto edge = [&](size_t j) {
+            return Filterbank::fromScale(config.scale,
+                                         low + (high - low) * static_cast<float>(j) / (config.bands + 1));
+        };
+        float lower = edge(k);
+        float center = edge(k + 1);
+        float upper = edge(k + 2);
+        float sum = 0.0f;
+        for (size_t i = 0; i < numBins; ++i) {
+            float f = static_cast<float>(i) * binWidth;
+            if (f > lower && f < center) {
+                weights[k][i] = (f - lower) / (center - lower);
+            } else if (f >= center && f < upper) {
+                weights[k][i] = (upper - f) / (upper - center);
+            }
+            sum += weights[k][i];
+        }
+        if (sum == 0.0f) {
+            weights[k][std::min(numBins - 1, static_cast<size_t>(std::lround(center / binWidth)))] = 1.0f;
+            sum = 1.0f;
+        }
+        for (float& w : weights[k]) {
+            w /= sum;
+        }
+    }
+    return weights;
+}
+
+void testAgainstDense() {
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> dist(0.0f, 2.0f);
+
+    struct Case {
+        FilterbankScale scale;
+        size_t bands;
+        size_t fftSize;
+        float minFrequency;
+        float maxFrequency;
+    };
+    const Case cases[] = {
+        {FilterbankScale::Mel, 32, 2048, 50.0f, 8000.0f},
+        {FilterbankScale::ERB, 32, 2048, 50.0f, 8000.0f},
+        {FilterbankScale::Mel, 40, 1024, 0.0f, 30000.0f},   // Clamped to Nyquist
+        {FilterbankScale::ERB, 64, 256, 20.0f, 1000.0f},    // Bands narrower than a bin
+    };
+
+    for (const Case& c : cases) {
+        FilterbankConfig config;
+        config.scale = c.scale;
+        config.bands = c.bands;
+        config.minFrequency = c.minFrequency;
+        config.maxFrequency = c.maxFrequency;
+        auto dense = denseWeights(config, c.fftSize);
+        const size_t numBins = c.fftSize / 2 + 1;
+
+        std::vector<float> magnitudes(numBins);
+        for (float& m : magnitudes) {
+            m = dist(rng);
+        }
+        std::vector<float> ones(numBins, 1.0f);
+
+        Filterbank scalar(config, SAMPLE_RATE, c.fftSize, SimdLevel::Scalar);
+        Filterbank simd(config, SAMPLE_RATE, c.fftSize);
+        CHECK_EQ(scalar.getNumBands(), c.bands);
+        CHECK(scalar.getMaxFrequency() <= SAMPLE_RATE / 2.0f);
+        CHECK(scalar.getNumWeights() < numBins * c.bands / 4);
+
+        std::vector<float> bands(c.bands);
+        std::vector<float> simdBands(c.bands);
+        std::vector<float> unit(c.bands);
+        scalar.apply(magnitudes.data(), bands.data());
+        simd.apply(magnitudes.data(), simdBands.data());
+        scalar.apply(ones.data(), unit.data());
+
+        for (size_t k = 0; k < c.bands; ++k) {
+            double expected = 0.0;
+            for (size_t i = 0; i < numBins; ++i) {
+                expected += static_cast<double>(dense[k][i]) * magnitudes[i];
+            }
+            CHECK_NEAR(bands[k], expected, 1e-5);
+            CHECK_NEAR(simdBands[k], bands[k], 1e-5);
+
+            // Every band has unit weight, so a flat spectrum stays flat
+            CHECK_NEAR(unit[k], 1.0f, 1e-5);
+            if (k > 0) {
+                CHECK(scalar.getCenterFrequency(k) > scalar.getCenterFrequency(k - 1));
+            }
+        }
+    }
+}
+
+void testScales() {
+    // 1000 Hz is 1000 mel by construction, and ERB-rate 15.6
+    CHECK_NEAR(Filterbank::toScale(FilterbankScale::Mel, 1000.0f), 1000.0f, 0.5f);
+    CHECK_NEAR(Filterbank::toScale(FilterbankScale::ERB, 1000.0f), 15.62f, 0.01f);
+    for (float f : {0.0f, 50.0f, 440.0f, 8000.0f, 24000.0f}) {
+        for (FilterbankScale scale : {FilterbankScale::Mel, FilterbankScale::ERB}) {
+            CHECK_NEAR(Filterbank::fromScale(scale, Filterbank::toScale(scale, f)), f, 1e-3f * f + 1e-3f);
+        }
+    }
+
+    FilterbankScale scale = FilterbankScale::Mel;
+    CHECK(parseFilterbankScale("erb", scale));
+    CHECK(scale == FilterbankScale::ERB);
+    CHECK(parseFilterbankScale("mel", scale));
+    CHECK(scale == FilterbankScale::Mel);
+    CHECK(!parseFilterbankScale("bark", scale));
+
+    auto throws = [](FilterbankConfig config, size_t fftSize) {
+        try {
+            Filterbank filterbank(config, SAMPLE_RATE, fftSize);
+            return false;
+        } catch (const std::invalid_argument&) {
+            return true;
+        }
+    };
+    FilterbankConfig config;
+    CHECK(!throws(config, 2048));
+    CHECK(throws(config, 0));
+    config.bands = 0;
+    CHECK(throws(config, 2048));
+    config.bands = 32;
+    config.minFrequency = 30000.0f;
+    CHECK(throws(config, 2048));
+}
+
+/**
+ * @brief Replay summary: detections and mean profile match per section
+ */
+struct Replay {
+    size_t coveredDetections = 0;
+    size_t toneDetections = 0;
+    float coveredMatch = 0.0f;
+    float toneMatch = 0.0f;
+
+    bool operator==(const Replay& other) const {
+        return coveredDetections == other.coveredDetections &&
+               toneDetections == other.toneDetections &&
+               coveredMatch == other.coveredMatch && toneMatch == other.toneMatch;
+    }
+};
+
+Replay replay(INoiseDetector& detector, const std::vector<float>& fixture, size_t hopSize) {
+    const double coveredStart = 1.1;
+    const double coveredEnd = 3.1;
+    const double toneStart = 4.1;
+    Replay summary;
+    size_t coveredFrames = 0;
+    size_t toneFrames = 0;
+    DetectionResult results[4];
+    size_t frame = 0;
+    for (size_t offset = 0; offset + 480 <= fixture.size(); offset += 480) {
+        size_t n = detector.analyzeInto(fixture.data() + offset, 480, results, 4);
+        for (size_t i = 0; i < n; ++i, ++frame) {
+            double t = static_cast<double>((frame + 1) * hopSize) / SAMPLE_RATE;
+            if (t >= coveredStart + 0.1 && t < coveredEnd) {
+                summary.coveredMatch += results[i].correlation;
+                ++coveredFrames;
+            } else if (t >= toneStart + 0.1) {
+                summary.toneMatch += results[i].correlation;
+                ++toneFrames;
+            }
+            if (results[i].isWhiteNoise) {
+                ++(t >= toneStart ? summary.toneDetections : summary.coveredDetections);
+            }
+        }
+    }
+    summary.coveredMatch /= static_cast<float>(std::max<size_t>(coveredFrames, 1));
+    summary.toneMatch /= static_cast<float>(std::max<size_t>(toneFrames, 1));
+    return summary;
+}
+
+void testBandProfiles() {
+    // Covered mic, then a tone that must not trigger
+    auto fixture = touchAndCover(12).tone(2.0, 0.01f).take();
+    auto dir = std::filesystem::temp_directory_path();
+    auto binPath = dir / "micmap_test_bins.mmap";
+    auto melPath = dir / "micmap_test_mel.mmap";
+
+    NoiseDetectorConfig binConfig;
+    binConfig.sampleRate = SAMPLE_RATE;
+    NoiseDetectorConfig melConfig = binConfig;
+    melConfig.filterbank.enabled = true;
+
+    for (ProfileMatch match : {ProfileMatch::Correlation, ProfileMatch::Mahalanobis}) {
+        NoiseDetectorConfig config = melConfig;
+        config.profileMatch = match;
+        auto detector = makeTrainedDetector(config);
+        CHECK_EQ(detector->getTrainingData().spectralProfile.size(), melConfig.filterbank.bands);
+        CHECK(detector->getProfileMatch() == match);
+        Replay summary = replay(*detector, fixture, config.hopSize);
+        CHECK(summary.coveredDetections > 0);
+        CHECK_EQ(summary.toneDetections, size_t(0));
+        CHECK(summary.coveredMatch > 0.6f);
+        CHECK(summary.toneMatch < 0.5f * summary.coveredMatch);
+    }
+
+    // Band profiles are an order of magnitude smaller than bin profiles
+    auto bins = makeTrainedDetector(binConfig);
+    auto mel = makeTrainedDetector(melConfig);
+    CHECK(bins->saveTrainingData(binPath));
+    CHECK(mel->saveTrainingData(melPath));
+    CHECK(std::filesystem::file_size(melPath) * 10 < std::filesystem::file_size(binPath));
+
+    // Same layout round trip scores like the trained detector
+    auto loaded = createFFTDetector(melConfig);
+    CHECK(loaded->loadTrainingData(melPath));
+    auto reference = makeTrainedDetector(melConfig);
+    CHECK(replay(*loaded, fixture, melConfig.hopSize) == replay(*reference, fixture, melConfig.hopSize));
+
+    // Bins and bands, or bands of another layout, do not mix
+    CHECK(!loaded->addTrainingData(binPath));
+    CHECK(loaded->addTrainingData(melPath));
+    CHECK_EQ(loaded->getProfileCount(), size_t(2));
+    CHECK(!createFFTDetector(binConfig)->loadTrainingData(melPath));
+
+    NoiseDetectorConfig other = melConfig;
+    other.filterbank.scale = FilterbankScale::ERB;
+    CHECK(!createFFTDetector(other)->loadTrainingData(melPath));
+    other = melConfig;
+    other.filterbank.bands = 24;
+    CHECK(!createFFTDetector(other)->loadTrainingData(melPath));
+    other = melConfig;
+    other.filterbank.maxFrequency = 4000.0f;
+    CHECK(!createFFTDetector(other)->loadTrainingData(melPath));
+
+    std::filesystem::remove(binPath);
+    std::filesystem::remove(melPath);
+}
+
+} // anonymous namespace
+
+int main() {
+    micmap::common::Logger::getLogger()->setMinLevel(micmap::common::LogLevel::Warning);
+
+    testAgainstDense();
+    testScales();
+    testBandProfiles();
+
+    return TEST_RESULT("Filterbank tests");
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+/**
+ * @file test_recordings.hpp
+ * @brief Synthetic recordings and trained detectors shared by the detection tests
+ *
+ * Recordings are put together from a few deterministic sections (quiet
+ * room, touch spike, covered mic, tone) drawn from one seeded generator,
+ * so every test replays exactly the same samples on every platform.
+ */
+
+#include "micmap/detection/noise_detector.hpp"
+#include "test_common.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace micmap::test {
+
+/**
+ * @brief Builds a mono recording section by section
+ */
+class RecordingBuilder {
+public:
+    explicit RecordingBuilder(uint32_t seed, uint32_t sampleRate = 48000)
+        : rng_(seed), sampleRate_(sampleRate) {}
+
+    /// Quiet room: faint broadband noise
+    RecordingBuilder& quiet(double seconds) {
+        for (size_t i = 0, n = count(seconds); i < n; ++i) {
+            samples_.push_back(0.003f * noise_(rng_));
+        }
+        return *this;
+    }
+
+    /// Finger hitting the microphone: full-scale noise
+    RecordingBuilder& spike(double seconds = 0.1) {
+        for (size_t i = 0, n = count(seconds); i < n; ++i) {
+            samples_.push_back(noise_(rng_));
+        }
+        return *this;
+    }
+
+    /// Covered microphone: low-passed broadband noise, as used for training
+    RecordingBuilder& covered(double seconds) {
+        float state = 0.0f;
+        for (size_t i = 0, n = count(seconds); i < n; ++i) {
+            state = 0.7f * state + 0.3f * noise_(rng_);
+            samples_.push_back(0.4f * state);
+        }
+        return *this;
+    }
+
+    /// 440 Hz tone, optionally with its third harmonic, over some noise
+    RecordingBuilder& tone(double seconds, float noiseLevel, float harmonic = 0.0f) {
+        for (size_t i = 0, n = count(seconds); i < n; ++i) {
+            float t = static_cast<float>(i) / sampleRate_;
+            samples_.push_back(0.2f * std::sin(2.0f * 3.14159265f * 440.0f * t) +
+                               harmonic * std::sin(2.0f * 3.14159265f * 1320.0f * t) +
+                               noiseLevel * noise_(rng_));
+        }
+        return *this;
+    }
+
+    std::vector<float> take() { return std::move(samples_); }
+
+private:
+    size_t count(double seconds) const {
+        return static_cast<size_t>(std::lround(seconds * sampleRate_));
+    }
+
+    std::mt19937 rng_;
+    std::uniform_real_distribution<float> noise_{-1.0f, 1.0f};
+    uint32_t sampleRate_;
+    std::vector<float> samples_;
+};
+
+/**
+ * @brief Quiet room (1 s), touch spike, covered mic (2 s), quiet (1 s)
+ *
+ * The spike and covered mic span 1.0 s - 3.1 s; tests append the sounds
+ * that must not trigger, such as a tone.
+ */
+inline RecordingBuilder touchAndCover(uint32_t seed, uint32_t sampleRate = 48000) {
+    RecordingBuilder builder(seed, sampleRate);
+    builder.quiet(1.0).spike().covered(2.0).quiet(1.0);
+    return builder;
+}
+
+/**
+ * @brief Two seconds of covered mic, the default training recording
+ */
+inline std::vector<float> coveredTraining(uint32_t seed = 11, uint32_t sampleRate = 48000) {
+    return RecordingBuilder(seed, sampleRate).covered(2.0).take();
+}
+
+/**
+ * @brief Create a detector and train it on a recording
+ */
+inline std::unique_ptr<detection::INoiseDetector> makeTrainedDetector(
+    const detection::NoiseDetectorConfig& config,
+    const std::vector<float>& training) {
+    auto detector = detection::createFFTDetector(config);
+    detector->startTraining();
+    detector->addTrainingSample(training.data(), training.size());
+    CHECK(detector->finishTraining());
+    return detector;
+}
+
+/**
+ * @brief Create a detector trained on coveredTraining() at its sample rate
+ */
+inline std::unique_ptr<detection::INoiseDetector> makeTrainedDetector(
+    const detection::NoiseDetectorConfig& config) {
+    return makeTrainedDetector(config, coveredTraining(11, config.sampleRate));
+}
+
+} // namespace micmap::test
@@ -0,0 +1,239 @@
+/**
+ * @file test_resampler.cpp
+ * @brief Tests for the polyphase resampler and the resampling capture
+ *
+ * Checks tone gain and alias rejection for the common device rates, that
+ * block sizes and kernel levels do not change the output, and that the
+ * capture decorator reports and delivers the analysis rate.
+ */
+
+#include "micmap/audio/resampler.hpp"
+#include "micmap/common/logger.hpp"
+#include "test_common.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace micmap::audio;
+using micmap::common::SimdLevel;
+using micmap::common::isSimdLevelSupported;
+
+namespace {
+
+std::vector<float> tone(uint32_t sampleRate, float frequency, size_t count) {
+    std::vector<float> samples(count);
+    for (size_t i = 0; i < count; ++i) {
+        double phase = 2.0 * 3.14159265358979 * frequency * static_cast<double>(i) / sampleRate;
+        samples[i] = static_cast<float>(std::sin(phase));
+    }
+    return samples;
+}
+
+std::vector<float> resampleAll(Resampler& resampler, const std::vector<float>& input, size_t block) {
+    std::vector<float> output;
+    std::vector<float> scratch(resampler.maxOutput(block));
+    for (size_t offset = 0; offset < input.size(); offset += block) {
+        size_t n = std::min(block, input.size() - offset);
+        size_t produced = resampler.process(input.data() + offset, n, scratch.data());
+        CHECK(produced <= resampler.maxOutput(n));
+        output.insert(output.end(), scratch.begin(), scratch.begin() + produced);
+    }
+    return output;
+}
+
+/**
+ * @brief RMS of the output after the filter has settled
+ */
+float settledRms(const std::vector<float>& samples) {
+    size_t begin = samples.size() / 4;
+    double sum = 0.0;
+    for (size_t i = begin; i < samples.size(); ++i) {
+        sum += static_cast<double>(samples[i]) * samples[i];
+    }
+    return static_cast<float>(std::sqrt(sum / static_cast<double>(samples.size() - begin)));
+}
+
+void testRates() {
+    struct Case {
+        uint32_t from;
+        uint32_t to;
+    };
+    const Case cases[] = {{48000, 16000}, {44100, 16000}, {96000, 16000}, {44100, 48000},
+                          {16000, 48000}, {96000, 48000}};
+
+    for (const Case& c : cases) {
+        Resampler resampler(c.from, c.to);
+        CHECK(resampler.getTapsPerPhase() > 0);
+        CHECK_EQ(resampler.getTapsPerPhase() % 8, size_t(0));
+
+        // One second in gives one second out
+        auto pass = resampleAll(resampler, tone(c.from, 1000.0f, c.from), 480);
+        CHECK(pass.size() + 1 >= c.to && pass.size() <= c.to + 1);
+        CHECK_NEAR(settledRms(pass), std::sqrt(0.5f), 0.01);
+
+        // Past the transition band above the lower Nyquist frequency
+        // nothing comes through
+        uint32_t lower = std::min(c.from, c.to);
+        float alias = 0.55f * static_cast<float>(lower);
+        if (alias < 0.5f * static_cast<float>(c.from)) {
+            resampler.reset();
+            auto stop = resampleAll(resampler, tone(c.from, alias, c.from), 480);
+            CHECK(settledRms(stop) < 1e-3f);
+        }
+    }
+
+    // Equal rates pass through
+    Resampler same(48000, 48000);
+    CHECK_EQ(same.getTapsPerPhase(), size_t(0));
+    auto input = tone(48000, 440.0f, 1000);
+    CHECK(resampleAll(same, input, 333) == input);
+
+    auto throws = [](uint32_t from, uint32_t to) {
+        try {
+            Resampler resampler(from, to);
+            return false;
+        } catch (const std::invalid_argument&) {
+            return true;
+        }
+    };
+    CHECK(throws(0, 16000));
+    CHECK(throws(48000, 0));
+    CHECK(throws(44099, 16000));    // 16000/44099 does not reduce
+    CHECK(!throws(22050, 16000));
+}
+
+void testBlocksAndKernels() {
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> input(50000);
+    for (float& s : input) {
+        s = dist(rng);
+    }
+
+    Resampler reference(44100, 16000, SimdLevel::Scalar);
+    auto expected = resampleAll(reference, input, input.size());
+
+    // Block sizes only change where the history is shifted
+    for (size_t block : {size_t(1), size_t(7), size_t(441), size_t(1024), size_t(5000)}) {
+        reference.reset();
+        CHECK(resampleAll(reference, input, block) == expected);
+    }
+
+    for (SimdLevel level : {SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::NEON}) {
+        if (!isSimdLevelSupported(level)) {
+            continue;
+        }
+        Resampler resampler(44100, 16000, level);
+        auto actual = resampleAll(resampler, input, 480);
+        CHECK_EQ(actual.size(), expected.size());
+        for (size_t i = 0; i < std::min(actual.size(), expected.size()); ++i) {
+            CHECK_NEAR(actual[i], expected[i], 1e-5);
+        }
+    }
+}
+
+/**
+ * @brief Capture that delivers pushed packets synchronously
+ */
+class FakeCapture : public IAudioCapture {
+public:
+    explicit FakeCapture(uint32_t sampleRate) : sampleRate_(sampleRate) {}
+
+    void push(const std::vector<float>& samples) {
+        if (callback_) {
+            callback_(samples.data(), samples.size());
+        }
+    }
+
+    std::vector<AudioDevice> enumerateDevices() override { return {getCurrentDevice()}; }
+    bool selectDevice(const std::wstring&) override { return true; }
+    bool selectDeviceById(const std::wstring&) override { return true; }
+    bool startCapture() override { capturing_ = true; return true; }
+    void stopCapture() override { capturing_ = false; }
+    bool isCapturing() const override { return capturing_; }
+    bool getAudioBuffer(std::vector<float>&) override { return false; }
+    AudioDevice getCurrentDevice() const override {
+        return AudioDevice{L"fake", L"Fake", sampleRate_, 1, 32, true};
+    }
+    void setAudioCallback(AudioCallback callback) override { callback_ = std::move(callback); }
+    void setMultiChannelCallback(MultiChannelCallback) override {}
+    uint32_t getSampleRate() const override { return sampleRate_; }
+    uint16_t getChannels() const override { return 1; }
+
+private:
+    uint32_t sampleRate_;
+    bool capturing_ = false;
+    AudioCallback callback_;
+};
+
+void testCapture() {
+    auto fake = std::make_unique<FakeCapture>(96000);
+    FakeCapture* device = fake.get();
+    auto capture = createResamplingCapture(std::move(fake), 16000);
+
+    CHECK_EQ(capture->getSampleRate(), 16000u);
+    CHECK_EQ(capture->getCurrentDevice().sampleRate, 16000u);
+    CHECK_EQ(capture->enumerateDevices().front().sampleRate, 96000u);
+
+    size_t delivered = 0;
+    std::vector<float> received;
+    capture->setAudioCallback([&](const float* samples, size_t count) {
+        delivered += count;
+        received.insert(received.end(), samples, samples + count);
+    });
+    CHECK(capture->startCapture());
+    CHECK(capture->isCapturing());
+
+    // Half a second in 10 ms packets, plus one packet larger than a block
+    auto input = tone(96000, 1000.0f, 48000 + 9600);
+    for (size_t offset = 0; offset < 48000; offset += 960) {
+        device->push(std::vector<float>(input.begin() + offset, input.begin() + offset + 960));
+    }
+    device->push(std::vector<float>(input.begin() + 48000, input.end()));
+    CHECK(delivered + 1 >= 9600 && delivered <= 9601);
+    CHECK_NEAR(settledRms(received), std::sqrt(0.5f), 0.01);
+
+    std::vector<float> buffered;
+    CHECK(capture->getAudioBuffer(buffered));
+    CHECK_EQ(buffered.size(), delivered);
+    CHECK(!capture->getAudioBuffer(buffered));
+
+    capture->stopCapture();
+    CHECK(!capture->isCapturing());
+
+    // Matching rates pass packets through untouched
+    auto same = std::make_unique<FakeCapture>(16000);
+    FakeCapture* sameDevice = same.get();
+    auto passthrough = createResamplingCapture(std::move(same), 16000);
+    received.clear();
+    passthrough->setAudioCallback([&](const float* samples, size_t count) {
+        received.insert(received.end(), samples, samples + count);
+    });
+    CHECK(passthrough->startCapture());
+    std::vector<float> packet(input.begin(), input.begin() + 160);
+    sameDevice->push(packet);
+    CHECK(received == packet);
+
+    bool threw = false;
+    try {
+        createResamplingCapture(nullptr, 16000);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+} // anonymous namespace
+
+int main() {
+    micmap::common::Logger::getLogger()->setMinLevel(micmap::common::LogLevel::Warning);
+
+    testRates();
+    testBlocksAndKernels();
+    testCapture();
+
+    return TEST_RESULT("Resampler tests");
+}
@@ -0,0 +1,114 @@
+/**
+ * @file test_rolling_stats.cpp
+ * @brief Tests for the detector's rolling energy statistics and hit window
+ *
+ * Compares the rolling mean and variance with a two-pass computation over
+ * the same window for a long stream, and the hit count with a plain count
+ * of the last frames.
+ */
+
+#include "micmap/detection/rolling_stats.hpp"
+#include "micmap/common/logger.hpp"
+#include "test_common.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <random>
+
+using namespace micmap::detection;
+
+namespace {
+
+void testRollingStats() {
+    RollingStats empty(10);
+    CHECK_EQ(empty.capacity(), size_t(10));
+    CHECK_EQ(empty.count(), size_t(0));
+    CHECK_EQ(empty.mean(), 0.0);
+    CHECK_EQ(empty.variance(), 0.0);
+    CHECK_EQ(RollingStats(0).capacity(), size_t(1));
+
+    // Hop energies spanning several decades, as the detector sees them
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> exponent(-6.0f, 0.0f);
+    for (size_t capacity : {size_t(1), size_t(3), size_t(10), size_t(37)}) {
+        RollingStats stats(capacity);
+        std::deque<float> window;
+        double maxMeanError = 0.0;
+        double maxVarianceError = 0.0;
+        for (int i = 0; i < 100000; ++i) {
+            float value = std::pow(10.0f, exponent(rng));
+            stats.add(value);
+            window.push_back(value);
+            if (window.size() > capacity) {
+                window.pop_front();
+            }
+            CHECK_EQ(stats.count(), window.size());
+
+            double mean = 0.0;
+            for (float v : window) {
+                mean += v;
+            }
+            mean /= static_cast<double>(window.size());
+            double variance = 0.0;
+            for (float v : window) {
+                variance += (v - mean) * (v - mean);
+            }
+            variance /= static_cast<double>(window.size());
+
+            maxMeanError = std::max(maxMeanError, std::fabs(stats.mean() - mean) / mean);
+            maxVarianceError = std::max(maxVarianceError,
+                                        std::fabs(stats.variance() - variance) / (mean * mean));
+        }
+        // Relative to the window's level, whatever came before it
+        CHECK(maxMeanError < 1e-9);
+        CHECK(maxVarianceError < 1e-8);
+    }
+
+    RollingStats stats(4);
+    for (float v : {1.0f, 2.0f, 3.0f, 4.0f, 5.0f}) {
+        stats.add(v);
+    }
+    CHECK_NEAR(stats.mean(), 3.5, 1e-12);
+    CHECK_NEAR(stats.variance(), 1.25, 1e-12);
+    stats.reset();
+    CHECK_EQ(stats.count(), size_t(0));
+    stats.add(7.0f);
+    CHECK_EQ(stats.mean(), 7.0);
+    CHECK_EQ(stats.variance(), 0.0);
+}
+
+void testHitWindow() {
+    CHECK_EQ(HitWindow(0).length(), size_t(1));
+    CHECK_EQ(HitWindow(100).length(), HitWindow::MAX_LENGTH);
+
+    std::mt19937 rng(2);
+    std::bernoulli_distribution hit(0.3);
+    for (size_t length : {size_t(1), size_t(12), size_t(63), size_t(64)}) {
+        HitWindow window(length);
+        CHECK_EQ(window.count(), 0);
+        std::deque<bool> frames;
+        for (int i = 0; i < 1000; ++i) {
+            bool h = hit(rng);
+            window.push(h);
+            frames.push_back(h);
+            if (frames.size() > length) {
+                frames.pop_front();
+            }
+            CHECK_EQ(window.count(), static_cast<int>(std::count(frames.begin(), frames.end(), true)));
+        }
+        window.reset();
+        CHECK_EQ(window.count(), 0);
+    }
+}
+
+} // anonymous namespace
+
+int main() {
+    micmap::common::Logger::getLogger()->setMinLevel(micmap::common::LogLevel::Warning);
+
+    testRollingStats();
+    testHitWindow();
+
+    return TEST_RESULT("Rolling statistics tests");
+}
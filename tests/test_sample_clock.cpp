@@ -0,0 +1,147 @@
+/**
+ * @file test_sample_clock.cpp
+ * @brief Tests for sample-driven time in the clock, trainer and detector
+ *
+ * Verifies exact sample-to-time conversion and that detector and trainer
+ * timing follows the audio fed in rather than the wall clock.
+ */
+
+#include "micmap/common/types.hpp"
+#include "micmap/common/logger.hpp"
+#include "micmap/detection/noise_detector.hpp"
+#include "micmap/detection/pattern_trainer.hpp"
+#include "test_common.hpp"
+#include "test_recordings.hpp"
+
+#include <chrono>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace micmap::detection;
+using micmap::common::SampleClock;
+using micmap::common::Timestamp;
+using micmap::test::makeTrainedDetector;
+
+namespace {
+
+constexpr uint32_t SAMPLE_RATE = 48000;
+
+void testSampleClock() {
+    using std::chrono::milliseconds;
+    using std::chrono::seconds;
+
+    SampleClock clock(SAMPLE_RATE);
+    CHECK(clock.now() == Timestamp{});
+
+    clock.advance(SAMPLE_RATE);
+    CHECK(clock.now() - Timestamp{} == seconds(1));
+    clock.advance(480);
+    CHECK(clock.now() - Timestamp{} == milliseconds(1010));
+    CHECK_EQ(clock.getSampleCount(), uint64_t(SAMPLE_RATE + 480));
+
+    // A week at 44.1 kHz converts without drift
+    SampleClock week(44100);
+    week.advance(uint64_t(44100) * 3600 * 24 * 7);
+    CHECK(week.now() - Timestamp{} == std::chrono::hours(24 * 7));
+
+    clock.reset();
+    CHECK(clock.now() == Timestamp{});
+}
+
+/**
+ * @brief Quiet room, touch spike, then 1.5 s of covered mic
+ */
+std::vector<float> makeRecording() {
+    return micmap::test::RecordingBuilder(5).quiet(0.5).spike().covered(1.5).take();
+}
+
+std::vector<bool> replay(INoiseDetector& detector, const std::vector<float>& recording,
+                         size_t packetSize) {
+    std::vector<bool> decisions;
+    std::vector<DetectionResult> frames(packetSize);
+    for (size_t offset = 0; offset < recording.size(); offset += packetSize) {
+        size_t count = std::min(packetSize, recording.size() - offset);
+        size_t written = detector.analyzeInto(recording.data() + offset, count,
+                                              frames.data(), frames.size());
+        for (size_t i = 0; i < written; ++i) {
+            decisions.push_back(frames[i].isWhiteNoise);
+        }
+    }
+    return decisions;
+}
+
+size_t countDetections(const std::vector<bool>& decisions) {
+    size_t count = 0;
+    for (bool detected : decisions) {
+        count += detected ? 1 : 0;
+    }
+    return count;
+}
+
+void testDetectorSampleTime() {
+    auto recording = makeRecording();
+    NoiseDetectorConfig config;
+    config.sampleRate = SAMPLE_RATE;
+
+    // The default clock counts analysed samples: decisions do not depend on
+    // how the audio is split into packets
+    auto small = makeTrainedDetector(config);
+    small->setMinDetectionDuration(300);
+    auto large = makeTrainedDetector(config);
+    large->setMinDetectionDuration(300);
+    auto smallDecisions = replay(*small, recording, 480);
+    auto largeDecisions = replay(*large, recording, 4096);
+    CHECK(smallDecisions == largeDecisions);
+    CHECK(countDetections(smallDecisions) > 0);
+
+    // The first confirmation comes 300 ms of audio after detection starts,
+    // so not before spike + 300 ms
+    size_t firstDetected = 0;
+    while (firstDetected < smallDecisions.size() && !smallDecisions[firstDetected]) {
+        ++firstDetected;
+    }
+    double firstSec = static_cast<double>((firstDetected + 1) * config.hopSize) / SAMPLE_RATE;
+    CHECK(firstSec >= 0.8);
+
+    // A shared clock that nobody advances freezes time, so the duration
+    // requirement is never met
+    auto frozen = std::make_shared<SampleClock>(SAMPLE_RATE);
+    config.clock = frozen;
+    auto stalled = makeTrainedDetector(config);
+    stalled->setMinDetectionDuration(300);
+    CHECK_EQ(countDetections(replay(*stalled, recording, 480)), size_t(0));
+}
+
+void testTrainerSampleInterval() {
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> noise(-0.5f, 0.5f);
+    std::vector<float> chunk(2048);
+    for (float& s : chunk) {
+        s = noise(rng);
+    }
+
+    // 2048 samples are 42.7 ms, so a 100 ms interval keeps every third chunk
+    TrainingConfig config;
+    config.minSamples = 1;
+    PatternTrainer trainer(createSpectralAnalyzer(SAMPLE_RATE, 2048, FFTBackendType::Auto), config);
+    trainer.startTraining();
+    for (int i = 0; i < 12; ++i) {
+        trainer.addSample(chunk.data(), chunk.size());
+    }
+    CHECK_EQ(trainer.getStats().samplesCollected, size_t(4));
+    CHECK(trainer.finishTraining());
+    CHECK(trainer.getStats().duration == std::chrono::milliseconds(512));
+}
+
+} // anonymous namespace
+
+int main() {
+    micmap::common::Logger::getLogger()->setMinLevel(micmap::common::LogLevel::Warning);
+
+    testSampleClock();
+    testDetectorSampleTime();
+    testTrainerSampleInterval();
+
+    return TEST_RESULT("Sample clock tests");
+}
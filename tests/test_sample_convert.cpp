@@ -0,0 +1,165 @@
+/**
+ * @file test_sample_convert.cpp
+ * @brief Bit-exactness tests for the SIMD sample conversion kernels
+ *
+ * Every kernel level available on the build machine is compared bit for bit
+ * against the scalar reference over all formats, common channel layouts and
+ * frame counts that exercise the vector tails.
+ */
+
+#include "micmap/audio/sample_convert.hpp"
+#include "test_common.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+using micmap::audio::SampleFormat;
+using micmap::audio::bytesPerSample;
+using micmap::audio::convertToMono;
+using micmap::common::SimdLevel;
+using micmap::common::isSimdLevelSupported;
+using micmap::common::simdLevelToString;
+
+namespace {
+
+/**
+ * @brief Build random interleaved input, salted with edge-case values
+ */
+std::vector<uint8_t> makeInput(SampleFormat format, size_t samples, std::mt19937& rng) {
+    const size_t bytes = bytesPerSample(format);
+    std::vector<uint8_t> data(samples * bytes + 16);
+    std::uniform_int_distribution<uint32_t> bits;
+
+    for (size_t i = 0; i < samples; ++i) {
+        uint8_t* out = data.data() + i * bytes;
+        uint32_t raw = bits(rng);
+
+        switch (format) {
+            case SampleFormat::Float32: {
+                static const float specials[] = {
+                    0.0f, -0.0f, 1.0f, -1.0f, 1e-40f, -1e-40f,
+                    std::numeric_limits<float>::min(), 0.999999f
+                };
+                float value = (i % 13 == 0)
+                    ? specials[(i / 13) % 8]
+                    : std::uniform_real_distribution<float>(-1.5f, 1.5f)(rng);
+                std::memcpy(out, &value, sizeof(value));
+                break;
+            }
+            case SampleFormat::Int16: {
+                static const int16_t specials[] = {0, -1, 1, INT16_MIN, INT16_MAX};
+                int16_t value = (i % 11 == 0) ? specials[(i / 11) % 5]
+                                              : static_cast<int16_t>(raw);
+                std::memcpy(out, &value, sizeof(value));
+                break;
+            }
+            case SampleFormat::Int24: {
+                static const uint32_t specials[] = {0x000000, 0xFFFFFF, 0x800000, 0x7FFFFF, 0x000001};
+                uint32_t value = (i % 11 == 0) ? specials[(i / 11) % 5] : raw;
+                out[0] = static_cast<uint8_t>(value);
+                out[1] = static_cast<uint8_t>(value >> 8);
+                out[2] = static_cast<uint8_t>(value >> 16);
+                break;
+            }
+            case SampleFormat::Int32: {
+                static const int32_t specials[] = {0, -1, 1, INT32_MIN, INT32_MAX, 0x7FFFFFC0};
+                int32_t value = (i % 11 == 0) ? specials[(i / 11) % 6]
+                                              : static_cast<int32_t>(raw);
+                std::memcpy(out, &value, sizeof(value));
+                break;
+            }
+            default:
+                break;
+        }
+    }
+    return data;
+}
+
+void testBitExactness() {
+    const SampleFormat formats[] = {
+        SampleFormat::Float32, SampleFormat::Int16, SampleFormat::Int24, SampleFormat::Int32
+    };
+    const uint16_t channelCounts[] = {1, 2, 3, 4, 6, 8};
+    const size_t frameCounts[] = {1, 3, 7, 8, 17, 480, 1031, 4099};
+    const SimdLevel levels[] = {SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::NEON};
+
+    std::mt19937 rng(1234);
+
+    for (SimdLevel level : levels) {
+        if (!isSimdLevelSupported(level)) {
+            std::cout << "  " << simdLevelToString(level) << ": not supported, skipped\n";
+            continue;
+        }
+        std::cout << "  " << simdLevelToString(level) << ": checking\n";
+
+        for (SampleFormat format : formats) {
+            for (uint16_t channels : channelCounts) {
+                for (size_t frames : frameCounts) {
+                    auto input = makeInput(format, frames * channels, rng);
+                    std::vector<float> reference(frames, -7.0f);
+                    std::vector<float> actual(frames, 7.0f);
+
+                    convertToMono(format, input.data(), frames, channels,
+                                  reference.data(), SimdLevel::Scalar);
+                    convertToMono(format, input.data(), frames, channels,
+                                  actual.data(), level);
+
+                    bool identical = std::memcmp(reference.data(), actual.data(),
+                                                 frames * sizeof(float)) == 0;
+                    if (!identical) {
+                        std::cerr << "Mismatch: level=" << simdLevelToString(level)
+                                  << " format=" << static_cast<int>(format)
+                                  << " channels=" << channels
+                                  << " frames=" << frames << "\n";
+                    }
+                    CHECK(identical);
+                }
+            }
+        }
+    }
+}
+
+void testKnownValues() {
+    // Stereo int16: average of full-scale negative and zero
+    const int16_t stereo[] = {INT16_MIN, 0, 16384, 16384};
+    float out[2] = {};
+    convertToMono(SampleFormat::Int16, stereo, 2, 2, out);
+    CHECK_EQ(out[0], -0.5f);
+    CHECK_EQ(out[1], 0.5f);
+
+    // 24-bit sign extension
+    const uint8_t packed[] = {0x00, 0x00, 0x80, 0xFF, 0xFF, 0x7F};
+    convertToMono(SampleFormat::Int24, packed, 2, 1, out);
+    CHECK_EQ(out[0], -1.0f);
+    CHECK_NEAR(out[1], 1.0f, 1e-6);
+
+    // Unknown formats and zero channels produce silence
+    convertToMono(SampleFormat::Unknown, packed, 2, 1, out);
+    CHECK_EQ(out[0], 0.0f);
+    out[0] = 1.0f;
+    convertToMono(SampleFormat::Float32, packed, 1, 0, out);
+    CHECK_EQ(out[0], 0.0f);
+
+    // Deinterleaving keeps each channel, one after the other
+    float planar[4] = {};
+    deinterleave(SampleFormat::Int16, stereo, 2, 2, planar);
+    CHECK_EQ(planar[0], -1.0f);
+    CHECK_EQ(planar[1], 0.5f);
+    CHECK_EQ(planar[2], 0.0f);
+    CHECK_EQ(planar[3], 0.5f);
+}
+
+} // anonymous namespace
+
+int main() {
+    std::cout << "Default conversion kernel: "
+              << simdLevelToString(micmap::audio::getConversionSimdLevel()) << "\n";
+
+    testBitExactness();
+    testKnownValues();
+
+    return TEST_RESULT("Sample conversion tests");
+}
@@ -0,0 +1,262 @@
+/**
+ * @file test_sliding_dft.cpp
+ * @brief Tests for the sparse-bin sliding DFT and idle monitoring
+ *
+ * Compares the tracked bins with the FFT analyzer over long streams, checks
+ * the discriminative bin selection, and runs the detector with idle frames
+ * matched on the monitor bins.
+ */
+
+#include "micmap/detection/sliding_dft.hpp"
+#include "micmap/detection/noise_detector.hpp"
+#include "micmap/detection/streaming_stft.hpp"
+#include "micmap/common/logger.hpp"
+#include "test_common.hpp"
+#include "test_recordings.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace micmap::detection;
+using micmap::common::SimdLevel;
+using micmap::test::touchAndCover;
+using micmap::test::makeTrainedDetector;
+
+namespace {
+
+constexpr uint32_t SAMPLE_RATE = 48000;
+
+/**
+ * @brief Largest difference between tracked and FFT magnitudes over a stream
+ *
+ * The FFT analyzer uses a symmetric Hann window and the sliding DFT the
+ * periodic one, so the bins agree to about 1/fftSize of the spectrum level.
+ */
+float maxDifference(SlidingDFTAnalyzer& sliding, ISpectralAnalyzer& fft,
+                    const std::vector<float>& stream, float& level) {
+    StreamingSTFT stft(sliding.getFFTSize(), sliding.getHopSize());
+    std::vector<float> slidingMagnitudes(fft.getNumBins());
+    std::vector<float> fftMagnitudes(fft.getNumBins());
+    std::vector<float> tracked(sliding.getBins().size());
+    float maxDiff = 0.0f;
+    level = 0.0f;
+    stft.process(stream.data(), stream.size(), [&](const float* frame, const float*) {
+        SpectralFeatures features = sliding.analyzeInto(frame, sliding.getFFTSize(),
+                                                        slidingMagnitudes.data(), slidingMagnitudes.size());
+        CHECK_NEAR(features.energy, fft.analyzeInto(frame, fft.getFFTSize(), fftMagnitudes.data(),
+                                                    fftMagnitudes.size()).energy, 1e-6);
+        sliding.getBinMagnitudes(tracked.data());
+        for (size_t i = 0; i < sliding.getBins().size(); ++i) {
+            size_t bin = sliding.getBins()[i];
+            CHECK_EQ(tracked[i], slidingMagnitudes[bin]);
+            maxDiff = std::max(maxDiff, std::abs(slidingMagnitudes[bin] - fftMagnitudes[bin]));
+            level = std::max(level, fftMagnitudes[bin]);
+        }
+        // Bins that are not tracked stay zero
+        CHECK_EQ(slidingMagnitudes[0], 0.0f);
+    });
+    return maxDiff;
+}
+
+void testMatchesFFT() {
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> noise(-1.0f, 1.0f);
+
+    // Ten seconds of tones over noise: enough hops for any drift to show
+    std::vector<float> stream(SAMPLE_RATE * 10);
+    for (size_t i = 0; i < stream.size(); ++i) {
+        float t = static_cast<float>(i) / SAMPLE_RATE;
+        stream[i] = 0.3f * std::sin(2.0f * 3.14159265f * 1000.0f * t) +
+                    0.1f * std::sin(2.0f * 3.14159265f * 7321.0f * t) + 0.05f * noise(rng);
+    }
+
+    struct Case {
+        size_t fftSize;
+        size_t hopSize;
+        std::vector<size_t> bins;
+    };
+    const Case cases[] = {
+        {2048, 512, {1, 2, 3, 43, 44, 312, 1000, 1023}},    // Adjacent bins share neighbours
+        {1024, 256, {21, 156, 400}},
+        {512, 512, {5, 11, 78}},                            // No overlap
+    };
+
+    for (const Case& c : cases) {
+        auto fft = createSpectralAnalyzer(SAMPLE_RATE, c.fftSize, FFTBackendType::Auto);
+        for (SimdLevel simd : {SimdLevel::Scalar, getSpectralFeatureSimdLevel()}) {
+            SlidingDFTAnalyzer sliding(SAMPLE_RATE, c.fftSize, c.hopSize, c.bins, simd);
+            CHECK(sliding.getBins() == c.bins);
+            float level = 0.0f;
+            float diff = maxDifference(sliding, *fft, stream, level);
+            CHECK(level > 0.1f);
+            CHECK(diff < 4.0f * level / static_cast<float>(c.fftSize));
+        }
+    }
+
+    // After a jump in the stream, reset() transforms the next frame in full
+    SlidingDFTAnalyzer sliding(SAMPLE_RATE, 2048, 512, {43, 312});
+    auto fft = createSpectralAnalyzer(SAMPLE_RATE, 2048, FFTBackendType::Auto);
+    std::vector<float> slidingMagnitudes(1025);
+    std::vector<float> fftMagnitudes(1025);
+    sliding.analyzeInto(stream.data(), 2048, slidingMagnitudes.data(), slidingMagnitudes.size());
+    sliding.reset();
+    sliding.analyzeInto(stream.data() + 100000, 2048, slidingMagnitudes.data(), slidingMagnitudes.size());
+    fft->analyzeInto(stream.data() + 100000, 2048, fftMagnitudes.data(), fftMagnitudes.size());
+    CHECK_NEAR(slidingMagnitudes[43], fftMagnitudes[43], 1e-3);
+    CHECK_NEAR(slidingMagnitudes[312], fftMagnitudes[312], 1e-3);
+
+    auto throws = [](size_t fftSize, size_t hopSize, std::vector<size_t> bins) {
+        try {
+            SlidingDFTAnalyzer analyzer(SAMPLE_RATE, fftSize, hopSize, bins);
+            return false;
+        } catch (const std::invalid_argument&) {
+            return true;
+        }
+    };
+    CHECK(!throws(2048, 512, {1, 1023}));
+    CHECK(throws(2048, 500, {10}));
+    CHECK(throws(2048, 0, {10}));
+    CHECK(throws(2048, 512, {}));
+    CHECK(throws(2048, 512, {0}));
+    CHECK(throws(2048, 512, {1024}));
+}
+
+void testSelectBins() {
+    // A smooth slope with a mild bump, two standout bins, one quiet bin
+    // and a loud but noisy one
+    std::vector<float> logMean(64);
+    std::vector<float> logVariance(64, 0.1f);
+    for (size_t i = 0; i < logMean.size(); ++i) {
+        logMean[i] = -0.01f * static_cast<float>(i) + (i >= 20 && i < 26 ? 0.5f : 0.0f);
+    }
+    logMean[10] = 3.0f;
+    logMean[11] = 2.9f;
+    logMean[40] = -3.0f;
+    logMean[50] = 5.0f;
+    logVariance[50] = 100.0f;
+    logMean[0] = 50.0f;     // DC is never picked
+
+    auto bins = selectDiscriminativeBins(logMean, logVariance, 4);
+    CHECK_EQ(bins.size(), size_t(4));
+    CHECK(std::is_sorted(bins.begin(), bins.end()));
+    CHECK(std::find(bins.begin(), bins.end(), 10) != bins.end());
+    CHECK(std::find(bins.begin(), bins.end(), 40) != bins.end());
+    CHECK(std::find(bins.begin(), bins.end(), 11) == bins.end());  // Too close to 10
+    CHECK(std::find(bins.begin(), bins.end(), 50) == bins.end());  // Too variable
+    for (size_t i = 0; i < bins.size(); ++i) {
+        CHECK(bins[i] >= 1 && bins[i] <= 62);
+        if (i > 0) {
+            CHECK(bins[i] - bins[i - 1] >= 2);
+        }
+    }
+
+    // No variances weigh every bin alike; fewer candidates than asked
+    CHECK_EQ(selectDiscriminativeBins(logMean, {}, 100).size(), size_t(31));
+    CHECK(selectDiscriminativeBins(logMean, logVariance, 0).empty());
+    CHECK(selectDiscriminativeBins({1.0f, 2.0f}, {}, 4).empty());
+}
+
+/**
+ * @brief Replay the fixture; returns the detected frames and the mean
+ *        profile match over the covered part and over the tone
+ */
+size_t replay(INoiseDetector& detector, const std::vector<float>& fixture, size_t hopSize,
+              float& coveredMatch, float& toneMatch) {
+    size_t detected = 0;
+    size_t coveredFrames = 0;
+    size_t toneFrames = 0;
+    coveredMatch = 0.0f;
+    toneMatch = 0.0f;
+    DetectionResult results[4];
+    size_t frame = 0;
+    for (size_t offset = 0; offset + 480 <= fixture.size(); offset += 480) {
+        size_t n = detector.analyzeInto(fixture.data() + offset, 480, results, 4);
+        for (size_t i = 0; i < n; ++i, ++frame) {
+            double t = static_cast<double>((frame + 1) * hopSize) / SAMPLE_RATE;
+            if (t >= 1.2 && t < 3.1) {
+                coveredMatch += results[i].correlation;
+                ++coveredFrames;
+            } else if (t >= 4.2) {
+                toneMatch += results[i].correlation;
+                ++toneFrames;
+            }
+            detected += results[i].isWhiteNoise ? 1 : 0;
+        }
+    }
+    coveredMatch /= static_cast<float>(std::max<size_t>(coveredFrames, 1));
+    toneMatch /= static_cast<float>(std::max<size_t>(toneFrames, 1));
+    return detected;
+}
+
+void testMonitor() {
+    // Covered mic, then a tone that must not trigger
+    auto fixture = touchAndCover(12).tone(2.0, 0.01f).take();
+
+    for (ProfileMatch match : {ProfileMatch::Correlation, ProfileMatch::Mahalanobis}) {
+        NoiseDetectorConfig config;
+        config.sampleRate = SAMPLE_RATE;
+        config.profileMatch = match;
+        auto full = makeTrainedDetector(config);
+        float fullCovered = 0.0f;
+        float fullTone = 0.0f;
+        size_t fullDetected = replay(*full, fixture, config.hopSize, fullCovered, fullTone);
+
+        config.monitor.enabled = true;
+        config.monitor.bins = 16;
+        auto monitored = makeTrainedDetector(config);
+        float covered = 0.0f;
+        float tone = 0.0f;
+        size_t detected = replay(*monitored, fixture, config.hopSize, covered, tone);
+
+        // The spike switches to the full match, so detection is unchanged
+        CHECK(detected > 0);
+        CHECK_EQ(detected, fullDetected);
+        CascadeStats stats = monitored->getCascadeStats();
+        CHECK_EQ(stats.energyOnly + stats.reused + stats.monitored + stats.analyzed, stats.frames);
+        CHECK(stats.monitored > stats.frames / 2);
+
+        // Without a spike every frame is monitored, and the sparse match
+        // still tells the covered mic from the tone
+        config.thresholds.spikeThresholdDb = 1.0f;
+        auto idle = makeTrainedDetector(config);
+        CHECK_EQ(replay(*idle, fixture, config.hopSize, covered, tone), size_t(0));
+        CHECK_EQ(idle->getCascadeStats().monitored, idle->getCascadeStats().frames);
+        CHECK(covered > 0.5f);
+        CHECK(tone < 0.5f * covered);
+    }
+
+    auto throws = [](NoiseDetectorConfig config) {
+        try {
+            createFFTDetector(config);
+            return false;
+        } catch (const std::invalid_argument&) {
+            return true;
+        }
+    };
+    NoiseDetectorConfig config;
+    config.monitor.enabled = true;
+    CHECK(!throws(config));
+    config.hopSize = 500;
+    CHECK(throws(config));
+    config.hopSize = 512;
+    config.filterbank.enabled = true;
+    CHECK(throws(config));
+    config.filterbank.enabled = false;
+    config.monitor.bins = 0;
+    CHECK(throws(config));
+}
+
+} // anonymous namespace
+
+int main() {
+    micmap::common::Logger::getLogger()->setMinLevel(micmap::common::LogLevel::Warning);
+
+    testMatchesFFT();
+    testSelectBins();
+    testMonitor();
+
+    return TEST_RESULT("Sliding DFT tests");
+}
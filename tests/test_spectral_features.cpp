@@ -0,0 +1,450 @@
+/**
+ * @file test_spectral_features.cpp
+ * @brief Accuracy tests for the vectorized spectral feature kernels
+ *
+ * Checks the polynomial logarithm's error bound and compares every SIMD kernel
+ * against the exact Scalar reference. It also replays synthetic fixture
+ * signals through the detector to show that per-frame detection decisions
+ * match the reference kernels, and checks the per-bin variance profile
+ * match, its file format and batched matching against several profiles.
+ */
+
+#include "micmap/detection/noise_detector.hpp"
+#include "micmap/detection/spectral_features.hpp"
+#include "test_common.hpp"
+#include "test_recordings.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <vector>
+
+using namespace micmap::detection;
+using micmap::common::SimdLevel;
+using micmap::test::coveredTraining;
+using micmap::test::touchAndCover;
+using micmap::test::makeTrainedDetector;
+
+namespace {
+
+constexpr uint32_t SAMPLE_RATE = 48000;
+
+std::vector<SimdLevel> availableSimdLevels() {
+    std::vector<SimdLevel> levels;
+    for (SimdLevel level : {SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::NEON}) {
+        SimdLevel resolved = getSpectralFeatureKernels(level).level;
+        if (resolved != SimdLevel::Scalar &&
+            std::find(levels.begin(), levels.end(), resolved) == levels.end()) {
+            levels.push_back(resolved);
+        }
+    }
+    return levels;
+}
+
+void testFastLog() {
+    // Sweep several decades including the ranges seen for magnitudes
+    double maxError = 0.0;
+    for (double x = 1e-12; x < 1e4; x *= 1.0007) {
+        float value = static_cast<float>(x);
+        double exact = std::log(static_cast<double>(value));
+        double error = std::fabs(static_cast<double>(fastLog(value)) - exact);
+        maxError = std::max(maxError, error / std::max(1.0, std::fabs(exact)));
+    }
+    CHECK(maxError < 2e-7);
+
+    CHECK_EQ(fastLog(1.0f), 0.0f);
+    CHECK(std::isfinite(fastLog(0.0f)));
+}
+
+void testKernelsMatchReference(SimdLevel level) {
+    const SpectralFeatureKernels& reference = getSpectralFeatureKernels(SimdLevel::Scalar);
+    const SpectralFeatureKernels& kernels = getSpectralFeatureKernels(level);
+    CHECK(reference.level == SimdLevel::Scalar);
+    CHECK(kernels.level == level);
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> bins(-0.05f, 0.05f);
+    std::uniform_real_distribution<float> mags(0.0f, 0.02f);
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+
+    // Sizes cover full vectors, every tail length and the 2048-point FFT
+    for (size_t count : {size_t(1), size_t(7), size_t(64), size_t(1023), size_t(1025)}) {
+        std::vector<float> complexBins(count * 2);
+        for (float& v : complexBins) {
+            v = bins(rng);
+        }
+        std::vector<float> expected(count), actual(count);
+        reference.magnitudes(complexBins.data(), count, 0.001f, expected.data());
+        kernels.magnitudes(complexBins.data(), count, 0.001f, actual.data());
+        CHECK(expected == actual);
+
+        std::vector<float> spectrum(count), profile(count);
+        for (size_t i = 0; i < count; ++i) {
+            spectrum[i] = mags(rng);
+            profile[i] = mags(rng) + 0.5f * spectrum[i];
+        }
+        // Silent bins must be skipped the same way
+        spectrum[0] = 0.0f;
+
+        CHECK_NEAR(kernels.meanSquare(spectrum.data(), count),
+                   reference.meanSquare(spectrum.data(), count), 1e-6 * 4e-4);
+        CHECK_NEAR(kernels.flatness(spectrum.data(), count),
+                   reference.flatness(spectrum.data(), count), 1e-5);
+        CHECK_NEAR(kernels.centroid(spectrum.data(), count),
+                   reference.centroid(spectrum.data(), count), 1e-4 * count);
+
+        float mean = 0.0f;
+        for (float p : profile) {
+            mean += p;
+        }
+        mean /= static_cast<float>(count);
+        std::vector<float> centered(count), logCentered(count);
+        float sumSq = 0.0f;
+        float logMean = 0.0f;
+        for (size_t i = 0; i < count; ++i) {
+            centered[i] = profile[i] - mean;
+            sumSq += centered[i] * centered[i];
+            logCentered[i] = std::log(profile[i] + 1e-10f);
+            logMean += logCentered[i];
+        }
+        logMean /= static_cast<float>(count);
+        for (float& v : logCentered) {
+            v -= logMean;
+        }
+
+        CHECK_NEAR(kernels.correlation(spectrum.data(), centered.data(), sumSq, count),
+                   reference.correlation(spectrum.data(), centered.data(), sumSq, count), 1e-5);
+
+        std::vector<float> scratch(count);
+        float expectedMse = reference.logShapeMse(spectrum.data(), logCentered.data(),
+                                                  count, scratch.data());
+        float actualMse = kernels.logShapeMse(spectrum.data(), logCentered.data(),
+                                              count, scratch.data());
+        CHECK_NEAR(actualMse, expectedMse, 1e-4 * std::max(1.0f, expectedMse));
+
+        // Log-domain model of the profile with a spread of variances
+        std::vector<float> logMeans(count), inverseVariance(count);
+        float inverseVarianceSum = 0.0f;
+        for (size_t i = 0; i < count; ++i) {
+            logMeans[i] = std::log(profile[i] + 1e-10f);
+            inverseVariance[i] = 1.0f / (0.05f + 0.5f * dist(rng));
+            inverseVarianceSum += inverseVariance[i];
+        }
+        float expectedDistance = reference.logMahalanobis(spectrum.data(), logMeans.data(),
+                                                          inverseVariance.data(),
+                                                          inverseVarianceSum, count);
+        float actualDistance = kernels.logMahalanobis(spectrum.data(), logMeans.data(),
+                                                      inverseVariance.data(),
+                                                      inverseVarianceSum, count);
+        CHECK_NEAR(actualDistance, expectedDistance, 1e-4 * std::max(1.0f, expectedDistance));
+
+        std::vector<float> expectedLogs(count), actualLogs(count);
+        float expectedLogMean = reference.logSpectrum(spectrum.data(), count, expectedLogs.data());
+        float actualLogMean = kernels.logSpectrum(spectrum.data(), count, actualLogs.data());
+        CHECK_NEAR(actualLogMean, expectedLogMean, 1e-5 * std::max(1.0f, std::fabs(expectedLogMean)));
+        for (size_t i = 0; i < count; ++i) {
+            CHECK_NEAR(actualLogs[i], expectedLogs[i], 1e-5 * std::max(1.0f, std::fabs(expectedLogs[i])));
+        }
+
+        // Seven rows cover a full block of four and every leftover row
+        constexpr size_t ROWS = 7;
+        const size_t stride = count + 3;
+        std::vector<float> matrix(ROWS * stride);
+        for (float& v : matrix) {
+            v = dist(rng) - 0.5f;
+        }
+        std::vector<float> expectedDots(ROWS), actualDots(ROWS);
+        reference.dotRows(matrix.data(), ROWS, stride, spectrum.data(), count, expectedDots.data());
+        kernels.dotRows(matrix.data(), ROWS, stride, spectrum.data(), count, actualDots.data());
+        for (size_t r = 0; r < ROWS; ++r) {
+            CHECK_NEAR(actualDots[r], expectedDots[r], 1e-6 * static_cast<double>(count));
+        }
+
+        // A few frames of two partly correlated channels through the smoothing
+        std::vector<float> first(count * 2), second(count * 2);
+        std::vector<float> expectedState(count * 4, 0.0f), actualState(count * 4, 0.0f);
+        for (int frame = 0; frame < 3; ++frame) {
+            for (size_t i = 0; i < count * 2; ++i) {
+                first[i] = bins(rng);
+                second[i] = 0.5f * first[i] + bins(rng);
+            }
+            float expectedCoherence = reference.coherence(first.data(), second.data(), count, 0.7f,
+                                                          expectedState.data());
+            float actualCoherence = kernels.coherence(first.data(), second.data(), count, 0.7f,
+                                                      actualState.data());
+            CHECK_NEAR(actualCoherence, expectedCoherence, 1e-5);
+            CHECK(expectedCoherence >= 0.0f && expectedCoherence <= 1.0f);
+        }
+        for (size_t i = 0; i < expectedState.size(); ++i) {
+            CHECK_NEAR(actualState[i], expectedState[i], 1e-6);
+        }
+    }
+
+    // The fitted level makes the distance gain invariant
+    constexpr size_t BINS = 64;
+    std::vector<float> values(BINS), logMeans(BINS), inverseVariance(BINS, 2.0f);
+    for (size_t i = 0; i < BINS; ++i) {
+        values[i] = 0.01f + dist(rng);
+        logMeans[i] = std::log(values[i] + 1e-10f) + 1.5f;
+    }
+    CHECK_NEAR(kernels.logMahalanobis(values.data(), logMeans.data(), inverseVariance.data(),
+                                      2.0f * BINS, BINS), 0.0f, 1e-4);
+    CHECK_EQ(kernels.logMahalanobis(values.data(), logMeans.data(), inverseVariance.data(),
+                                    0.0f, BINS), 0.0f);
+}
+
+std::vector<DetectionResult> replay(INoiseDetector& detector, const std::vector<float>& fixture) {
+    constexpr size_t PACKET = 480;
+    std::vector<DetectionResult> frames;
+    DetectionResult packetResults[PACKET / 512 + 1];
+    for (size_t offset = 0; offset + PACKET <= fixture.size(); offset += PACKET) {
+        size_t n = detector.analyzeInto(fixture.data() + offset, PACKET,
+                                         packetResults, PACKET / 512 + 1);
+        frames.insert(frames.end(), packetResults, packetResults + n);
+    }
+    return frames;
+}
+
+/**
+ * @brief Covered mic, then music: a tone with its third harmonic
+ */
+std::vector<float> makeFixture(uint32_t seed) {
+    return touchAndCover(seed).tone(2.0, 0.01f, 0.1f).take();
+}
+
+std::vector<DetectionResult> replay(SimdLevel level, const std::vector<float>& training,
+                                    const std::vector<float>& fixture) {
+    NoiseDetectorConfig config;
+    config.featureLevel = level;
+    auto detector = makeTrainedDetector(config, training);
+    return replay(*detector, fixture);
+}
+
+/**
+ * @brief Mean profile match over the fixture frames in [beginSec, endSec)
+ */
+float meanCorrelation(const std::vector<DetectionResult>& frames, size_t hopSize,
+                      double beginSec, double endSec) {
+    float sum = 0.0f;
+    size_t count = 0;
+    for (size_t i = 0; i < frames.size(); ++i) {
+        double t = static_cast<double>((i + 1) * hopSize) / SAMPLE_RATE;
+        if (t >= beginSec && t < endSec) {
+            sum += frames[i].correlation;
+            ++count;
+        }
+    }
+    return count > 0 ? sum / static_cast<float>(count) : 0.0f;
+}
+
+void testDecisionsUnchanged(const std::vector<SimdLevel>& levels) {
+    auto training = coveredTraining(11);
+    auto fixture = makeFixture(12);
+
+    auto reference = replay(SimdLevel::Scalar, training, fixture);
+    size_t detections = std::count_if(reference.begin(), reference.end(),
+                                      [](const DetectionResult& r) { return r.isWhiteNoise; });
+    CHECK(detections > 0);
+
+    for (SimdLevel level : levels) {
+        auto frames = replay(level, training, fixture);
+        CHECK_EQ(frames.size(), reference.size());
+        size_t mismatches = 0;
+        for (size_t i = 0; i < std::min(frames.size(), reference.size()); ++i) {
+            if (frames[i].isWhiteNoise != reference[i].isWhiteNoise) {
+                ++mismatches;
+            }
+            CHECK_NEAR(frames[i].confidence, reference[i].confidence, 1e-3);
+            CHECK_NEAR(frames[i].energy, reference[i].energy, 1e-5 * reference[i].energy);
+        }
+        CHECK_EQ(mismatches, size_t(0));
+    }
+}
+
+/**
+ * @brief Muffled cover: low-passed more strongly than coveredTraining()
+ */
+std::vector<float> makeMuffledTraining(uint32_t seed, size_t count) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> noise(-1.0f, 1.0f);
+    std::vector<float> samples(count);
+    float state = 0.0f;
+    for (float& s : samples) {
+        state = 0.95f * state + 0.05f * noise(rng);
+        s = 1.5f * state;
+    }
+    return samples;
+}
+
+void testProfileMatch() {
+    auto training = coveredTraining(11);
+    auto fixture = makeFixture(12);
+    NoiseDetectorConfig config;
+
+    auto trained = makeTrainedDetector(config, training);
+    const TrainingData& data = trained->getTrainingData();
+    CHECK_EQ(data.logMean.size(), data.spectralProfile.size());
+    CHECK_EQ(data.logVariance.size(), data.spectralProfile.size());
+    CHECK(data.logVariance[100] > 0.0f);
+    CHECK(trained->getProfileMatch() == ProfileMatch::Mahalanobis);
+
+    config.profileMatch = ProfileMatch::Correlation;
+    auto correlation = makeTrainedDetector(config, training);
+    CHECK(correlation->getProfileMatch() == ProfileMatch::Correlation);
+
+    // Covered frames (1.6-3.6 s) match the variance model more closely than
+    // the correlation, and tonal frames (4.6-6.6 s) match it less
+    auto variance = replay(*trained, fixture);
+    auto pearson = replay(*correlation, fixture);
+    CHECK(std::any_of(variance.begin(), variance.end(),
+                      [](const DetectionResult& r) { return r.isWhiteNoise; }));
+    CHECK(meanCorrelation(variance, config.hopSize, 1.8, 3.6) >
+          meanCorrelation(pearson, config.hopSize, 1.8, 3.6) + 0.05f);
+    CHECK(meanCorrelation(variance, config.hopSize, 4.8, 6.6) <
+          meanCorrelation(pearson, config.hopSize, 4.8, 6.6));
+
+    // Version 2 files round-trip the log-domain model
+    auto dir = std::filesystem::temp_directory_path();
+    auto v2Path = dir / "micmap_test_profile_v2.mmap";
+    auto v1Path = dir / "micmap_test_profile_v1.mmap";
+    CHECK(trained->saveTrainingData(v2Path));
+
+    auto loaded = createFFTDetector(NoiseDetectorConfig{});
+    CHECK(loaded->loadTrainingData(v2Path));
+    CHECK(loaded->getProfileMatch() == ProfileMatch::Mahalanobis);
+    CHECK(loaded->getTrainingData().logMean == data.logMean);
+    CHECK(loaded->getTrainingData().logVariance == data.logVariance);
+
+    // A version 1 file is the header and the mean profile only
+    {
+        std::ifstream in(v2Path, std::ios::binary);
+        std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        constexpr size_t HEADER_SIZE = 56;
+        CHECK(bytes.size() == HEADER_SIZE + 3 * data.spectralProfile.size() * sizeof(float));
+        uint32_t version = 1;
+        std::memcpy(bytes.data() + 4, &version, sizeof(version));
+        bytes.resize(HEADER_SIZE + data.spectralProfile.size() * sizeof(float));
+        std::ofstream out(v1Path, std::ios::binary);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+    auto legacy = createFFTDetector(NoiseDetectorConfig{});
+    CHECK(legacy->loadTrainingData(v1Path));
+    CHECK(legacy->getProfileMatch() == ProfileMatch::Correlation);
+    CHECK(legacy->getTrainingData().logVariance.empty());
+    CHECK(legacy->getTrainingData().spectralProfile == data.spectralProfile);
+
+    std::filesystem::remove(v2Path);
+    std::filesystem::remove(v1Path);
+}
+
+void testMultipleProfiles() {
+    auto covered = coveredTraining(11);
+    auto muffled = makeMuffledTraining(13, SAMPLE_RATE * 2);
+    auto fixture = makeFixture(12);
+    auto dir = std::filesystem::temp_directory_path();
+    auto coveredPath = dir / "micmap_test_profile_covered.mmap";
+    auto muffledPath = dir / "micmap_test_profile_muffled.mmap";
+    CHECK(makeTrainedDetector(NoiseDetectorConfig{}, muffled)->saveTrainingData(muffledPath));
+
+    for (ProfileMatch match : {ProfileMatch::Mahalanobis, ProfileMatch::Correlation}) {
+        NoiseDetectorConfig config;
+        config.profileMatch = match;
+        auto single = makeTrainedDetector(config, covered);
+        CHECK(single->saveTrainingData(coveredPath));
+        CHECK_EQ(single->getProfileCount(), size_t(1));
+
+        // The same profile twice goes through the batched matrix match and
+        // must score like the single-profile kernels
+        auto twice = createFFTDetector(config);
+        CHECK(twice->addTrainingData(coveredPath));
+        CHECK(twice->addTrainingData(coveredPath));
+        CHECK_EQ(twice->getProfileCount(), size_t(2));
+        CHECK(twice->getProfileMatch() == single->getProfileMatch());
+        auto reference = replay(*single, fixture);
+        auto batched = replay(*twice, fixture);
+        CHECK_EQ(batched.size(), reference.size());
+        size_t mismatches = 0;
+        for (size_t i = 0; i < std::min(batched.size(), reference.size()); ++i) {
+            CHECK_NEAR(batched[i].correlation, reference[i].correlation, 2e-3);
+            mismatches += batched[i].isWhiteNoise != reference[i].isWhiteNoise ? 1 : 0;
+        }
+        CHECK_EQ(mismatches, size_t(0));
+        CHECK(twice->getActiveProfile() == 0);
+
+        // A second, different cover adds matches without losing the first
+        auto both = createFFTDetector(config);
+        CHECK(both->loadTrainingData(coveredPath));
+        CHECK(both->addTrainingData(muffledPath));
+        auto frames = replay(*both, fixture);
+        CHECK(std::any_of(frames.begin(), frames.end(),
+                          [](const DetectionResult& r) { return r.isWhiteNoise; }));
+        CHECK(both->getActiveProfile() >= 0);
+
+        // Muffled audio is matched and scored by its own profile
+        auto muffledAudio = makeMuffledTraining(14, SAMPLE_RATE);
+        replay(*both, muffledAudio);
+        CHECK_EQ(both->getActiveProfile(), 1);
+        auto muffledFrames = replay(*both, muffledAudio);
+        auto coveredOnly = replay(*single, muffledAudio);
+        CHECK(meanCorrelation(muffledFrames, config.hopSize, 0.2, 1.0) >
+              meanCorrelation(coveredOnly, config.hopSize, 0.2, 1.0));
+
+        // Loading replaces all profiles
+        CHECK(both->loadTrainingData(coveredPath));
+        CHECK_EQ(both->getProfileCount(), size_t(1));
+    }
+
+    // Profiles must share the sample rate and number of bins
+    NoiseDetectorConfig smallFft;
+    smallFft.fftSize = 1024;
+    smallFft.hopSize = 256;
+    auto other = makeTrainedDetector(smallFft, covered);
+    auto otherPath = dir / "micmap_test_profile_1024.mmap";
+    CHECK(other->saveTrainingData(otherPath));
+    auto mixed = createFFTDetector(NoiseDetectorConfig{});
+    CHECK(mixed->loadTrainingData(coveredPath));
+    CHECK(!mixed->addTrainingData(otherPath));
+    CHECK_EQ(mixed->getProfileCount(), size_t(1));
+    CHECK(!createFFTDetector(NoiseDetectorConfig{})->loadTrainingData(otherPath));
+
+    // A profile recorded at another rate has the same size but its bins
+    // are other frequencies
+    NoiseDetectorConfig otherRate;
+    otherRate.sampleRate = 44100;
+    auto resampled = makeTrainedDetector(otherRate, covered);
+    auto ratePath = dir / "micmap_test_profile_44100.mmap";
+    CHECK(resampled->saveTrainingData(ratePath));
+    CHECK_EQ(resampled->getTrainingData().spectralProfile.size(),
+             mixed->getTrainingData().spectralProfile.size());
+    CHECK(!createFFTDetector(NoiseDetectorConfig{})->loadTrainingData(ratePath));
+    CHECK(!mixed->addTrainingData(ratePath));
+    CHECK_EQ(mixed->getProfileCount(), size_t(1));
+    CHECK(createFFTDetector(otherRate)->loadTrainingData(ratePath));
+
+    std::filesystem::remove(coveredPath);
+    std::filesystem::remove(muffledPath);
+    std::filesystem::remove(otherPath);
+    std::filesystem::remove(ratePath);
+}
+
+} // anonymous namespace
+
+int main() {
+    testFastLog();
+
+    auto levels = availableSimdLevels();
+    std::cout << "Spectral feature kernels: "
+              << micmap::common::simdLevelToString(getSpectralFeatureSimdLevel()) << "\n";
+    for (SimdLevel level : levels) {
+        testKernelsMatchReference(level);
+    }
+    testDecisionsUnchanged(levels);
+    testProfileMatch();
+    testMultipleProfiles();
+
+    return TEST_RESULT("Spectral feature kernel tests");
+}
@@ -0,0 +1,127 @@
+/**
+ * @file test_streaming_stft.cpp
+ * @brief Tests for the streaming STFT framer
+ *
+ * Verifies frame cadence, overlap between consecutive frames, that the
+ * emitted frames do not depend on how the input is split into packets and
+ * that a frame stays readable after the packet that completed it.
+ */
+
+#include "micmap/detection/streaming_stft.hpp"
+#include "test_common.hpp"
+
+#include <vector>
+
+using micmap::detection::StreamingSTFT;
+
+namespace {
+
+std::vector<std::vector<float>> collectFrames(StreamingSTFT& stft,
+                                              const std::vector<float>& input,
+                                              size_t packetSize) {
+    std::vector<std::vector<float>> frames;
+    size_t fftSize = stft.getFFTSize();
+    for (size_t offset = 0; offset < input.size(); offset += packetSize) {
+        size_t count = std::min(packetSize, input.size() - offset);
+        stft.process(input.data() + offset, count,
+                     [&](const float* frame, const float*) {
+                         frames.emplace_back(frame, frame + fftSize);
+                     });
+    }
+    return frames;
+}
+
+void testCadenceAndOverlap() {
+    StreamingSTFT stft(16, 4);
+    std::vector<float> input(100);
+    for (size_t i = 0; i < input.size(); ++i) {
+        input[i] = static_cast<float>(i + 1);
+    }
+
+    auto frames = collectFrames(stft, input, 7);
+    CHECK_EQ(frames.size(), size_t(25));
+    CHECK_EQ(stft.getTotalFrames(), size_t(25));
+    CHECK_EQ(stft.getPendingSamples(), size_t(0));
+
+    // First frame is zero-padded at the front
+    CHECK_EQ(frames[0][11], 0.0f);
+    CHECK_EQ(frames[0][12], 1.0f);
+    CHECK_EQ(frames[0][15], 4.0f);
+
+    // Frame k ends at sample 4(k+1) and overlaps the previous one by 12
+    for (size_t k = 4; k < frames.size(); ++k) {
+        for (size_t i = 0; i < 16; ++i) {
+            CHECK_EQ(frames[k][i], static_cast<float>(4 * (k + 1) - 15 + i));
+        }
+    }
+
+    stft.reset();
+    CHECK_EQ(stft.getTotalFrames(), size_t(0));
+    auto afterReset = collectFrames(stft, input, 100);
+    CHECK_EQ(afterReset.size(), size_t(25));
+    CHECK_EQ(afterReset[0][11], 0.0f);
+}
+
+void testPacketSizeIndependence() {
+    std::vector<float> input(48000);
+    for (size_t i = 0; i < input.size(); ++i) {
+        input[i] = static_cast<float>(i % 977) * 0.001f;
+    }
+
+    StreamingSTFT byPeriod(2048, 512);
+    StreamingSTFT bySample(2048, 512);
+    auto periodFrames = collectFrames(byPeriod, input, 480);
+    auto sampleFrames = collectFrames(bySample, input, 1);
+
+    CHECK_EQ(periodFrames.size(), input.size() / 512);
+    CHECK_EQ(periodFrames.size(), sampleFrames.size());
+    CHECK(periodFrames == sampleFrames);
+}
+
+void testFrameOutlivesPacket() {
+    StreamingSTFT stft(16, 4);
+    std::vector<float> input(40);
+    for (size_t i = 0; i < input.size(); ++i) {
+        input[i] = static_cast<float>(i + 1);
+    }
+
+    // Packets ending on a hop boundary leave their last frame in place
+    const float* frame = nullptr;
+    const float* hop = nullptr;
+    for (size_t offset = 0; offset < input.size(); offset += 8) {
+        stft.process(input.data() + offset, 8, [&](const float* f, const float* h) {
+            frame = f;
+            hop = h;
+        });
+        CHECK_EQ(frame[15], static_cast<float>(offset + 8));
+        CHECK_EQ(hop[0], static_cast<float>(offset + 5));
+    }
+    CHECK_EQ(frame[0], 25.0f);
+
+    // The next packet still continues the stream
+    std::vector<float> next = {41.0f, 42.0f, 43.0f, 44.0f};
+    std::vector<float> last;
+    stft.process(next.data(), next.size(), [&](const float* f, const float*) {
+        last.assign(f, f + 16);
+    });
+    CHECK_EQ(last[0], 29.0f);
+    CHECK_EQ(last[15], 44.0f);
+}
+
+void testHopClamp() {
+    StreamingSTFT stft(8, 0);
+    CHECK_EQ(stft.getHopSize(), size_t(1));
+    StreamingSTFT wide(8, 32);
+    CHECK_EQ(wide.getHopSize(), size_t(8));
+}
+
+} // anonymous namespace
+
+int main() {
+    testCadenceAndOverlap();
+    testPacketSizeIndependence();
+    testFrameOutlivesPacket();
+    testHopClamp();
+
+    return TEST_RESULT("StreamingSTFT tests");
+}
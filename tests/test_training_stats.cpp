@@ -0,0 +1,209 @@
+/**
+ * @file test_training_stats.cpp
+ * @brief Tests for the streaming training statistics
+ *
+ * Compares the running moments with two-pass reference computations and
+ * the P-square quantile estimate with the exact sorted quantile.
+ */
+
+#include "micmap/detection/training_stats.hpp"
+#include "micmap/detection/pattern_trainer.hpp"
+#include "micmap/common/logger.hpp"
+#include "test_common.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace micmap::detection;
+
+namespace {
+
+double exactQuantile(std::vector<double> values, double quantile) {
+    std::sort(values.begin(), values.end());
+    double rank = quantile * static_cast<double>(values.size() - 1);
+    size_t lower = static_cast<size_t>(rank);
+    size_t upper = std::min(lower + 1, values.size() - 1);
+    return values[lower] + (values[upper] - values[lower]) * (rank - static_cast<double>(lower));
+}
+
+void testRunningMoments() {
+    RunningMoments empty;
+    CHECK_EQ(empty.count(), size_t(0));
+    CHECK_EQ(empty.mean(), 0.0);
+    CHECK_EQ(empty.variance(), 0.0);
+    CHECK_EQ(empty.min(), 0.0);
+
+    // A large offset is where the naive sum-of-squares formula fails
+    std::mt19937 rng(1);
+    std::normal_distribution<double> dist(1.0e6, 2.0);
+    std::vector<double> values(10000);
+    RunningMoments moments;
+    for (double& v : values) {
+        v = dist(rng);
+        moments.add(v);
+    }
+
+    double mean = 0.0;
+    for (double v : values) {
+        mean += v;
+    }
+    mean /= static_cast<double>(values.size());
+    double variance = 0.0;
+    for (double v : values) {
+        variance += (v - mean) * (v - mean);
+    }
+    variance /= static_cast<double>(values.size());
+
+    CHECK_EQ(moments.count(), values.size());
+    CHECK_NEAR(moments.mean(), mean, 1e-6);
+    CHECK_NEAR(moments.variance(), variance, 1e-6);
+    CHECK_NEAR(moments.stdDev(), std::sqrt(variance), 1e-6);
+    CHECK_EQ(moments.min(), *std::min_element(values.begin(), values.end()));
+    CHECK_EQ(moments.max(), *std::max_element(values.begin(), values.end()));
+
+    moments.reset();
+    CHECK_EQ(moments.count(), size_t(0));
+}
+
+void testSpectrumMoments() {
+    constexpr size_t BINS = 9;
+    constexpr size_t FRAMES = 500;
+    std::mt19937 rng(2);
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+
+    std::vector<std::vector<float>> spectra(FRAMES, std::vector<float>(BINS));
+    SpectrumMoments moments(BINS);
+    for (auto& spectrum : spectra) {
+        for (size_t i = 0; i < BINS; ++i) {
+            spectrum[i] = dist(rng) * static_cast<float>(i + 1);
+        }
+        moments.add(spectrum.data());
+    }
+
+    CHECK_EQ(moments.count(), FRAMES);
+    CHECK_EQ(moments.bins(), BINS);
+    for (size_t i = 0; i < BINS; ++i) {
+        double mean = 0.0;
+        for (const auto& spectrum : spectra) {
+            mean += spectrum[i];
+        }
+        mean /= FRAMES;
+        double variance = 0.0;
+        for (const auto& spectrum : spectra) {
+            variance += (spectrum[i] - mean) * (spectrum[i] - mean);
+        }
+        variance /= FRAMES;
+
+        CHECK_NEAR(moments.mean()[i], mean, 1e-9);
+        CHECK_NEAR(moments.variance(i), variance, 1e-9);
+    }
+    CHECK_EQ(moments.variance(BINS), 0.0);
+
+    moments.reset();
+    CHECK_EQ(moments.count(), size_t(0));
+    CHECK_EQ(moments.bins(), BINS);
+    CHECK_EQ(moments.mean()[0], 0.0);
+}
+
+void testP2QuantileSmall() {
+    P2Quantile median(0.5);
+    CHECK_EQ(median.value(), 0.0);
+    median.add(3.0);
+    CHECK_EQ(median.value(), 3.0);
+    median.add(1.0);
+    CHECK_NEAR(median.value(), 2.0, 1e-12);
+    median.add(2.0);
+    median.add(5.0);
+    median.add(4.0);
+    CHECK_NEAR(median.value(), 3.0, 1e-12);
+    CHECK_EQ(median.count(), size_t(5));
+
+    median.reset();
+    CHECK_EQ(median.count(), size_t(0));
+    CHECK_EQ(median.value(), 0.0);
+}
+
+void testP2QuantileLarge() {
+    std::mt19937 rng(3);
+    std::normal_distribution<double> normal(10.0, 2.0);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    for (double quantile : {0.05, 0.5, 0.9}) {
+        P2Quantile normalEstimate(quantile);
+        P2Quantile uniformEstimate(quantile);
+        std::vector<double> normalValues;
+        std::vector<double> uniformValues;
+        for (int i = 0; i < 20000; ++i) {
+            normalValues.push_back(normal(rng));
+            normalEstimate.add(normalValues.back());
+            uniformValues.push_back(uniform(rng));
+            uniformEstimate.add(uniformValues.back());
+        }
+        CHECK_NEAR(normalEstimate.value(), exactQuantile(normalValues, quantile), 0.05);
+        CHECK_NEAR(uniformEstimate.value(), exactQuantile(uniformValues, quantile), 0.01);
+    }
+
+    // Monotonic input keeps the markers ordered
+    P2Quantile ramp(0.25);
+    std::vector<double> rampValues;
+    for (int i = 0; i < 1000; ++i) {
+        rampValues.push_back(static_cast<double>(i));
+        ramp.add(rampValues.back());
+    }
+    CHECK_NEAR(ramp.value(), exactQuantile(rampValues, 0.25), 2.0);
+}
+
+void testPatternTrainerStreaming() {
+    constexpr uint32_t SAMPLE_RATE = 48000;
+    constexpr size_t FFT_SIZE = 2048;
+    std::mt19937 rng(4);
+    std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+
+    TrainingConfig config;
+    config.minSamples = 10;
+    config.maxSamples = 1000;
+    config.sampleInterval = std::chrono::milliseconds(0);
+    std::shared_ptr<ISpectralAnalyzer> analyzer =
+        createSpectralAnalyzer(SAMPLE_RATE, FFT_SIZE, FFTBackendType::Auto);
+    PatternTrainer trainer(analyzer, config);
+
+    std::vector<float> chunk(FFT_SIZE);
+    RunningMoments energy;
+    trainer.startTraining();
+    for (int n = 0; n < 200; ++n) {
+        float gain = 0.5f + 0.5f * static_cast<float>(n % 5) / 4.0f;
+        for (float& s : chunk) {
+            s = gain * dist(rng);
+        }
+        if (trainer.addSample(chunk.data(), chunk.size())) {
+            energy.add(analyzer->analyze(chunk.data(), chunk.size()).energy);
+        }
+    }
+    CHECK_EQ(trainer.getStats().samplesAccepted, energy.count());
+    CHECK_NEAR(trainer.getStats().averageEnergy, energy.mean(), 1e-5);
+
+    CHECK(trainer.finishTraining());
+    CHECK_EQ(trainer.getSpectralVariance().size(), analyzer->getNumBins());
+    CHECK(trainer.getSpectralVariance()[100] > 0.0f);
+
+    // The threshold is a low percentile of the accepted energies
+    CHECK(trainer.getEnergyThreshold() >= static_cast<float>(energy.min()));
+    CHECK(trainer.getEnergyThreshold() < static_cast<float>(energy.mean()));
+}
+
+} // anonymous namespace
+
+int main() {
+    micmap::common::Logger::getLogger()->setMinLevel(micmap::common::LogLevel::Warning);
+
+    testRunningMoments();
+    testSpectrumMoments();
+    testP2QuantileSmall();
+    testP2QuantileLarge();
+    testPatternTrainerStreaming();
+
+    return TEST_RESULT("Training statistics tests");
+}
@@ -0,0 +1,285 @@
+/**
+ * @file test_trigger_dispatcher.cpp
+ * @brief Tests for asynchronous trigger delivery
+ *
+ * Drives the dispatcher with a sample clock advanced by hand, so
+ * coalescing, deadlines and latencies are checked exactly, and with fake
+ * routes that fail, block or are unavailable.
+ */
+
+#include "micmap/core/trigger_dispatcher.hpp"
+#include "micmap/common/logger.hpp"
+#include "test_common.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace micmap::core;
+using namespace std::chrono_literals;
+
+namespace {
+
+/// 1 kHz: one sample per millisecond
+std::shared_ptr<micmap::common::SampleClock> manualClock() {
+    return std::make_shared<micmap::common::SampleClock>(1000);
+}
+
+TriggerRoute route(const std::string& name, bool available, RouteOutcome outcome, std::atomic<int>& fired) {
+    return TriggerRoute{
+        name,
+        [available] { return available; },
+        [outcome, &fired] { ++fired; return outcome; }};
+}
+
+void testFallback() {
+    auto clock = manualClock();
+    TriggerDispatcherConfig config;
+    config.clock = clock;
+    auto dispatcher = createTriggerDispatcher(config);
+
+    std::atomic<int> dashboard{0}, driver{0}, input{0};
+    dispatcher->setRoutes({route("dashboard", false, RouteOutcome::Delivered, dashboard),
+                           route("driver", true, RouteOutcome::NotAttempted, driver),
+                           route("input", true, RouteOutcome::Delivered, input)});
+    std::vector<TriggerResult> results;
+    std::mutex resultsMutex;
+    dispatcher->setResultCallback([&](const TriggerResult& result) {
+        std::lock_guard<std::mutex> lock(resultsMutex);
+        results.push_back(result);
+    });
+
+    CHECK(dispatcher->start());
+    CHECK(!dispatcher->start());
+    CHECK(dispatcher->isRunning());
+    uint64_t id = dispatcher->submit();
+    CHECK_EQ(id, uint64_t(1));
+    CHECK(dispatcher->waitIdle(5000ms));
+
+    // Unavailable routes are skipped, ones that sent nothing fall through
+    CHECK_EQ(dashboard.load(), 0);
+    CHECK_EQ(driver.load(), 1);
+    CHECK_EQ(input.load(), 1);
+    CHECK_EQ(results.size(), size_t(1));
+    CHECK_EQ(results[0].id, id);
+    CHECK(results[0].outcome == TriggerOutcome::Delivered);
+    CHECK_EQ(results[0].route, std::string("input"));
+    CHECK_EQ(results[0].latency.count(), 0);
+
+    TriggerDispatcherStats stats = dispatcher->getStats();
+    CHECK_EQ(stats.submitted, uint64_t(1));
+    CHECK_EQ(stats.delivered, uint64_t(1));
+    CHECK_EQ(stats.fallbacks, uint64_t(1));
+
+    // Without a working route the trigger fails
+    dispatcher->setRoutes({route("driver", true, RouteOutcome::NotAttempted, driver)});
+    clock->advance(1000);
+    CHECK(dispatcher->submit() != 0);
+    CHECK(dispatcher->waitIdle(5000ms));
+    CHECK_EQ(results.size(), size_t(2));
+    CHECK(results[1].outcome == TriggerOutcome::Failed);
+    CHECK(results[1].route.empty());
+    CHECK_EQ(dispatcher->getStats().failed, uint64_t(1));
+
+    dispatcher->stop();
+    CHECK(!dispatcher->isRunning());
+}
+
+void testUnconfirmed() {
+    auto clock = manualClock();
+    TriggerDispatcherConfig config;
+    config.clock = clock;
+    config.coalesceWindow = 0ms;
+    auto dispatcher = createTriggerDispatcher(config);
+
+    // The dashboard route clicks, but the acknowledgement is lost: the
+    // driver route must not click again
+    std::atomic<int> dashboard{0}, driver{0};
+    dispatcher->setRoutes({route("dashboard", true, RouteOutcome::Unconfirmed, dashboard),
+                           route("driver", true, RouteOutcome::Delivered, driver)});
+    std::vector<TriggerResult> results;
+    std::mutex resultsMutex;
+    dispatcher->setResultCallback([&](const TriggerResult& result) {
+        std::lock_guard<std::mutex> lock(resultsMutex);
+        results.push_back(result);
+    });
+    dispatcher->start();
+
+    CHECK(dispatcher->submit() != 0);
+    CHECK(dispatcher->waitIdle(5000ms));
+    CHECK_EQ(dashboard.load(), 1);
+    CHECK_EQ(driver.load(), 0);
+    CHECK_EQ(results.size(), size_t(1));
+    CHECK(results[0].outcome == TriggerOutcome::Unconfirmed);
+    CHECK_EQ(results[0].route, std::string("dashboard"));
+
+    // A route that throws may have acted before it did
+    dispatcher->setRoutes({TriggerRoute{"dashboard", nullptr, [&]() -> RouteOutcome {
+                               ++dashboard;
+                               throw std::runtime_error("lost connection");
+                           }},
+                           route("driver", true, RouteOutcome::Delivered, driver)});
+    CHECK(dispatcher->submit() != 0);
+    CHECK(dispatcher->waitIdle(5000ms));
+    CHECK_EQ(dashboard.load(), 2);
+    CHECK_EQ(driver.load(), 0);
+
+    TriggerDispatcherStats stats = dispatcher->getStats();
+    CHECK_EQ(stats.unconfirmed, uint64_t(2));
+    CHECK_EQ(stats.delivered, uint64_t(0));
+    CHECK_EQ(stats.failed, uint64_t(0));
+    CHECK_EQ(stats.fallbacks, uint64_t(0));
+}
+
+void testCoalescing() {
+    auto clock = manualClock();
+    TriggerDispatcherConfig config;
+    config.clock = clock;
+    config.coalesceWindow = 300ms;
+    auto dispatcher = createTriggerDispatcher(config);
+    std::atomic<int> fired{0};
+    dispatcher->setRoutes({route("driver", true, RouteOutcome::Delivered, fired)});
+    dispatcher->start();
+
+    CHECK_EQ(dispatcher->submit(), uint64_t(1));
+    clock->advance(100);
+    CHECK_EQ(dispatcher->submit(), uint64_t(0));  // Same cover, reported twice
+    clock->advance(199);
+    CHECK_EQ(dispatcher->submit(), uint64_t(0));
+    clock->advance(1);
+    CHECK_EQ(dispatcher->submit(), uint64_t(2));
+    CHECK(dispatcher->waitIdle(5000ms));
+
+    TriggerDispatcherStats stats = dispatcher->getStats();
+    CHECK_EQ(fired.load(), 2);
+    CHECK_EQ(stats.submitted, uint64_t(4));
+    CHECK_EQ(stats.coalesced, uint64_t(2));
+    CHECK_EQ(stats.delivered, uint64_t(2));
+
+    dispatcher->resetStats();
+    CHECK_EQ(dispatcher->getStats().submitted, uint64_t(0));
+}
+
+void testDeadline() {
+    auto clock = manualClock();
+    TriggerDispatcherConfig config;
+    config.clock = clock;
+    config.coalesceWindow = 300ms;
+    config.deadline = 500ms;
+    auto dispatcher = createTriggerDispatcher(config);
+
+    // The first delivery hangs, as an HTTP request to a busy driver would
+    std::atomic<bool> entered{false};
+    std::atomic<bool> release{false};
+    dispatcher->setRoutes({TriggerRoute{"driver", nullptr, [&] {
+        entered = true;
+        while (!release) {
+            std::this_thread::sleep_for(1ms);
+        }
+        return RouteOutcome::Delivered;
+    }}});
+    std::vector<TriggerResult> results;
+    std::mutex resultsMutex;
+    dispatcher->setResultCallback([&](const TriggerResult& result) {
+        std::lock_guard<std::mutex> lock(resultsMutex);
+        results.push_back(result);
+    });
+    dispatcher->start();
+
+    CHECK_EQ(dispatcher->submit(), uint64_t(1));
+    while (!entered) {
+        std::this_thread::sleep_for(1ms);
+    }
+    clock->advance(350);
+    CHECK_EQ(dispatcher->submit(), uint64_t(2));
+    clock->advance(600);
+    release = true;
+    CHECK(dispatcher->waitIdle(5000ms));
+
+    CHECK_EQ(results.size(), size_t(2));
+    CHECK(results[0].outcome == TriggerOutcome::Delivered);
+    CHECK_EQ(results[0].latency.count(), 950000);
+    CHECK(results[1].outcome == TriggerOutcome::Expired);
+    CHECK_EQ(results[1].queueDelay.count(), 600000);
+
+    TriggerDispatcherStats stats = dispatcher->getStats();
+    CHECK_EQ(stats.delivered, uint64_t(1));
+    CHECK_EQ(stats.expired, uint64_t(1));
+    CHECK_EQ(stats.deadlineMisses, uint64_t(1));
+    CHECK_EQ(stats.lastLatency.count(), 950000);
+    CHECK_EQ(stats.maxLatency.count(), 950000);
+    CHECK_EQ(stats.totalLatency.count(), 950000);
+}
+
+void testQueueBounds() {
+    auto clock = manualClock();
+    TriggerDispatcherConfig config;
+    config.clock = clock;
+    config.coalesceWindow = 0ms;
+    config.queueCapacity = 2;
+    auto dispatcher = createTriggerDispatcher(config);
+    std::atomic<int> fired{0};
+    dispatcher->setRoutes({route("driver", true, RouteOutcome::Delivered, fired)});
+
+    // Not started yet: triggers wait in the queue
+    CHECK_EQ(dispatcher->submit(), uint64_t(1));
+    CHECK_EQ(dispatcher->submit(), uint64_t(2));
+    CHECK_EQ(dispatcher->submit(), uint64_t(0));
+    CHECK_EQ(dispatcher->getStats().rejected, uint64_t(1));
+    CHECK(!dispatcher->waitIdle(10ms));
+
+    dispatcher->start();
+    CHECK(dispatcher->waitIdle(5000ms));
+    CHECK_EQ(fired.load(), 2);
+    dispatcher->stop();
+
+    // Queued when stopped: counted as expired, never fired
+    CHECK(dispatcher->submit() != 0);
+    dispatcher->stop();
+    CHECK_EQ(dispatcher->getStats().expired, uint64_t(1));
+    CHECK_EQ(fired.load(), 2);
+    CHECK(dispatcher->waitIdle(10ms));
+}
+
+void testSubmitDoesNotWait() {
+    // Real time: a slow route must not hold up the caller
+    auto dispatcher = createTriggerDispatcher();
+    std::atomic<int> fired{0};
+    dispatcher->setRoutes({TriggerRoute{"slow", nullptr, [&] {
+        std::this_thread::sleep_for(200ms);
+        ++fired;
+        return RouteOutcome::Delivered;
+    }}});
+    dispatcher->start();
+
+    auto start = std::chrono::steady_clock::now();
+    CHECK(dispatcher->submit() != 0);
+    auto submitTime = std::chrono::steady_clock::now() - start;
+    CHECK(submitTime < 50ms);
+    CHECK_EQ(fired.load(), 0);
+
+    CHECK(dispatcher->waitIdle(5000ms));
+    CHECK_EQ(fired.load(), 1);
+    TriggerDispatcherStats stats = dispatcher->getStats();
+    CHECK(stats.lastLatency >= 200ms);
+    CHECK_EQ(stats.deadlineMisses, uint64_t(0));
+}
+
+} // anonymous namespace
+
+int main() {
+    // Failed and expired triggers are logged as warnings on purpose
+    micmap::common::Logger::getLogger()->setMinLevel(micmap::common::LogLevel::Error);
+
+    testFallback();
+    testUnconfirmed();
+    testCoalescing();
+    testDeadline();
+    testQueueBounds();
+    testSubmitDoesNotWait();
+
+    return TEST_RESULT("Trigger dispatcher tests");
+}
@@ -0,0 +1,223 @@
+/**
+ * @file test_zero_alloc.cpp
+ * @brief Verifies that steady-state resampling, spectral analysis,
+ *        detection and training do not allocate
+ *
+ * Replaces the global allocation functions with counting versions, warms the
+ * analyzer and detector up, then checks that further analysis performs no
+ * heap allocations at all.
+ */
+
+#include "micmap/audio/resampler.hpp"
+#include "micmap/detection/noise_detector.hpp"
+#include "micmap/detection/spectral_analyzer.hpp"
+#include "test_common.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <new>
+#include <random>
+#include <vector>
+
+namespace {
+
+std::atomic<size_t> g_allocationCount{0};
+
+} // anonymous namespace
+
+void* operator new(std::size_t size) {
+    g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+using namespace micmap::detection;
+
+namespace {
+
+constexpr uint32_t SAMPLE_RATE = 48000;
+constexpr size_t PACKET_SIZE = 480;
+
+std::vector<float> makeNoise(size_t count, float amplitude, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-amplitude, amplitude);
+    std::vector<float> samples(count);
+    for (float& s : samples) {
+        s = dist(rng);
+    }
+    return samples;
+}
+
+void testAnalyzerInto() {
+    auto analyzer = createKissFFTAnalyzer(SAMPLE_RATE, 2048);
+    auto input = makeNoise(2048, 0.5f, 1);
+    std::vector<float> magnitudes(analyzer->getNumBins());
+    CHECK_EQ(magnitudes.size(), size_t(1025));
+
+    // Reference through the allocating API
+    SpectralResult reference = analyzer->analyze(input.data(), input.size());
+
+    size_t before = g_allocationCount.load();
+    SpectralFeatures features = analyzer->analyzeInto(input.data(), input.size(),
+                                                      magnitudes.data(), magnitudes.size());
+    CHECK_EQ(g_allocationCount.load() - before, size_t(0));
+
+    CHECK(magnitudes == reference.magnitudes);
+    CHECK_EQ(features.energy, reference.energy);
+    CHECK_EQ(features.spectralFlatness, reference.spectralFlatness);
+    CHECK_EQ(features.spectralCentroid, reference.spectralCentroid);
+
+    // A short buffer receives the leading bins only
+    std::vector<float> partial(16);
+    SpectralFeatures partialFeatures = analyzer->analyzeInto(input.data(), input.size(),
+                                                             partial.data(), partial.size());
+    CHECK_EQ(partial[15], reference.magnitudes[15]);
+    CHECK_EQ(partialFeatures.spectralFlatness, reference.spectralFlatness);
+}
+
+void testDetectorSteadyState(bool filterbank) {
+    NoiseDetectorConfig config;
+    config.sampleRate = SAMPLE_RATE;
+    config.filterbank.enabled = filterbank;
+    auto detector = createFFTDetector(config);
+
+    // Train on white noise so the full confidence path runs
+    auto training = makeNoise(SAMPLE_RATE * 2, 0.3f, 2);
+    detector->startTraining();
+    detector->addTrainingSample(training.data(), training.size());
+    CHECK(detector->finishTraining());
+
+    // Loud noise bursts exercise the spike gate and temporal state as well
+    auto input = makeNoise(SAMPLE_RATE * 4, 0.9f, 3);
+    std::vector<DetectionResult> results(PACKET_SIZE / config.hopSize + 1);
+
+    // Warm-up fills the energy and confidence histories
+    for (size_t offset = 0; offset + PACKET_SIZE <= SAMPLE_RATE; offset += PACKET_SIZE) {
+        detector->analyze(input.data() + offset, PACKET_SIZE);
+    }
+
+    auto steadyState = [&] {
+        size_t before = g_allocationCount.load();
+        size_t frames = 0;
+        for (size_t offset = SAMPLE_RATE; offset + PACKET_SIZE <= input.size(); offset += PACKET_SIZE) {
+            if (offset % (PACKET_SIZE * 2) == 0) {
+                detector->analyze(input.data() + offset, PACKET_SIZE);
+            } else {
+                frames += detector->analyzeInto(input.data() + offset, PACKET_SIZE,
+                                                results.data(), results.size());
+            }
+        }
+        CHECK_EQ(g_allocationCount.load() - before, size_t(0));
+        CHECK(frames > 0);
+    };
+    steadyState();
+
+    // Matching several profiles uses scratch sized when they were added
+    auto path = std::filesystem::temp_directory_path() / "micmap_zero_alloc_profile.mmap";
+    CHECK(detector->saveTrainingData(path));
+    CHECK(detector->addTrainingData(path));
+    CHECK(detector->addTrainingData(path));
+    CHECK_EQ(detector->getProfileCount(), size_t(3));
+    steadyState();
+    std::filesystem::remove(path);
+}
+
+void testChannelsSteadyState() {
+    NoiseDetectorConfig config;
+    config.sampleRate = SAMPLE_RATE;
+    config.channels = 2;
+    auto detector = createFFTDetector(config);
+
+    auto first = makeNoise(SAMPLE_RATE * 4, 0.3f, 6);
+    auto second = makeNoise(SAMPLE_RATE * 4, 0.3f, 7);
+    const float* training[2] = {first.data(), second.data()};
+    detector->startTraining();
+    detector->addTrainingChannels(training, SAMPLE_RATE * 2);
+    CHECK(detector->finishTraining());
+
+    std::vector<DetectionResult> results(PACKET_SIZE / config.hopSize + 1);
+    auto analyze = [&](size_t offset) {
+        const float* channels[2] = {first.data() + offset, second.data() + offset};
+        return detector->analyzeChannelsInto(channels, PACKET_SIZE, results.data(), results.size());
+    };
+    for (size_t offset = 0; offset + PACKET_SIZE <= SAMPLE_RATE; offset += PACKET_SIZE) {
+        analyze(offset);
+    }
+
+    size_t before = g_allocationCount.load();
+    size_t frames = 0;
+    for (size_t offset = SAMPLE_RATE; offset + PACKET_SIZE <= first.size(); offset += PACKET_SIZE) {
+        frames += analyze(offset);
+    }
+    CHECK_EQ(g_allocationCount.load() - before, size_t(0));
+    CHECK(frames > 0);
+}
+
+void testTrainingSteadyState() {
+    NoiseDetectorConfig config;
+    config.sampleRate = SAMPLE_RATE;
+    auto detector = createFFTDetector(config);
+    auto input = makeNoise(SAMPLE_RATE * 4, 0.3f, 4);
+
+    // Training statistics are streaming, so a session of any length keeps
+    // its memory from the first frame on
+    detector->startTraining();
+    detector->addTrainingSample(input.data(), SAMPLE_RATE);
+
+    size_t before = g_allocationCount.load();
+    for (size_t offset = SAMPLE_RATE; offset + PACKET_SIZE <= input.size(); offset += PACKET_SIZE) {
+        detector->addTrainingSample(input.data() + offset, PACKET_SIZE);
+    }
+    CHECK_EQ(g_allocationCount.load() - before, size_t(0));
+    CHECK(detector->finishTraining());
+}
+
+void testResamplerSteadyState() {
+    micmap::audio::Resampler resampler(44100, 16000);
+    auto input = makeNoise(44100, 0.3f, 5);
+    std::vector<float> output(resampler.maxOutput(441));
+
+    size_t before = g_allocationCount.load();
+    size_t produced = 0;
+    for (size_t offset = 0; offset + 441 <= input.size(); offset += 441) {
+        produced += resampler.process(input.data() + offset, 441, output.data());
+    }
+    CHECK_EQ(g_allocationCount.load() - before, size_t(0));
+    CHECK(produced > 15900);
+}
+
+} // anonymous namespace
+
+int main() {
+    testAnalyzerInto();
+    testDetectorSteadyState(false);
+    testDetectorSteadyState(true);
+    testChannelsSteadyState();
+    testTrainingSteadyState();
+    testResamplerSteadyState();
+
+    return TEST_RESULT("Zero-allocation analysis tests");
+}